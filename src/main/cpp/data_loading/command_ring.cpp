@@ -0,0 +1,165 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <algorithm>
+#include <new>
+#include <easylogging++.h>
+#include "command_ring.h"
+
+namespace nova {
+    static uint32_t round_up(uint32_t value, uint32_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    malformed_command::malformed_command(const std::string& msg) : std::runtime_error(msg) {}
+
+    command_reader::command_reader(const uint8_t* data, uint32_t size) : data(data), size(size) {}
+
+    const char* command_reader::read_string() {
+        auto length = read<uint32_t>();
+        if(length >= size - pos) {
+            throw malformed_command("String of " + std::to_string(length) + " characters doesn't fit in the command");
+        }
+
+        auto* str = reinterpret_cast<const char*>(take(round_up(length + 1, 4)));
+        if(str[length] != '\0') {
+            throw malformed_command("String isn't null-terminated");
+        }
+        return str;
+    }
+
+    const uint8_t* command_reader::take(uint32_t num_bytes) {
+        if(num_bytes > size - pos) {
+            throw malformed_command("Tried to read " + std::to_string(num_bytes) + " bytes but the command only has " + std::to_string(size - pos) + " left");
+        }
+
+        auto* start = data + pos;
+        pos += num_bytes;
+        return start;
+    }
+
+    command_builder& command_builder::add_string(const std::string& str) {
+        add(static_cast<uint32_t>(str.size()));
+        data.insert(data.end(), str.begin(), str.end());
+        data.resize(data.size() + round_up(static_cast<uint32_t>(str.size()) + 1, 4) - str.size(), 0);
+        return *this;
+    }
+
+    const std::vector<uint8_t>& command_builder::get_data() const {
+        return data;
+    }
+
+    command_ring::command_ring(uint32_t capacity) {
+        uint32_t rounded_capacity = 64;
+        while(rounded_capacity < capacity) {
+            rounded_capacity <<= 1;
+        }
+
+        // The header's offsets need to be on their own cache lines, so over-allocate and line the header up with one
+        memory = std::make_unique<uint8_t[]>(sizeof(command_ring_header) + rounded_capacity + 64);
+        auto aligned_start = (reinterpret_cast<uintptr_t>(memory.get()) + 63) & ~static_cast<uintptr_t>(63);
+        header = new(reinterpret_cast<void*>(aligned_start)) command_ring_header{};
+        data = reinterpret_cast<uint8_t*>(header) + sizeof(command_ring_header);
+
+        header->magic = COMMAND_RING_MAGIC;
+        header->version = COMMAND_RING_VERSION;
+        header->capacity = rounded_capacity;
+        header->data_offset = sizeof(command_ring_header);
+        header->write_offset.store(0);
+        header->read_offset.store(0);
+    }
+
+    uint8_t* command_ring::get_memory() {
+        return reinterpret_cast<uint8_t*>(header);
+    }
+
+    uint32_t command_ring::get_memory_size() const {
+        return header->data_offset + header->capacity;
+    }
+
+    bool command_ring::write(command_type type, const std::vector<uint8_t>& payload) {
+        auto capacity = header->capacity;
+        auto size = round_up(static_cast<uint32_t>(sizeof(command_header) + payload.size()), 8);
+
+        auto write_offset = header->write_offset.load(std::memory_order_relaxed);
+        auto read_offset = header->read_offset.load(std::memory_order_acquire);
+
+        auto space_before_end = capacity - static_cast<uint32_t>(write_offset & (capacity - 1));
+        auto padding = size > space_before_end ? space_before_end : 0;
+        if(padding + size > capacity - (write_offset - read_offset)) {
+            return false;
+        }
+
+        if(padding > 0) {
+            command_header padding_header = {static_cast<uint32_t>(command_type::padding), padding};
+            std::memcpy(data + (write_offset & (capacity - 1)), &padding_header, sizeof(command_header));
+            write_offset += padding;
+        }
+
+        auto* dest = data + (write_offset & (capacity - 1));
+        command_header cmd_header = {static_cast<uint32_t>(type), size};
+        std::memcpy(dest, &cmd_header, sizeof(command_header));
+        std::memcpy(dest + sizeof(command_header), payload.data(), payload.size());
+
+        header->write_offset.store(write_offset + size, std::memory_order_release);
+        return true;
+    }
+
+    uint64_t command_ring::get_write_offset() const {
+        return header->write_offset.load(std::memory_order_acquire);
+    }
+
+    uint32_t command_ring::consume(const std::function<void(command_type, command_reader&)>& handler) {
+        return consume(handler, get_write_offset());
+    }
+
+    uint32_t command_ring::consume(const std::function<void(command_type, command_reader&)>& handler, uint64_t end_offset) {
+        auto capacity = header->capacity;
+        auto read_offset = header->read_offset.load(std::memory_order_relaxed);
+        auto write_offset = header->write_offset.load(std::memory_order_acquire);
+
+        if(write_offset - read_offset > capacity) {
+            LOG(ERROR) << "Command ring write offset " << write_offset << " is more than a ring ahead of read offset " << read_offset << ", throwing away everything in the ring";
+            header->read_offset.store(write_offset, std::memory_order_release);
+            return 0;
+        }
+
+        if(end_offset < read_offset) {
+            // Someone already consumed past the end, most likely through process_command_ring
+            return 0;
+        }
+        auto stop_offset = std::min(end_offset, write_offset);
+
+        uint32_t num_commands = 0;
+        while(read_offset < stop_offset) {
+            auto position = static_cast<uint32_t>(read_offset & (capacity - 1));
+            command_header cmd_header = {};
+            std::memcpy(&cmd_header, data + position, sizeof(command_header));
+
+            if(cmd_header.size < sizeof(command_header) || cmd_header.size % 8 != 0 ||
+                    cmd_header.size > capacity - position || cmd_header.size > write_offset - read_offset) {
+                LOG(ERROR) << "Command at offset " << read_offset << " has a bad size of " << cmd_header.size << ", throwing away the rest of the ring";
+                read_offset = write_offset;
+                break;
+            }
+
+            auto type = static_cast<command_type>(cmd_header.type);
+            if(type != command_type::padding) {
+                command_reader reader(data + position + sizeof(command_header), cmd_header.size - static_cast<uint32_t>(sizeof(command_header)));
+                try {
+                    handler(type, reader);
+                    num_commands++;
+                } catch(std::exception& e) {
+                    LOG(ERROR) << "Skipping command of type " << cmd_header.type << ": " << e.what();
+                }
+            }
+
+            read_offset += cmd_header.size;
+        }
+
+        header->read_offset.store(read_offset, std::memory_order_release);
+        return num_commands;
+    }
+}
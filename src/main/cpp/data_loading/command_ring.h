@@ -0,0 +1,213 @@
+/*!
+ * \brief A block of native memory that Java writes commands into, so that Minecraft can send Nova lots of little
+ * things without paying for a JNA call for each one
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_COMMAND_RING_H
+#define RENDERER_COMMAND_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace nova {
+    /*!
+     * \brief The things that Java can ask Nova to do through the command ring
+     *
+     * These values are part of the binary format that Java writes. Don't change them, add new ones to the end and bump
+     * COMMAND_RING_VERSION if the layout of an existing command changes
+     */
+    enum class command_type : uint32_t {
+        padding = 0,                //!< Fills the space at the end of the ring when a command doesn't fit there
+        add_chunk_geometry = 1,     //!< format, x, y, z, id, vertex count, index count, filter name, vertex data, indices
+        remove_chunk_geometry = 2,  //!< x, y, z, id, filter name
+        add_gui_geometry = 3,       //!< index count, vertex count, texture name, atlas name, indices, vertex data
+        clear_gui = 4,              //!< Nothing
+        set_float_setting = 5,      //!< value, setting name
+        set_string_setting = 6,     //!< setting name, setting value
+        set_camera = 7,             //!< x, y, z as doubles, yaw, pitch as floats
+    };
+
+    const uint32_t COMMAND_RING_MAGIC = 0x5243564E;     // "NVCR" in little-endian
+    const uint32_t COMMAND_RING_VERSION = 1;
+
+    /*!
+     * \brief The start of the ring's memory. Java finds everything else through this
+     *
+     * The write and read offsets only ever go up. The position in the ring is the offset modulo the capacity. Java is
+     * the only one who writes write_offset and Nova is the only one who writes read_offset, and they're on separate
+     * cache lines so the two sides don't fight over them
+     */
+    struct command_ring_header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t capacity;      //!< How many bytes of commands fit in the ring. Always a power of two
+        uint32_t data_offset;   //!< How far from the start of the header the first command byte is
+
+        alignas(64) std::atomic<uint64_t> write_offset;
+        alignas(64) std::atomic<uint64_t> read_offset;
+    };
+
+    static_assert(sizeof(command_ring_header) == 192, "Java expects the command ring header to be 192 bytes");
+
+    /*!
+     * \brief Every command starts with this. The size includes the header and is always a multiple of 8, so the next
+     * command is always 8-byte aligned
+     */
+    struct command_header {
+        uint32_t type;
+        uint32_t size;
+    };
+
+    /*!
+     * \brief Thrown when a command is shorter than its type says it should be
+     */
+    class malformed_command : public std::runtime_error {
+    public:
+        explicit malformed_command(const std::string& msg);
+    };
+
+    /*!
+     * \brief Reads the fields of a single command, making sure to never read past its end
+     *
+     * Strings are a uint32 length, the characters, a null terminator, then padding up to a multiple of 4 bytes. Arrays
+     * are just their elements. This means that strings and arrays can be read right out of the ring without copying
+     * them, but they're only valid until the ring handler returns
+     */
+    class command_reader {
+    public:
+        command_reader(const uint8_t* data, uint32_t size);
+
+        template<typename T>
+        T read() {
+            T value;
+            std::memcpy(&value, take(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        const char* read_string();
+
+        template<typename T>
+        const T* read_array(uint32_t count) {
+            if(count > (size - pos) / sizeof(T)) {
+                throw malformed_command("Array of " + std::to_string(count) + " elements doesn't fit in the command");
+            }
+            return reinterpret_cast<const T*>(take(count * sizeof(T)));
+        }
+
+    private:
+        const uint8_t* data;
+        uint32_t size;
+        uint32_t pos = 0;
+
+        const uint8_t* take(uint32_t num_bytes);
+    };
+
+    /*!
+     * \brief Lays out a command the same way Java does. Nova doesn't send itself commands, but this is the reference
+     * for the format and it's what the tests use
+     */
+    class command_builder {
+    public:
+        template<typename T>
+        command_builder& add(const T& value) {
+            auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+            data.insert(data.end(), bytes, bytes + sizeof(T));
+            return *this;
+        }
+
+        command_builder& add_string(const std::string& str);
+
+        template<typename T>
+        command_builder& add_array(const T* values, uint32_t count) {
+            auto* bytes = reinterpret_cast<const uint8_t*>(values);
+            data.insert(data.end(), bytes, bytes + count * sizeof(T));
+            return *this;
+        }
+
+        const std::vector<uint8_t>& get_data() const;
+
+    private:
+        std::vector<uint8_t> data;
+    };
+
+    /*!
+     * \brief A ring of commands, written by Java through a direct ByteBuffer and read by Nova at the start of each frame
+     *
+     * Nova allocates the memory and hands Java a pointer to it. Java writes a command, then bumps the write offset.
+     * Nova reads every command between the read offset and the write offset, then bumps the read offset once for the
+     * whole batch. If there isn't enough room for a command, Java asks Nova to process the ring right then, which is
+     * fine because Java makes all its calls into Nova from the same thread.
+     *
+     * A command never wraps around the end of the ring. If there isn't enough room before the end, the writer fills
+     * that space with a padding command and starts the real command at the beginning.
+     */
+    class command_ring {
+    public:
+        /*!
+         * \param capacity How many bytes of commands the ring can hold. Rounded up to a power of two
+         */
+        explicit command_ring(uint32_t capacity);
+
+        command_ring(const command_ring& other) = delete;
+        command_ring& operator=(const command_ring& other) = delete;
+
+        /*!
+         * \brief The start of the ring's memory, header and all. This is what Java wraps in a ByteBuffer
+         */
+        uint8_t* get_memory();
+
+        /*!
+         * \brief The size of the ring's memory, header and all
+         */
+        uint32_t get_memory_size() const;
+
+        /*!
+         * \brief Writes a command into the ring. Only call this from the thread that writes commands
+         *
+         * \return False if there isn't enough room for the command. Nothing is written in that case
+         */
+        bool write(command_type type, const std::vector<uint8_t>& payload);
+
+        /*!
+         * \brief Hands every command in the ring to the handler, in the order they were written, then frees up the
+         * space they used
+         *
+         * A command that the handler throws on is logged and skipped. If the ring itself is garbage, everything that's
+         * in it is thrown away
+         *
+         * \return The number of commands that the handler handled without throwing
+         */
+        uint32_t consume(const std::function<void(command_type, command_reader&)>& handler);
+
+        /*!
+         * \brief Like the other #consume, but stops at the given offset
+         *
+         * The game thread grabs the write offset when it publishes a frame, and the render thread consumes up to that
+         * offset, so a frame only sees the commands that were written before it was published
+         *
+         * \param end_offset The offset to stop at, from #get_write_offset
+         */
+        uint32_t consume(const std::function<void(command_type, command_reader&)>& handler, uint64_t end_offset);
+
+        /*!
+         * \brief How far into the ring Java has written. Only ever goes up
+         */
+        uint64_t get_write_offset() const;
+
+    private:
+        std::unique_ptr<uint8_t[]> memory;
+        command_ring_header* header;
+        uint8_t* data;
+    };
+}
+
+#endif //RENDERER_COMMAND_RING_H
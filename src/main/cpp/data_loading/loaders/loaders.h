@@ -13,15 +13,21 @@
 #include <string>
 #include <unordered_map>
 #include "../../render/objects/shaders/shaderpack.h"
+#include "../../utils/job_system.h"
 
 namespace nova {
     /*!
      * \brief Loads the shaderpack with the given name
      *
      * \param shaderpack_name The name of the shaderpack to load
+     * \param program_cache Where to look for compiled programs before compiling them. Nothing is cached if this is
+     * nullptr
+     * \param jobs The job system to load the shader files on. The files are loaded one after another if this is
+     * nullptr
      * \return The loaded shaderpack
      */
-    shaderpack load_shaderpack(const std::string &shaderpack_name);
+    shaderpack load_shaderpack(const std::string &shaderpack_name, program_binary_cache* program_cache = nullptr,
+                               job_system* jobs = nullptr);
 }
 
 #endif //RENDERER_LOADERS_H
@@ -5,13 +5,16 @@
  * \date 03-Sep-16.
  */
 
+#include <sstream>
 #include <easylogging++.h>
 
 #include "loaders.h"
 #include "shader_loading.h"
 #include "loader_utils.h"
+#include "shaderpack_files.h"
 #include "../../render/objects/shaders/shaderpack.h"
 #include "../../utils/utils.h"
+#include "../../render/objects/uniform_buffers/uniform_buffer_definitions.h"
 
 namespace nova {
     /*!
@@ -35,7 +38,7 @@ namespace nova {
             ".vert.spv"
     };
 
-    shaderpack load_shaderpack(const std::string &shaderpack_name) {
+    shaderpack load_shaderpack(const std::string &shaderpack_name, program_binary_cache* program_cache, job_system* jobs) {
         LOG(DEBUG) << "Loading shaderpack " << shaderpack_name;
         auto shader_sources = std::unordered_map<std::string, shader_definition>{};
         if(is_zip_file(shaderpack_name)) {
@@ -44,7 +47,7 @@ namespace nova {
 
         } else {
             LOG(TRACE) << "Loading shaderpack " << shaderpack_name << " from a regular folder";
-            return load_sources_from_folder(shaderpack_name, shader_names);
+            return load_sources_from_folder(shaderpack_name, shader_names, program_cache, jobs);
         }
     }
 
@@ -68,7 +71,8 @@ namespace nova {
         return definitions;
     }
 
-    shaderpack load_sources_from_folder(const std::string &shaderpack_name, const std::vector<std::string> &shader_names) {
+    shaderpack load_sources_from_folder(const std::string &shaderpack_name, const std::vector<std::string> &shader_names,
+                                        program_binary_cache* program_cache, job_system* jobs) {
         std::vector<shader_definition> sources;
 
         // First, load in the shaders.json file so we can see what we're
@@ -88,23 +92,56 @@ namespace nova {
         // Figure out all the shader files that we need to load
         auto shaders = get_shader_definitions(shaders_json);
 
-        for(auto &shader : shaders) {
-            try {
-                // All shaderpacks are in the shaderpacks folder
-                auto shader_path = "shaderpacks/" + shaderpack_name + "/shaders/" + shader.name;
+        // All shaderpacks are in the shaderpacks folder
+        auto shaders_directory = "shaderpacks/" + shaderpack_name + "/shaders";
+        shaderpack_files files(shaders_directory);
 
-                shader.vertex_source = load_shader_file(shader_path, vertex_extensions);
-                shader.fragment_source = load_shader_file(shader_path, fragment_extensions);
+        // Every stage of every shader is loaded on its own, so they can all be loaded at the same time. Stage 2n is
+        // the vertex shader of shader n, and stage 2n + 1 is its fragment shader
+        std::vector<std::string> stage_errors(shaders.size() * 2);
+        auto load_stage = [&](size_t stage) {
+            auto& shader = shaders[stage / 2];
+            bool is_vertex_stage = stage % 2 == 0;
+            try {
+                auto shader_path = shaders_directory + "/" + shader.name;
+                auto stage_path = files.find_shader(shader_path, is_vertex_stage ? vertex_extensions : fragment_extensions);
+                if(!stage_path) {
+                    throw resource_not_found(shader_path);
+                }
 
-                sources.push_back(shader);
+                auto& stage_source = is_vertex_stage ? shader.vertex_source : shader.fragment_source;
+                stage_source = files.load_shader(*stage_path);
             } catch(std::exception& e) {
-                LOG(ERROR) << "Could not load shader " << shader.name << ". Reason: " << e.what();
+                stage_errors[stage] = e.what();
+            }
+        };
+
+        if(jobs != nullptr) {
+            jobs->parallel_for(stage_errors.size(), 1, [&](size_t first_stage, size_t last_stage) {
+                for(size_t stage = first_stage; stage < last_stage; stage++) {
+                    load_stage(stage);
+                }
+            });
+        } else {
+            for(size_t stage = 0; stage < stage_errors.size(); stage++) {
+                load_stage(stage);
+            }
+        }
+
+        for(size_t i = 0; i < shaders.size(); i++) {
+            const auto& error = stage_errors[i * 2].empty() ? stage_errors[i * 2 + 1] : stage_errors[i * 2];
+            if(error.empty()) {
+                sources.push_back(shaders[i]);
+            } else {
+                LOG(ERROR) << "Could not load shader " << shaders[i].name << ". Reason: " << error;
             }
         }
 
+        LOG(DEBUG) << "Read " << files.get_num_files_read() << " of the " << files.get_num_files() << " files in shaderpack " << shaderpack_name;
+
         warn_for_missing_fallbacks(sources);
 
-        return shaderpack(shaderpack_name, shaders_json, sources);
+        return shaderpack(shaderpack_name, shaders_json, sources, program_cache);
     }
 
     void warn_for_missing_fallbacks(std::vector<shader_definition> sources) {
@@ -177,7 +214,7 @@ namespace nova {
         }
     }
 
-    std::vector<shader_line> load_shader_file(const std::string &shader_path, const std::vector<std::string> &extensions) {
+    shader_source load_shader_file(const std::string &shader_path, const std::vector<std::string> &extensions) {
         for(auto &extension : extensions) {
             auto full_shader_path = shader_path + extension;
             LOG(TRACE) << "Trying to load shader file " << full_shader_path;
@@ -194,17 +231,17 @@ namespace nova {
         throw resource_not_found(shader_path);
     }
 
-    std::vector<shader_line> read_shader_stream(std::istream &stream, const std::string &shader_path) {
-        std::vector<shader_line> file_source;
+    shader_source read_shader_stream(std::istream &stream, const std::string &shader_path) {
+        shader_source file_source;
+        auto file_id = file_source.add_file(shader_path);
         std::string line;
-        auto line_counter = 1;
+        auto line_counter = 1u;
         while(std::getline(stream, line, '\n')) {
             if(line.find("#include") == 0) { 
-                auto included_file = load_included_file(shader_path, line);
-                file_source.insert(file_source.end(), std::begin(included_file), std::end(included_file));
+                file_source.append(load_included_file(shader_path, line));
 
             } else {
-                file_source.push_back({line_counter, shader_path, line});
+                file_source.add_line(file_id, line_counter, line);
             }
 
             line_counter++;
@@ -213,8 +250,36 @@ namespace nova {
         return file_source;
     }
 
-    std::vector<shader_line> load_included_file(const std::string &shader_path, const std::string &line) {
+    bool is_nova_include(const std::string &included_file_name) {
+        return included_file_name.find("/nova/") == 0;
+    }
+
+    shader_source load_nova_include(const std::string &included_file_name) {
+        auto block_source = get_uniform_block_include(included_file_name);
+        if(!block_source) {
+            throw std::runtime_error("Nova does not provide the include file " + included_file_name);
+        }
+
+        shader_source block_lines;
+        auto file_id = block_lines.add_file(included_file_name);
+        std::stringstream block_stream(*block_source);
+        std::string block_line;
+        auto line_counter = 1u;
+        while(std::getline(block_stream, block_line)) {
+            block_lines.add_line(file_id, line_counter, block_line);
+            line_counter++;
+        }
+
+        return block_lines;
+    }
+
+    shader_source load_included_file(const std::string &shader_path, const std::string &line) {
         auto included_file_name = get_filename_from_include(line);
+
+        if(is_nova_include(included_file_name)) {
+            return load_nova_include(included_file_name);
+        }
+
         auto file_to_include = get_included_file_path(shader_path, included_file_name);
         LOG(TRACE) << "Dealing with included file " << file_to_include;
 
@@ -13,6 +13,8 @@
 #include <unordered_map>
 
 #include "shader_source_structs.h"
+#include "../../render/objects/shaders/shaderpack.h"
+#include "../../utils/job_system.h"
 
 namespace nova {
     /*!
@@ -35,9 +37,14 @@ namespace nova {
      *
      * \param shaderpack_name The name of the shaderpack to load the shaders from
      * \param shader_names The list of names of shaders to load
+     * \param program_cache Where to look for compiled programs before compiling them. Nothing is cached if this is
+     * nullptr
+     * \param jobs The job system to load the shader files on. The files are loaded one after another if this is
+     * nullptr
      * \return A map from shader name to shader source
      */
-    shaderpack load_sources_from_folder(const std::string &shaderpack_name, const std::vector<std::string> &shader_names);
+    shaderpack load_sources_from_folder(const std::string &shaderpack_name, const std::vector<std::string> &shader_names,
+                                        program_binary_cache* program_cache = nullptr, job_system* jobs = nullptr);
 
     /*!
      * \brief Tries to load a single shader file from a folder
@@ -50,16 +57,16 @@ namespace nova {
      * \param extensions A list of extensions to try
      * \return The full source of the shader file
      */
-    std::vector<shader_line> load_shader_file(const std::string &shader_path, const std::vector<std::string> &extensions);
+    shader_source load_shader_file(const std::string &shader_path, const std::vector<std::string> &extensions);
 
     /*!
      * \brief Loads the shader file from the provided istream
      *
      * \param stream The istream to load the shader file from
      * \param shader_path The path to the shader file (useful mostly for includes)
-     * \return A list of shader_line objects
+     * \return The shader's source
      */
-    std::vector<shader_line> read_shader_stream(std::istream &stream, const std::string &shader_path);
+    shader_source read_shader_stream(std::istream &stream, const std::string &shader_path);
 
     /*!
      * \brief Loads a file that was requested through a #include statement
@@ -71,7 +78,24 @@ namespace nova {
      * \param line The line in the shader that contains the #include statement
      * \return The full source of the included file
      */
-    std::vector<shader_line> load_included_file(const std::string &shader_path, const std::string &line);
+    shader_source load_included_file(const std::string &shader_path, const std::string &line);
+
+    /*!
+     * \brief True if the include file is one that Nova makes instead of reading from disk
+     *
+     * Files under /nova/ don't exist on disk. Nova makes them, so that shaders can use Nova's uniform blocks without
+     * writing them out by hand
+     */
+    bool is_nova_include(const std::string &included_file_name);
+
+    /*!
+     * \brief Makes the lines of one of the include files under /nova/
+     *
+     * \param included_file_name The name of the include file, like "/nova/per_frame_uniforms.glsl"
+     * \return The lines of the file
+     * \throws std::runtime_error if Nova doesn't make a file with that name
+     */
+    shader_source load_nova_include(const std::string &included_file_name);
 
     /*!
      * \brief Determines the full file path of an included file
@@ -4,6 +4,8 @@
  */
 
 #include "shader_source_structs.h"
+#include <algorithm>
+#include <limits>
 #include <easylogging++.h>
 
 namespace nova {
@@ -20,11 +22,110 @@ namespace nova {
         }
     }
 
-    el::base::Writer& operator<<(el::base::Writer& out, const std::vector<shader_line>& lines) {
-        for(const auto& line : lines) {
-            out << line;
+    uint32_t shader_source::add_file(const std::string& file_name) {
+        // A shader only has a handful of files, so looking through them all is fine
+        auto file_itr = std::find(file_names.begin(), file_names.end(), file_name);
+        if(file_itr != file_names.end()) {
+            return static_cast<uint32_t>(file_itr - file_names.begin());
         }
 
+        file_names.push_back(file_name);
+        return static_cast<uint32_t>(file_names.size() - 1);
+    }
+
+    void shader_source::add_line(uint32_t file_id, uint32_t line_num, const char* line, size_t length) {
+        lines.push_back({file_id, line_num, static_cast<uint32_t>(text.size())});
+        text.append(line, length);
+        text.push_back('\n');
+    }
+
+    void shader_source::add_line(uint32_t file_id, uint32_t line_num, const std::string& line) {
+        add_line(file_id, line_num, line.data(), line.size());
+    }
+
+    void shader_source::append(const shader_source& other, size_t first_line, size_t last_line) {
+        if(first_line >= last_line) {
+            return;
+        }
+
+        auto first_char = other.lines[first_line].offset;
+        auto last_char = last_line < other.lines.size() ? other.lines[last_line].offset : other.text.size();
+        auto offset_change = static_cast<uint32_t>(text.size()) - first_char;
+
+        // Only the files that the lines actually come from get added to this shader
+        const auto no_file = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> file_ids(other.file_names.size(), no_file);
+
+        lines.reserve(lines.size() + last_line - first_line);
+        for(size_t i = first_line; i < last_line; i++) {
+            const auto& location = other.lines[i];
+            auto& file_id = file_ids[location.file_id];
+            if(file_id == no_file) {
+                file_id = add_file(other.file_names[location.file_id]);
+            }
+
+            lines.push_back({file_id, location.line_num, location.offset + offset_change});
+        }
+
+        text.append(other.text, first_char, last_char - first_char);
+    }
+
+    void shader_source::append(const shader_source& other) {
+        append(other, 0, other.size());
+    }
+
+    size_t shader_source::size() const {
+        return lines.size();
+    }
+
+    bool shader_source::empty() const {
+        return lines.empty();
+    }
+
+    shader_line shader_source::operator[](size_t index) const {
+        const auto& location = lines[index];
+        return {static_cast<int>(location.line_num), file_names[location.file_id], get_line(index)};
+    }
+
+    std::string shader_source::get_line(size_t index) const {
+        auto line_start = lines[index].offset;
+        return text.substr(line_start, get_line_end(index) - line_start);
+    }
+
+    const shader_line_location& shader_source::get_location(size_t index) const {
+        return lines[index];
+    }
+
+    const std::string& shader_source::get_file_name(uint32_t file_id) const {
+        return file_names[file_id];
+    }
+
+    const std::string& shader_source::get_text() const {
+        return text;
+    }
+
+    size_t shader_source::get_line_end(size_t index) const {
+        auto next_line_start = index + 1 < lines.size() ? lines[index + 1].offset : text.size();
+        return next_line_start - 1;
+    }
+
+    el::base::Writer& operator<<(el::base::Writer& out, const shader_source& source) {
+        // Written straight from the text and the line map into one string, instead of making a shader_line for every
+        // line
+        std::string listing;
+        listing.reserve(source.text.size() + source.lines.size() * 32);
+        for(size_t i = 0; i < source.lines.size(); i++) {
+            const auto& location = source.lines[i];
+            listing += '\t';
+            listing += std::to_string(location.line_num);
+            listing += '(';
+            listing += source.file_names[location.file_id];
+            listing += ") ";
+            listing.append(source.text, location.offset, source.get_line_end(i) - location.offset);
+            listing += '\n';
+        }
+
+        out << listing;
         return out;
     }
 
@@ -8,6 +8,7 @@
 #ifndef RENDERER_SHADER_SOURCE_STRUCTS_H
 #define RENDERER_SHADER_SOURCE_STRUCTS_H
 
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <vector>
@@ -33,6 +34,100 @@ namespace nova {
         std::string line;           //!< The actual line
     };
 
+    /*!
+     * \brief Where a line of a shader came from, and where it is in the shader's text
+     */
+    struct shader_line_location {
+        uint32_t file_id;           //!< Which of the shader's files the line came from
+        uint32_t line_num;          //!< The line number in that file
+        uint32_t offset;            //!< Where the line starts in the shader's text
+    };
+
+    /*!
+     * \brief The source of one shader stage, with everything it includes put in
+     *
+     * All the lines are kept in one string, which is exactly what gets sent to the driver, so a shader is a handful
+     * of allocations no matter how many lines it has. Each line also gets a shader_line_location so errors from the
+     * driver can be traced back to the file on disk. File names are only stored once per shader, not once per line
+     */
+    class shader_source {
+    public:
+        /*!
+         * \brief Gets the ID of a file, so lines from it can be added
+         *
+         * \param file_name The name of the file. If this shader doesn't have any lines from it yet, it gets a new ID
+         * \return The ID of the file
+         */
+        uint32_t add_file(const std::string& file_name);
+
+        /*!
+         * \brief Adds a line to the end of this shader
+         *
+         * \param file_id The ID of the file the line came from, from #add_file
+         * \param line_num The line number in that file
+         * \param line The first character of the line
+         * \param length How many characters are in the line, not counting the newline
+         */
+        void add_line(uint32_t file_id, uint32_t line_num, const char* line, size_t length);
+
+        void add_line(uint32_t file_id, uint32_t line_num, const std::string& line);
+
+        /*!
+         * \brief Adds some of the lines of another shader to the end of this one
+         *
+         * The text is copied in one go, and the file IDs are changed to this shader's
+         *
+         * \param other The shader to take the lines from
+         * \param first_line The index of the first line to add
+         * \param last_line One past the index of the last line to add
+         */
+        void append(const shader_source& other, size_t first_line, size_t last_line);
+
+        void append(const shader_source& other);
+
+        /*!
+         * \brief How many lines this shader has
+         */
+        size_t size() const;
+
+        bool empty() const;
+
+        /*!
+         * \brief Makes a shader_line for the line at the given index
+         *
+         * This copies the line and the file name, so it's meant for error messages and the like
+         */
+        shader_line operator[](size_t index) const;
+
+        /*!
+         * \brief Gets the text of the line at the given index, without its newline
+         */
+        std::string get_line(size_t index) const;
+
+        const shader_line_location& get_location(size_t index) const;
+
+        const std::string& get_file_name(uint32_t file_id) const;
+
+        /*!
+         * \brief The whole shader, with a newline after every line
+         */
+        const std::string& get_text() const;
+
+        friend el::base::Writer& operator<<(el::base::Writer& out, const shader_source& source);
+
+    private:
+        std::string text;
+
+        std::vector<shader_line_location> lines;
+
+        std::vector<std::string> file_names;
+
+        /*!
+         * \brief Where the line at the given index ends in the text, not counting its newline
+         */
+        size_t get_line_end(size_t index) const;
+    };
+
     /*!
      * \brief Represents a shader before it goes to the GPU
      */
@@ -43,8 +138,8 @@ namespace nova {
 
         optional<std::shared_ptr<shader_definition>> fallback_def;
 
-        std::vector<shader_line> vertex_source;
-        std::vector<shader_line> fragment_source;
+        shader_source vertex_source;
+        shader_source fragment_source;
         // TODO: Figure out how to handle geometry and tessellation shaders
 
         /*!
@@ -55,7 +150,7 @@ namespace nova {
         shader_definition(nlohmann::json &json);
     };
 
-    el::base::Writer& operator<<(el::base::Writer& out, const std::vector<shader_line>& lines);
+    el::base::Writer& operator<<(el::base::Writer& out, const shader_source& source);
 
     el::base::Writer& operator<<(el::base::Writer& out, const shader_line& line);
 }
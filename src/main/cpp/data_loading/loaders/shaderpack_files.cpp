@@ -0,0 +1,181 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <easylogging++.h>
+#include "shaderpack_files.h"
+#include "shader_loading.h"
+#include "../../utils/mapped_file.h"
+#include "../../utils/utils.h"
+
+namespace nova {
+    /*!
+     * \brief The key a file is stored under. Windows doesn't care about the case of file names, so shaderpacks made
+     * there don't always match the case of their files; on Windows the keys ignore case like opening the file would
+     */
+    std::string get_file_key(const std::string& normalized_path) {
+#ifdef _WIN32
+        std::string key = normalized_path;
+        std::transform(key.begin(), key.end(), key.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+        return key;
+#else
+        return normalized_path;
+#endif
+    }
+
+    shaderpack_files::shaderpack_files(const std::string& shaders_directory) : shaders_directory(shaders_directory) {
+        for(const auto& path : list_files(shaders_directory)) {
+            files.emplace(get_file_key(normalize_path(path)), std::make_unique<source_file>());
+        }
+
+        LOG(DEBUG) << "Found " << files.size() << " files in " << shaders_directory;
+    }
+
+    optional<std::string> shaderpack_files::find_shader(const std::string& shader_path, const std::vector<std::string>& extensions) const {
+        for(const auto& extension : extensions) {
+            auto full_shader_path = shader_path + extension;
+            if(files.find(get_file_key(normalize_path(full_shader_path))) != files.end()) {
+                return full_shader_path;
+            }
+        }
+
+        return {};
+    }
+
+    shader_source shaderpack_files::load_shader(const std::string& shader_path) {
+        shader_source shader;
+        std::vector<std::string> include_stack;
+        append_file(normalize_path(shader_path), shader, include_stack);
+        return shader;
+    }
+
+    size_t shaderpack_files::get_num_files() const {
+        return files.size();
+    }
+
+    size_t shaderpack_files::get_num_files_read() const {
+        std::lock_guard<std::mutex> lock(num_files_read_lock);
+        return num_files_read;
+    }
+
+    shaderpack_files::source_file& shaderpack_files::get_file(const std::string& path) {
+        auto file_itr = files.find(get_file_key(path));
+        if(file_itr == files.end()) {
+            throw resource_not_found(path);
+        }
+
+        auto& file = *file_itr->second;
+
+        // read_file doesn't throw, so a file that can't be read isn't tried again by every shader that includes it
+        std::call_once(file.read_flag, [&]() { read_file(path, file); });
+        if(file.error) {
+            std::rethrow_exception(file.error);
+        }
+
+        return file;
+    }
+
+    void shaderpack_files::read_file(const std::string& path, source_file& file) {
+        try {
+            mapped_file contents(path);
+            auto text = reinterpret_cast<const char*>(contents.get_data());
+            auto text_end = text + contents.get_size();
+
+            // Split the same way std::getline does, so a file that ends with a newline doesn't get an empty last line
+            const std::string include_directive = "#include";
+            auto file_id = file.source.add_file(path);
+            uint32_t line_counter = 1;
+            while(text != text_end) {
+                auto line_end = std::find(text, text_end, '\n');
+                auto line_length = static_cast<size_t>(line_end - text);
+
+                // Files with Windows line endings keep their \r out of the lines, like a text mode stream would
+                if(line_length > 0 && text[line_length - 1] == '\r') {
+                    line_length--;
+                }
+
+                if(line_length >= include_directive.size() && std::equal(include_directive.begin(), include_directive.end(), text)) {
+                    file.includes.emplace_back(file.source.size(), get_filename_from_include(std::string(text, line_length)));
+                }
+                file.source.add_line(file_id, line_counter, text, line_length);
+
+                line_counter++;
+                text = line_end == text_end ? text_end : line_end + 1;
+            }
+
+        } catch(...) {
+            file.error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(num_files_read_lock);
+        num_files_read++;
+    }
+
+    void shaderpack_files::append_file(const std::string& path, shader_source& shader, std::vector<std::string>& include_stack) {
+        if(std::find(include_stack.begin(), include_stack.end(), path) != include_stack.end()) {
+            throw std::runtime_error("File " + path + " includes itself");
+        }
+
+        const auto& file = get_file(path);
+        include_stack.push_back(path);
+
+        size_t next_line = 0;
+        for(const auto& include : file.includes) {
+            shader.append(file.source, next_line, include.first);
+            next_line = include.first + 1;
+
+            if(is_nova_include(include.second)) {
+                shader.append(load_nova_include(include.second));
+                continue;
+            }
+
+            auto included_path = get_included_path(path, include.second);
+            LOG(TRACE) << "Dealing with included file " << included_path;
+            try {
+                append_file(included_path, shader, include_stack);
+            } catch(resource_not_found& e) {
+                throw std::runtime_error("Could not load included file " + included_path);
+            }
+        }
+        shader.append(file.source, next_line, file.source.size());
+
+        include_stack.pop_back();
+    }
+
+    std::string shaderpack_files::get_included_path(const std::string& including_path, const std::string& included_file_name) const {
+        if(included_file_name[0] == '/') {
+            // This is an absolute include and it should be relative to the shaders folder
+            return normalize_path(shaders_directory + included_file_name);
+        }
+
+        auto slash_pos = including_path.find_last_of('/');
+        return normalize_path(including_path.substr(0, slash_pos + 1) + included_file_name);
+    }
+
+    std::string normalize_path(const std::string& path) {
+        std::vector<std::string> parts;
+        for(const auto& part : split(path, '/')) {
+            if(part.empty() || part == ".") {
+                continue;
+            }
+
+            if(part == ".." && !parts.empty() && parts.back() != "..") {
+                parts.pop_back();
+            } else {
+                parts.push_back(part);
+            }
+        }
+
+        std::string normalized = path.size() > 0 && path[0] == '/' ? "/" : "";
+        for(size_t i = 0; i < parts.size(); i++) {
+            if(i > 0) {
+                normalized += "/";
+            }
+            normalized += parts[i];
+        }
+        return normalized;
+    }
+}
@@ -0,0 +1,134 @@
+/*!
+ * \brief Reads the shader files of a shaderpack, each of them only once
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_SHADERPACK_FILES_H
+#define RENDERER_SHADERPACK_FILES_H
+
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <optional.hpp>
+
+#include "shader_source_structs.h"
+
+namespace nova {
+    /*!
+     * \brief All the files in a shaderpack's shaders folder
+     *
+     * The folder is listed once, when this is made, so finding out which extension a shader has is a lookup instead
+     * of trying to open every possible file. Each file is memory mapped and split into lines the first time it's
+     * needed, and those lines are kept, so a file that's included by every shader is still only read once.
+     *
+     * Loading shaders from several threads at the same time is safe
+     */
+    class shaderpack_files {
+    public:
+        /*!
+         * \brief Lists all the files in the given directory
+         *
+         * \param shaders_directory The shaders folder of the shaderpack, like "shaderpacks/default/shaders". Includes
+         * that start with a / are found relative to it
+         */
+        explicit shaderpack_files(const std::string& shaders_directory);
+
+        shaderpack_files(const shaderpack_files& other) = delete;
+        shaderpack_files& operator=(const shaderpack_files& other) = delete;
+
+        /*!
+         * \brief Finds which of the given extensions the shader has
+         *
+         * \param shader_path The path of the shader, without an extension
+         * \param extensions The extensions to try, in order
+         * \return The path of the first file that exists, or an empty optional if none of them do
+         */
+        optional<std::string> find_shader(const std::string& shader_path, const std::vector<std::string>& extensions) const;
+
+        /*!
+         * \brief Gets the lines of a shader, with all its includes put in
+         *
+         * \param shader_path The path of the shader file, with its extension
+         * \return The lines of the shader
+         * \throws resource_not_found if the shader or something it includes isn't in the shaderpack
+         * \throws std::runtime_error if the shader includes itself, or something else goes wrong
+         */
+        shader_source load_shader(const std::string& shader_path);
+
+        /*!
+         * \brief How many files are in the shaderpack
+         */
+        size_t get_num_files() const;
+
+        /*!
+         * \brief How many of the files have been read so far
+         */
+        size_t get_num_files_read() const;
+
+    private:
+        /*!
+         * \brief One file, split into lines
+         */
+        struct source_file {
+            std::once_flag read_flag;
+
+            /*!
+             * \brief Every line of the file, #include lines too
+             */
+            shader_source source;
+
+            /*!
+             * \brief Each #include line in the file: which line it is, and the name of the file it includes
+             */
+            std::vector<std::pair<size_t, std::string>> includes;
+
+            /*!
+             * \brief What went wrong reading the file, if anything did
+             */
+            std::exception_ptr error;
+        };
+
+        std::string shaders_directory;
+
+        std::unordered_map<std::string, std::unique_ptr<source_file>> files;
+
+        mutable std::mutex num_files_read_lock;
+        size_t num_files_read = 0;
+
+        /*!
+         * \brief Reads the file the first time it's asked for, and hands back the same lines every time after
+         */
+        source_file& get_file(const std::string& path);
+
+        void read_file(const std::string& path, source_file& file);
+
+        /*!
+         * \brief Adds the lines of a file to the end of a shader, and the lines of everything it includes where its
+         * #include lines are
+         *
+         * \param include_stack The files that are being included right now, to catch files that include themselves
+         */
+        void append_file(const std::string& path, shader_source& shader, std::vector<std::string>& include_stack);
+
+        /*!
+         * \brief Works out the path of an included file
+         *
+         * \param including_path The path of the file with the #include line
+         * \param included_file_name The name in the #include line
+         */
+        std::string get_included_path(const std::string& including_path, const std::string& included_file_name) const;
+    };
+
+    /*!
+     * \brief Gets rid of any . and .. in a path, so that two paths to the same file are the same string
+     */
+    std::string normalize_path(const std::string& path);
+}
+
+#endif //RENDERER_SHADERPACK_FILES_H
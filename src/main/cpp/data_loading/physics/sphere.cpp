@@ -0,0 +1,12 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include "sphere.h"
+
+namespace nova {
+    void sphere::translate(glm::vec3 &delta) {
+        center += delta;
+    }
+}
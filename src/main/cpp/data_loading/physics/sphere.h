@@ -0,0 +1,25 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_SPHERE_H
+#define RENDERER_SPHERE_H
+
+#include <glm/glm.hpp>
+
+namespace nova {
+    /*!
+     * \brief Represents a bounding sphere
+     *
+     * Cheaper to test than an AABB, so it's a good first check before testing something's AABB
+     */
+    struct sphere {
+        glm::vec3 center;   //!< The center of this sphere
+        float radius;       //!< How far from the center this sphere reaches
+
+        void translate(glm::vec3 &delta);
+    };
+}
+
+#endif //RENDERER_SPHERE_H
@@ -0,0 +1,75 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "vertex_bounds.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define NOVA_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace nova {
+    vertex_bounds compute_vertex_bounds(const float* vertex_data, size_t num_vertices, size_t vertex_stride) {
+        vertex_bounds bounds = {};
+        if(num_vertices == 0) {
+            return bounds;
+        }
+
+        glm::vec3 min_pos;
+        glm::vec3 max_pos;
+
+#ifdef NOVA_USE_SSE
+        // Each vertex is loaded as (x, y, z, whatever comes next), so the fourth lane is garbage and ignored. The
+        // last vertex is loaded without reading past its position, since there might not be anything after it
+        const float* last_vertex = vertex_data + (num_vertices - 1) * vertex_stride;
+        __m128 last_pos = _mm_setr_ps(last_vertex[0], last_vertex[1], last_vertex[2], 0);
+        __m128 min_lanes = last_pos;
+        __m128 max_lanes = last_pos;
+
+        for(size_t i = 0; i + 1 < num_vertices; i++) {
+            __m128 pos = _mm_loadu_ps(vertex_data + i * vertex_stride);
+            min_lanes = _mm_min_ps(min_lanes, pos);
+            max_lanes = _mm_max_ps(max_lanes, pos);
+        }
+
+        float min_array[4];
+        float max_array[4];
+        _mm_storeu_ps(min_array, min_lanes);
+        _mm_storeu_ps(max_array, max_lanes);
+        min_pos = {min_array[0], min_array[1], min_array[2]};
+        max_pos = {max_array[0], max_array[1], max_array[2]};
+#else
+        min_pos = {vertex_data[0], vertex_data[1], vertex_data[2]};
+        max_pos = min_pos;
+        for(size_t i = 1; i < num_vertices; i++) {
+            const float* pos = vertex_data + i * vertex_stride;
+            min_pos = {std::min(min_pos.x, pos[0]), std::min(min_pos.y, pos[1]), std::min(min_pos.z, pos[2])};
+            max_pos = {std::max(max_pos.x, pos[0]), std::max(max_pos.y, pos[1]), std::max(max_pos.z, pos[2])};
+        }
+#endif
+
+        bounds.bounding_box.center = (min_pos + max_pos) * 0.5f;
+        bounds.bounding_box.extents = (max_pos - min_pos) * 0.5f;
+
+        // The sphere is centered on the box, but its radius comes from the vertices themselves. That's tighter than
+        // using the corner of the box whenever the box has empty corners, which chunk meshes usually do
+        const glm::vec3& center = bounds.bounding_box.center;
+        float max_distance_squared = 0;
+        for(size_t i = 0; i < num_vertices; i++) {
+            const float* pos = vertex_data + i * vertex_stride;
+            float dx = pos[0] - center.x;
+            float dy = pos[1] - center.y;
+            float dz = pos[2] - center.z;
+            max_distance_squared = std::max(max_distance_squared, dx * dx + dy * dy + dz * dz);
+        }
+
+        bounds.bounding_sphere.center = center;
+        bounds.bounding_sphere.radius = std::sqrt(max_distance_squared);
+
+        return bounds;
+    }
+}
@@ -0,0 +1,39 @@
+/*!
+ * \brief Functions to compute bounding volumes from raw vertex data
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_VERTEX_BOUNDS_H
+#define RENDERER_VERTEX_BOUNDS_H
+
+#include <cstddef>
+#include "aabb.h"
+#include "sphere.h"
+
+namespace nova {
+    /*!
+     * \brief The bounding volumes of a set of vertices
+     */
+    struct vertex_bounds {
+        aabb bounding_box;
+        sphere bounding_sphere;
+    };
+
+    /*!
+     * \brief Computes a tight AABB and bounding sphere around some interleaved vertices
+     *
+     * The position of each vertex must be the first three floats of the vertex. The min/max pass uses SSE when it's
+     * available, so this is cheap enough to run on every mesh we receive
+     *
+     * \param vertex_data The interleaved vertex data
+     * \param num_vertices The number of vertices in vertex_data
+     * \param vertex_stride The number of floats from the start of one vertex to the start of the next
+     * \return The bounding volumes of the vertices. If there are no vertices, both volumes are at the origin and have
+     * a size of 0
+     */
+    vertex_bounds compute_vertex_bounds(const float* vertex_data, size_t num_vertices, size_t vertex_stride);
+}
+
+#endif //RENDERER_VERTEX_BOUNDS_H
@@ -6,9 +6,62 @@
 #include "settings.h"
 #include "../utils/utils.h"
 
+#include <algorithm>
 #include <easylogging++.h>
 
 namespace nova {
+    /*!
+     * \brief Lets a setting be read and written by the name it has in the config file
+     */
+    struct setting_info {
+        const char* name;
+
+        /*!
+         * \brief Sets the setting from a JSON value, converting the value to the setting's type. Throws if it can't be
+         * converted
+         */
+        void (*set_from_json)(settings& settings, const nlohmann::json& value);
+        void (*set_to_default)(settings& settings);
+    };
+
+    template<setting Key>
+    setting_info make_setting_info() {
+        using type = typename setting_traits<Key>::type;
+        return {
+                setting_traits<Key>::name(),
+                [](settings& settings, const nlohmann::json& value) { settings.set<Key>(value.get<type>()); },
+                [](settings& settings) { settings.set<Key>(setting_traits<Key>::default_value()); }
+        };
+    }
+
+    /*!
+     * \brief Info about each setting, in the same order as the setting enum
+     */
+    static const std::array<setting_info, NUM_SETTINGS>& get_setting_infos() {
+        static const std::array<setting_info, NUM_SETTINGS> infos = {{
+                make_setting_info<setting::loaded_shaderpack>(),
+                make_setting_info<setting::view_width>(),
+                make_setting_info<setting::view_height>(),
+                make_setting_info<setting::scalefactor>(),
+                make_setting_info<setting::shadow_map_resolution>(),
+                make_setting_info<setting::translucent_resort_distance>(),
+                make_setting_info<setting::translucent_sorts_per_frame>(),
+                make_setting_info<setting::texture_compression>(),
+                make_setting_info<setting::texture_compression_quality>(),
+                make_setting_info<setting::frames_in_flight>()
+        }};
+        return infos;
+    }
+
+    static const setting_info* find_setting_info(const std::string& name) {
+        for(const auto& info : get_setting_infos()) {
+            if(name == info.name) {
+                return &info;
+            }
+        }
+        return nullptr;
+    }
+
     settings::settings(std::string filename) {
         LOG(INFO) << "Loading config from " << filename;
 
@@ -16,6 +69,17 @@ namespace nova {
 		if(config_file.is_open()) {
 			options = load_json_from_stream(config_file);
 		}
+
+        // Nobody's subscribed yet, so this just fills in the typed settings
+        begin_transaction();
+        for(const auto& info : get_setting_infos()) {
+            info.set_to_default(*this);
+        }
+        auto json_settings = options["settings"];
+        for(auto itr = json_settings.begin(); itr != json_settings.end(); ++itr) {
+            set(itr.key(), itr.value());
+        }
+        commit_transaction();
     }
 
     void settings::register_change_listener(iconfig_listener *new_listener) {
@@ -26,11 +90,67 @@ namespace nova {
         return options;
     }
 
-    void settings::update_config_changed() {
-        for(iconfig_listener *l : config_change_listeners) {
-            l->on_config_change(options["settings"]);
+    void settings::set(const std::string& name, const nlohmann::json& value) {
+        std::lock_guard<std::recursive_mutex> lock(change_mutex);
+
+        auto info = find_setting_info(name);
+        if(info == nullptr) {
+            options["settings"][name] = value;
+            return;
+        }
+
+        try {
+            info->set_from_json(*this, value);
+
+        } catch(std::exception& e) {
+            LOG(WARNING) << "Can't set setting " << name << " to " << value << ": " << e.what();
+        }
+    }
+
+    void settings::begin_transaction() {
+        // The lock is held for the whole transaction, so nobody else sees half of it
+        change_mutex.lock();
+        transaction_depth++;
+    }
+
+    void settings::commit_transaction() {
+        if(transaction_depth == 0) {
+            LOG(WARNING) << "Committing a settings transaction that was never started";
+            return;
+        }
+
+        transaction_depth--;
+        if(transaction_depth == 0) {
+            notify_subscribers();
         }
-        LOG(DEBUG) << "Finished updating listeners";
+        change_mutex.unlock();
+    }
+
+    settings::subscription_id settings::subscribe(std::initializer_list<setting> keys, std::function<void()> callback) {
+        std::lock_guard<std::recursive_mutex> lock(change_mutex);
+
+        subscription new_subscription = {next_subscription_id++, {}, std::move(callback)};
+        for(auto key : keys) {
+            new_subscription.keys.set(static_cast<size_t>(key));
+        }
+
+        subscriptions.push_back(std::move(new_subscription));
+        return subscriptions.back().id;
+    }
+
+    void settings::unsubscribe(subscription_id id) {
+        std::lock_guard<std::recursive_mutex> lock(change_mutex);
+
+        subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(),
+                                           [id](const subscription& sub) { return sub.id == id; }),
+                            subscriptions.end());
+    }
+
+    void settings::notify_all_subscribers() {
+        std::lock_guard<std::recursive_mutex> lock(change_mutex);
+
+        changed_settings.set();
+        notify_subscribers();
     }
 
     void settings::update_config_loaded() {
@@ -38,4 +158,44 @@ namespace nova {
             l->on_config_loaded(options["readOnly"]);
         }
     }
+
+    void settings::notify_subscribers() {
+        // Subscribers might change settings themselves, which starts a new round of notifications
+        auto changed = changed_settings;
+        changed_settings.reset();
+        if(changed.none()) {
+            return;
+        }
+
+        publish_snapshot();
+
+        // Copy the callbacks so that subscribing or unsubscribing from a callback is safe
+        std::vector<std::function<void()>> callbacks;
+        for(const auto& sub : subscriptions) {
+            if((sub.keys & changed).any()) {
+                callbacks.push_back(sub.callback);
+            }
+        }
+
+        for(auto& callback : callbacks) {
+            callback();
+        }
+        LOG(DEBUG) << "Told " << callbacks.size() << " subscribers about " << changed.count() << " changed settings";
+    }
+
+    const settings_snapshot& settings::get_snapshot() {
+        return snapshots.read();
+    }
+
+    void settings::publish_snapshot() {
+        auto& snapshot = snapshots.get_write_buffer();
+        snapshot.view_width = get<setting::view_width>();
+        snapshot.view_height = get<setting::view_height>();
+        snapshot.scalefactor = get<setting::scalefactor>();
+        snapshot.shadow_map_resolution = get<setting::shadow_map_resolution>();
+        snapshot.translucent_resort_distance = get<setting::translucent_resort_distance>();
+        snapshot.translucent_sorts_per_frame = get<setting::translucent_sorts_per_frame>();
+        snapshot.frames_in_flight = get<setting::frames_in_flight>();
+        snapshots.publish();
+    }
 }
@@ -6,42 +6,98 @@
 #ifndef RENDERER_CONFIG_H
 #define RENDERER_CONFIG_H
 
+#include <array>
+#include <bitset>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <json.hpp>
+#include "../utils/triple_buffer.h"
 
 
 namespace nova {
     /*!
-     * \brief Anything which inherits from this class wants to know about the configuration and any changes to it
+     * \brief Every setting that Nova knows about. Each one has a setting_traits specialization that says what type it
+     * is and what it's called in the config file
+     */
+    enum class setting {
+        loaded_shaderpack,
+        view_width,
+        view_height,
+        scalefactor,
+        shadow_map_resolution,
+        translucent_resort_distance,
+        translucent_sorts_per_frame,
+        texture_compression,
+        texture_compression_quality,
+        frames_in_flight,
+
+        count
+    };
+
+    const size_t NUM_SETTINGS = static_cast<size_t>(setting::count);
+
+    /*!
+     * \brief Says what type a setting is, what it's called in the config file, and what it is when the config file
+     * doesn't have it
+     */
+    template<setting Key>
+    struct setting_traits;
+
+#define NOVA_SETTING(key, value_type, json_name, default_val)                   \
+    template<>                                                                  \
+    struct setting_traits<setting::key> {                                       \
+        using type = value_type;                                                \
+        static const char* name() { return json_name; }                         \
+        static type default_value() { return default_val; }                     \
+    };
+
+    NOVA_SETTING(loaded_shaderpack,             std::string,    "loadedShaderpack",             "default")
+    NOVA_SETTING(view_width,                    int,            "viewWidth",                    854)
+    NOVA_SETTING(view_height,                   int,            "viewHeight",                   480)
+    NOVA_SETTING(scalefactor,                   float,          "scalefactor",                  4.0f)
+    NOVA_SETTING(shadow_map_resolution,         int,            "shadowMapResolution",          1024)
+    NOVA_SETTING(translucent_resort_distance,   float,          "translucentResortDistance",    1.0f)
+    NOVA_SETTING(translucent_sorts_per_frame,   int,            "translucentSortsPerFrame",     16)
+    NOVA_SETTING(texture_compression,           std::string,    "textureCompression",           "none")
+    NOVA_SETTING(texture_compression_quality,   std::string,    "textureCompressionQuality",    "normal")
+    NOVA_SETTING(frames_in_flight,              int,            "framesInFlight",               2)
+
+#undef NOVA_SETTING
+
+    /*!
+     * \brief A copy of the settings that get read every frame, so the render thread can read them without locking
+     */
+    struct settings_snapshot {
+        int view_width;
+        int view_height;
+        float scalefactor;
+        int shadow_map_resolution;
+        float translucent_resort_distance;
+        int translucent_sorts_per_frame;
+        int frames_in_flight;
+    };
+
+    /*!
+     * \brief Anything which inherits from this class wants to know about the configuration when it's loaded
+     *
+     * To hear about changes to the settings, subscribe to the specific settings you care about with
+     * settings#subscribe
      */
     class iconfig_listener {
     public:
-        /*!
-         * \brief Tells the listeners that there has been a change in the configuration
-         *
-         * This method is called throughout Nova's lifetime whenever a configuration value changes. This method should
-         * handle changing configuration values such as the size of the window and what shaderpack the user has loaded
-         *
-         * Note that this method only recieves the read-write config values (the 'settings' node)
-         *
-         * \param new_config The updated configuration
-         */
-        virtual void on_config_change(nlohmann::json &new_config) = 0;
-
         /*!
          * \brief Tells listeners that the configuration has been loaded
          *
-         * When Nova starts up, this method is called on all config listeners, then on_config_change is called.
-         * on_config_change should be used to listen for any config values that change throughout the program's life, so
-         * then this method should be used for any initial configuration whose values will not change throughout the
-         * program's lifetime. An example of this is reading in the bind points of the UBOs: the bind points won't change
-         * throughout the program's life, so they should be handled in this function
-         *
-         * We may want to consider two config files: one for read-only values and one for read-write values. Probably a
-         * good idea, but I don't feel like implimenting that just yet
+         * When Nova starts up, this method is called on all config listeners, then all the settings subscriptions are
+         * called. Subscriptions should be used to listen for any config values that change throughout the program's
+         * life, so then this method should be used for any initial configuration whose values will not change
+         * throughout the program's lifetime. An example of this is reading in the bind points of the UBOs: the bind
+         * points won't change throughout the program's life, so they should be handled in this function
          *
-         * \param config The configuration that was loaded
+         * \param config The read-only configuration that was loaded
          */
         virtual void on_config_loaded(nlohmann::json &config) = 0;
     };
@@ -49,11 +105,21 @@ namespace nova {
     /*!
      * \brief Holds the configuration of Nova
      *
-     * Stores values like the graphics settings, performance settings, any settings shaderpacks define, etc. Uses a JSON
-     * document as the data model
+     * Stores values like the graphics settings, performance settings, any settings shaderpacks define, etc. Every
+     * setting in the setting enum is stored as its real type, so reading one doesn't go through JSON. Settings Nova
+     * doesn't know about (and the read-only config) stay in a JSON document, which also mirrors the typed settings
+     *
+     * Changing a setting to the value it already has does nothing. Subscribers are only told about settings that really
+     * changed, and a transaction makes a bunch of changes show up to subscribers all at once
+     *
+     * Settings can be changed from any thread. Changes are serialized, and subscribers are called on the thread that
+     * made the change. The render thread shouldn't use #get, since a change could happen in the middle of reading;
+     * it should read the settings it needs from #get_snapshot instead
      */
     class settings {
     public:
+        using subscription_id = size_t;
+
         /*!
          * \brief Constructs this config from the given JSON document
          *
@@ -62,31 +128,162 @@ namespace nova {
         settings(std::string filename);
 
         /*!
-         * \brief Registers the given iconfig_change_listener as an Observer
+         * \brief Registers the given iconfig_listener to hear about when the config is loaded
          */
         void register_change_listener(iconfig_listener *new_listener);
 
+        /*!
+         * \brief Returns the JSON version of the config. Only read from it; changes to the 'settings' node won't reach
+         * the typed settings
+         */
         nlohmann::json &get_options();
 
         /*!
-         * \brief Updates all the change listeners with the current state of the settings
+         * \brief Returns the current value of a setting. Not safe to call while another thread might be changing
+         * settings, except from a subscription
+         */
+        template<setting Key>
+        const typename setting_traits<Key>::type& get() const {
+            return values<typename setting_traits<Key>::type>()[static_cast<size_t>(Key)];
+        }
+
+        /*!
+         * \brief Changes a setting. If there's no transaction open, subscribers hear about it right away
+         */
+        template<setting Key>
+        void set(const typename setting_traits<Key>::type& value) {
+            std::lock_guard<std::recursive_mutex> lock(change_mutex);
+
+            auto& current_value = values<typename setting_traits<Key>::type>()[static_cast<size_t>(Key)];
+            if(current_value == value) {
+                return;
+            }
+
+            current_value = value;
+            options["settings"][setting_traits<Key>::name()] = value;
+            changed_settings.set(static_cast<size_t>(Key));
+
+            if(transaction_depth == 0) {
+                notify_subscribers();
+            }
+        }
+
+        /*!
+         * \brief Changes a setting by the name it has in the config file
          *
-         * This method is public so that whatever changes values can delay calling it. You can set a bunch of options that
-         * are pretty computationally intensive to change, the update listeners after all the values are changed
+         * This is how the settings from Minecraft get in. If the setting isn't one that Nova knows about, it just goes
+         * into the JSON document
          *
-         * Note that this method only send the read-write config values (children of the node 'settings') to the listeners
+         * \param name The name of the setting in the config file, like "viewWidth"
+         * \param value The new value. It's converted to the setting's type
          */
-        void update_config_changed();
+        void set(const std::string& name, const nlohmann::json& value);
+
+        /*!
+         * \brief Starts a transaction. Nothing is sent to subscribers until the matching #commit_transaction
+         *
+         * Transactions can be nested. Subscribers only hear about the changes when the outermost one is committed
+         */
+        void begin_transaction();
+
+        /*!
+         * \brief Ends a transaction, and tells every subscriber whose settings changed during it about the changes
+         */
+        void commit_transaction();
+
+        /*!
+         * \brief Calls a function whenever any of the given settings change
+         *
+         * The function is called at most once for each change or transaction, no matter how many of the settings
+         * changed. Read the new values with #get
+         *
+         * \return An ID to pass to #unsubscribe
+         */
+        subscription_id subscribe(std::initializer_list<setting> keys, std::function<void()> callback);
+
+        /*!
+         * \brief Calls a function with the new value of a setting whenever it changes
+         */
+        template<setting Key>
+        subscription_id subscribe(std::function<void(const typename setting_traits<Key>::type&)> callback) {
+            return subscribe({Key}, [this, callback]() { callback(get<Key>()); });
+        }
+
+        void unsubscribe(subscription_id id);
+
+        /*!
+         * \brief Calls every subscription once, like all the settings just changed, so subscribers can set themselves
+         * up from the starting values
+         */
+        void notify_all_subscribers();
 
         /*!
          * \brief Tells all the config listeners that the configuration has been loaded for the first time
          */
         void update_config_loaded();
 
+        /*!
+         * \brief Returns the settings as of the last change or transaction
+         *
+         * Only one thread may call this - the render thread. The snapshot never changes while it's being read, and
+         * stays valid until the next call
+         */
+        const settings_snapshot& get_snapshot();
+
     private:
+        struct subscription {
+            subscription_id id;
+            std::bitset<NUM_SETTINGS> keys;
+            std::function<void()> callback;
+        };
+
         nlohmann::json options;
         std::vector<iconfig_listener *> config_change_listeners;
+
+        std::array<int, NUM_SETTINGS> int_values = {};
+        std::array<float, NUM_SETTINGS> float_values = {};
+        std::array<std::string, NUM_SETTINGS> string_values;
+
+        std::vector<subscription> subscriptions;
+        subscription_id next_subscription_id = 0;
+
+        std::bitset<NUM_SETTINGS> changed_settings;
+        size_t transaction_depth = 0;
+
+        /*!
+         * \brief Held while settings change or subscribers are called. Recursive so subscribers can change settings
+         */
+        std::recursive_mutex change_mutex;
+
+        triple_buffer<settings_snapshot> snapshots;
+
+        void publish_snapshot();
+
+        template<typename T>
+        std::array<T, NUM_SETTINGS>& values();
+
+        template<typename T>
+        const std::array<T, NUM_SETTINGS>& values() const {
+            return const_cast<settings*>(this)->values<T>();
+        }
+
+        void notify_subscribers();
     };
+
+    template<>
+    inline std::array<int, NUM_SETTINGS>& settings::values<int>() {
+        return int_values;
+    }
+
+    template<>
+    inline std::array<float, NUM_SETTINGS>& settings::values<float>() {
+        return float_values;
+    }
+
+    template<>
+    inline std::array<std::string, NUM_SETTINGS>& settings::values<std::string>() {
+        return string_values;
+    }
 }
 
 #endif //RENDERER_CONFIG_H
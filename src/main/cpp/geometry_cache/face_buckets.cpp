@@ -0,0 +1,117 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <cmath>
+#include "face_buckets.h"
+
+namespace nova {
+    const size_t INDICES_PER_QUAD = 6;
+
+    /*!
+     * \brief How closely a face's normal has to line up with an axis for the face to count as pointing along that axis
+     */
+    const float AXIS_ALIGNMENT_THRESHOLD = 0.999f;
+
+    glm::vec3 get_position(const float* vertex_data, size_t vertex_stride, int index) {
+        const float* pos = vertex_data + static_cast<size_t>(index) * vertex_stride;
+        return {pos[0], pos[1], pos[2]};
+    }
+
+    face_direction classify_quad(const float* vertex_data, size_t vertex_stride, const int* quad_indices) {
+        glm::vec3 v0 = get_position(vertex_data, vertex_stride, quad_indices[0]);
+        glm::vec3 v1 = get_position(vertex_data, vertex_stride, quad_indices[1]);
+        glm::vec3 v2 = get_position(vertex_data, vertex_stride, quad_indices[2]);
+
+        // Counter-clockwise winding is front-facing, so this points out of the front of the face
+        glm::vec3 normal = glm::cross(v1 - v0, v2 - v0);
+        float length = glm::length(normal);
+        if(length == 0) {
+            return face_direction::other;
+        }
+
+        float threshold = length * AXIS_ALIGNMENT_THRESHOLD;
+        if(std::abs(normal.x) >= threshold) {
+            return normal.x > 0 ? face_direction::positive_x : face_direction::negative_x;
+        }
+        if(std::abs(normal.y) >= threshold) {
+            return normal.y > 0 ? face_direction::positive_y : face_direction::negative_y;
+        }
+        if(std::abs(normal.z) >= threshold) {
+            return normal.z > 0 ? face_direction::positive_z : face_direction::negative_z;
+        }
+
+        return face_direction::other;
+    }
+
+    face_bucket_ranges sort_indices_into_face_buckets(const float* vertex_data, size_t vertex_stride, std::vector<int>& indices) {
+        size_t num_quads = indices.size() / INDICES_PER_QUAD;
+
+        // Counting sort: classify every quad, count the quads in each bucket, then copy each quad to its bucket
+        std::vector<face_direction> quad_directions(num_quads);
+        face_bucket_ranges ranges = {};
+        for(size_t quad = 0; quad < num_quads; quad++) {
+            auto direction = classify_quad(vertex_data, vertex_stride, &indices[quad * INDICES_PER_QUAD]);
+            quad_directions[quad] = direction;
+            ranges[static_cast<size_t>(direction)].num_indices += INDICES_PER_QUAD;
+        }
+
+        size_t leftover_indices = indices.size() - num_quads * INDICES_PER_QUAD;
+        ranges[static_cast<size_t>(face_direction::other)].num_indices += leftover_indices;
+
+        uint32_t next_index = 0;
+        for(auto& range : ranges) {
+            range.first_index = next_index;
+            next_index += range.num_indices;
+        }
+
+        std::vector<int> sorted_indices(indices.size());
+        std::array<uint32_t, NUM_FACE_DIRECTIONS> write_positions;
+        for(size_t i = 0; i < NUM_FACE_DIRECTIONS; i++) {
+            write_positions[i] = ranges[i].first_index;
+        }
+
+        for(size_t quad = 0; quad < num_quads; quad++) {
+            auto& write_pos = write_positions[static_cast<size_t>(quad_directions[quad])];
+            for(size_t i = 0; i < INDICES_PER_QUAD; i++) {
+                sorted_indices[write_pos++] = indices[quad * INDICES_PER_QUAD + i];
+            }
+        }
+
+        auto& other_write_pos = write_positions[static_cast<size_t>(face_direction::other)];
+        for(size_t i = num_quads * INDICES_PER_QUAD; i < indices.size(); i++) {
+            sorted_indices[other_write_pos++] = indices[i];
+        }
+
+        indices = std::move(sorted_indices);
+        return ranges;
+    }
+
+    uint8_t get_potentially_visible_faces(const aabb& bounds, const glm::vec3& camera_position) {
+        glm::vec3 min = bounds.center - bounds.extents;
+        glm::vec3 max = bounds.center + bounds.extents;
+
+        uint8_t visible_faces = 1 << static_cast<uint8_t>(face_direction::other);
+        if(camera_position.x > min.x) {
+            visible_faces |= 1 << static_cast<uint8_t>(face_direction::positive_x);
+        }
+        if(camera_position.x < max.x) {
+            visible_faces |= 1 << static_cast<uint8_t>(face_direction::negative_x);
+        }
+        if(camera_position.y > min.y) {
+            visible_faces |= 1 << static_cast<uint8_t>(face_direction::positive_y);
+        }
+        if(camera_position.y < max.y) {
+            visible_faces |= 1 << static_cast<uint8_t>(face_direction::negative_y);
+        }
+        if(camera_position.z > min.z) {
+            visible_faces |= 1 << static_cast<uint8_t>(face_direction::positive_z);
+        }
+        if(camera_position.z < max.z) {
+            visible_faces |= 1 << static_cast<uint8_t>(face_direction::negative_z);
+        }
+
+        return visible_faces;
+    }
+}
@@ -0,0 +1,78 @@
+/*!
+ * \brief Functions to split chunk geometry up by which way each face points
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_FACE_BUCKETS_H
+#define RENDERER_FACE_BUCKETS_H
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include "../data_loading/physics/aabb.h"
+
+namespace nova {
+    /*!
+     * \brief The directions that a face in a chunk can point in
+     *
+     * Almost all block faces are axis-aligned. Anything else - torches, flowers, stairs that someone rotated with a
+     * resource pack - goes into the `other` bucket, which is always drawn
+     */
+    enum class face_direction : uint8_t {
+        positive_x,
+        negative_x,
+        positive_y,
+        negative_y,
+        positive_z,
+        negative_z,
+        other,
+    };
+
+    const size_t NUM_FACE_DIRECTIONS = 7;
+
+    /*!
+     * \brief A contiguous range of indices in an index buffer
+     */
+    struct index_range {
+        uint32_t first_index;
+        uint32_t num_indices;
+    };
+
+    /*!
+     * \brief Where each face_direction's indices live in an index buffer, indexed by face_direction
+     */
+    using face_bucket_ranges = std::array<index_range, NUM_FACE_DIRECTIONS>;
+
+    /*!
+     * \brief Reorders the indices of a quad mesh so that all the quads facing the same direction are next to each
+     * other
+     *
+     * Chunk meshes are made of quads, six indices each. The direction of each quad is found from the winding of its
+     * first triangle. Any trailing indices that don't make up a full quad go into the `other` bucket
+     *
+     * \param vertex_data The interleaved vertex data. The position of each vertex must be its first three floats
+     * \param vertex_stride The number of floats from the start of one vertex to the start of the next
+     * \param indices The indices to reorder. Must only refer to vertices in vertex_data
+     * \return Where each bucket ended up in indices
+     */
+    face_bucket_ranges sort_indices_into_face_buckets(const float* vertex_data, size_t vertex_stride, std::vector<int>& indices);
+
+    /*!
+     * \brief Works out which face directions could possibly face the camera somewhere inside the given box
+     *
+     * A face pointing in +X is only front-facing when the camera is on its +X side. Every +X face in the box is at
+     * or past the box's minimum X, so when the camera is at or before that no +X face in the box can be seen. The
+     * other directions work the same way
+     *
+     * \param bounds The world space bounds of the faces
+     * \param camera_position The world space position of the camera
+     * \return A bitmask with bit N set if the bucket for face_direction N might be visible
+     */
+    uint8_t get_potentially_visible_faces(const aabb& bounds, const glm::vec3& camera_position);
+}
+
+#endif //RENDERER_FACE_BUCKETS_H
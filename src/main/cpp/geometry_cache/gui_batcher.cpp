@@ -0,0 +1,301 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <cstring>
+#include <easylogging++.h>
+#include "gui_batcher.h"
+#include "../render/nova_renderer.h"
+#include "../utils/stats.h"
+#include "../utils/utils.h"
+
+namespace nova {
+    /*!
+     * \brief How long to wait for the GPU to finish with a frame's region of the buffers, in nanoseconds
+     */
+    const GLuint64 REGION_WAIT_TIMEOUT = 1000000000;
+
+    std::string normalize_gui_texture_name(const std::string& texture_name) {
+        const std::string prefix = "textures/";
+        const std::string extension = ".png";
+
+        size_t begin = texture_name.compare(0, prefix.size(), prefix) == 0 ? prefix.size() : 0;
+        size_t end = texture_name.size();
+        if(end - begin >= extension.size() && texture_name.compare(end - extension.size(), extension.size(), extension) == 0) {
+            end -= extension.size();
+        }
+
+        return "minecraft:" + texture_name.substr(begin, end - begin);
+    }
+
+    void append_gui_draw(std::vector<gui_draw>& draws, const std::string& atlas_name, uint32_t first_index, uint32_t num_indices) {
+        if(!draws.empty()) {
+            auto& last_draw = draws.back();
+            if(last_draw.atlas_name == atlas_name && last_draw.first_index + last_draw.num_indices == first_index) {
+                last_draw.num_indices += num_indices;
+                return;
+            }
+        }
+
+        draws.push_back({atlas_name, first_index, num_indices});
+    }
+
+    void write_gui_vertices(const mc_gui_geometry& command, const texture_manager::texture_location& location, float* destination) {
+        glm::vec2 tex_size = location.max - location.min;
+        const float* source = command.vertex_buffer;
+        auto num_floats = static_cast<size_t>(command.vertex_buffer_size);
+
+        for(size_t i = 0; i + GUI_VERTEX_SIZE <= num_floats; i += GUI_VERTEX_SIZE) {
+            destination[i + 0] = source[i + 0];
+            destination[i + 1] = source[i + 1];
+            destination[i + 2] = source[i + 2];
+            destination[i + 3] = source[i + 3] * tex_size.x + location.min.x;
+            destination[i + 4] = source[i + 4] * tex_size.y + location.min.y;
+            destination[i + 5] = source[i + 5];
+            destination[i + 6] = source[i + 6];
+            destination[i + 7] = source[i + 7];
+            destination[i + 8] = source[i + 8];
+        }
+    }
+
+    void write_gui_indices(const mc_gui_geometry& command, uint32_t first_vertex, uint32_t* destination) {
+        for(int i = 0; i < command.index_buffer_size; i++) {
+            destination[i] = first_vertex + static_cast<uint32_t>(command.index_buffer[i]);
+        }
+    }
+
+    gui_batcher::gui_batcher(size_t max_vertices_per_frame, size_t max_indices_per_frame) :
+            max_vertices_per_frame(max_vertices_per_frame), max_indices_per_frame(max_indices_per_frame) {}
+
+    gui_batcher::~gui_batcher() {
+        destroy_buffers();
+    }
+
+    void gui_batcher::begin_frame() {
+        if(!geometry_hashes.empty()) {
+            num_frames++;
+            if(!has_own_region) {
+                num_reused_frames++;
+            }
+            stats::set("gui_reuse_rate", static_cast<double>(num_reused_frames) / static_cast<double>(num_frames));
+            LOG_EVERY_N(600, DEBUG) << "The GUI reused last frame's buffers in " << num_reused_frames << " of " << num_frames << " frames";
+        }
+
+        std::swap(geometry_hashes, last_frame_geometry_hashes);
+        geometry_hashes.clear();
+
+        if(needs_bigger_buffers) {
+            destroy_buffers();
+            max_vertices_per_frame *= 2;
+            max_indices_per_frame *= 2;
+            needs_bigger_buffers = false;
+            LOG(INFO) << "Growing the GUI buffers to " << max_vertices_per_frame << " vertices and " << max_indices_per_frame << " indices per frame";
+        }
+
+        if(vertex_buffer == 0) {
+            create_buffers();
+
+            // Last frame's geometry went away with the old buffers
+            last_frame_geometry_hashes.clear();
+        }
+
+        has_own_region = false;
+        num_vertices = 0;
+        num_indices = 0;
+        draws.clear();
+    }
+
+    void gui_batcher::add_geometry(const mc_gui_geometry& command) {
+        if(vertex_buffer == 0) {
+            begin_frame();
+        }
+
+        auto command_vertices = static_cast<size_t>(command.vertex_buffer_size) / GUI_VERTEX_SIZE;
+        auto command_indices = static_cast<size_t>(command.index_buffer_size);
+        if(num_vertices + command_vertices > max_vertices_per_frame || num_indices + command_indices > max_indices_per_frame) {
+            if(!needs_bigger_buffers) {
+                LOG(WARNING) << "Too much GUI geometry for one frame, some of it won't be drawn this frame";
+            }
+            needs_bigger_buffers = true;
+            return;
+        }
+
+        const auto& texture_name = get_normalized_texture_name(command.texture_name);
+        auto location = nova_renderer::instance->get_texture_manager().get_texture_location(texture_name);
+        std::string atlas_name = command.atlas_name ? command.atlas_name : "";
+
+        auto geometry_hash = hash_geometry(command, texture_name, location);
+        size_t geometry_index = geometry_hashes.size();
+        geometry_hashes.push_back(geometry_hash);
+
+        bool same_as_last_frame = geometry_index < last_frame_geometry_hashes.size() && last_frame_geometry_hashes[geometry_index] == geometry_hash;
+        if(!has_own_region && !same_as_last_frame) {
+            move_to_new_region();
+        }
+
+        if(has_own_region) {
+            float* vertex_destination = mapped_vertices + (current_region * max_vertices_per_frame + num_vertices) * GUI_VERTEX_SIZE;
+            uint32_t* index_destination = mapped_indices + current_region * max_indices_per_frame + num_indices;
+            write_gui_vertices(command, location, vertex_destination);
+            write_gui_indices(command, static_cast<uint32_t>(num_vertices), index_destination);
+        }
+
+        append_gui_draw(draws, atlas_name, static_cast<uint32_t>(num_indices), static_cast<uint32_t>(command_indices));
+
+        num_vertices += command_vertices;
+        num_indices += command_indices;
+    }
+
+    void gui_batcher::draw(texture_manager& textures) {
+        if(draws.empty()) {
+            return;
+        }
+
+        glBindVertexArray(vertex_array);
+
+        auto base_vertex = static_cast<GLint>(current_region * max_vertices_per_frame);
+        size_t region_first_index = current_region * max_indices_per_frame;
+        for(const auto& draw : draws) {
+            if(!draw.atlas_name.empty()) {
+                textures.get_texture(draw.atlas_name).bind(0);
+            }
+
+            auto offset = reinterpret_cast<const void*>((region_first_index + draw.first_index) * sizeof(uint32_t));
+            glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(draw.num_indices), GL_UNSIGNED_INT, offset, base_vertex);
+        }
+
+        auto& fence = region_fences[current_region];
+        if(fence) {
+            // The GUI was drawn more than once this frame, the new fence covers both
+            glDeleteSync(fence);
+        }
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    const std::vector<gui_draw>& gui_batcher::get_draws() const {
+        return draws;
+    }
+
+    size_t gui_batcher::get_num_frames() const {
+        return num_frames;
+    }
+
+    size_t gui_batcher::get_num_reused_frames() const {
+        return num_reused_frames;
+    }
+
+    void gui_batcher::create_buffers() {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        auto vertex_bytes = static_cast<GLsizeiptr>(NUM_FRAME_REGIONS * max_vertices_per_frame * GUI_VERTEX_SIZE * sizeof(float));
+        auto index_bytes = static_cast<GLsizeiptr>(NUM_FRAME_REGIONS * max_indices_per_frame * sizeof(uint32_t));
+
+        glCreateBuffers(1, &vertex_buffer);
+        glNamedBufferStorage(vertex_buffer, vertex_bytes, nullptr, flags);
+        mapped_vertices = static_cast<float*>(glMapNamedBufferRange(vertex_buffer, 0, vertex_bytes, flags));
+
+        glCreateBuffers(1, &index_buffer);
+        glNamedBufferStorage(index_buffer, index_bytes, nullptr, flags);
+        mapped_indices = static_cast<uint32_t*>(glMapNamedBufferRange(index_buffer, 0, index_bytes, flags));
+
+        // Same layout as format::POS_UV_COLOR
+        glCreateVertexArrays(1, &vertex_array);
+        glVertexArrayVertexBuffer(vertex_array, 0, vertex_buffer, 0, GUI_VERTEX_SIZE * sizeof(float));
+        glVertexArrayElementBuffer(vertex_array, index_buffer);
+
+        glEnableVertexArrayAttrib(vertex_array, 0);     // Position
+        glVertexArrayAttribFormat(vertex_array, 0, 3, GL_FLOAT, GL_FALSE, 0);
+        glVertexArrayAttribBinding(vertex_array, 0, 0);
+
+        glEnableVertexArrayAttrib(vertex_array, 1);     // Texture UV
+        glVertexArrayAttribFormat(vertex_array, 1, 2, GL_FLOAT, GL_FALSE, 3 * sizeof(float));
+        glVertexArrayAttribBinding(vertex_array, 1, 0);
+
+        glEnableVertexArrayAttrib(vertex_array, 2);     // Vertex color
+        glVertexArrayAttribFormat(vertex_array, 2, 4, GL_FLOAT, GL_FALSE, 5 * sizeof(float));
+        glVertexArrayAttribBinding(vertex_array, 2, 0);
+    }
+
+    void gui_batcher::destroy_buffers() {
+        if(vertex_buffer == 0) {
+            return;
+        }
+
+        for(auto& fence : region_fences) {
+            if(fence) {
+                glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, REGION_WAIT_TIMEOUT);
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+
+        glUnmapNamedBuffer(vertex_buffer);
+        glUnmapNamedBuffer(index_buffer);
+        glDeleteBuffers(1, &vertex_buffer);
+        glDeleteBuffers(1, &index_buffer);
+        glDeleteVertexArrays(1, &vertex_array);
+
+        vertex_buffer = 0;
+        index_buffer = 0;
+        vertex_array = 0;
+        mapped_vertices = nullptr;
+        mapped_indices = nullptr;
+    }
+
+    void gui_batcher::move_to_new_region() {
+        size_t last_region = current_region;
+        current_region = (current_region + 1) % NUM_FRAME_REGIONS;
+
+        auto& fence = region_fences[current_region];
+        if(fence) {
+            // Usually long done, since this region was drawn from NUM_FRAME_REGIONS frames ago
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, REGION_WAIT_TIMEOUT);
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        // Indices are relative to the start of their region, so the geometry that matched can be copied as-is
+        if(num_vertices > 0) {
+            const auto vertex_region_bytes = max_vertices_per_frame * GUI_VERTEX_SIZE * sizeof(float);
+            glCopyNamedBufferSubData(vertex_buffer, vertex_buffer,
+                                     static_cast<GLintptr>(last_region * vertex_region_bytes),
+                                     static_cast<GLintptr>(current_region * vertex_region_bytes),
+                                     static_cast<GLsizeiptr>(num_vertices * GUI_VERTEX_SIZE * sizeof(float)));
+        }
+        if(num_indices > 0) {
+            const auto index_region_bytes = max_indices_per_frame * sizeof(uint32_t);
+            glCopyNamedBufferSubData(index_buffer, index_buffer,
+                                     static_cast<GLintptr>(last_region * index_region_bytes),
+                                     static_cast<GLintptr>(current_region * index_region_bytes),
+                                     static_cast<GLsizeiptr>(num_indices * sizeof(uint32_t)));
+        }
+
+        has_own_region = true;
+    }
+
+    uint64_t gui_batcher::hash_geometry(const mc_gui_geometry& command, const std::string& texture_name,
+                                        const texture_manager::texture_location& location) {
+        // The location is part of the hash so that geometry gets rewritten when the atlases are rebuilt
+        uint64_t hash = hash_bytes(texture_name.data(), texture_name.size());
+        if(command.atlas_name) {
+            hash = hash_bytes(command.atlas_name, std::strlen(command.atlas_name), hash);
+        }
+        hash = hash_value(location.min.x, hash);
+        hash = hash_value(location.min.y, hash);
+        hash = hash_value(location.max.x, hash);
+        hash = hash_value(location.max.y, hash);
+        hash = hash_value(command.vertex_buffer_size, hash);
+        hash = hash_value(command.index_buffer_size, hash);
+        hash = hash_bytes(command.vertex_buffer, command.vertex_buffer_size * sizeof(float), hash);
+        return hash_bytes(command.index_buffer, command.index_buffer_size * sizeof(int), hash);
+    }
+
+    const std::string& gui_batcher::get_normalized_texture_name(const char* texture_name) {
+        std::string raw_name = texture_name ? texture_name : "";
+        auto itr = normalized_texture_names.find(raw_name);
+        if(itr == normalized_texture_names.end()) {
+            itr = normalized_texture_names.emplace(raw_name, normalize_gui_texture_name(raw_name)).first;
+        }
+        return itr->second;
+    }
+}
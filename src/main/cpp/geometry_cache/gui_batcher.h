@@ -0,0 +1,180 @@
+/*!
+ * \brief Collects each frame's GUI geometry into as few draw calls as possible
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_GUI_BATCHER_H
+#define RENDERER_GUI_BATCHER_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glad/glad.h>
+#include "../mc_interface/mc_objects.h"
+#include "../render/objects/textures/texture_manager.h"
+#include "../render/frame_sync.h"
+
+namespace nova {
+    /*!
+     * \brief The number of floats in each GUI vertex: position, UV, and color
+     */
+    const size_t GUI_VERTEX_SIZE = 9;
+
+    /*!
+     * \brief One draw call's worth of GUI geometry
+     */
+    struct gui_draw {
+        std::string atlas_name;
+
+        /*!
+         * \brief The first index of the draw, counting from the start of the frame's indices
+         */
+        uint32_t first_index;
+        uint32_t num_indices;
+    };
+
+    /*!
+     * \brief Turns the texture name Minecraft uses for a GUI texture (like "textures/gui/widgets.png") into the name of
+     * its texture location (like "minecraft:gui/widgets")
+     */
+    std::string normalize_gui_texture_name(const std::string& texture_name);
+
+    /*!
+     * \brief Adds a draw to the list of draws, merging it into the last draw if they use the same atlas and their
+     * indices are next to each other
+     */
+    void append_gui_draw(std::vector<gui_draw>& draws, const std::string& atlas_name, uint32_t first_index, uint32_t num_indices);
+
+    /*!
+     * \brief Copies GUI vertices, moving their UVs from the [0, 1] range of their texture to where the texture is in
+     * its atlas
+     *
+     * \param command The GUI geometry to copy the vertices of
+     * \param location Where the command's texture is in its atlas
+     * \param destination Where to write the vertices. Must have room for all of the command's floats
+     */
+    void write_gui_vertices(const mc_gui_geometry& command, const texture_manager::texture_location& location, float* destination);
+
+    /*!
+     * \brief Copies GUI indices, offsetting them to where the command's vertices ended up
+     */
+    void write_gui_indices(const mc_gui_geometry& command, uint32_t first_vertex, uint32_t* destination);
+
+    /*!
+     * \brief Batches up the GUI geometry that Minecraft sends each frame and draws it
+     *
+     * Vertices and indices go straight into persistently mapped buffers, split into one region per frame in flight.
+     * A fence after each frame's draws says when its region can be written again, so nothing is ever allocated,
+     * created or deleted while the GUI is drawn. Draws that use the same atlas one after another become a single draw
+     * call
+     *
+     * Most frames the GUI is exactly the same as it was last frame, so each piece of geometry is hashed and compared
+     * with the geometry at the same place in last frame's list. As long as everything matches, nothing is written and
+     * last frame's region gets drawn again. Only once something is different does the frame get a new region, and the
+     * part that matched is copied over on the GPU
+     */
+    class gui_batcher {
+    public:
+        /*!
+         * \param max_vertices_per_frame The most GUI vertices one frame can have. The buffers grow if a frame needs more
+         * \param max_indices_per_frame The most GUI indices one frame can have
+         */
+        explicit gui_batcher(size_t max_vertices_per_frame = 32 * 1024, size_t max_indices_per_frame = 48 * 1024);
+
+        ~gui_batcher();
+
+        /*!
+         * \brief Throws away the last frame's GUI geometry and starts collecting geometry for a new frame
+         */
+        void begin_frame();
+
+        /*!
+         * \brief Adds some GUI geometry to the current frame
+         */
+        void add_geometry(const mc_gui_geometry& command);
+
+        /*!
+         * \brief Draws everything that's been added since the last #begin_frame. The GUI shader must already be bound
+         */
+        void draw(texture_manager& textures);
+
+        /*!
+         * \brief Returns the draw calls the current frame will make
+         */
+        const std::vector<gui_draw>& get_draws() const;
+
+        /*!
+         * \brief Returns the number of frames that had any GUI geometry
+         */
+        size_t get_num_frames() const;
+
+        /*!
+         * \brief Returns the number of frames that drew last frame's buffers again instead of writing new geometry
+         */
+        size_t get_num_reused_frames() const;
+
+    private:
+        /*!
+         * \brief How many frames the GPU can be drawing while the CPU fills in the next one
+         */
+        static const size_t NUM_FRAME_REGIONS = MAX_FRAMES_IN_FLIGHT;
+
+        size_t max_vertices_per_frame;
+        size_t max_indices_per_frame;
+
+        GLuint vertex_array = 0;
+        GLuint vertex_buffer = 0;
+        GLuint index_buffer = 0;
+        float* mapped_vertices = nullptr;
+        uint32_t* mapped_indices = nullptr;
+
+        GLsync region_fences[NUM_FRAME_REGIONS] = {};
+
+        /*!
+         * \brief The region that holds the current frame's geometry
+         */
+        size_t current_region = 0;
+
+        /*!
+         * \brief Whether the current frame has moved on to its own region, or is still using last frame's
+         */
+        bool has_own_region = false;
+
+        std::vector<uint64_t> geometry_hashes;
+        std::vector<uint64_t> last_frame_geometry_hashes;
+
+        size_t num_frames = 0;
+        size_t num_reused_frames = 0;
+
+        size_t num_vertices = 0;
+        size_t num_indices = 0;
+        std::vector<gui_draw> draws;
+
+        /*!
+         * \brief Set when a frame had more geometry than fit, so the buffers get bigger at the start of the next frame
+         */
+        bool needs_bigger_buffers = false;
+
+        std::unordered_map<std::string, std::string> normalized_texture_names;
+
+        void create_buffers();
+
+        void destroy_buffers();
+
+        /*!
+         * \brief Moves the current frame to the next region, and copies the geometry it's added so far from last
+         * frame's region
+         */
+        void move_to_new_region();
+
+        static uint64_t hash_geometry(const mc_gui_geometry& command, const std::string& texture_name,
+                                      const texture_manager::texture_location& location);
+
+        const std::string& get_normalized_texture_name(const char* texture_name);
+    };
+}
+
+#endif //RENDERER_GUI_BATCHER_H
@@ -9,8 +9,13 @@
 #define RENDERER_MESH_DEFINITION_H
 
 #include <vector>
+#include <memory>
 #include <glm/glm.hpp>
+#include <optional.hpp>
 #include "../utils/smart_enum.h"
+#include "../data_loading/physics/vertex_bounds.h"
+#include "face_buckets.h"
+#include "translucent_sorter.h"
 
 namespace nova {
     /*!
@@ -31,6 +36,21 @@ namespace nova {
         format vertex_format;
         glm::vec3 position;
         int id;
+
+        /*!
+         * \brief The bounds of the vertices, in the same space as position
+         */
+        vertex_bounds bounds;
+
+        /*!
+         * \brief Where the indices for each face direction are, if the indices have been sorted by face direction
+         */
+        std::experimental::optional<face_bucket_ranges> face_buckets;
+
+        /*!
+         * \brief The data needed to sort this mesh back-to-front, if it's translucent
+         */
+        std::shared_ptr<translucent_geometry> translucent_data;
     };
 }
 
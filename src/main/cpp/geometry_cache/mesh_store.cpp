@@ -7,7 +7,6 @@
 
 #include <algorithm>
 #include <easylogging++.h>
-#include <regex>
 #include <iomanip>
 #include "mesh_store.h"
 #include "../../../render/nova_renderer.h"
@@ -17,94 +16,89 @@ namespace nova {
         return renderables_grouped_by_shader[shader_name];
     }
 
-    void mesh_store::add_gui_buffers(mc_gui_geometry* command) {
-        std::string texture_name(command->texture_name);
-        texture_name = std::regex_replace(texture_name, std::regex("^textures/"), "");
-        texture_name = std::regex_replace(texture_name, std::regex(".png$"), "");
-        texture_name = "minecraft:" + texture_name;
-        const texture_manager::texture_location tex_location = nova_renderer::instance->get_texture_manager().get_texture_location(texture_name);
-        glm::vec2 tex_size = tex_location.max - tex_location.min;
-
-        mesh_definition cur_screen_buffer = {};
-        cur_screen_buffer.vertex_data.resize(static_cast<unsigned long>(command->vertex_buffer_size), 0);
-        for (int i = 0; i + 8 < command->vertex_buffer_size; i += 9) {
-            cur_screen_buffer.vertex_data[i]   = *reinterpret_cast<int*>(&command->vertex_buffer[i]);
-            cur_screen_buffer.vertex_data[i+1] = *reinterpret_cast<int*>(&command->vertex_buffer[i+1]);
-            cur_screen_buffer.vertex_data[i+2] = *reinterpret_cast<int*>(&command->vertex_buffer[i+2]);
-            float u = command->vertex_buffer[i+3] * tex_size.x + tex_location.min.x;
-            cur_screen_buffer.vertex_data[i+3] = *reinterpret_cast<int*>(&u);
-            float v = command->vertex_buffer[i+4] * tex_size.y + tex_location.min.y;
-            cur_screen_buffer.vertex_data[i+4] = *reinterpret_cast<int*>(&v);
-            cur_screen_buffer.vertex_data[i+5] = *reinterpret_cast<int*>(&command->vertex_buffer[i+5]);
-            cur_screen_buffer.vertex_data[i+6] = *reinterpret_cast<int*>(&command->vertex_buffer[i+6]);
-            cur_screen_buffer.vertex_data[i+7] = *reinterpret_cast<int*>(&command->vertex_buffer[i+7]);
-            cur_screen_buffer.vertex_data[i+8] = *reinterpret_cast<int*>(&command->vertex_buffer[i+8]);
-        }
-        cur_screen_buffer.indices.resize(static_cast<unsigned long>(command->index_buffer_size), 0);
-        for(int i = 0; i < command->index_buffer_size; i++) {
-            cur_screen_buffer.indices[i] = (unsigned int)command->index_buffer[i];
-        }
-
-        cur_screen_buffer.vertex_format = format::POS_UV_COLOR;
+    uint64_t mesh_store::get_geometry_version(const std::string& shader_name) {
+        return geometry_versions[shader_name];
+    }
 
-        render_object gui = {};
-        gui.geometry = std::make_unique<gl_mesh>(cur_screen_buffer);
-        gui.type = geometry_type::gui;
-        gui.name = "gui";
-        gui.color_texture = command->atlas_name;
+    void mesh_store::remove_deleted_render_objects(const std::string& shader_name) {
+        auto& group = renderables_grouped_by_shader[shader_name];
+        auto removed_elements = std::remove_if(group.begin(), group.end(), [](auto& obj) {return obj.needs_deletion;});
+        if(removed_elements != group.end()) {
+            group.erase(removed_elements, group.end());
+            geometry_versions[shader_name]++;
+        }
+    }
 
-        // TODO: Something more intelligent
-        renderables_grouped_by_shader["gui"].push_back(std::move(gui));
+    void mesh_store::add_gui_buffers(mc_gui_geometry* command) {
+        gui.add_geometry(*command);
     }
 
     void mesh_store::remove_gui_render_objects() {
-        remove_render_objects([](auto& render_obj) {return render_obj.type == geometry_type::gui;});
+        gui.begin_frame();
+    }
+
+    gui_batcher& mesh_store::get_gui_batcher() {
+        return gui;
     }
 
     void mesh_store::remove_render_objects(std::function<bool(render_object&)> filter) {
         for(auto& group : renderables_grouped_by_shader) {
             auto removed_elements = std::remove_if(group.second.begin(), group.second.end(), filter);
-            group.second.erase(removed_elements, group.second.end());
+            if(removed_elements != group.second.end()) {
+                group.second.erase(removed_elements, group.second.end());
+                geometry_versions[group.first]++;
+            }
         }
     }
 
     void mesh_store::upload_new_geometry() {
-        chunk_parts_to_upload_lock.lock();
-        while(!chunk_parts_to_upload.empty()) {
-            const auto& entry = chunk_parts_to_upload.front();
-            const auto& def = std::get<1>(entry);
+        chunk_changes_lock.lock();
+        while(!chunk_changes.empty()) {
+            const auto& change = chunk_changes.front();
+            const auto& def = change.def;
+            const std::string& shader_name = change.filter_name;
+
+            // Replace whatever used to be where this chunk is. This happens here rather than when the chunk is added
+            // because chunks are added from the game's threads, and only the render thread touches the render objects
+            mark_chunk_for_deletion(shader_name, change.position);
+            if(change.is_removal) {
+                chunk_changes.pop();
+                continue;
+            }
 
             render_object obj = {};
             obj.geometry = std::make_unique<gl_mesh>(def);
             obj.type = geometry_type::block;
             obj.name = "chunk";
             obj.parent_id = def.id;
-            obj.color_texture = "block_color";
+            obj.color_texture = BLOCK_COLOR_ATLAS_NAME;
             obj.position = def.position;
-            obj.bounding_box.center = {def.position.x+8,def.position.y+8,def.position.z+8};
-            obj.bounding_box.extents = {16, 16, 16};   // TODO: Make these values come from Minecraft
+            obj.bounding_box = def.bounds.bounding_box;
+            obj.bounding_sphere = def.bounds.bounding_sphere;
+            obj.translucent_data = def.translucent_data;
             obj.needs_deletion=false;
-            const std::string& shader_name = std::get<0>(entry);
             renderables_grouped_by_shader[shader_name].push_back(std::move(obj));
+            geometry_versions[shader_name]++;
 
-            chunk_parts_to_upload.pop();
+            chunk_changes.pop();
         }
-        chunk_parts_to_upload_lock.unlock();
+        chunk_changes_lock.unlock();
     }
 
     void mesh_store::remove_chunk_render_object(std::string filter_name, mc_chunk_render_object &chunk) {
-        mesh_definition def = {};
-
-        def.position = {chunk.x, chunk.y, chunk.z};
-        def.id = chunk.id;
+        chunk_changes_lock.lock();
+        chunk_changes.push({filter_name, {chunk.x, chunk.y, chunk.z}, true, {}});
+        chunk_changes_lock.unlock();
+    }
 
+    void mesh_store::mark_chunk_for_deletion(const std::string& filter_name, const glm::vec3& position) {
         try {
             if(renderables_grouped_by_shader.find(filter_name) != renderables_grouped_by_shader.end()) {
                 auto& group = renderables_grouped_by_shader.at(filter_name);
                 for(int i=0;i<group.size();i++) {
-                    bool t=(static_cast<int>(group[i].position.x) == static_cast<int>(def.position.x)) &&
-                           (static_cast<int>(group[i].position.y) == static_cast<int>(def.position.y)) &&
-                           (static_cast<int>(group[i].position.z) == static_cast<int>(def.position.z));
+                    bool t=(static_cast<int>(group[i].position.x) == static_cast<int>(position.x)) &&
+                           (static_cast<int>(group[i].position.y) == static_cast<int>(position.y)) &&
+                           (static_cast<int>(group[i].position.z) == static_cast<int>(position.z));
                     if(t){
                         group[i].needs_deletion=true;
                     }
@@ -140,10 +134,25 @@ namespace nova {
         def.vertex_format = format::all_values()[chunk.format];
         def.position = {chunk.x, chunk.y, chunk.z};
         def.id = chunk.id;
-        remove_chunk_render_object(filter_name,chunk);
-        chunk_parts_to_upload_lock.lock();
-        chunk_parts_to_upload.emplace(filter_name, def);
-        chunk_parts_to_upload_lock.unlock();
+
+        // Chunk vertices are relative to the chunk's position (the model matrix moves them into place), so the
+        // bounds need to be moved into place too
+        auto num_vertices = static_cast<size_t>(chunk.vertex_buffer_size / 7);
+        def.bounds = compute_vertex_bounds(reinterpret_cast<const float*>(chunk.vertex_data), num_vertices, 7);
+        def.bounds.bounding_box.translate(def.position);
+        def.bounds.bounding_sphere.translate(def.position);
+
+        if(filter_name == TRANSLUCENT_SHADER_NAME) {
+            // Translucent quads get re-sorted back-to-front as the camera moves, which would scramble any face buckets
+            def.translucent_data = make_translucent_geometry(reinterpret_cast<const float*>(chunk.vertex_data), 7, def.indices, def.position);
+        } else {
+            // Group the quads by which way they face, so whole groups can be skipped when they face away from the camera
+            def.face_buckets = sort_indices_into_face_buckets(reinterpret_cast<const float*>(chunk.vertex_data), 7, def.indices);
+        }
+
+        chunk_changes_lock.lock();
+        chunk_changes.push({filter_name, def.position, false, std::move(def)});
+        chunk_changes_lock.unlock();
     }
 
     void mesh_store::remove_render_objects_with_parent(long parent_id) {
@@ -13,12 +13,20 @@
 #include <functional>
 #include <unordered_map>
 #include <queue>
+#include <cstdint>
 #include "../render/objects/render_object.h"
 #include "../render/objects/shaders/shaderpack.h"
 #include "../mc_interface/mc_gui_objects.h"
 #include "../mc_interface/mc_objects.h"
+#include "gui_batcher.h"
 
 namespace nova {
+    /*!
+     * \brief The shader that draws translucent blocks, like water and stained glass. Its geometry is sorted
+     * back-to-front instead of being split into face buckets
+     */
+    const std::string TRANSLUCENT_SHADER_NAME = "gbuffers_water";
+
     /*!
          * \brief Provides access to the meshes that Nova will want to deal with
          *
@@ -38,6 +46,9 @@ namespace nova {
         /*!
          * \brief Removes a chunk's geometry for the specified filter
          *
+         * The removal waits in the same queue as added chunks, so adds and removes for a chunk happen in the order
+         * they were made
+         *
          * \param filter_name The name of the filter to remove the chunk geometry from
          * \param chunk The chunk to remove
          */
@@ -52,15 +63,39 @@ namespace nova {
         std::vector<render_object>& get_meshes_for_shader(std::string shader_name);
 
         /*!
-         * \brief Takes geometry that's been added in the last frame and sends it to the GPU
+         * \brief Tells you how many times the list of meshes for the given shader has changed
+         *
+         * Anything that caches information about a shader's meshes - like the indices of the visible meshes - should
+         * throw that information away when this number changes
+         *
+         * \param shader_name The name of the shader to get the geometry version of
+         * \return The version of the shader's geometry
+         */
+        uint64_t get_geometry_version(const std::string& shader_name);
+
+        /*!
+         * \brief Erases all the meshes for the given shader which have been marked for deletion
+         *
+         * \param shader_name The name of the shader to remove deleted meshes from
+         */
+        void remove_deleted_render_objects(const std::string& shader_name);
+
+        /*!
+         * \brief Takes geometry that's been added in the last frame and sends it to the GPU, and removes the chunks
+         * that have been removed, in the order they came in
          */
         void upload_new_geometry();
 
         /*!
-        * \brief Removes all gui render objects and thereby deletes all the buffers
+        * \brief Removes all gui geometry, making room for the next frame's GUI
         */
         void remove_gui_render_objects();
 
+        /*!
+         * \brief Returns the batcher that holds this frame's GUI geometry
+         */
+        gui_batcher& get_gui_batcher();
+
         /*!
          * \brief Removes all known render objects that come from the given ID
          *
@@ -73,11 +108,35 @@ namespace nova {
     private:
         std::unordered_map<std::string, std::vector<render_object>> renderables_grouped_by_shader;
 
-        std::mutex chunk_parts_to_upload_lock;
+        std::unordered_map<std::string, uint64_t> geometry_versions;
+
+        gui_batcher gui;
+
+        /*!
+         * \brief A chunk that was added or removed
+         */
+        struct chunk_change {
+            std::string filter_name;
+            glm::vec3 position;
+            bool is_removal;
+
+            /*!
+             * \brief The chunk's new geometry. Empty for removals
+             */
+            mesh_definition def;
+        };
+
+        std::mutex chunk_changes_lock;
+        /*!
+         * \brief Chunk geometry that's ready to upload to the GPU, and chunks to remove, in the order they came in
+         */
+        std::queue<chunk_change> chunk_changes;
+
         /*!
-         * \brief A list of chunk renderable things that are ready to upload to the GPU
+         * \brief Marks the chunk at the given position for deletion, if there is one. Must be called on the render
+         * thread
          */
-        std::queue<std::tuple<std::string, mesh_definition>> chunk_parts_to_upload;
+        void mark_chunk_for_deletion(const std::string& filter_name, const glm::vec3& position);
 
         float seconds_spent_updating_chunks = 0;
         long total_chunks_updated = 0;
@@ -0,0 +1,141 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <easylogging++.h>
+#include "translucent_sorter.h"
+#include "../render/objects/render_object.h"
+#include "../utils/profiler.h"
+
+namespace nova {
+    const size_t INDICES_PER_TRANSLUCENT_QUAD = 6;
+
+    std::shared_ptr<translucent_geometry> make_translucent_geometry(const float* vertex_data, size_t vertex_stride, const std::vector<int>& indices, const glm::vec3& position) {
+        auto geometry = std::make_shared<translucent_geometry>();
+        geometry->position = position;
+
+        size_t num_quads = indices.size() / INDICES_PER_TRANSLUCENT_QUAD;
+        geometry->indices = indices;
+        geometry->quad_centers.reserve(num_quads);
+
+        for(size_t quad = 0; quad < num_quads; quad++) {
+            // The first triangle of a quad covers its diagonal, so the middle of that diagonal is the quad's center
+            const float* first = vertex_data + static_cast<size_t>(indices[quad * INDICES_PER_TRANSLUCENT_QUAD]) * vertex_stride;
+            const float* third = vertex_data + static_cast<size_t>(indices[quad * INDICES_PER_TRANSLUCENT_QUAD + 2]) * vertex_stride;
+            geometry->quad_centers.emplace_back((first[0] + third[0]) * 0.5f, (first[1] + third[1]) * 0.5f, (first[2] + third[2]) * 0.5f);
+        }
+
+        return geometry;
+    }
+
+    void sort_translucent_geometry(translucent_geometry& geometry, const glm::vec3& camera_position) {
+        glm::vec3 local_camera_position = camera_position - geometry.position;
+
+        size_t num_quads = geometry.quad_centers.size();
+        std::vector<std::pair<float, uint32_t>> quad_distances(num_quads);
+        for(size_t quad = 0; quad < num_quads; quad++) {
+            glm::vec3 to_camera = geometry.quad_centers[quad] - local_camera_position;
+            quad_distances[quad] = {glm::dot(to_camera, to_camera), static_cast<uint32_t>(quad)};
+        }
+
+        std::sort(quad_distances.begin(), quad_distances.end(), [](const auto& a, const auto& b) {return a.first > b.first;});
+
+        geometry.sorted_indices.resize(geometry.indices.size());
+        for(size_t i = 0; i < num_quads; i++) {
+            auto source = geometry.indices.begin() + quad_distances[i].second * INDICES_PER_TRANSLUCENT_QUAD;
+            std::copy(source, source + INDICES_PER_TRANSLUCENT_QUAD, geometry.sorted_indices.begin() + i * INDICES_PER_TRANSLUCENT_QUAD);
+        }
+
+        // Any indices that don't make up a full quad stay at the end
+        auto leftover_indices = geometry.indices.begin() + num_quads * INDICES_PER_TRANSLUCENT_QUAD;
+        std::copy(leftover_indices, geometry.indices.end(), geometry.sorted_indices.begin() + num_quads * INDICES_PER_TRANSLUCENT_QUAD);
+    }
+
+    translucent_sorter::translucent_sorter(job_system& jobs, float resort_distance, size_t max_sorts_per_frame) :
+            jobs(jobs), resort_distance(resort_distance), max_sorts_per_frame(max_sorts_per_frame) {}
+
+    void translucent_sorter::set_resort_distance(float resort_distance) {
+        this->resort_distance = resort_distance;
+    }
+
+    void translucent_sorter::set_max_sorts_per_frame(size_t max_sorts_per_frame) {
+        this->max_sorts_per_frame = max_sorts_per_frame;
+    }
+
+    void translucent_sorter::update(const glm::vec3& camera_position, std::vector<render_object>& objects) {
+        profiler::start("translucent_sort");
+        upload_finished_sorts(objects);
+        update_sort_generation(camera_position);
+
+        std::vector<std::pair<float, std::shared_ptr<translucent_geometry>>> needs_sort;
+        for(auto& obj : objects) {
+            auto& data = obj.translucent_data;
+            if(!data || data->pending_sort.valid() || data->sorted_generation == sort_generation) {
+                continue;
+            }
+
+            glm::vec3 to_camera = obj.bounding_sphere.center - camera_position;
+            needs_sort.emplace_back(glm::dot(to_camera, to_camera), data);
+        }
+
+        size_t num_to_sort = std::min(needs_sort.size(), max_sorts_per_frame);
+        std::partial_sort(needs_sort.begin(), needs_sort.begin() + num_to_sort, needs_sort.end(), [](const auto& a, const auto& b) {return a.first < b.first;});
+
+        for(size_t i = 0; i < num_to_sort; i++) {
+            auto& data = needs_sort[i].second;
+            data->pending_generation = sort_generation;
+
+            // The job holds its own reference to the data, in case the chunk is unloaded while it's being sorted
+            data->pending_sort = jobs.submit([data, camera_position]() {
+                sort_translucent_geometry(*data, camera_position);
+            });
+        }
+
+        if(needs_sort.size() > num_to_sort) {
+            LOG(TRACE) << "Deferring " << needs_sort.size() - num_to_sort << " translucent sorts to a later frame";
+        }
+        profiler::end("translucent_sort");
+    }
+
+    void translucent_sorter::update_sort_generation(const glm::vec3& camera_position) {
+        glm::ivec3 camera_block(std::floor(camera_position.x), std::floor(camera_position.y), std::floor(camera_position.z));
+
+        bool crossed_block = camera_block != last_sort_block;
+        bool moved_far_enough = glm::distance(camera_position, last_sort_position) >= resort_distance;
+        if(has_sorted && !crossed_block && !moved_far_enough) {
+            return;
+        }
+
+        has_sorted = true;
+        last_sort_position = camera_position;
+        last_sort_block = camera_block;
+        sort_generation++;
+    }
+
+    void translucent_sorter::upload_finished_sorts(std::vector<render_object>& objects) {
+        for(auto& obj : objects) {
+            auto& data = obj.translucent_data;
+            if(!data || !data->pending_sort.valid()) {
+                continue;
+            }
+
+            if(data->pending_sort.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                continue;
+            }
+
+            try {
+                data->pending_sort.get();
+                obj.geometry->update_index_array(data->sorted_indices);
+                data->sorted_generation = data->pending_generation;
+            } catch(std::exception& e) {
+                LOG(ERROR) << "Could not sort translucent geometry for chunk " << obj.parent_id << ": " << e.what();
+                // Don't try again until the camera moves
+                data->sorted_generation = data->pending_generation;
+            }
+        }
+    }
+}
@@ -0,0 +1,135 @@
+/*!
+ * \brief Keeps translucent chunk geometry sorted back-to-front
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_TRANSLUCENT_SORTER_H
+#define RENDERER_TRANSLUCENT_SORTER_H
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../utils/job_system.h"
+
+namespace nova {
+    struct render_object;
+
+    /*!
+     * \brief Everything needed to re-sort the quads of one translucent mesh
+     */
+    struct translucent_geometry {
+        /*!
+         * \brief The center of each quad, relative to position
+         */
+        std::vector<glm::vec3> quad_centers;
+
+        /*!
+         * \brief The indices of the mesh in the order they were received, six per quad
+         */
+        std::vector<int> indices;
+
+        /*!
+         * \brief The world space position of the mesh
+         */
+        glm::vec3 position;
+
+        /*!
+         * \brief The indices sorted back-to-front. Written by a worker thread, only read once pending_sort is ready
+         */
+        std::vector<int> sorted_indices;
+
+        /*!
+         * \brief The sort job for this mesh, if there's one running. Only touched by the render thread
+         */
+        std::future<void> pending_sort;
+
+        /*!
+         * \brief Which of the sorter's sort generations the indices on the GPU were sorted for, or 0 if the indices
+         * are still in the order they were received
+         */
+        uint64_t sorted_generation = 0;
+
+        /*!
+         * \brief Which sort generation pending_sort is sorting for
+         */
+        uint64_t pending_generation = 0;
+    };
+
+    /*!
+     * \brief Builds the sorting data for a translucent quad mesh
+     *
+     * \param vertex_data The interleaved vertex data. The position of each vertex must be its first three floats
+     * \param vertex_stride The number of floats from the start of one vertex to the start of the next
+     * \param indices The indices of the mesh, six per quad. Any trailing indices that don't make a full quad are
+     * left where they are when sorting
+     * \param position The world space position of the mesh
+     */
+    std::shared_ptr<translucent_geometry> make_translucent_geometry(const float* vertex_data, size_t vertex_stride, const std::vector<int>& indices, const glm::vec3& position);
+
+    /*!
+     * \brief Re-sorts the quads of translucent meshes by their distance to the camera, farthest first, so that
+     * blending comes out right
+     *
+     * The sorting happens on the job system. A new round of sorting only starts when the camera moves far enough or
+     * crosses into a different block, and only a limited number of meshes start sorting each frame - the closest ones
+     * first, since that's where wrong ordering is most noticeable. When a sort finishes only the mesh's index buffer
+     * is uploaded; its vertices never change
+     */
+    class translucent_sorter {
+    public:
+        /*!
+         * \param jobs The job system to sort on
+         * \param resort_distance How many blocks the camera has to move before everything is sorted again. The camera
+         * moving into a different block triggers a sort too, even if it hasn't moved this far
+         * \param max_sorts_per_frame The maximum number of meshes which can start sorting each frame
+         */
+        translucent_sorter(job_system& jobs, float resort_distance = 1.0f, size_t max_sorts_per_frame = 16);
+
+        void set_resort_distance(float resort_distance);
+
+        void set_max_sorts_per_frame(size_t max_sorts_per_frame);
+
+        /*!
+         * \brief Uploads the results of any sorts that have finished, then starts sorting whichever meshes need it,
+         * up to the per-frame budget
+         *
+         * Must be called on the render thread, since it uploads index buffers
+         *
+         * \param camera_position The world space position of the camera
+         * \param objects The translucent render objects. Objects without translucent_data are ignored
+         */
+        void update(const glm::vec3& camera_position, std::vector<render_object>& objects);
+
+    private:
+        job_system& jobs;
+        float resort_distance;
+        size_t max_sorts_per_frame;
+
+        /*!
+         * \brief Incremented every time the camera moves enough to need a new sort
+         */
+        uint64_t sort_generation = 1;
+
+        glm::vec3 last_sort_position;
+        glm::ivec3 last_sort_block;
+        bool has_sorted = false;
+
+        void update_sort_generation(const glm::vec3& camera_position);
+
+        void upload_finished_sorts(std::vector<render_object>& objects);
+    };
+
+    /*!
+     * \brief Sorts a translucent mesh's quads back-to-front, writing the result into sorted_indices
+     *
+     * \param geometry The mesh to sort
+     * \param camera_position The world space position to sort relative to
+     */
+    void sort_translucent_geometry(translucent_geometry& geometry, const glm::vec3& camera_position);
+}
+
+#endif //RENDERER_TRANSLUCENT_SORTER_H
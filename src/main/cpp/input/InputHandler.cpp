@@ -31,85 +31,175 @@ namespace nova {
 
 	input_handler::~input_handler() {};
 
+	template<typename EventType, size_t Capacity>
+	void input_handler::queue_event(spsc_ring<queued_event<EventType>, Capacity>& ring, const EventType& event) {
+		queued_event<EventType> queued = {event, next_sequence.fetch_add(1, std::memory_order_relaxed), get_input_timestamp()};
+		if(!ring.push(queued)) {
+			num_dropped_events.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	template<typename EventType, size_t Capacity>
+	EventType input_handler::dequeue_event(spsc_ring<queued_event<EventType>, Capacity>& ring) {
+		queued_event<EventType> queued;
+		if(ring.pop(queued)) {
+			latency.on_event_consumed(queued.timestamp);
+			return queued.event;
+		}
+		return {};
+	}
+
 	void input_handler::queue_mouse_button_event(struct mouse_button_event e) {
-		std::lock_guard<std::mutex> lock_guard(lock_button);
-		mouse_button_event_queue.push(e);
+		queue_event(mouse_button_events, e);
 	};
 
 	struct mouse_button_event input_handler::dequeue_mouse_button_event() {
-		std::lock_guard<std::mutex> lock_guard(lock_button);
-		if (mouse_button_event_queue.size() != 0) {
-			struct mouse_button_event e = mouse_button_event_queue.front();
-			mouse_button_event_queue.pop();
-			return e;
-		}
-		return { 0,0,0,0 };
+		return dequeue_event(mouse_button_events);
 	};
 
 
 	void input_handler::queue_mouse_position_event(struct mouse_position_event e) {
-		std::lock_guard<std::mutex> lock_guard(lock_position);
-		mouse_position_event_queue.push(e);
+		queue_event(mouse_position_events, e);
 	};
 
 	struct mouse_position_event input_handler::dequeue_mouse_position_event() {
-		std::lock_guard<std::mutex> lock_guard(lock_position);
-		if (mouse_position_event_queue.size() != 0) {
-			struct mouse_position_event e = mouse_position_event_queue.front();
-			mouse_position_event_queue.pop();
-			return e;
-		}
-		return { 0,0,0 };
+		return dequeue_event(mouse_position_events);
 	}
 
     void input_handler::queue_mouse_scroll_event(struct mouse_scroll_event e) {
-        std::lock_guard<std::mutex> lock_guard(lock_scroll);
-        mouse_scroll_event_queue.push(e);
+        queue_event(mouse_scroll_events, e);
     };
 
     struct mouse_scroll_event input_handler::dequeue_mouse_scroll_event() {
-        std::lock_guard<std::mutex> lock_guard(lock_scroll);
-        if(mouse_scroll_event_queue.size() != 0) {
-            struct mouse_scroll_event e = mouse_scroll_event_queue.front();
-            mouse_scroll_event_queue.pop();
-            return e;
-        }
-        return { 0,0,0 };
+        return dequeue_event(mouse_scroll_events);
     }
 
 	void input_handler::queue_key_press_event(key_press_event e)
 	{
-		std::lock_guard<std::mutex> lock_guard(lock_key_press);
-		key_press_event_queue.push(e);
+		// The keymap never changes after it's made, so it's safe to read from here
+		auto key = keymap.find(e.key);
+		e.key = (int) (key != keymap.end() ? key->second : lwjgl_keycodes::KEY_NONE);
+		queue_event(key_press_events, e);
 	}
 
 	key_press_event input_handler::dequeue_key_press_event()
 	{
-		std::lock_guard<std::mutex> lock_guard(lock_key_press);
-		if (key_press_event_queue.size() != 0) {
-			struct key_press_event e = key_press_event_queue.front();
-			key_press_event_queue.pop();
-			e.key =(int) keymap[e.key];
-			return e;
-		}
-		return {0,0,0,0,0};
+		return dequeue_event(key_press_events);
 	}
 
 	void input_handler::queue_key_char_event(key_char_event e)
 	{
-		std::lock_guard<std::mutex> lock_guard(lock_key_char);
-		key_char_event_queue.push(e);
+		queue_event(key_char_events, e);
 	}
 
 	key_char_event input_handler::dequeue_key_char_event()
 	{
-		std::lock_guard<std::mutex> lock_guard(lock_key_char);
-		if (key_char_event_queue.size() != 0) {
-			struct key_char_event e = key_char_event_queue.front();
-			key_char_event_queue.pop();
-			return e;
+		return dequeue_event(key_char_events);
+	}
+
+	size_t input_handler::drain_events(input_event* buffer, size_t capacity, bool coalesce_mouse_moves) {
+		size_t num_events = 0;
+		while(true) {
+			// Find the oldest event at the front of any of the rings
+			int oldest_type = -1;
+			uint64_t oldest_sequence = UINT64_MAX;
+			auto consider = [&](const uint64_t* sequence, int type) {
+				if(sequence != nullptr && *sequence < oldest_sequence) {
+					oldest_sequence = *sequence;
+					oldest_type = type;
+				}
+			};
+			auto button = mouse_button_events.peek();
+			auto position = mouse_position_events.peek();
+			auto scroll = mouse_scroll_events.peek();
+			auto key_press = key_press_events.peek();
+			auto key_char = key_char_events.peek();
+			consider(button ? &button->sequence : nullptr, INPUT_EVENT_MOUSE_BUTTON);
+			consider(position ? &position->sequence : nullptr, INPUT_EVENT_MOUSE_POSITION);
+			consider(scroll ? &scroll->sequence : nullptr, INPUT_EVENT_MOUSE_SCROLL);
+			consider(key_press ? &key_press->sequence : nullptr, INPUT_EVENT_KEY_PRESS);
+			consider(key_char ? &key_char->sequence : nullptr, INPUT_EVENT_KEY_CHAR);
+
+			if(oldest_type < 0) {
+				break;
+			}
+
+			bool coalesce = coalesce_mouse_moves && oldest_type == INPUT_EVENT_MOUSE_POSITION && num_events > 0 &&
+					buffer[num_events - 1].type == INPUT_EVENT_MOUSE_POSITION;
+			if(!coalesce && num_events == capacity) {
+				break;
+			}
+
+			input_event& e = coalesce ? buffer[num_events - 1] : buffer[num_events++];
+
+			// A run of mouse moves is as late as its oldest move
+			uint64_t run_timestamp = coalesce ? e.timestamp : 0;
+			e = {};
+			e.type = oldest_type;
+			switch(oldest_type) {
+				case INPUT_EVENT_MOUSE_BUTTON:
+					e.button_or_key = button->event.button;
+					e.action = button->event.action;
+					e.mods = button->event.mods;
+					e.timestamp = button->timestamp;
+					mouse_button_events.pop();
+					break;
+
+				case INPUT_EVENT_MOUSE_POSITION:
+					e.xpos = position->event.xpos;
+					e.ypos = position->event.ypos;
+					e.timestamp = coalesce ? run_timestamp : position->timestamp;
+					mouse_position_events.pop();
+					break;
+
+				case INPUT_EVENT_MOUSE_SCROLL:
+					e.xoffset = scroll->event.xoffset;
+					e.yoffset = scroll->event.yoffset;
+					e.timestamp = scroll->timestamp;
+					mouse_scroll_events.pop();
+					break;
+
+				case INPUT_EVENT_KEY_PRESS:
+					e.button_or_key = key_press->event.key;
+					e.scancode = key_press->event.scancode;
+					e.action = key_press->event.action;
+					e.mods = key_press->event.mods;
+					e.timestamp = key_press->timestamp;
+					key_press_events.pop();
+					break;
+
+				case INPUT_EVENT_KEY_CHAR:
+					e.unicode_char = key_char->event.unicode_char;
+					e.timestamp = key_char->timestamp;
+					key_char_events.pop();
+					break;
+
+				default:
+					break;
+			}
 		}
-		return {0,0};
+
+		for(size_t i = 0; i < num_events; i++) {
+			latency.on_event_consumed(buffer[i].timestamp);
+		}
+
+		return num_events;
+	}
+
+	size_t input_handler::get_num_dropped_events() const {
+		return num_dropped_events.load(std::memory_order_relaxed);
+	}
+
+	uint64_t input_handler::on_frame_published() {
+		return latency.on_frame_published();
+	}
+
+	void input_handler::on_frame_presented(uint64_t frame_number) {
+		latency.on_frame_presented(frame_number, get_input_timestamp());
+	}
+
+	input_latency_summary input_handler::get_latency_summary() const {
+		return latency.get_summary();
 	}
 	
 
@@ -4,10 +4,12 @@
 
 
 #include "GLFW/glfw3.h"
-#include <queue>
-#include <mutex>
+#include <atomic>
+#include <cstdint>
 #include <unordered_map>
 #include "../mc_interface/mc_objects.h"
+#include "../utils/spsc_ring.h"
+#include "input_latency.h"
 
 namespace nova {
 
@@ -159,6 +161,14 @@ namespace nova {
 
     void mouse_scroll_callback(GLFWwindow *window, double xoffset, double yoffset);
 
+    /*!
+     * \brief Collects input events from GLFW until Minecraft asks for them
+     *
+     * Each kind of event has its own lock-free ring. GLFW's callbacks push into the rings from the thread that polls
+     * for events, and Minecraft pops from them on its own thread. Events can be popped one kind at a time with the
+     * dequeue_* methods, or all at once, in the order they happened, with #drain_events. Use one or the other: they
+     * pop from the same rings
+     */
     class input_handler {
     public:
         input_handler();
@@ -175,19 +185,71 @@ namespace nova {
         void queue_key_char_event(key_char_event  e);
         key_char_event dequeue_key_char_event();
 
+        /*!
+         * \brief Pops all the pending events of every kind, oldest first
+         *
+         * \param buffer Where to put the events
+         * \param capacity The most events that fit in the buffer. Events that don't fit stay queued for next time
+         * \param coalesce_mouse_moves If true, mouse moves that come right after each other become a single event
+         * with the last position and the first move's timestamp
+         * \return The number of events put in the buffer
+         */
+        size_t drain_events(input_event* buffer, size_t capacity, bool coalesce_mouse_moves);
+
+        /*!
+         * \brief Returns how many events have been thrown away because their ring was full
+         */
+        size_t get_num_dropped_events() const;
+
+        /*!
+         * \brief Call when a frame is handed to the render thread, so the events Minecraft takes after this are
+         * counted towards the next frame
+         *
+         * \return The frame's number, to pass to #on_frame_presented once it's on the screen
+         */
+        uint64_t on_frame_published();
+
+        /*!
+         * \brief Call right after a frame is presented, to measure how long the events Minecraft took while that frame
+         * was being built took to reach the screen
+         */
+        void on_frame_presented(uint64_t frame_number);
+
+        input_latency_summary get_latency_summary() const;
+
     private:
+        /*!
+         * \brief An event, plus what's needed to put events of different kinds back in order
+         */
+        template<typename EventType>
+        struct queued_event {
+            EventType event;
+            uint64_t sequence;
+            uint64_t timestamp;
+        };
+
         std::unordered_map<int, lwjgl_keycodes> keymap;
-        std::queue< mouse_button_event> mouse_button_event_queue;
-        std::queue< mouse_position_event> mouse_position_event_queue;
-        std::queue< mouse_scroll_event> mouse_scroll_event_queue;
-        std::mutex lock_button;
-        std::mutex lock_position;
-        std::mutex lock_scroll;
-
-        std::queue< key_press_event> key_press_event_queue;
-        std::queue< key_char_event> key_char_event_queue;
-        std::mutex lock_key_press;
-        std::mutex lock_key_char;
+
+        spsc_ring<queued_event<mouse_button_event>, 256> mouse_button_events;
+        spsc_ring<queued_event<mouse_position_event>, 4096> mouse_position_events;
+        spsc_ring<queued_event<mouse_scroll_event>, 256> mouse_scroll_events;
+        spsc_ring<queued_event<key_press_event>, 256> key_press_events;
+        spsc_ring<queued_event<key_char_event>, 256> key_char_events;
+
+        /*!
+         * \brief Counts up with every event, so events of different kinds can be put back in order
+         */
+        std::atomic<uint64_t> next_sequence{0};
+        std::atomic<size_t> num_dropped_events{0};
+
+        input_latency_tracker latency;
+
+        template<typename EventType, size_t Capacity>
+        void queue_event(spsc_ring<queued_event<EventType>, Capacity>& ring, const EventType& event);
+
+        template<typename EventType, size_t Capacity>
+        EventType dequeue_event(spsc_ring<queued_event<EventType>, Capacity>& ring);
+
         void create_keymap();
     };
 
@@ -0,0 +1,117 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include "input_latency.h"
+#include "../utils/stats.h"
+
+namespace nova {
+    uint64_t get_input_timestamp() {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+    }
+
+    /*!
+     * \brief Sorting the samples isn't free, so the percentile stats are only updated this often
+     */
+    const uint64_t STATS_INTERVAL_NS = 1000000000;
+
+    /*!
+     * \brief Works out the percentiles of some latency samples, in nanoseconds
+     */
+    input_latency_summary summarize(std::vector<uint64_t> samples) {
+        input_latency_summary summary = {};
+        if(samples.empty()) {
+            return summary;
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        auto to_ms = [](uint64_t nanoseconds) { return static_cast<double>(nanoseconds) / 1000000.0; };
+        auto percentile = [&](double fraction) {
+            auto index = static_cast<size_t>(fraction * static_cast<double>(samples.size() - 1) + 0.5);
+            return to_ms(samples[index]);
+        };
+
+        double total = 0;
+        for(auto sample : samples) {
+            total += to_ms(sample);
+        }
+
+        summary.num_samples = samples.size();
+        summary.mean_ms = total / static_cast<double>(samples.size());
+        summary.p50_ms = percentile(0.5);
+        summary.p95_ms = percentile(0.95);
+        summary.p99_ms = percentile(0.99);
+        summary.max_ms = to_ms(samples.back());
+        return summary;
+    }
+
+    input_latency_tracker::input_latency_tracker(size_t max_samples) : max_samples(max_samples) {}
+
+    void input_latency_tracker::on_event_consumed(uint64_t event_timestamp) {
+        std::lock_guard<std::mutex> lock(tracker_mutex);
+        consumed_events.push_back({frame_being_built, event_timestamp});
+    }
+
+    uint64_t input_latency_tracker::on_frame_published() {
+        std::lock_guard<std::mutex> lock(tracker_mutex);
+        return frame_being_built++;
+    }
+
+    void input_latency_tracker::on_frame_presented(uint64_t frame_number, uint64_t present_timestamp) {
+        uint64_t num_total_samples;
+        std::vector<uint64_t> samples_to_publish;
+        {
+            std::lock_guard<std::mutex> lock(tracker_mutex);
+            // Events taken for later frames stay until those frames are presented
+            auto frame_end = std::find_if(consumed_events.begin(), consumed_events.end(),
+                                          [&](const consumed_event& event) { return event.frame_number > frame_number; });
+            if(frame_end == consumed_events.begin()) {
+                return;
+            }
+
+            for(auto event = consumed_events.begin(); event != frame_end; ++event) {
+                uint64_t latency = present_timestamp > event->timestamp ? present_timestamp - event->timestamp : 0;
+                if(samples.size() < max_samples) {
+                    samples.push_back(latency);
+                } else {
+                    samples[next_sample] = latency;
+                }
+                next_sample = (next_sample + 1) % max_samples;
+                total_samples++;
+            }
+            consumed_events.erase(consumed_events.begin(), frame_end);
+
+            num_total_samples = total_samples;
+            if(!has_published_stats || present_timestamp - last_stats_timestamp >= STATS_INTERVAL_NS) {
+                samples_to_publish = samples;
+                last_stats_timestamp = present_timestamp;
+                has_published_stats = true;
+            }
+        }
+
+        // Sorted outside the lock, so the game thread never waits on it to take input
+        if(!samples_to_publish.empty()) {
+            auto summary = summarize(std::move(samples_to_publish));
+            stats::set("input_latency_mean_ms", summary.mean_ms);
+            stats::set("input_latency_p50_ms", summary.p50_ms);
+            stats::set("input_latency_p95_ms", summary.p95_ms);
+            stats::set("input_latency_p99_ms", summary.p99_ms);
+            stats::set("input_latency_max_ms", summary.max_ms);
+        }
+        stats::set("input_latency_samples", static_cast<double>(num_total_samples));
+    }
+
+    input_latency_summary input_latency_tracker::get_summary() const {
+        std::vector<uint64_t> samples_copy;
+        {
+            std::lock_guard<std::mutex> lock(tracker_mutex);
+            samples_copy = samples;
+        }
+        return summarize(std::move(samples_copy));
+    }
+}
@@ -0,0 +1,103 @@
+/*!
+ * \brief Measures how long it takes for input to show up on the screen
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_INPUT_LATENCY_H
+#define RENDERER_INPUT_LATENCY_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace nova {
+    /*!
+     * \brief Returns the current time in nanoseconds, from a clock that only goes forwards. Input events are stamped
+     * with this
+     */
+    uint64_t get_input_timestamp();
+
+    struct input_latency_summary {
+        size_t num_samples;
+        double mean_ms;
+        double p50_ms;
+        double p95_ms;
+        double p99_ms;
+        double max_ms;
+    };
+
+    /*!
+     * \brief Ties input events to the frame they end up in
+     *
+     * When Minecraft takes an event, the event's timestamp is held along with the number of the frame being built.
+     * The render thread runs a frame behind the game thread, so events can be taken for the next frame while this one
+     * is still being presented; each event waits for the present of its own frame. The time from the event to that
+     * present is one latency sample. The most recent samples are summarized and published as the
+     * input_latency_* stats, at most once a second
+     */
+    class input_latency_tracker {
+    public:
+        /*!
+         * \param max_samples How many of the most recent samples to summarize
+         */
+        explicit input_latency_tracker(size_t max_samples = 1024);
+
+        /*!
+         * \brief Records that Minecraft has taken an event, so whatever it does about it will be in the frame being
+         * built
+         */
+        void on_event_consumed(uint64_t event_timestamp);
+
+        /*!
+         * \brief Records that the frame being built has been handed to the render thread. Events taken after this
+         * belong to the next frame
+         *
+         * \return The number of the frame that was handed over, to pass to #on_frame_presented
+         */
+        uint64_t on_frame_published();
+
+        /*!
+         * \brief Records that a frame has been presented, which finishes the samples for every event consumed while
+         * that frame was being built
+         *
+         * \param frame_number The number #on_frame_published returned for the frame
+         * \param present_timestamp When the frame was presented
+         */
+        void on_frame_presented(uint64_t frame_number, uint64_t present_timestamp);
+
+        /*!
+         * \brief Summarizes the most recent samples. This sorts them, so don't call it every frame
+         */
+        input_latency_summary get_summary() const;
+
+    private:
+        size_t max_samples;
+
+        mutable std::mutex tracker_mutex;
+
+        struct consumed_event {
+            uint64_t frame_number;
+            uint64_t timestamp;
+        };
+
+        /*!
+         * \brief Events that haven't been presented yet, in the order they were taken. Their frame numbers only go up
+         */
+        std::vector<consumed_event> consumed_events;
+        uint64_t frame_being_built = 0;
+
+        /*!
+         * \brief The most recent latencies, in nanoseconds. A ring once it's full
+         */
+        std::vector<uint64_t> samples;
+        size_t next_sample = 0;
+        uint64_t total_samples = 0;
+
+        bool has_published_stats = false;
+        uint64_t last_stats_timestamp = 0;
+    };
+}
+
+#endif //RENDERER_INPUT_LATENCY_H
@@ -202,6 +202,36 @@ struct key_char_event {
 
 };
 
+/*!
+ * \brief What kind of event an input_event is
+ */
+enum input_event_type {
+    INPUT_EVENT_MOUSE_BUTTON = 0,
+    INPUT_EVENT_MOUSE_POSITION = 1,
+    INPUT_EVENT_MOUSE_SCROLL = 2,
+    INPUT_EVENT_KEY_PRESS = 3,
+    INPUT_EVENT_KEY_CHAR = 4
+};
+
+/*!
+ * \brief Any kind of input event, so that all the pending events can be handed to Minecraft in a single array
+ *
+ * Only the fields that go with the event's type are filled in
+ */
+struct input_event {
+    int type;                   //!< One of the values of input_event_type
+    int button_or_key;          //!< The mouse button for mouse button events, or the key for key press events
+    int scancode;
+    int action;
+    int mods;
+    int xpos;
+    int ypos;
+    double xoffset;
+    double yoffset;
+    std::uint64_t unicode_char;
+    std::uint64_t timestamp;    //!< When the event happened, in nanoseconds since some arbitrary point
+};
+
 struct window_size {
     int height;
     int width;
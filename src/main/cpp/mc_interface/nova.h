@@ -60,6 +60,26 @@ NOVA_API void add_texture(mc_atlas_texture & texture);
  */
 NOVA_API void add_texture_location(mc_texture_atlas_location location);
 
+/*!
+ * \brief Adds a single texture for Nova to pack into an atlas
+ *
+ * Nova works out where the sprite goes and what its texture location is, so there's no need to call
+ * add_texture_location for it. The atlas is packed when finalize_textures is called. The sprite is copied and handed
+ * to the render thread without waiting for it, since nothing uses the sprite before then
+ *
+ * \param atlas_name The name of the atlas to put the sprite in
+ * \param sprite The sprite to add. Its name becomes the name of its texture location
+ */
+NOVA_API void add_sprite(const char* atlas_name, mc_atlas_texture & sprite);
+
+/*!
+ * \brief Tells the texture manager that all the textures and texture locations for the current atlases have been added
+ *
+ * Textures which need mipmaps (the block atlas) aren't uploaded until this is called, and sprites added with add_sprite
+ * are packed into their atlases here
+ */
+NOVA_API void finalize_textures();
+
 /*!
  * \brief Queries OpenGL and returns the maximum texture size that OpenGL allows
  */
@@ -171,6 +191,51 @@ NOVA_API struct key_press_event  get_next_key_press_event();
 
 NOVA_API struct key_char_event  get_next_key_char_event();
 
+/*!
+ * \brief Gets all the pending mouse and key events in one call, in the order they happened
+ *
+ * This pops from the same queues as the get_next_*_event functions, so use one or the other
+ *
+ * \param buffer Where to put the events
+ * \param capacity How many events fit in the buffer. Any more events stay queued for the next call
+ * \param coalesce_mouse_moves If non-zero, mouse moves that happen right after each other are merged into a single
+ * event with the last position and the first move's timestamp
+ * \return The number of events put in the buffer
+ */
+NOVA_API int drain_input_events(struct input_event* buffer, int capacity, int coalesce_mouse_moves);
+
+/*!
+ * \brief Reads one of the numbers Nova keeps about how it's doing, like "gui_reuse_rate" or "input_latency_p95_ms"
+ *
+ * \return The value of the stat, or 0 if it's never been set
+ */
+NOVA_API double get_stat(const char* name);
+
+/**
+ * Command ring
+ */
+
+/*!
+ * \brief Gets the memory that Java writes commands into
+ *
+ * Java wraps this in a direct ByteBuffer and writes commands into it without calling into Nova. Nova does all the
+ * commands at the start of each frame. The layout of the memory and the commands is in data_loading/command_ring.h
+ *
+ * \return A pointer to the start of the command ring's header
+ */
+NOVA_API void* get_command_ring();
+
+/*!
+ * \brief The number of bytes in the memory that get_command_ring returns, header included
+ */
+NOVA_API int get_command_ring_size();
+
+/*!
+ * \brief Does all the commands in the command ring right now. Java calls this when the ring is too full for the next
+ * command
+ */
+NOVA_API void process_command_ring();
+
 NOVA_API int get_num_loaded_shaders();
 
 NOVA_API char* get_shaders_and_filters();
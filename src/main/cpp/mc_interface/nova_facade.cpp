@@ -22,6 +22,7 @@
 #include "../render/windowing/glfw_gl_window.h"
 #include "../utils/utils.h"
 #include "../utils/profiler.h"
+#include "../utils/stats.h"
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "../utils/stb_image_write.h"
@@ -32,9 +33,11 @@ using namespace nova;
 #define TEXTURE_MANAGER NOVA_RENDERER->get_texture_manager()
 #define INPUT_HANDLER NOVA_RENDERER->get_input_handler()
 #define MESH_STORE NOVA_RENDERER->get_mesh_store()
+#define RENDER_THREAD NOVA_RENDERER->get_render_thread()
 
 #define PROFILER nova::profiler
-// runs in thread 5
+// Everything here is called from Minecraft's threads. Anything that touches OpenGL, or state that the render thread
+// reads while it renders, goes through RENDER_THREAD
 
 NOVA_API void initialize() {
     PROFILER::start("initialize");
@@ -44,31 +47,60 @@ NOVA_API void initialize() {
 
 NOVA_API void add_texture(mc_atlas_texture & texture) {
     PROFILER::start("add_texture");
-    TEXTURE_MANAGER.add_texture(texture);
+    RENDER_THREAD.run_and_wait([&]() { TEXTURE_MANAGER.add_texture(texture); });
     PROFILER::end("add_texture");
 }
 
 NOVA_API void reset_texture_manager() {
     PROFILER::start("reset_texture_manager");
-    TEXTURE_MANAGER.reset();
+    RENDER_THREAD.run_and_wait([&]() { TEXTURE_MANAGER.reset(); });
     PROFILER::end("reset_texture_mamager");
 }
 
 NOVA_API void send_lightmap_texture(int* data, int count, int width, int height) {
     auto size = glm::ivec2{width, height};
-    TEXTURE_MANAGER.update_texture("lightmap", data, size, GL_BGRA, GL_UNSIGNED_BYTE);
-    auto& lightmap = TEXTURE_MANAGER.get_texture("lightmap");
-    lightmap.bind(4);
+    // Java reuses the array, so the render thread gets its own copy
+    std::vector<int> lightmap_data(data, data + count);
+    RENDER_THREAD.run_before_next_frame([=]() mutable {
+        TEXTURE_MANAGER.update_texture("lightmap", lightmap_data.data(), size, GL_BGRA, GL_UNSIGNED_BYTE);
+        auto& lightmap = TEXTURE_MANAGER.get_texture("lightmap");
+        lightmap.bind(4);
+    });
 }
 
 NOVA_API void add_texture_location(mc_texture_atlas_location location) {
     PROFILER::start("add_texture_location");
-    TEXTURE_MANAGER.add_texture_location(location);
+    RENDER_THREAD.run_and_wait([&]() { TEXTURE_MANAGER.add_texture_location(location); });
     PROFILER::end("add_texture_location");
 }
 
+NOVA_API void add_sprite(const char* atlas_name, mc_atlas_texture & sprite) {
+    PROFILER::start("add_sprite");
+    // Sprites are only held onto until finalize_textures, so there's no need to wait for the render thread for each
+    // one. The queued work gets its own copy of everything Java owns
+    std::string atlas(atlas_name);
+    std::string name(sprite.name);
+    auto data_size = static_cast<size_t>(sprite.width * sprite.height * sprite.num_components);
+    std::vector<unsigned char> data(sprite.texture_data, sprite.texture_data + data_size);
+    mc_atlas_texture sprite_copy = sprite;
+    RENDER_THREAD.run_before_next_frame([=]() mutable {
+        sprite_copy.texture_data = data.data();
+        sprite_copy.name = name.c_str();
+        TEXTURE_MANAGER.add_sprite(atlas, sprite_copy);
+    });
+    PROFILER::end("add_sprite");
+}
+
+NOVA_API void finalize_textures() {
+    PROFILER::start("finalize_textures");
+    RENDER_THREAD.run_and_wait([&]() { TEXTURE_MANAGER.finalize_textures(); });
+    PROFILER::end("finalize_textures");
+}
+
 NOVA_API int get_max_texture_size() {
-    return TEXTURE_MANAGER.get_max_texture_size();
+    int max_texture_size = 0;
+    RENDER_THREAD.run_and_wait([&]() { max_texture_size = TEXTURE_MANAGER.get_max_texture_size(); });
+    return max_texture_size;
 }
 
 NOVA_API void add_chunk_geometry_for_filter(const char* filter_name, mc_chunk_render_object * chunk) {
@@ -79,13 +111,14 @@ NOVA_API void add_chunk_geometry_for_filter(const char* filter_name, mc_chunk_re
 
 NOVA_API void remove_chunk_geometry_for_filter(const char* filter_name, mc_chunk_render_object * chunk) {
     PROFILER::start("remove_chunk_geometry_for_filter");
+    // Goes through the same queue as added chunks, so a remove and an add for one chunk stay in order
     MESH_STORE.remove_chunk_render_object(std::string(filter_name), *chunk);
     PROFILER::end("remove_chunk_geometry_for_filter");
 }
 
 NOVA_API void execute_frame() {
     PROFILER::start("execute_frame");
-    NOVA_RENDERER->render_frame();
+    NOVA_RENDERER->execute_frame();
     PROFILER::end("execute_frame");
 }
 
@@ -109,7 +142,21 @@ NOVA_API bool display_is_active() {
 
 NOVA_API void add_gui_geometry(mc_gui_geometry * gui_geometry) {
     PROFILER::start("add_gui_geometry");
-    NOVA_RENDERER->get_mesh_store().add_gui_buffers(gui_geometry);
+    // Waiting for the render thread here would hold the game thread up on the frame in flight, so the queued work gets
+    // its own copy of everything Java owns instead
+    std::string texture_name(gui_geometry->texture_name);
+    bool has_atlas = gui_geometry->atlas_name != nullptr;
+    std::string atlas_name(has_atlas ? gui_geometry->atlas_name : "");
+    std::vector<float> vertices(gui_geometry->vertex_buffer, gui_geometry->vertex_buffer + gui_geometry->vertex_buffer_size);
+    std::vector<int> indices(gui_geometry->index_buffer, gui_geometry->index_buffer + gui_geometry->index_buffer_size);
+    mc_gui_geometry geometry_copy = *gui_geometry;
+    RENDER_THREAD.run_before_next_frame([=]() mutable {
+        geometry_copy.texture_name = texture_name.c_str();
+        geometry_copy.atlas_name = has_atlas ? atlas_name.c_str() : nullptr;
+        geometry_copy.vertex_buffer = vertices.data();
+        geometry_copy.index_buffer = indices.data();
+        MESH_STORE.add_gui_buffers(&geometry_copy);
+    });
     PROFILER::end("add_gui_geometry");
 }
 
@@ -121,32 +168,27 @@ NOVA_API struct window_size get_window_size()
 
 NOVA_API void clear_gui_buffers() {
     PROFILER::start("clear_gui_buffers");
-    NOVA_RENDERER->get_mesh_store().remove_gui_render_objects();
+    RENDER_THREAD.run_before_next_frame([]() { MESH_STORE.remove_gui_render_objects(); });
     PROFILER::end("clear_gui_buffers");
 }
 
 NOVA_API void set_string_setting(const char * setting_name, const char * setting_value) {
     PROFILER::start("set_string_setting");
     settings& settings = NOVA_RENDERER->get_render_settings();
-    settings.get_options()["settings"][setting_name] = setting_value;
-    settings.update_config_changed();
+    settings.set(setting_name, setting_value);
     PROFILER::end("set_string_setting");
 }
 
 NOVA_API void set_float_setting(const char * setting_name, float setting_value) {
     PROFILER::start("set_float_setting");
     settings& settings = NOVA_RENDERER->get_render_settings();
-    settings.get_options()["settings"][setting_name] = setting_value;
-    settings.update_config_changed();
+    settings.set(setting_name, setting_value);
     PROFILER::end("set_float_setting");
 }
 
 NOVA_API void set_player_camera_transform(double x, double y, double z, float yaw, float pitch) {
     PROFILER::start("set_player_camera_transform");
-    auto& player_camera = NOVA_RENDERER->get_player_camera();
-
-    player_camera.position = {x, y, z};
-    player_camera.rotation = {yaw, pitch};
+    NOVA_RENDERER->set_player_camera_transform({x, y, z}, {yaw, pitch});
     PROFILER::end("set_player_camera_transform");
 }
 
@@ -172,17 +214,49 @@ NOVA_API struct key_char_event get_next_key_char_event()
 	return  INPUT_HANDLER.dequeue_key_char_event();
 }
 
+NOVA_API int drain_input_events(struct input_event* buffer, int capacity, int coalesce_mouse_moves) {
+    if(buffer == nullptr || capacity <= 0) {
+        return 0;
+    }
+    return static_cast<int>(INPUT_HANDLER.drain_events(buffer, static_cast<size_t>(capacity), coalesce_mouse_moves != 0));
+}
+
 NOVA_API void set_mouse_grabbed(int grabbed) {
     NOVA_RENDERER->get_game_window().set_mouse_grabbed(grabbed != 0);
 }
 
+NOVA_API double get_stat(const char* name) {
+    return stats::get(name);
+}
+
+NOVA_API void* get_command_ring() {
+    return NOVA_RENDERER->get_command_ring().get_memory();
+}
+
+NOVA_API int get_command_ring_size() {
+    return static_cast<int>(NOVA_RENDERER->get_command_ring().get_memory_size());
+}
+
+NOVA_API void process_command_ring() {
+    // Waits for the frame in flight, which might still be reading commands out of the ring
+    RENDER_THREAD.run_and_wait([]() {
+        auto& renderer = *NOVA_RENDERER;
+        renderer.process_commands(renderer.get_command_ring().get_write_offset());
+    });
+}
+
 NOVA_API int get_num_loaded_shaders() {
-    return static_cast<int>(NOVA_RENDERER->get_shaders()->get_loaded_shaders().size());
+    int num_shaders = 0;
+    RENDER_THREAD.run_and_wait([&]() { num_shaders = static_cast<int>(NOVA_RENDERER->get_shaders()->get_loaded_shaders().size()); });
+    return num_shaders;
 }
 
 NOVA_API char* get_shaders_and_filters() {
     PROFILER::start("set_shaders_and_filters");
-    auto& shaders = NOVA_RENDERER->get_shaders()->get_loaded_shaders();
+    // The shaderpack is swapped out on the render thread, so hold onto the one that's there right now
+    std::shared_ptr<shaderpack> loaded_shaderpack;
+    RENDER_THREAD.run_and_wait([&]() { loaded_shaderpack = NOVA_RENDERER->get_shaders(); });
+    auto& shaders = loaded_shaderpack->get_loaded_shaders();
 
     int num_chars = 0;
     for(auto& s : shaders) {
@@ -0,0 +1,188 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <string>
+#include <vector>
+#include <easylogging++.h>
+#include "nova_jni.h"
+#include "../render/nova_renderer.h"
+#include "../utils/profiler.h"
+
+using namespace nova;
+
+#define NOVA_RENDERER nova_renderer::instance
+#define INPUT_HANDLER NOVA_RENDERER->get_input_handler()
+#define MESH_STORE NOVA_RENDERER->get_mesh_store()
+
+#define PROFILER nova::profiler
+
+/*!
+ * \brief The Java class that the functions in this file are registered on
+ */
+static const char* NOVA_JNI_CLASS = "com/continuum/nova/NovaJNI";
+
+/*!
+ * \brief Runs the given function, turning any C++ exception into a Java RuntimeException
+ *
+ * Letting a C++ exception unwind through the JVM's stack frames takes the whole JVM down with it
+ */
+template<typename Func>
+static void rethrow_in_java(JNIEnv* env, Func&& func) {
+    try {
+        func();
+
+    } catch(std::exception& e) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
+    }
+}
+
+static void JNICALL add_chunk_geometry_for_filter(JNIEnv* env, jclass, jstring filter_name, jint format, jfloat x, jfloat y,
+                                                  jfloat z, jint id, jintArray vertex_data, jint vertex_count,
+                                                  jintArray indices, jint index_count) {
+    if(vertex_count < 0 || vertex_count > env->GetArrayLength(vertex_data) || index_count < 0 || index_count > env->GetArrayLength(indices)) {
+        env->ThrowNew(env->FindClass("java/lang/ArrayIndexOutOfBoundsException"), "Vertex or index count is bigger than its array");
+        return;
+    }
+
+    const char* filter_chars = env->GetStringUTFChars(filter_name, nullptr);
+    std::string filter(filter_chars);
+    env->ReleaseStringUTFChars(filter_name, filter_chars);
+
+    // Building the chunk's mesh takes a while and can wait on the render thread, which isn't allowed while holding an
+    // array with GetPrimitiveArrayCritical, so the data is copied out first
+    std::vector<jint> vertices(static_cast<size_t>(vertex_count));
+    std::vector<jint> chunk_indices(static_cast<size_t>(index_count));
+    env->GetIntArrayRegion(vertex_data, 0, vertex_count, vertices.data());
+    env->GetIntArrayRegion(indices, 0, index_count, chunk_indices.data());
+
+    mc_chunk_render_object chunk = {format, x, y, z, id, vertices.data(), chunk_indices.data(), vertex_count, index_count};
+    PROFILER::start("add_chunk_geometry_for_filter");
+    rethrow_in_java(env, [&]() {
+        MESH_STORE.add_chunk_render_object(filter, chunk);
+    });
+    PROFILER::end("add_chunk_geometry_for_filter");
+}
+
+static void JNICALL remove_chunk_geometry_for_filter(JNIEnv* env, jclass, jstring filter_name, jfloat x, jfloat y, jfloat z, jint id) {
+    const char* filter_chars = env->GetStringUTFChars(filter_name, nullptr);
+    std::string filter(filter_chars);
+    env->ReleaseStringUTFChars(filter_name, filter_chars);
+
+    mc_chunk_render_object chunk = {};
+    chunk.x = x;
+    chunk.y = y;
+    chunk.z = z;
+    chunk.id = id;
+    rethrow_in_java(env, [&]() {
+        MESH_STORE.remove_chunk_render_object(filter, chunk);
+    });
+}
+
+static void JNICALL set_player_camera_transform(JNIEnv*, jclass, jdouble x, jdouble y, jdouble z, jfloat yaw, jfloat pitch) {
+    NOVA_RENDERER->set_player_camera_transform({x, y, z}, {yaw, pitch});
+}
+
+/*!
+ * \brief Writes {button, action, mods} into event
+ */
+static jboolean JNICALL next_mouse_button_event(JNIEnv* env, jclass, jintArray event) {
+    auto next_event = INPUT_HANDLER.dequeue_mouse_button_event();
+    if(!next_event.filled) {
+        return JNI_FALSE;
+    }
+
+    jint values[] = {next_event.button, next_event.action, next_event.mods};
+    env->SetIntArrayRegion(event, 0, 3, values);
+    return JNI_TRUE;
+}
+
+/*!
+ * \brief Writes {x, y} into event
+ */
+static jboolean JNICALL next_mouse_position_event(JNIEnv* env, jclass, jintArray event) {
+    auto next_event = INPUT_HANDLER.dequeue_mouse_position_event();
+    if(!next_event.filled) {
+        return JNI_FALSE;
+    }
+
+    jint values[] = {next_event.xpos, next_event.ypos};
+    env->SetIntArrayRegion(event, 0, 2, values);
+    return JNI_TRUE;
+}
+
+/*!
+ * \brief Writes {x offset, y offset} into event
+ */
+static jboolean JNICALL next_mouse_scroll_event(JNIEnv* env, jclass, jdoubleArray event) {
+    auto next_event = INPUT_HANDLER.dequeue_mouse_scroll_event();
+    if(!next_event.filled) {
+        return JNI_FALSE;
+    }
+
+    jdouble values[] = {next_event.xoffset, next_event.yoffset};
+    env->SetDoubleArrayRegion(event, 0, 2, values);
+    return JNI_TRUE;
+}
+
+/*!
+ * \brief Writes {key, scancode, action, mods} into event
+ */
+static jboolean JNICALL next_key_press_event(JNIEnv* env, jclass, jintArray event) {
+    auto next_event = INPUT_HANDLER.dequeue_key_press_event();
+    if(!next_event.filled) {
+        return JNI_FALSE;
+    }
+
+    jint values[] = {next_event.key, next_event.scancode, next_event.action, next_event.mods};
+    env->SetIntArrayRegion(event, 0, 4, values);
+    return JNI_TRUE;
+}
+
+/*!
+ * \brief Returns the next typed character, or -1 if there isn't one
+ */
+static jlong JNICALL next_key_char_event(JNIEnv*, jclass) {
+    auto next_event = INPUT_HANDLER.dequeue_key_char_event();
+    if(!next_event.filled) {
+        return -1;
+    }
+
+    return static_cast<jlong>(next_event.unicode_char);
+}
+
+static JNINativeMethod nova_jni_methods[] = {
+        {(char*)"addChunkGeometryForFilter",     (char*)"(Ljava/lang/String;IFFFI[II[II)V", (void*)&add_chunk_geometry_for_filter},
+        {(char*)"removeChunkGeometryForFilter",  (char*)"(Ljava/lang/String;FFFI)V",         (void*)&remove_chunk_geometry_for_filter},
+        {(char*)"setPlayerCameraTransform",      (char*)"(DDDFF)V",                          (void*)&set_player_camera_transform},
+        {(char*)"nextMouseButtonEvent",          (char*)"([I)Z",                             (void*)&next_mouse_button_event},
+        {(char*)"nextMousePositionEvent",        (char*)"([I)Z",                             (void*)&next_mouse_position_event},
+        {(char*)"nextMouseScrollEvent",          (char*)"([D)Z",                             (void*)&next_mouse_scroll_event},
+        {(char*)"nextKeyPressEvent",             (char*)"([I)Z",                             (void*)&next_key_press_event},
+        {(char*)"nextKeyCharEvent",              (char*)"()J",                               (void*)&next_key_char_event},
+};
+
+NOVA_API jint JNICALL JNI_OnLoad(JavaVM* vm, void*) {
+    JNIEnv* env = nullptr;
+    if(vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) {
+        return JNI_ERR;
+    }
+
+    jclass nova_jni = env->FindClass(NOVA_JNI_CLASS);
+    if(nova_jni == nullptr) {
+        env->ExceptionClear();
+        // Nova's being loaded by something that doesn't have NovaJNI, like the tests. That's fine, there's just
+        // nothing to register
+        return JNI_VERSION_1_6;
+    }
+
+    auto num_methods = static_cast<jint>(sizeof(nova_jni_methods) / sizeof(JNINativeMethod));
+    if(env->RegisterNatives(nova_jni, nova_jni_methods, num_methods) != JNI_OK) {
+        LOG(ERROR) << "Could not register the native methods of " << NOVA_JNI_CLASS;
+        return JNI_ERR;
+    }
+
+    env->DeleteLocalRef(nova_jni);
+    return JNI_VERSION_1_6;
+}
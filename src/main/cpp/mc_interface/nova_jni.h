@@ -1,23 +1,26 @@
-/*! 
- * \author gold1 
+/*!
+ * \brief Hand-written JNI bindings for the functions that Minecraft calls the most
+ *
+ * Everything else goes through JNA and the functions in nova.h. JNA works out how to marshal each argument with
+ * reflection on every call, which is fine for things that happen once in a while but too slow for chunk geometry and
+ * input polling. These functions are registered on com.continuum.nova.NovaJNI when Java calls System.loadLibrary on
+ * Nova
+ *
+ * \author gold1
  * \date 19-Jul-17.
  */
 
 #ifndef RENDERER_NOVA_JNI_H
 #define RENDERER_NOVA_JNI_H
 
-#include "../../../../../../Program Files/Java/jdk1.8.0_121/include/jni.h"
-#define DLL_EXPORT
+#include <jni.h>
 #include "../utils/export.h"
 
-#if defined(_WIN32)
-    #define JNICALL __stdcall
-#else
-    #define JNICALL __attribute__((stdcall))
-#endif
-
 extern "C" {
-NOVA_API jobject JNICALL Java_getSharedBuffer(JNIEnv *env, jobject caller);
+/*!
+ * \brief Registers all the native methods of com.continuum.nova.NovaJNI
+ */
+NOVA_API jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved);
 }
 
 #endif //RENDERER_NOVA_JNI_H
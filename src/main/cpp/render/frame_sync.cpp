@@ -0,0 +1,90 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <easylogging++.h>
+#include "frame_sync.h"
+#include "../utils/profiler.h"
+#include "../utils/stats.h"
+
+namespace nova {
+    /*!
+     * \brief How long to wait for the GPU to finish a frame before giving up on it, in nanoseconds
+     */
+    const GLuint64 FRAME_WAIT_TIMEOUT = 1000000000;
+
+    frame_sync::~frame_sync() {
+        for(size_t slot = 0; slot < MAX_FRAMES_IN_FLIGHT; slot++) {
+            wait_for_slot(slot);
+        }
+    }
+
+    size_t frame_sync::begin_frame(int requested_frames_in_flight) {
+        auto new_frames_in_flight = static_cast<size_t>(std::min(std::max(requested_frames_in_flight, 1), static_cast<int>(MAX_FRAMES_IN_FLIGHT)));
+
+        double wait_ms = 0;
+        profiler::start("wait_for_gpu");
+        if(new_frames_in_flight != frames_in_flight) {
+            // The slots are about to be handed out in a different order, so every slot has to be free
+            for(size_t slot = 0; slot < MAX_FRAMES_IN_FLIGHT; slot++) {
+                wait_ms += wait_for_slot(slot);
+            }
+            LOG(INFO) << "Rendering with " << new_frames_in_flight << " frames in flight";
+            frames_in_flight = new_frames_in_flight;
+            frame_slot = 0;
+
+        } else {
+            frame_slot = (frame_slot + 1) % frames_in_flight;
+            wait_ms = wait_for_slot(frame_slot);
+        }
+        profiler::end("wait_for_gpu");
+
+        stats::set("gpu_wait_ms", wait_ms);
+        frame_number++;
+        return frame_slot;
+    }
+
+    void frame_sync::end_frame() {
+        auto& fence = fences[frame_slot];
+        if(fence) {
+            // end_frame was called twice, the new fence covers both
+            glDeleteSync(fence);
+        }
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    size_t frame_sync::get_frame_slot() const {
+        return frame_slot;
+    }
+
+    uint64_t frame_sync::get_frame_number() const {
+        return frame_number;
+    }
+
+    double frame_sync::wait_for_slot(size_t slot) {
+        auto& fence = fences[slot];
+        if(!fence) {
+            return 0;
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        // Check without flushing first, the fence is usually long signalled
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        if(status == GL_TIMEOUT_EXPIRED) {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FRAME_WAIT_TIMEOUT);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        if(status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED) {
+            LOG(WARNING) << "Gave up waiting for the GPU to finish frame slot " << slot << ", its buffers might be overwritten while they're in use";
+        }
+
+        glDeleteSync(fence);
+        fence = nullptr;
+
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+}
@@ -0,0 +1,89 @@
+/*!
+ * \brief Keeps the CPU a few frames ahead of the GPU, without getting so far ahead that it overwrites data the GPU
+ * is still reading
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_FRAME_SYNC_H
+#define RENDERER_FRAME_SYNC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <glad/glad.h>
+
+namespace nova {
+    /*!
+     * \brief The most frames the GPU can be working on while the CPU sets up the next one. Buffers that are split into
+     * one slice per frame in flight have this many slices
+     */
+    const size_t MAX_FRAMES_IN_FLIGHT = 3;
+
+    /*!
+     * \brief Hands out a slot for each frame, and fences each slot so that its resources aren't written while the GPU
+     * is still using them
+     *
+     * Anything that the CPU writes every frame and the GPU reads later - uniforms, streamed vertices - lives in a
+     * buffer with one slice per slot. The frame only writes to its own slot's slice. #begin_frame waits on the fence
+     * from the last frame that used the slot, which is frames_in_flight frames ago, so most of the time the GPU is
+     * long done with it and there's no wait at all.
+     *
+     * With one frame in flight the CPU waits for the GPU every frame. With three, the CPU can be up to three frames
+     * ahead, which hides GPU hitches but adds latency. How long each frame waits goes into the "gpu_wait_ms" stat
+     *
+     * Everything here has to be called on the thread with the OpenGL context
+     */
+    class frame_sync {
+    public:
+        frame_sync() = default;
+
+        frame_sync(const frame_sync& other) = delete;
+        frame_sync& operator=(const frame_sync& other) = delete;
+
+        /*!
+         * \brief Waits for every frame in flight, then deletes the fences
+         */
+        ~frame_sync();
+
+        /*!
+         * \brief Starts a new frame, waiting until the GPU is done with the last frame that used its slot
+         *
+         * \param frames_in_flight How many frames the GPU can be working on. Clamped to [1, MAX_FRAMES_IN_FLIGHT]. If
+         * this changed since the last frame, every frame in flight is waited for so that the slots start over cleanly
+         * \return The slot for this frame
+         */
+        size_t begin_frame(int frames_in_flight);
+
+        /*!
+         * \brief Fences the commands for this frame. Call this after the last command that uses the frame's slot
+         */
+        void end_frame();
+
+        /*!
+         * \brief The slot for the current frame
+         */
+        size_t get_frame_slot() const;
+
+        /*!
+         * \brief How many frames have been started
+         */
+        uint64_t get_frame_number() const;
+
+    private:
+        GLsync fences[MAX_FRAMES_IN_FLIGHT] = {};
+
+        size_t frames_in_flight = 0;
+        size_t frame_slot = 0;
+        uint64_t frame_number = 0;
+
+        /*!
+         * \brief Waits for the fence in the given slot, if there is one, and deletes it
+         *
+         * \return How long the wait took, in milliseconds
+         */
+        double wait_for_slot(size_t slot);
+    };
+}
+
+#endif //RENDERER_FRAME_SYNC_H
@@ -6,6 +6,7 @@
 #include "../utils/utils.h"
 #include "../data_loading/loaders/loaders.h"
 #include "../utils/profiler.h"
+#include "../utils/stats.h"
 
 #include <easylogging++.h>
 #include <glm/gtc/matrix_transform.hpp>
@@ -15,19 +16,41 @@ INITIALIZE_EASYLOGGINGPP
 namespace nova {
     std::unique_ptr<nova_renderer> nova_renderer::instance;
 
+    /*!
+     * \brief How many bytes of commands Java can write before Nova has to process them. Big enough for a frame of GUI
+     * geometry and a few chunks
+     */
+    const uint32_t COMMAND_RING_CAPACITY = 8 * 1024 * 1024;
+
+    const std::string PROGRAM_CACHE_DIRECTORY = "cache/programs";
+
     nova_renderer::nova_renderer() {
         game_window = std::make_unique<glfw_gl_window>();
         enable_debug();
         ubo_manager = std::make_unique<uniform_buffer_store>();
+        gpu_frames = std::make_unique<frame_sync>();
+
+        GLint num_program_binary_formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_program_binary_formats);
+        if(num_program_binary_formats > 0) {
+            program_cache = std::make_unique<program_binary_cache>(PROGRAM_CACHE_DIRECTORY);
+        } else {
+            LOG(INFO) << "The driver can't save program binaries, shaders will be compiled every time they're loaded";
+        }
+
         textures = std::make_unique<texture_manager>();
         meshes = std::make_unique<mesh_store>();
+        jobs = std::make_unique<job_system>();
+        translucent_geometry_sorter = std::make_unique<translucent_sorter>(*jobs);
         inputs = std::make_unique<input_handler>();
+        commands = std::make_unique<command_ring>(COMMAND_RING_CAPACITY);
 		render_settings->register_change_listener(ubo_manager.get());
 		render_settings->register_change_listener(game_window.get());
         render_settings->register_change_listener(this);
+        subscribe_to_settings();
 
         render_settings->update_config_loaded();
-		render_settings->update_config_changed();
+		render_settings->notify_all_subscribers();
 
         LOG(INFO) << "Finished sending out initial config";
 
@@ -54,20 +77,79 @@ namespace nova {
     }
 
     nova_renderer::~nova_renderer() {
+        for(auto subscription : settings_subscriptions) {
+            render_settings->unsubscribe(subscription);
+        }
+
+        commands.reset();
         inputs.reset();
+        translucent_geometry_sorter.reset();
+        jobs.reset();
         meshes.reset();
         textures.reset();
         ubo_manager.reset();
+        gpu_frames.reset();
         game_window.reset();
     }
 
-    void nova_renderer::render_frame() {
+    void nova_renderer::execute_frame() {
+        // Input and window resizes have to be handled on the thread that made the window
+        game_window->poll_events();
+
+        scene_state scene;
+        {
+            std::lock_guard<std::mutex> lock(next_scene_lock);
+            scene = next_scene;
+        }
+        auto command_ring_end = commands->get_write_offset();
+
+        // Whatever input Minecraft has taken so far ends up in this frame
+        auto frame_number = inputs->on_frame_published();
+
+        profiler::start("wait_for_frame");
+        renderer.publish_frame([=]() {
+            render_frame(scene, command_ring_end, frame_number);
+        });
+        profiler::end("wait_for_frame");
+    }
+
+    void nova_renderer::set_player_camera_transform(const glm::vec3& position, const glm::vec2& rotation) {
+        std::lock_guard<std::mutex> lock(next_scene_lock);
+        next_scene.camera_position = position;
+        next_scene.camera_rotation = rotation;
+        next_scene.has_camera = true;
+    }
+
+    void nova_renderer::render_frame(const scene_state& scene, uint64_t command_ring_end, uint64_t frame_number) {
         profiler::log_all_profiler_data();
-        player_camera.recalculate_frustum();
+
+        if(scene.has_camera) {
+            player_camera.position = scene.camera_position;
+            player_camera.rotation = scene.camera_rotation;
+        }
+
+        // Settings changes from the command ring need to be in this frame's snapshot
+        process_commands(command_ring_end);
+
+        frame_settings = render_settings->get_snapshot();
+
+        // Wait until the GPU is done with the buffers this frame is about to write into
+        auto frame_slot = gpu_frames->begin_frame(frame_settings.frames_in_flight);
+        ubo_manager->begin_frame(frame_slot);
+
+        glViewport(0, 0, frame_settings.view_width, frame_settings.view_height);
+        translucent_geometry_sorter->set_resort_distance(frame_settings.translucent_resort_distance);
+        translucent_geometry_sorter->set_max_sorts_per_frame(static_cast<size_t>(std::max(frame_settings.translucent_sorts_per_frame, 0)));
+        ubo_manager->update(frame_settings);
+
+        textures->process_uploads();
 
         // Make geometry for any new chunks
         meshes->upload_new_geometry();
 
+        // Only re-culls if the camera has moved far enough
+        visible_objects.update(player_camera);
+
 
         // upload shadow UBO things
 
@@ -91,7 +173,9 @@ namespace nova {
         // stencil buffer when the GUI screen changes
         render_gui();
 
+        gpu_frames->end_frame();
         game_window->end_frame();
+        inputs->on_frame_presented(frame_number);
     }
 
     void nova_renderer::render_shadow_pass() {
@@ -104,7 +188,8 @@ namespace nova {
         // TODO: Get shaders with gbuffers prefix, draw transparents last, etc
         auto& terrain_shader = loaded_shaderpack->get_shader("gbuffers_terrain");
         render_shader(terrain_shader);
-        auto& water_shader = loaded_shaderpack->get_shader("gbuffers_water");
+        auto& water_shader = loaded_shaderpack->get_shader(TRANSLUCENT_SHADER_NAME);
+        translucent_geometry_sorter->update(player_camera.position, meshes->get_meshes_for_shader(TRANSLUCENT_SHADER_NAME));
         render_shader(water_shader);
     }
 
@@ -129,15 +214,7 @@ namespace nova {
         upload_gui_model_matrix(gui_shader);
 
         // Render GUI objects
-        std::vector<render_object>& gui_geometry = meshes->get_meshes_for_shader("gui");
-        for(const auto& geom : gui_geometry) {
-            if (!geom.color_texture.empty()) {
-                auto color_texture = textures->get_texture(geom.color_texture);
-                color_texture.bind(0);
-            }
-            geom.geometry->set_active();
-            geom.geometry->draw();
-        }
+        meshes->get_gui_batcher().draw(*textures);
     }
 
     bool nova_renderer::should_end() {
@@ -151,6 +228,14 @@ namespace nova {
 		render_settings = std::make_unique<settings>("config/config.json");
 	
 		instance = std::make_unique<nova_renderer>();
+        instance->start_render_thread();
+    }
+
+    void nova_renderer::start_render_thread() {
+        // Everything up to now has set up OpenGL on this thread, from here on only the render thread touches it
+        game_window->release_context();
+        renderer.start([&]() { game_window->make_context_current(); }, [&]() { game_window->release_context(); });
+        LOG(INFO) << "Started the render thread";
     }
 
     std::string translate_debug_source(GLenum source) {
@@ -233,8 +318,25 @@ namespace nova {
         glDebugMessageCallback(debug_logger, nullptr);
     }
 
-    void nova_renderer::on_config_change(nlohmann::json &new_config) {
-		auto& shaderpack_name = new_config["loadedShaderpack"];
+    void nova_renderer::subscribe_to_settings() {
+        // The translucent sorter's settings come from each frame's snapshot, in render_frame. These subscriptions can
+        // run on any thread, so they grab the new values now and hand the work to the render thread
+        settings_subscriptions.push_back(render_settings->subscribe({setting::texture_compression, setting::texture_compression_quality}, [&]() {
+            auto format_name = render_settings->get<setting::texture_compression>();
+            auto quality_name = render_settings->get<setting::texture_compression_quality>();
+            renderer.run_before_next_frame([=]() {
+                update_texture_compression(format_name, quality_name);
+            });
+        }));
+        settings_subscriptions.push_back(render_settings->subscribe({setting::loaded_shaderpack}, [&]() {
+            auto shaderpack_name = render_settings->get<setting::loaded_shaderpack>();
+            renderer.run_before_next_frame([=]() {
+                update_loaded_shaderpack(shaderpack_name);
+            });
+        }));
+    }
+
+    void nova_renderer::update_loaded_shaderpack(const std::string& shaderpack_name) {
         LOG(INFO) << "Shaderpack in settings: " << shaderpack_name;
 
         if(!loaded_shaderpack) {
@@ -252,6 +354,23 @@ namespace nova {
         LOG(DEBUG) << "Finished dealing with possible new shaderpack";
     }
 
+    void nova_renderer::update_texture_compression(const std::string& format_name, const std::string& quality_name) {
+        std::experimental::optional<block_format> format;
+        compression_quality quality = compression_quality::normal;
+        try {
+            if(format_name != "none") {
+                format = block_format::from_string(format_name);
+            }
+            quality = compression_quality::from_string(quality_name);
+
+        } catch(std::exception& e) {
+            LOG(WARNING) << "Texture compression settings (" << format_name << ", " << quality_name << ") aren't valid, textures won't be compressed";
+            format = std::experimental::optional<block_format>();
+        }
+
+        textures->set_texture_compression(format, quality);
+    }
+
     void nova_renderer::on_config_loaded(nlohmann::json &config) {
         // TODO: Probably want to do some setup here, don't need to do that now
     }
@@ -276,10 +395,104 @@ namespace nova {
         return *meshes;
     }
 
+    job_system &nova_renderer::get_job_system() {
+        return *jobs;
+    }
+
+    command_ring &nova_renderer::get_command_ring() {
+        return *commands;
+    }
+
+    render_thread &nova_renderer::get_render_thread() {
+        return renderer;
+    }
+
+    void nova_renderer::process_commands(uint64_t end_offset) {
+        profiler::start("process_commands");
+        auto num_commands = commands->consume([&](command_type type, command_reader& reader) {
+            process_command(type, reader);
+        }, end_offset);
+        stats::set("commands_per_frame", num_commands);
+        profiler::end("process_commands");
+    }
+
+    void nova_renderer::process_command(command_type type, command_reader& reader) {
+        switch(type) {
+            case command_type::add_chunk_geometry:
+            case command_type::remove_chunk_geometry: {
+                mc_chunk_render_object chunk = {};
+                if(type == command_type::add_chunk_geometry) {
+                    chunk.format = reader.read<int32_t>();
+                }
+                chunk.x = reader.read<float>();
+                chunk.y = reader.read<float>();
+                chunk.z = reader.read<float>();
+                chunk.id = reader.read<int32_t>();
+
+                if(type == command_type::remove_chunk_geometry) {
+                    meshes->remove_chunk_render_object(reader.read_string(), chunk);
+                    break;
+                }
+
+                chunk.vertex_buffer_size = reader.read<int32_t>();
+                chunk.index_buffer_size = reader.read<int32_t>();
+                std::string filter_name = reader.read_string();
+                // mesh_store copies the data, so it's fine that it points into the ring
+                chunk.vertex_data = const_cast<int*>(reader.read_array<int32_t>(static_cast<uint32_t>(chunk.vertex_buffer_size)));
+                chunk.indices = const_cast<int*>(reader.read_array<int32_t>(static_cast<uint32_t>(chunk.index_buffer_size)));
+                meshes->add_chunk_render_object(filter_name, chunk);
+                break;
+            }
+
+            case command_type::add_gui_geometry: {
+                mc_gui_geometry geometry = {};
+                geometry.index_buffer_size = reader.read<int32_t>();
+                geometry.vertex_buffer_size = reader.read<int32_t>();
+                geometry.texture_name = reader.read_string();
+                geometry.atlas_name = reader.read_string();
+                geometry.index_buffer = const_cast<int*>(reader.read_array<int32_t>(static_cast<uint32_t>(geometry.index_buffer_size)));
+                geometry.vertex_buffer = const_cast<float*>(reader.read_array<float>(static_cast<uint32_t>(geometry.vertex_buffer_size)));
+                meshes->add_gui_buffers(&geometry);
+                break;
+            }
+
+            case command_type::clear_gui:
+                meshes->remove_gui_render_objects();
+                break;
+
+            case command_type::set_float_setting: {
+                auto value = reader.read<float>();
+                render_settings->set(reader.read_string(), value);
+                break;
+            }
+
+            case command_type::set_string_setting: {
+                std::string name = reader.read_string();
+                render_settings->set(name, std::string(reader.read_string()));
+                break;
+            }
+
+            case command_type::set_camera: {
+                auto x = reader.read<double>();
+                auto y = reader.read<double>();
+                auto z = reader.read<double>();
+                auto yaw = reader.read<float>();
+                auto pitch = reader.read<float>();
+                player_camera.position = {x, y, z};
+                player_camera.rotation = {yaw, pitch};
+                break;
+            }
+
+            default:
+                LOG_EVERY_N(600, WARNING) << "Unknown command type " << static_cast<uint32_t>(type) << ", maybe Java is newer than Nova?";
+                break;
+        }
+    }
+
     void nova_renderer::load_new_shaderpack(const std::string &new_shaderpack_name) {
 		LOG(INFO) << "Loading a new shaderpack";
         LOG(INFO) << "Name of shaderpack " << new_shaderpack_name;
-        loaded_shaderpack = std::make_shared<shaderpack>(load_shaderpack(new_shaderpack_name));
+        loaded_shaderpack = std::make_shared<shaderpack>(load_shaderpack(new_shaderpack_name, program_cache.get(), jobs.get()));
         LOG(DEBUG) << "Shaderpack loaded, wiring everything together";
         LOG(INFO) << "Loading complete";
 		
@@ -293,9 +506,10 @@ namespace nova {
         // TODO: Examine the shaderpack and determine what's needed
         // For now, just create framebuffers with all possible attachments
 
-        auto settings = render_settings->get_options()["settings"];
+        // This runs on the render thread, so it reads the sizes from the latest snapshot rather than the live settings
+        const auto& settings = render_settings->get_snapshot();
 
-        main_framebuffer_builder.set_framebuffer_size(settings["viewWidth"], settings["viewHeight"])
+        main_framebuffer_builder.set_framebuffer_size(settings.view_width, settings.view_height)
                                 .enable_color_attachment(0)
                                 .enable_color_attachment(1)
                                 .enable_color_attachment(2)
@@ -307,7 +521,7 @@ namespace nova {
 
         main_framebuffer = std::make_unique<framebuffer>(main_framebuffer_builder.build());
 
-        shadow_framebuffer_builder.set_framebuffer_size(settings["shadowMapResolution"], settings["shadowMapResolution"])
+        shadow_framebuffer_builder.set_framebuffer_size(settings.shadow_map_resolution, settings.shadow_map_resolution)
                                   .enable_color_attachment(0)
                                   .enable_color_attachment(1)
                                   .enable_color_attachment(2)
@@ -318,6 +532,9 @@ namespace nova {
     }
 
     void nova_renderer::deinit() {
+        // Finish the last frame and take the OpenGL context back, so that everything can be cleaned up on this thread
+        instance->renderer.stop();
+        instance->game_window->make_context_current();
         instance.release();
     }
 
@@ -327,16 +544,18 @@ namespace nova {
         shader.bind();
 
         profiler::start("get_meshes_for_shader");
+        meshes->remove_deleted_render_objects(shader.get_name());
         auto& geometry = meshes->get_meshes_for_shader(shader.get_name());
+        auto geometry_version = meshes->get_geometry_version(shader.get_name());
         profiler::end("get_meshes_for_shader");
+
+        auto& visible_geometry = visible_objects.get_visible_objects(shader.get_name(), geometry, geometry_version);
+
         profiler::start("process_all");
-        for(auto& geom : geometry) {
+        for(auto geometry_index : visible_geometry) {
+            auto& geom = geometry[geometry_index];
             profiler::start("process_renderable");
 
-            // if(!player_camera.has_object_in_frustum(geom.bounding_box)) {
-            //     continue;
-            // }
-
             if(geom.geometry->has_data()) {
                 if(!geom.color_texture.empty()) {
                     auto color_texture = textures->get_texture(geom.color_texture);
@@ -357,19 +576,17 @@ namespace nova {
 
                 profiler::start("drawcall");
                 geom.geometry->set_active();
-                geom.geometry->draw();
+                if(geom.geometry->has_face_buckets()) {
+                    geom.geometry->draw_face_buckets(get_potentially_visible_faces(geom.bounding_box, player_camera.position));
+                } else {
+                    geom.geometry->draw();
+                }
                 profiler::end("drawcall");
             } else {
                 LOG(TRACE) << "Skipping some geometry since it has no data";
             }
             profiler::end("process_renderable");
         }
-        for(int i=0;i<geometry.size();i++){
-            if(geometry[i].needs_deletion){
-                geometry.erase( geometry.begin()+i);
-                i--;
-            }
-        }
         profiler::end("process_all");
 
         profiler::end(shader.get_name());
@@ -383,10 +600,9 @@ namespace nova {
     }
 
     void nova_renderer::upload_gui_model_matrix(gl_shader_program &program) {
-        auto config = render_settings->get_options()["settings"];
-        float view_width = config["viewWidth"];
-        float view_height = config["viewHeight"];
-        float scalefactor = config["scalefactor"];
+        auto view_width = static_cast<float>(frame_settings.view_width);
+        auto view_height = static_cast<float>(frame_settings.view_height);
+        float scalefactor = frame_settings.scalefactor;
         // The GUI matrix is super simple, just a viewport transformation
         glm::mat4 gui_model(1.0f);
         gui_model = glm::translate(gui_model, glm::vec3(-1.0f, 1.0f, 0.0f));
@@ -402,13 +618,12 @@ namespace nova {
     void nova_renderer::update_gbuffer_ubos() {
         // Big thing here is to update the camera's matrices
 
+        // Only written if the camera moved
         auto& per_frame_ubo = ubo_manager->get_per_frame_uniforms();
+        per_frame_ubo.set(&per_frame_uniforms::gbufferProjection, player_camera.get_projection_matrix());
+        per_frame_ubo.set(&per_frame_uniforms::gbufferModelView, player_camera.get_view_matrix());
 
-        auto per_frame_uniform_data = per_frame_uniforms{};
-        per_frame_uniform_data.gbufferProjection = player_camera.get_projection_matrix();
-        per_frame_uniform_data.gbufferModelView = player_camera.get_view_matrix();
-
-        per_frame_ubo.send_data(per_frame_uniform_data);
+        ubo_manager->upload();
     }
 
     camera &nova_renderer::get_player_camera() {
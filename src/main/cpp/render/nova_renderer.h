@@ -15,6 +15,13 @@
 #include "../input/InputHandler.h"
 #include "objects/framebuffer.h"
 #include "objects/camera.h"
+#include "visibility_cache.h"
+#include "../geometry_cache/translucent_sorter.h"
+#include "../utils/job_system.h"
+#include "../data_loading/command_ring.h"
+#include "render_thread.h"
+#include "frame_sync.h"
+#include "objects/shaders/program_binary_cache.h"
 
 namespace nova {
     /*!
@@ -59,13 +66,18 @@ namespace nova {
         ~nova_renderer();
 
         /*!
-         * \brief Renders a single frame
+         * \brief Hands the next frame to the render thread
          *
-         * This method runs in a separate thread from the rest of the methods in this class. This is because the other
-         * methods are called by Minecraft, from the Minecraft thread, while this method is run in a separate thread. This
-         * is done to keep the OpenGL contexts separate. Hopefully it'll work
+         * Called by Minecraft once per frame. This polls the window, waits for the last frame to finish, then publishes
+         * the scene state that Minecraft has set up since the last call. The frame is rendered while Minecraft goes on
+         * to the next tick
          */
-        void render_frame();
+        void execute_frame();
+
+        /*!
+         * \brief Sets where the camera will be for the next frame that's published. Can be called from any thread
+         */
+        void set_player_camera_transform(const glm::vec3& position, const glm::vec2& rotation);
 
         /*!
          * \brief determines whether or not the Nova Renderer, and by extension Minecraft, should shut down. Called directly
@@ -85,14 +97,35 @@ namespace nova {
 
         mesh_store& get_mesh_store();
 
+        /*!
+         * \brief The camera that the render thread renders from. Only touch it on the render thread, use
+         * #set_player_camera_transform everywhere else
+         */
         camera& get_player_camera();
 
+        job_system& get_job_system();
+
+        command_ring& get_command_ring();
+
+        /*!
+         * \brief The thread that owns the OpenGL context. Anything that calls OpenGL has to go through here
+         */
+        render_thread& get_render_thread();
+
+        /*!
+         * \brief Does everything that Java has written into the command ring, up to the given offset
+         *
+         * This runs at the start of every frame, and Java calls it when the ring is too full for its next command. It
+         * has to run on the render thread
+         *
+         * \param end_offset Where to stop reading commands. Commands written after this are left for the next call
+         */
+        void process_commands(uint64_t end_offset);
+
         std::shared_ptr<shaderpack> get_shaders();
 
         // Overrides from iconfig_listener
 
-        void on_config_change(nlohmann::json& new_config);
-
         void on_config_loaded(nlohmann::json& config);
 
     private:
@@ -109,8 +142,43 @@ namespace nova {
 
         std::unique_ptr<mesh_store> meshes;
 
+        std::unique_ptr<job_system> jobs;
+
+        std::unique_ptr<command_ring> commands;
+
+        render_thread renderer;
+
+        /*!
+         * \brief The parts of the scene that Minecraft sets straight through the API, rather than through a subsystem
+         * that's already safe to call from the game thread
+         */
+        struct scene_state {
+            glm::vec3 camera_position;
+            glm::vec2 camera_rotation;
+            bool has_camera = false;
+        };
+
+        /*!
+         * \brief The scene state for the next frame. Copied out when the frame is published, so the render thread has
+         * its own copy while the game thread fills this one in again
+         */
+        scene_state next_scene;
+        std::mutex next_scene_lock;
+
+        std::unique_ptr<translucent_sorter> translucent_geometry_sorter;
+
         std::unique_ptr<uniform_buffer_store> ubo_manager;
 
+        /*!
+         * \brief Keeps the render thread from getting too far ahead of the GPU
+         */
+        std::unique_ptr<frame_sync> gpu_frames;
+
+        /*!
+         * \brief Linked shader programs from earlier runs. nullptr if the driver can't give back program binaries
+         */
+        std::unique_ptr<program_binary_cache> program_cache;
+
         std::vector<GLuint> shadow_depth_textures;
         std::unique_ptr<framebuffer> shadow_framebuffer;
         framebuffer_builder shadow_framebuffer_builder;
@@ -121,11 +189,27 @@ namespace nova {
 
         camera player_camera;
 
+        visibility_cache visible_objects;
+
         /*!
          * \brief Renders the GUI of Minecraft
          */
         void render_gui();
 
+        /*!
+         * \brief Renders a single frame. Runs on the render thread
+         *
+         * \param scene The scene state that was published with this frame
+         * \param command_ring_end How far into the command ring Java had written when this frame was published
+         * \param frame_number The input handler's number for this frame, so input latency is measured to its present
+         */
+        void render_frame(const scene_state& scene, uint64_t command_ring_end, uint64_t frame_number);
+
+        /*!
+         * \brief Lets go of the OpenGL context on this thread and starts the render thread, which picks it up
+         */
+        void start_render_thread();
+
         void render_shadow_pass();
 
         void render_gbuffers();
@@ -154,6 +238,33 @@ namespace nova {
         void upload_model_matrix(render_object &geom, gl_shader_program &program) const;
 
         void update_gbuffer_ubos();
+
+        /*!
+         * \brief Does a single command from the command ring
+         */
+        void process_command(command_type type, command_reader& reader);
+
+        std::vector<settings::subscription_id> settings_subscriptions;
+
+        /*!
+         * \brief The settings for the frame being rendered, so that they don't change halfway through the frame
+         */
+        settings_snapshot frame_settings = {};
+
+        /*!
+         * \brief Subscribes to the settings that the renderer itself cares about
+         */
+        void subscribe_to_settings();
+
+        /*!
+         * \brief Loads the given shaderpack, if it isn't the one that's already loaded
+         */
+        void update_loaded_shaderpack(const std::string& shaderpack_name);
+
+        /*!
+         * \brief Hands the texture compression format and quality from the settings to the texture manager
+         */
+        void update_texture_compression(const std::string& format_name, const std::string& quality_name);
     };
 
     void link_up_uniform_buffers(std::unordered_map<std::string, gl_shader_program> &shaders, uniform_buffer_store &ubos);
@@ -6,6 +6,8 @@
 #include "camera.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <utility>
+#include <algorithm>
+#include <cmath>
 
 namespace nova {
     glm::mat4& camera::get_projection_matrix() {
@@ -37,13 +39,42 @@ namespace nova {
     }
 
     void camera::recalculate_frustum() {
-        glm::mat4 proj = get_projection_matrix();
-        glm::mat4 modl = get_view_matrix();
-        glm::mat4 clip;
+        extract_frustum_planes(get_projection_matrix() * get_view_matrix());
+    }
 
-        float t;
+    void camera::recalculate_frustum(float position_margin, float angle_margin) {
+        // Widen the vertical FOV directly, and widen the horizontal FOV by adjusting the aspect ratio so that the
+        // horizontal half-angle grows by the same amount
+        float half_fov_y = glm::radians(fov) / 2.0f;
+        float half_fov_x = std::atan(std::tan(half_fov_y) * aspect_ratio);
+        float margin = glm::radians(angle_margin);
+
+        float max_half_angle = glm::radians(89.0f);
+        float widened_half_fov_y = std::min(half_fov_y + margin, max_half_angle);
+        float widened_half_fov_x = std::min(half_fov_x + margin, max_half_angle);
+        float widened_aspect_ratio = std::tan(widened_half_fov_x) / std::tan(widened_half_fov_y);
+
+        glm::mat4 widened_projection = glm::perspective(widened_half_fov_y * 2.0f, widened_aspect_ratio, near_plane, far_plane);
+        extract_frustum_planes(widened_projection * get_view_matrix());
+
+        // Turning the camera swings the corners of the far plane past the old far plane, and the near plane past the
+        // old near plane. Nothing the camera can see is further away than the corners of its far plane, however it's
+        // turned, so the far plane goes out to there. The near plane goes back to the camera itself
+        float far_corner_distance = far_plane * std::sqrt(1.0f + std::tan(half_fov_x) * std::tan(half_fov_x) + std::tan(half_fov_y) * std::tan(half_fov_y));
+        glm::vec3 forward = {frustum[5][0], frustum[5][1], frustum[5][2]};
+        float forward_distance = glm::dot(forward, position);
+
+        frustum[4][3] = forward_distance + far_corner_distance;
+        frustum[5][3] = -forward_distance;
+
+        // The planes are normalized, so their distance term is in world units
+        for(auto& plane : frustum) {
+            plane[3] += position_margin;
+        }
+    }
 
-        clip = proj * modl;
+    void camera::extract_frustum_planes(const glm::mat4& clip) {
+        float t;
 
         /* Extract the numbers for the RIGHT plane */
         frustum[0][0] = clip[0][3] - clip[0][0];
@@ -157,4 +188,14 @@ namespace nova {
         }
         return true;
     }
+
+    bool camera::has_sphere_in_frustum(const sphere& bounding_sphere) const {
+        const glm::vec3& c = bounding_sphere.center;
+        for(const auto& plane : frustum) {
+            if(plane[0] * c.x + plane[1] * c.y + plane[2] * c.z + plane[3] < -bounding_sphere.radius) {
+                return false;
+            }
+        }
+        return true;
+    }
 }
@@ -8,6 +8,7 @@
 
 #include <glm/glm.hpp>
 #include "../../data_loading/physics/aabb.h"
+#include "../../data_loading/physics/sphere.h"
 
 namespace nova {
     /*!
@@ -30,14 +31,37 @@ namespace nova {
 
         void recalculate_frustum();
 
+        /*!
+         * \brief Recalculates the frustum, widened so that it still contains everything the camera could see after
+         * moving or turning by a bounded amount
+         *
+         * Every plane is pushed outwards by position_margin, and the field of view is widened by angle_margin degrees
+         * on each side. The far plane is moved out to the corners of the far plane and the near plane back to the
+         * camera, since turning swings those corners past both of them. A camera that moves at most position_margin blocks and turns at most angle_margin degrees
+         * (yaw and pitch combined) never sees anything outside this "guard band" frustum
+         *
+         * \param position_margin How far, in blocks, to push the planes outwards
+         * \param angle_margin How many degrees to widen the field of view by on each side
+         */
+        void recalculate_frustum(float position_margin, float angle_margin);
+
         bool has_object_in_frustum(aabb& bounding_box);
 
+        /*!
+         * \brief Checks if a sphere is at least partially inside the frustum
+         *
+         * Cheaper than the AABB check, so it's a good way to throw out things that are nowhere near the frustum
+         */
+        bool has_sphere_in_frustum(const sphere& bounding_sphere) const;
+
     private:
-        bool projection_matrix_is_dirty;
+        bool projection_matrix_is_dirty = true;
 
         glm::mat4 projection_matrix;
 
         float frustum[6][4];
+
+        void extract_frustum_planes(const glm::mat4& clip);
     };
 }
 
@@ -13,7 +13,7 @@ namespace nova {
         create();
     }
 
-    gl_mesh::gl_mesh(const mesh_definition &definition) {
+    gl_mesh::gl_mesh(const mesh_definition &definition) : face_buckets(definition.face_buckets) {
         create();
         set_data(definition.vertex_data, definition.vertex_format, usage::static_draw);
         set_index_array(definition.indices, usage::static_draw);
@@ -81,10 +81,63 @@ namespace nova {
         num_indices = (unsigned int) data.size();
     }
 
+    void gl_mesh::update_index_array(const std::vector<int>& data) {
+        if(data.size() != num_indices) {
+            LOG(ERROR) << "Tried to replace " << num_indices << " indices with " << data.size() << " indices, ignoring";
+            return;
+        }
+
+        glNamedBufferSubData(indices, 0, data.size() * sizeof(unsigned int), data.data());
+    }
+
     void gl_mesh::draw() const {
         glDrawElements(GL_TRIANGLES, num_indices, GL_UNSIGNED_INT, nullptr);
     }
 
+    void gl_mesh::draw_face_buckets(uint8_t visible_faces) const {
+        if(!face_buckets) {
+            draw();
+            return;
+        }
+
+        std::array<GLsizei, NUM_FACE_DIRECTIONS> counts;
+        std::array<const void*, NUM_FACE_DIRECTIONS> offsets;
+        GLsizei num_draws = 0;
+        bool last_bucket_was_drawn = false;
+
+        for(size_t direction = 0; direction < NUM_FACE_DIRECTIONS; direction++) {
+            const auto& range = (*face_buckets)[direction];
+            if(range.num_indices == 0) {
+                // Empty buckets don't break up a run, since the buckets on either side of them are still adjacent
+                continue;
+            }
+
+            if((visible_faces & (1 << direction)) == 0) {
+                last_bucket_was_drawn = false;
+                continue;
+            }
+
+            if(last_bucket_was_drawn) {
+                counts[num_draws - 1] += range.num_indices;
+            } else {
+                counts[num_draws] = range.num_indices;
+                offsets[num_draws] = reinterpret_cast<const void*>(range.first_index * sizeof(unsigned int));
+                num_draws++;
+            }
+            last_bucket_was_drawn = true;
+        }
+
+        if(num_draws == 1) {
+            glDrawElements(GL_TRIANGLES, counts[0], GL_UNSIGNED_INT, offsets[0]);
+        } else if(num_draws > 1) {
+            glMultiDrawElements(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, offsets.data(), num_draws);
+        }
+    }
+
+    bool gl_mesh::has_face_buckets() const {
+        return static_cast<bool>(face_buckets);
+    }
+
     void gl_mesh::enable_vertex_attributes(format data_format) {
         switch(data_format) {
             case format::POS:
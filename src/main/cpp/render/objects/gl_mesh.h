@@ -55,10 +55,29 @@ namespace nova {
 
         void set_index_array(std::vector<int> data, usage data_usage);
 
+        /*!
+         * \brief Overwrites the contents of the index buffer without reallocating it
+         *
+         * \param data The new indices. Must be the same number of indices as the index buffer already has
+         */
+        void update_index_array(const std::vector<int>& data);
+
         void set_active() const;
 
         void draw() const;
 
+        /*!
+         * \brief Draws only the face buckets that are set in visible_faces
+         *
+         * Buckets that are next to each other in the index buffer are merged, and everything is drawn with a single
+         * draw call. If this mesh doesn't have face buckets, the whole mesh is drawn
+         *
+         * \param visible_faces A bitmask with bit N set if the bucket for face_direction N should be drawn
+         */
+        void draw_face_buckets(uint8_t visible_faces) const;
+
+        bool has_face_buckets() const;
+
         /*!
          * \brief Returns the format of this vertex buffer
          *
@@ -85,6 +104,8 @@ namespace nova {
 
         unsigned int vertex_array;
         unsigned int num_indices;
+
+        std::experimental::optional<face_bucket_ranges> face_buckets;
     };
 }
 
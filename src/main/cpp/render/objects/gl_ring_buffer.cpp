@@ -0,0 +1,115 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <easylogging++.h>
+#include "gl_ring_buffer.h"
+
+namespace nova {
+    frame_slice_allocator::frame_slice_allocator(size_t slice_size, size_t alignment) : alignment(alignment) {
+        // Round the slices up too, so that every slice starts on the alignment
+        this->slice_size = (slice_size + alignment - 1) & ~(alignment - 1);
+    }
+
+    bool frame_slice_allocator::reserve(size_t num_bytes, size_t& slice_offset) {
+        if(slice_used > reserved_size || num_bytes > slice_size - reserved_size) {
+            return false;
+        }
+
+        slice_offset = reserved_size;
+        reserved_size = std::min(slice_size, (reserved_size + num_bytes + alignment - 1) & ~(alignment - 1));
+        slice_used = reserved_size;
+        return true;
+    }
+
+    void frame_slice_allocator::begin_frame(size_t frame_slot) {
+        slice_start = (frame_slot % MAX_FRAMES_IN_FLIGHT) * slice_size;
+        slice_used = reserved_size;
+    }
+
+    bool frame_slice_allocator::allocate(size_t num_bytes, size_t& offset) {
+        if(num_bytes > slice_size - slice_used) {
+            return false;
+        }
+
+        offset = slice_start + slice_used;
+        slice_used = std::min(slice_size, (slice_used + num_bytes + alignment - 1) & ~(alignment - 1));
+        return true;
+    }
+
+    size_t frame_slice_allocator::get_slice_size() const {
+        return slice_size;
+    }
+
+    size_t frame_slice_allocator::get_slice_start() const {
+        return slice_start;
+    }
+
+    size_t frame_slice_allocator::get_num_bytes_used() const {
+        return slice_used;
+    }
+
+    gl_ring_buffer::gl_ring_buffer(size_t slice_size, size_t alignment) : slices(slice_size, alignment) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        auto buffer_size = static_cast<GLsizeiptr>(slices.get_slice_size() * MAX_FRAMES_IN_FLIGHT);
+
+        glCreateBuffers(1, &gl_name);
+        glNamedBufferStorage(gl_name, buffer_size, nullptr, flags);
+        mapped_memory = static_cast<uint8_t*>(glMapNamedBufferRange(gl_name, 0, buffer_size, flags));
+
+        LOG(DEBUG) << "Created a ring buffer with " << MAX_FRAMES_IN_FLIGHT << " slices of " << slices.get_slice_size() << " bytes";
+    }
+
+    gl_ring_buffer::~gl_ring_buffer() {
+        if(gl_name != 0) {
+            glUnmapNamedBuffer(gl_name);
+            glDeleteBuffers(1, &gl_name);
+        }
+    }
+
+    bool gl_ring_buffer::reserve(size_t num_bytes, size_t& slice_offset) {
+        return slices.reserve(num_bytes, slice_offset);
+    }
+
+    void gl_ring_buffer::begin_frame(size_t frame_slot) {
+        this->frame_slot = frame_slot;
+        slices.begin_frame(frame_slot);
+    }
+
+    size_t gl_ring_buffer::get_frame_slot() const {
+        return frame_slot;
+    }
+
+    size_t gl_ring_buffer::get_reserved_offset(size_t slice_offset) const {
+        return slices.get_slice_start() + slice_offset;
+    }
+
+    uint8_t* gl_ring_buffer::get_memory(size_t offset) {
+        return mapped_memory + offset;
+    }
+
+    bool gl_ring_buffer::write(const void* data, size_t num_bytes, size_t& offset) {
+        auto* destination = allocate(num_bytes, offset);
+        if(destination == nullptr) {
+            return false;
+        }
+
+        std::memcpy(destination, data, num_bytes);
+        return true;
+    }
+
+    uint8_t* gl_ring_buffer::allocate(size_t num_bytes, size_t& offset) {
+        if(mapped_memory == nullptr || !slices.allocate(num_bytes, offset)) {
+            return nullptr;
+        }
+
+        return mapped_memory + offset;
+    }
+
+    GLuint gl_ring_buffer::get_gl_name() const {
+        return gl_name;
+    }
+}
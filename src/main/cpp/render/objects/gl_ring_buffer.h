@@ -0,0 +1,164 @@
+/*!
+ * \brief A persistently mapped buffer for data that the CPU writes every frame
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_GL_RING_BUFFER_H
+#define RENDERER_GL_RING_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <glad/glad.h>
+#include "../frame_sync.h"
+
+namespace nova {
+    /*!
+     * \brief Hands out space in one slice of a buffer that's split into one slice per frame in flight
+     *
+     * This is only the bookkeeping, so that it can be used without an OpenGL context
+     */
+    class frame_slice_allocator {
+    public:
+        /*!
+         * \param slice_size The size of each slice, in bytes
+         * \param alignment Every allocation starts on a multiple of this many bytes. Must be a power of two
+         */
+        frame_slice_allocator(size_t slice_size, size_t alignment);
+
+        /*!
+         * \brief Sets aside room at the same place in every slice, for data that stays around from frame to frame
+         *
+         * Something that's mostly the same every frame can keep a copy in each slice, and only write the parts of the
+         * current slice's copy that are out of date. Reserved room is never handed out by #allocate. Reserve everything
+         * before allocating anything
+         *
+         * \param num_bytes How much room to set aside
+         * \param slice_offset Where the room starts, from the start of each slice
+         * \return False if there isn't enough room, or if something has already been allocated this frame
+         */
+        bool reserve(size_t num_bytes, size_t& slice_offset);
+
+        /*!
+         * \brief Frees everything that was allocated in the given slot's slice and starts allocating from it
+         *
+         * \param frame_slot The slot from frame_sync#begin_frame
+         */
+        void begin_frame(size_t frame_slot);
+
+        /*!
+         * \brief Finds room in the current slice
+         *
+         * \param num_bytes How much room to find
+         * \param offset Where the room starts, from the start of the whole buffer
+         * \return True if there's room, false if the slice is too full
+         */
+        bool allocate(size_t num_bytes, size_t& offset);
+
+        size_t get_slice_size() const;
+
+        /*!
+         * \brief Where the current slice starts, from the start of the whole buffer
+         */
+        size_t get_slice_start() const;
+
+        /*!
+         * \brief How many bytes of the current slice have been handed out, alignment included
+         */
+        size_t get_num_bytes_used() const;
+
+    private:
+        size_t slice_size;
+        size_t alignment;
+
+        size_t slice_start = 0;
+        size_t slice_used = 0;
+
+        /*!
+         * \brief How much room at the start of each slice has been reserved
+         */
+        size_t reserved_size = 0;
+    };
+
+    /*!
+     * \brief A persistently mapped buffer, split into one slice for each frame in flight
+     *
+     * Each frame writes its data into its own slice, and binds the parts it wrote with glBindBufferRange. Since
+     * frame_sync#begin_frame makes sure the GPU is done with a slot before the slot gets reused, writing into the
+     * buffer never makes the CPU wait for the GPU, unlike glNamedBufferSubData on a buffer the GPU is reading.
+     *
+     * Data only lasts for the frame it was written in, so anything that the GPU reads every frame has to be written
+     * every frame. That's why GUI geometry and texture uploads don't go through here: the GUI draws last frame's
+     * geometry again when nothing changed, and an upload can take more than a frame to finish, so both keep their own
+     * fenced buffers. Everything here has to be called on the thread with the OpenGL context
+     */
+    class gl_ring_buffer {
+    public:
+        /*!
+         * \param slice_size How many bytes each frame can write
+         * \param alignment Every allocation starts on a multiple of this many bytes, like
+         * GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT for uniform buffers
+         */
+        gl_ring_buffer(size_t slice_size, size_t alignment);
+
+        gl_ring_buffer(const gl_ring_buffer& other) = delete;
+        gl_ring_buffer& operator=(const gl_ring_buffer& other) = delete;
+
+        ~gl_ring_buffer();
+
+        /*!
+         * \brief Sets aside room at the same place in every slice. See frame_slice_allocator#reserve
+         */
+        bool reserve(size_t num_bytes, size_t& slice_offset);
+
+        /*!
+         * \brief Starts writing into the given slot's slice
+         */
+        void begin_frame(size_t frame_slot);
+
+        /*!
+         * \brief The slot that was passed to the last #begin_frame
+         */
+        size_t get_frame_slot() const;
+
+        /*!
+         * \brief Turns an offset from #reserve into an offset in the current slice
+         */
+        size_t get_reserved_offset(size_t slice_offset) const;
+
+        /*!
+         * \brief The mapped memory at the given offset from the start of the buffer
+         */
+        uint8_t* get_memory(size_t offset);
+
+        /*!
+         * \brief Copies some data into the current slice
+         *
+         * \param data The data to copy
+         * \param num_bytes How much data there is
+         * \param offset Where the data ended up, from the start of the buffer
+         * \return False if the slice is too full. Nothing is written in that case
+         */
+        bool write(const void* data, size_t num_bytes, size_t& offset);
+
+        /*!
+         * \brief Finds room in the current slice, for data that's easier to write in place
+         *
+         * \return Where to write the data, or nullptr if the slice is too full
+         */
+        uint8_t* allocate(size_t num_bytes, size_t& offset);
+
+        GLuint get_gl_name() const;
+
+    private:
+        frame_slice_allocator slices;
+
+        GLuint gl_name = 0;
+        uint8_t* mapped_memory = nullptr;
+
+        size_t frame_slot = 0;
+    };
+}
+
+#endif //RENDERER_GL_RING_BUFFER_H
@@ -13,6 +13,8 @@ namespace nova {
         normalmap = std::move(other.normalmap);
         data_texture = std::move(other.data_texture);
         bounding_box = std::move(other.bounding_box);
+        bounding_sphere = other.bounding_sphere;
+        translucent_data = std::move(other.translucent_data);
         needs_deletion=std::move(other.needs_deletion);
         position = other.position;
 
@@ -31,6 +33,8 @@ namespace nova {
         normalmap = std::move(other.normalmap);
         data_texture = std::move(other.data_texture);
         bounding_box = std::move(other.bounding_box);
+        bounding_sphere = other.bounding_sphere;
+        translucent_data = std::move(other.translucent_data);
         position = other.position;
         needs_deletion=std::move(other.needs_deletion);
 
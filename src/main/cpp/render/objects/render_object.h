@@ -13,6 +13,8 @@
 #include <optional.hpp>
 
 #include "gl_mesh.h"
+#include "../../data_loading/physics/sphere.h"
+#include "../../geometry_cache/translucent_sorter.h"
 #include "../../utils/smart_enum.h"
 #include "textures/texture_manager.h"
 
@@ -80,6 +82,13 @@ namespace nova {
 
         aabb bounding_box;
 
+        sphere bounding_sphere;
+
+        /*!
+         * \brief The data needed to sort this object's quads back-to-front, if it's translucent
+         */
+        std::shared_ptr<translucent_geometry> translucent_data;
+
         bool needs_deletion;
 
         render_object() = default;
@@ -3,23 +3,60 @@
  * \date 17-May-16.
  */
 
+#include <cctype>
 #include <cstdlib>
 #include <algorithm>
+#include <chrono>
+#include <sstream>
 
 #include <easylogging++.h>
 #include "gl_shader_program.h"
 
 namespace nova {
-    gl_shader_program::gl_shader_program(const shader_definition &source) : name(source.name) {
+    /*!
+     * \brief Everything about the driver that can make it give back a different program binary
+     */
+    std::string get_driver_description() {
+        std::string description;
+        for(GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION}) {
+            auto value = glGetString(name);
+            if(value != nullptr) {
+                description += reinterpret_cast<const char*>(value);
+            }
+            description += "\n";
+        }
+        return description;
+    }
+
+    gl_shader_program::gl_shader_program(const shader_definition &source, program_binary_cache* cache) : name(source.name) {
         LOG(TRACE) << "Creating shader with filter expression " << source.filter_expression;
         filter = source.filter_expression;
         LOG(TRACE) << "Created filter expression " << filter;
+
+        const auto& vertex_source = get_full_source(source.vertex_source);
+        const auto& fragment_source = get_full_source(source.fragment_source);
+
+        uint64_t cache_key = 0;
+        if(cache != nullptr) {
+            cache_key = program_binary_cache::make_key({vertex_source, fragment_source}, get_driver_description());
+            if(load_from_cache(*cache, cache_key)) {
+                return;
+            }
+        }
+
+        auto compile_start = std::chrono::high_resolution_clock::now();
+
         create_shader(source.vertex_source, GL_VERTEX_SHADER);
         LOG(TRACE) << "Creatd vertex shader";
         create_shader(source.fragment_source, GL_FRAGMENT_SHADER);
         LOG(TRACE) << "Created fragment shader";
 
-        link();
+        link(cache != nullptr);
+
+        if(cache != nullptr) {
+            auto compile_end = std::chrono::high_resolution_clock::now();
+            save_to_cache(*cache, cache_key, std::chrono::duration<double, std::milli>(compile_end - compile_start).count());
+        }
     }
 
     gl_shader_program::gl_shader_program(gl_shader_program &&other) noexcept :
@@ -32,7 +69,7 @@ namespace nova {
         other.added_shaders.clear();
     }
 
-    void gl_shader_program::link() {
+    void gl_shader_program::link(bool retrievable) {
         gl_name = glCreateProgram();
         glObjectLabel(GL_PROGRAM, gl_name, (GLsizei) name.length(), name.c_str());
         LOG(TRACE) << "Created shader program " << gl_name;
@@ -41,6 +78,11 @@ namespace nova {
             glAttachShader(gl_name, shader);
         }
 
+        if(retrievable) {
+            // Lets the driver know that we'll ask for the binary, so it can keep it around
+            glProgramParameteri(gl_name, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+
         glLinkProgram(gl_name);
         check_for_linking_errors();
 
@@ -55,7 +97,7 @@ namespace nova {
         LOG(DEBUG) << "Cleaned up resources";
     }
 
-    void gl_shader_program::check_for_shader_errors(GLuint shader_to_check, const std::vector<shader_line>& line_map) {
+    void gl_shader_program::check_for_shader_errors(GLuint shader_to_check, const shader_source& source) {
         GLint success = 0;
 
         glGetShaderiv(shader_to_check, GL_COMPILE_STATUS, &success);
@@ -70,7 +112,7 @@ namespace nova {
             if(log_size > 0) {
                 glDeleteShader(shader_to_check);
                 LOG(ERROR) << error_log.data();
-                throw compilation_error(error_log.data(), line_map);
+                throw compilation_error(error_log.data(), source);
             }
         }
     }
@@ -108,37 +150,84 @@ namespace nova {
         //glDeleteProgram(gl_name);
     }
 
-    void gl_shader_program::create_shader(const std::vector<shader_line>& shader_source, const GLenum shader_type) {
-        LOG(TRACE) << "Creating a shader from source\n" << shader_source;
+    const std::string& gl_shader_program::get_full_source(const shader_source& source) {
+        // Listing the whole shader isn't free, so only do it when someone will see it
+        if(el::Loggers::getLogger("default")->typedConfigurations()->enabled(el::Level::Trace)) {
+            LOG(TRACE) << "Creating a shader from source\n" << source;
+        }
 
-        std::string full_shader_source;
-        auto& version_line = shader_source[0].line;
+        auto version_line = source.empty() ? "" : source.get_line(0);
         LOG(TRACE) << "Version line: '" << version_line << "'";
 
-        if(version_line == "#version 450") {
-            // GLSL 450 code! This is the simplest: just concatenate all the lines in the shader file
-            std::for_each(
-                    std::begin(shader_source), std::end(shader_source),
-                    [&](auto &line) { full_shader_source.append(line.line + "\n"); }
-            );
-
-        } else {
-            throw wrong_shader_version(shader_source[0].line);
+        if(version_line != "#version 450") {
+            throw wrong_shader_version(version_line);
         }
 
+        // GLSL 450 code! This is the simplest: the lines of the shader are already one string
+        return source.get_text();
+    }
+
+    void gl_shader_program::create_shader(const shader_source& source, const GLenum shader_type) {
         auto shader_name = glCreateShader(shader_type);
 
-        const char *shader_source_char = full_shader_source.c_str();
+        const auto& full_shader_source = source.get_text();
+        const char *shader_source_char = full_shader_source.data();
+        auto shader_source_length = static_cast<GLint>(full_shader_source.size());
 
-        glShaderSource(shader_name, 1, &shader_source_char, nullptr);
+        glShaderSource(shader_name, 1, &shader_source_char, &shader_source_length);
 
         glCompileShader(shader_name);
 
-        check_for_shader_errors(shader_name, shader_source);
+        check_for_shader_errors(shader_name, source);
 
         added_shaders.push_back(shader_name);
     }
 
+    bool gl_shader_program::load_from_cache(program_binary_cache& cache, uint64_t cache_key) {
+        auto load_start = std::chrono::high_resolution_clock::now();
+
+        auto cached = cache.load(cache_key);
+        if(!cached) {
+            return false;
+        }
+
+        gl_name = glCreateProgram();
+        glObjectLabel(GL_PROGRAM, gl_name, (GLsizei) name.length(), name.c_str());
+        glProgramBinary(gl_name, cached->format, cached->binary, (GLsizei) cached->binary_size);
+
+        GLint is_linked = 0;
+        glGetProgramiv(gl_name, GL_LINK_STATUS, &is_linked);
+        if(is_linked == GL_FALSE) {
+            LOG(INFO) << "The driver would not load the cached binary of program " << name << ", compiling it instead";
+            glDeleteProgram(gl_name);
+            gl_name = 0;
+            cache.reject(cache_key);
+            return false;
+        }
+
+        auto load_end = std::chrono::high_resolution_clock::now();
+        double load_ms = std::chrono::duration<double, std::milli>(load_end - load_start).count();
+        cache.add_time_saved(std::max(cached->compile_ms - load_ms, 0.0));
+
+        LOG(DEBUG) << "Loaded program " << name << " from the program cache in " << load_ms << "ms";
+        return true;
+    }
+
+    void gl_shader_program::save_to_cache(program_binary_cache& cache, uint64_t cache_key, double compile_ms) {
+        GLint binary_length = 0;
+        glGetProgramiv(gl_name, GL_PROGRAM_BINARY_LENGTH, &binary_length);
+        if(binary_length <= 0) {
+            // The driver doesn't support any binary formats
+            return;
+        }
+
+        std::vector<uint8_t> binary(static_cast<size_t>(binary_length));
+        GLenum format = 0;
+        glGetProgramBinary(gl_name, binary_length, &binary_length, &format, binary.data());
+
+        cache.store(cache_key, format, binary.data(), static_cast<size_t>(binary_length), compile_ms);
+    }
+
     std::string & gl_shader_program::get_filter() noexcept {
         return filter;
     }
@@ -161,13 +250,71 @@ namespace nova {
                     "Invalid version line: '" + version_line + "'. Please only use GLSL version 450 (NOT compatibility profile)"
             ) {}
 
-    compilation_error::compilation_error(const std::string &error_message,
-                                         const std::vector<shader_line> source_lines) :
-            std::runtime_error(error_message + get_original_line_message(error_message, source_lines)) {}
+    compilation_error::compilation_error(const std::string &error_message, const shader_source &source) :
+            std::runtime_error(error_message + get_original_line_message(error_message, source)) {}
+
+    /*!
+     * \brief Reads a number from the text, starting at pos
+     *
+     * \return True if there was a number there. pos is moved past it
+     */
+    bool read_number(const std::string &text, size_t &pos, size_t &number) {
+        auto start = pos;
+        number = 0;
+        while(pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) {
+            number = number * 10 + static_cast<size_t>(text[pos] - '0');
+            pos++;
+        }
+        return pos != start;
+    }
 
     std::string compilation_error::get_original_line_message(const std::string &error_message,
-                                                             const std::vector<shader_line> source_lines) {
-        return "This logic isn't implemented yet";
+                                                             const shader_source &source) {
+        std::stringstream message;
+
+        std::stringstream error_stream(error_message);
+        std::string error_line;
+        while(std::getline(error_stream, error_line)) {
+            // Drivers put the line number after the number of the source string, in a couple of different ways:
+            // "0(12) : error C0000: ..." (Nvidia), "0:12(5): error: ..." (Mesa) and "ERROR: 0:12: ..." (AMD and Intel)
+            std::string severity;
+            size_t pos = 0;
+            for(const std::string prefix : {"ERROR: ", "WARNING: "}) {
+                if(error_line.compare(0, prefix.size(), prefix) == 0) {
+                    severity = prefix;
+                    pos = prefix.size();
+                }
+            }
+
+            size_t source_string;
+            size_t line_number;
+            if(!read_number(error_line, pos, source_string) || pos == error_line.size() ||
+               (error_line[pos] != '(' && error_line[pos] != ':')) {
+                continue;
+            }
+            pos++;
+            if(!read_number(error_line, pos, line_number) || line_number == 0 || line_number > source.size()) {
+                continue;
+            }
+
+            // Skip whatever the driver put between the line number and the actual error
+            while(pos < error_line.size() && std::string("()0123456789: ").find(error_line[pos]) != std::string::npos) {
+                pos++;
+            }
+
+            // The driver counts lines from 1
+            auto line_index = line_number - 1;
+            const auto& location = source.get_location(line_index);
+            message << "\n" << source.get_file_name(location.file_id) << "(" << location.line_num << "): "
+                    << severity << error_line.substr(pos) << "\n    " << source.get_line(line_index);
+        }
+
+        auto original_line_message = message.str();
+        if(original_line_message.empty()) {
+            return "";
+        }
+
+        return "\nIn the shaderpack's files:" + original_line_message;
     }
 
 }
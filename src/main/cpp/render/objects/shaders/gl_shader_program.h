@@ -15,6 +15,7 @@
 #include <glad/glad.h>
 #include "../../../utils/export.h"
 #include "../../../data_loading/loaders/shader_source_structs.h"
+#include "program_binary_cache.h"
 
 
 namespace nova {
@@ -24,19 +25,23 @@ namespace nova {
     class compilation_error : public std::runtime_error {
     public:
         /*!
-         * \brief Constructs a compilation_error with the provided message, using the given list of shader_lines to
-         * map from line number in the error message to line number and shader file on disk
+         * \brief Constructs a compilation_error with the provided message, using the shader's line map to map from
+         * line number in the error message to line number and shader file on disk
          *
          * \param error_message The compilation message, straight from the driver
-         * \param source_lines The list of source_line objects that maps from line in the shader sent to the driver
-         * to the line number and shader file on disk
+         * \param source The shader that was sent to the driver, which knows where each of its lines came from
          */
-        compilation_error(const std::string &error_message, const std::vector<shader_line> source_lines);
+        compilation_error(const std::string &error_message, const shader_source &source);
 
     private:
-
-        std::string
-        get_original_line_message(const std::string &error_message, const std::vector<shader_line> source_lines);
+        /*!
+         * \brief Finds the lines of the shader that the driver complained about, and says which file and line on
+         * disk they are
+         *
+         * \return A message with each error next to the file and line it's about, or an empty string if none of
+         * the errors have a line number we understand
+         */
+        static std::string get_original_line_message(const std::string &error_message, const shader_source &source);
     };
 
     class wrong_shader_version : public std::runtime_error {
@@ -69,8 +74,12 @@ namespace nova {
 
         /*!
          * \brief Constructs a gl_shader_program
+         *
+         * \param source The shader's source
+         * \param cache Where to look for the program before compiling it, and where to save it after. The program is
+         * always compiled if this is nullptr
          */
-        explicit gl_shader_program(const shader_definition &source);
+        explicit gl_shader_program(const shader_definition &source, program_binary_cache* cache = nullptr);
 
         /*!
          * \brief Default copy constructor
@@ -130,11 +139,29 @@ namespace nova {
          */
         std::string filter;
 
-        void create_shader(const std::vector<shader_line>& shader_source, GLenum shader_type);
+        /*!
+         * \brief Gets the source that's sent to the driver, after checking that it's a GLSL version we support
+         */
+        const std::string& get_full_source(const shader_source& source);
+
+        void create_shader(const shader_source& source, GLenum shader_type);
 
-        void check_for_shader_errors(GLuint shader_to_check, const std::vector<shader_line>& line_map);
+        void check_for_shader_errors(GLuint shader_to_check, const shader_source& source);
+
+        /*!
+         * \param retrievable True to ask the driver to keep the binary around for glGetProgramBinary
+         */
+        void link(bool retrievable = false);
+
+        /*!
+         * \brief Makes this program from a binary in the cache
+         *
+         * \return True if the program was in the cache and the driver took its binary. If it's false, the program
+         * needs to be compiled
+         */
+        bool load_from_cache(program_binary_cache& cache, uint64_t cache_key);
 
-        void link();
+        void save_to_cache(program_binary_cache& cache, uint64_t cache_key, double compile_ms);
 
         void check_for_linking_errors();
     };
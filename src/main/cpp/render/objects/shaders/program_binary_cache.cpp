@@ -0,0 +1,177 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <easylogging++.h>
+#include "program_binary_cache.h"
+#include "../../../utils/stats.h"
+#include "../../../utils/utils.h"
+
+namespace nova {
+    /*!
+     * \brief Bump this whenever the file layout or the way keys are made changes, so old files get ignored
+     */
+    const uint32_t PROGRAM_FILE_VERSION = 1;
+
+    const char PROGRAM_FILE_MAGIC[4] = {'N', 'V', 'P', 'B'};
+
+    struct program_file_header {
+        char magic[4];
+        uint32_t version;
+        uint64_t key;
+        uint32_t format;
+        uint32_t padding;
+        uint64_t binary_size;
+
+        /*!
+         * \brief A hash of the binary, so that a damaged file is never handed to the driver
+         */
+        uint64_t binary_hash;
+        double compile_ms;
+    };
+
+    uint64_t program_binary_cache::make_key(const std::vector<std::string>& preprocessed_sources, const std::string& driver) {
+        uint64_t key = hash_value(PROGRAM_FILE_VERSION);
+        key = hash_bytes(driver.data(), driver.size(), key);
+        for(const auto& source : preprocessed_sources) {
+            // Hash the size too, so that moving a line from the end of one stage to the start of the next changes the key
+            key = hash_value(static_cast<uint64_t>(source.size()), key);
+            key = hash_bytes(source.data(), source.size(), key);
+        }
+        return key;
+    }
+
+    program_binary_cache::program_binary_cache(const std::string& directory) : directory(directory) {
+        make_directories(directory);
+    }
+
+    std::unique_ptr<program_binary_cache::entry> program_binary_cache::load(uint64_t key) {
+        std::unique_ptr<entry> cached;
+        try {
+            cached = std::make_unique<entry>(mapped_file(get_path(key)));
+        } catch(resource_not_found& e) {
+            num_misses++;
+            update_stats();
+            return nullptr;
+        }
+
+        const uint8_t* data = cached->file.get_data();
+        size_t size = cached->file.get_size();
+
+        program_file_header header;
+        if(size < sizeof(header)) {
+            LOG(WARNING) << "Cached program " << get_path(key) << " is too small to be a cached program, ignoring it";
+            num_misses++;
+            update_stats();
+            return nullptr;
+        }
+        std::memcpy(&header, data, sizeof(header));
+
+        bool is_valid = std::memcmp(header.magic, PROGRAM_FILE_MAGIC, sizeof(PROGRAM_FILE_MAGIC)) == 0 &&
+                        header.version == PROGRAM_FILE_VERSION && header.key == key &&
+                        header.binary_size == size - sizeof(header) &&
+                        hash_bytes(data + sizeof(header), header.binary_size) == header.binary_hash;
+        if(!is_valid) {
+            LOG(WARNING) << "Cached program " << get_path(key) << " is from a different version of Nova or is damaged, ignoring it";
+            num_misses++;
+            update_stats();
+            return nullptr;
+        }
+
+        cached->format = header.format;
+        cached->binary = data + sizeof(header);
+        cached->binary_size = static_cast<size_t>(header.binary_size);
+        cached->compile_ms = header.compile_ms;
+
+        num_hits++;
+        update_stats();
+        return cached;
+    }
+
+    void program_binary_cache::reject(uint64_t key) {
+        if(num_hits > 0) {
+            num_hits--;
+        }
+        num_misses++;
+        update_stats();
+
+        std::remove(get_path(key).c_str());
+    }
+
+    void program_binary_cache::add_time_saved(double ms) {
+        ms_saved += ms;
+        update_stats();
+    }
+
+    bool program_binary_cache::store(uint64_t key, uint32_t format, const uint8_t* binary, size_t binary_size, double compile_ms) {
+        std::string path = get_path(key);
+        std::string temp_path = path + ".tmp";
+
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            if(!file.is_open()) {
+                LOG(WARNING) << "Could not open " << temp_path << " to cache a program";
+                return false;
+            }
+
+            program_file_header header = {};
+            std::memcpy(header.magic, PROGRAM_FILE_MAGIC, sizeof(PROGRAM_FILE_MAGIC));
+            header.version = PROGRAM_FILE_VERSION;
+            header.key = key;
+            header.format = format;
+            header.binary_size = binary_size;
+            header.binary_hash = hash_bytes(binary, binary_size);
+            header.compile_ms = compile_ms;
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(binary), static_cast<std::streamsize>(binary_size));
+
+            if(!file.good()) {
+                LOG(WARNING) << "Could not write a cached program to " << temp_path;
+                file.close();
+                std::remove(temp_path.c_str());
+                return false;
+            }
+        }
+
+        // rename won't replace an existing file everywhere, so get rid of any old version first
+        std::remove(path.c_str());
+        if(std::rename(temp_path.c_str(), path.c_str()) != 0) {
+            LOG(WARNING) << "Could not move cached program " << temp_path << " to " << path;
+            std::remove(temp_path.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    size_t program_binary_cache::get_num_hits() const {
+        return num_hits;
+    }
+
+    size_t program_binary_cache::get_num_misses() const {
+        return num_misses;
+    }
+
+    double program_binary_cache::get_ms_saved() const {
+        return ms_saved;
+    }
+
+    std::string program_binary_cache::get_path(uint64_t key) const {
+        std::stringstream path;
+        path << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".nvprog";
+        return path.str();
+    }
+
+    void program_binary_cache::update_stats() const {
+        if(num_hits + num_misses > 0) {
+            stats::set("program_cache_hit_rate", static_cast<double>(num_hits) / static_cast<double>(num_hits + num_misses));
+        }
+        stats::set("program_cache_ms_saved", ms_saved);
+    }
+}
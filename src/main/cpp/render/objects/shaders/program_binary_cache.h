@@ -0,0 +1,122 @@
+/*!
+ * \brief A disk cache of linked shader programs, so that loading a shaderpack doesn't have to compile everything again
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_PROGRAM_BINARY_CACHE_H
+#define RENDERER_PROGRAM_BINARY_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../../../utils/mapped_file.h"
+
+namespace nova {
+    /*!
+     * \brief Stores the binaries that the driver gives back from glGetProgramBinary, so that programs can be made with
+     * glProgramBinary instead of being compiled and linked
+     *
+     * Each program is one file in the cache directory, named after its key. Keys are a hash of everything that goes
+     * into the binary: the preprocessed source of every stage, and the vendor, renderer and version of the driver. Use
+     * #make_key to build them. A binary from a different driver gets a different key, so it's never loaded, but
+     * drivers can still turn down a binary - after an update that didn't change the version string, say - and #reject
+     * takes care of that.
+     *
+     * The cache keeps track of how many programs it could load, and of how long compiling them would have taken, and
+     * puts those in the "program_cache_hit_rate" and "program_cache_ms_saved" stats
+     */
+    class program_binary_cache {
+    public:
+        /*!
+         * \brief A program loaded from the cache. The binary points into the mapped file, so it's only valid for as
+         * long as the entry is around
+         */
+        struct entry {
+            explicit entry(mapped_file&& file) : file(std::move(file)) {}
+
+            mapped_file file;
+
+            /*!
+             * \brief The binary format from glGetProgramBinary
+             */
+            uint32_t format;
+
+            const uint8_t* binary;
+            size_t binary_size;
+
+            /*!
+             * \brief How long it took to compile and link the program when it was cached
+             */
+            double compile_ms;
+        };
+
+        /*!
+         * \brief Builds the key for a program
+         *
+         * \param preprocessed_sources The full source of each stage, in the order the stages are attached
+         * \param driver A description of the driver, like its vendor, renderer and version strings put together
+         */
+        static uint64_t make_key(const std::vector<std::string>& preprocessed_sources, const std::string& driver);
+
+        /*!
+         * \param directory The directory to keep the cached programs in. It's created if it doesn't exist
+         */
+        explicit program_binary_cache(const std::string& directory);
+
+        /*!
+         * \brief Loads the program with the given key
+         *
+         * \return The program, or nullptr if it's not in the cache or its file is damaged
+         */
+        std::unique_ptr<entry> load(uint64_t key);
+
+        /*!
+         * \brief Tells the cache that the driver wouldn't take the binary it loaded for the given key
+         *
+         * The load counts as a miss instead of a hit, and the file is deleted so it doesn't get loaded again
+         */
+        void reject(uint64_t key);
+
+        /*!
+         * \brief Tells the cache how much faster a program was to load from the cache than to compile
+         */
+        void add_time_saved(double ms);
+
+        /*!
+         * \brief Saves a program in the cache
+         *
+         * The program is written to a temporary file that's renamed when it's done, so a crash halfway through doesn't
+         * leave a broken file behind
+         *
+         * \param key The key to save the program with
+         * \param format The binary format from glGetProgramBinary
+         * \param binary The binary from glGetProgramBinary
+         * \param binary_size How big the binary is
+         * \param compile_ms How long it took to compile and link the program
+         * \return True if the program was saved
+         */
+        bool store(uint64_t key, uint32_t format, const uint8_t* binary, size_t binary_size, double compile_ms);
+
+        size_t get_num_hits() const;
+
+        size_t get_num_misses() const;
+
+        double get_ms_saved() const;
+
+    private:
+        std::string directory;
+        size_t num_hits = 0;
+        size_t num_misses = 0;
+        double ms_saved = 0;
+
+        std::string get_path(uint64_t key) const;
+
+        void update_stats() const;
+    };
+}
+
+#endif //RENDERER_PROGRAM_BINARY_CACHE_H
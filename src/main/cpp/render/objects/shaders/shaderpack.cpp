@@ -12,17 +12,23 @@
 #include <easylogging++.h>
 
 namespace nova {
-    shaderpack::shaderpack(std::string name, nlohmann::json shaders_json, std::vector<shader_definition> &shaders) {
+    shaderpack::shaderpack(std::string name, nlohmann::json shaders_json, std::vector<shader_definition> &shaders,
+                           program_binary_cache* program_cache) {
         this->name = std::move(name);
         for(auto& shader : shaders) {
             LOG(TRACE) << "Adding shader " << shader.name;
             try {
-                loaded_shaders.emplace(shader.name, gl_shader_program(shader));
+                loaded_shaders.emplace(shader.name, gl_shader_program(shader, program_cache));
             } catch(std::exception& e) {
                 LOG(ERROR) << "Could not load shader " << shader.name << " because " << e.what();
             }
         }
 
+        if(program_cache != nullptr) {
+            LOG(INFO) << "Program cache: " << program_cache->get_num_hits() << " hits, " << program_cache->get_num_misses()
+                      << " misses, " << program_cache->get_ms_saved() << "ms of compiling saved so far";
+        }
+
         LOG(TRACE) << "Shaderpack created";
     }
 
@@ -36,9 +36,12 @@ namespace nova {
          * it here?
          *
          * \param shaderpack_name The name of the shaderpcack to load
+         * \param program_cache Where to look for compiled programs before compiling them. Nothing is cached if this
+         * is nullptr
          *
          */
-        shaderpack(std::string name, nlohmann::json shaders_json, std::vector<shader_definition> &shaders);
+        shaderpack(std::string name, nlohmann::json shaders_json, std::vector<shader_definition> &shaders,
+                   program_binary_cache* program_cache = nullptr);
 
         gl_shader_program &operator[](std::string key);
 
@@ -0,0 +1,332 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_set>
+#include <easylogging++.h>
+#include "atlas_packer.h"
+
+namespace nova {
+    /*!
+     * \brief How many sprites each job copies into an atlas
+     */
+    const size_t SPRITES_PER_BLIT_JOB = 64;
+
+    /*!
+     * \brief Keeps track of the top edge of everything that's been placed in an atlas, as a list of horizontal
+     * segments from left to right
+     */
+    class skyline {
+    public:
+        explicit skyline(const glm::ivec2& size) : size(size) {
+            segments.push_back({0, 0, size.x});
+        }
+
+        /*!
+         * \brief Finds the lowest spot that the given rectangle fits in, and marks it as used
+         *
+         * \return True if the rectangle fit, false if there's no room for it
+         */
+        bool insert(const glm::ivec2& rect_size, glm::ivec2& position) {
+            size_t best_segment = segments.size();
+            int best_y = size.y;
+            for(size_t i = 0; i < segments.size(); i++) {
+                int y = fit(i, rect_size);
+                if(y >= 0 && y < best_y) {
+                    best_y = y;
+                    best_segment = i;
+                }
+            }
+
+            if(best_segment == segments.size()) {
+                return false;
+            }
+
+            position = {segments[best_segment].x, best_y};
+            add_segment(best_segment, {position.x, best_y + rect_size.y, rect_size.x});
+            return true;
+        }
+
+    private:
+        struct segment {
+            int x;
+            int y;
+            int width;
+        };
+
+        glm::ivec2 size;
+        std::vector<segment> segments;
+
+        /*!
+         * \brief Works out how far up a rectangle has to go if its left edge is at the start of the given segment
+         *
+         * \return The y position of the rectangle, or -1 if it doesn't fit there
+         */
+        int fit(size_t first_segment, const glm::ivec2& rect_size) const {
+            if(segments[first_segment].x + rect_size.x > size.x) {
+                return -1;
+            }
+
+            int y = 0;
+            int width_left = rect_size.x;
+            for(size_t i = first_segment; width_left > 0; i++) {
+                y = std::max(y, segments[i].y);
+                if(y + rect_size.y > size.y) {
+                    return -1;
+                }
+                width_left -= segments[i].width;
+            }
+
+            return y;
+        }
+
+        void add_segment(size_t index, const segment& new_segment) {
+            segments.insert(segments.begin() + index, new_segment);
+
+            // Cut the new segment's width out of the segments that it covers
+            int new_segment_end = new_segment.x + new_segment.width;
+            for(size_t i = index + 1; i < segments.size();) {
+                auto& covered = segments[i];
+                if(covered.x >= new_segment_end) {
+                    break;
+                }
+
+                int overlap = new_segment_end - covered.x;
+                covered.x += overlap;
+                covered.width -= overlap;
+                if(covered.width <= 0) {
+                    segments.erase(segments.begin() + i);
+                } else {
+                    break;
+                }
+            }
+
+            // Join neighbours at the same height, so later fits have fewer segments to walk over
+            for(size_t i = 0; i + 1 < segments.size();) {
+                if(segments[i].y == segments[i + 1].y) {
+                    segments[i].width += segments[i + 1].width;
+                    segments.erase(segments.begin() + i + 1);
+                } else {
+                    i++;
+                }
+            }
+        }
+    };
+
+    int next_power_of_two(int value) {
+        int power = 1;
+        while(power < value) {
+            power *= 2;
+        }
+        return power;
+    }
+
+    /*!
+     * \brief Tries to pack the given sprites into an atlas of the given size
+     *
+     * \param order The indices of the sprites to pack, in the order to pack them
+     * \param sprites All the sprites
+     * \param size The size of the atlas
+     * \param positions Where each sprite in order ended up
+     * \param leftover The sprites that didn't fit
+     */
+    void pack_into(const std::vector<size_t>& order, const std::vector<atlas_sprite>& sprites, const glm::ivec2& size,
+                   std::vector<glm::ivec2>& positions, std::vector<size_t>& leftover) {
+        skyline packer(size);
+        positions.assign(order.size(), glm::ivec2{-1, -1});
+        leftover.clear();
+
+        for(size_t i = 0; i < order.size(); i++) {
+            if(!packer.insert(sprites[order[i]].size, positions[i])) {
+                positions[i] = {-1, -1};
+                leftover.push_back(order[i]);
+            }
+        }
+    }
+
+    atlas_page make_page(const std::vector<size_t>& order, const std::vector<glm::ivec2>& positions,
+                         const std::vector<atlas_sprite>& sprites, const glm::ivec2& size, job_system* jobs) {
+        atlas_page page;
+        page.size = size;
+        page.rgba_pixels.resize(static_cast<size_t>(size.x) * size.y * 4);
+
+        std::vector<size_t> placed;
+        size_t used_area = 0;
+        for(size_t i = 0; i < order.size(); i++) {
+            if(positions[i].x < 0) {
+                continue;
+            }
+
+            const auto& sprite = sprites[order[i]];
+            page.placements[sprite.name] = {positions[i], sprite.size};
+            used_area += static_cast<size_t>(sprite.size.x) * sprite.size.y;
+            placed.push_back(i);
+        }
+        page.efficiency = static_cast<float>(used_area) / (static_cast<float>(size.x) * size.y);
+
+        // Every sprite goes to its own part of the atlas, so they can all be copied at once
+        auto blit_sprites = [&](size_t begin, size_t end) {
+            for(size_t i = begin; i < end; i++) {
+                const auto& sprite = sprites[order[placed[i]]];
+                const auto& position = positions[placed[i]];
+                size_t row_size = static_cast<size_t>(sprite.size.x) * 4;
+                for(int y = 0; y < sprite.size.y; y++) {
+                    const uint8_t* source = sprite.rgba_pixels.data() + y * row_size;
+                    uint8_t* dest = page.rgba_pixels.data() + ((static_cast<size_t>(position.y) + y) * size.x + position.x) * 4;
+                    std::memcpy(dest, source, row_size);
+                }
+            }
+        };
+
+        if(jobs) {
+            jobs->parallel_for(placed.size(), SPRITES_PER_BLIT_JOB, blit_sprites);
+        } else {
+            blit_sprites(0, placed.size());
+        }
+
+        return page;
+    }
+
+    template <typename T>
+    void write_value(std::vector<uint8_t>& data, const T& value) {
+        auto bytes = reinterpret_cast<const uint8_t*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    bool read_value(const uint8_t*& data, const uint8_t* end, T& value) {
+        if(static_cast<size_t>(end - data) < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data, sizeof(T));
+        data += sizeof(T);
+        return true;
+    }
+
+    std::vector<atlas_page> pack_sprites(const std::vector<atlas_sprite>& sprites, int max_size, job_system* jobs) {
+        std::vector<size_t> remaining;
+        std::unordered_set<std::string> names;
+        for(size_t i = 0; i < sprites.size(); i++) {
+            const auto& sprite = sprites[i];
+            if(names.count(sprite.name) != 0) {
+                LOG(ERROR) << "There's already a sprite named " << sprite.name << ". Only the first one will be in an atlas";
+            } else if(sprite.size.x > max_size || sprite.size.y > max_size) {
+                LOG(ERROR) << "Sprite " << sprite.name << " is " << sprite.size.x << "x" << sprite.size.y << ", which is bigger than the biggest atlas (" << max_size << "x" << max_size << "). It won't be in any atlas";
+            } else if(sprite.rgba_pixels.size() < static_cast<size_t>(sprite.size.x) * sprite.size.y * 4) {
+                LOG(ERROR) << "Sprite " << sprite.name << " doesn't have enough pixel data. It won't be in any atlas";
+            } else if(sprite.size.x > 0 && sprite.size.y > 0) {
+                names.insert(sprite.name);
+                remaining.push_back(i);
+            }
+        }
+
+        // Tallest first, then widest first. The name breaks ties so the same sprites always give the same atlas
+        std::sort(remaining.begin(), remaining.end(), [&](size_t a, size_t b) {
+            const auto& sprite_a = sprites[a];
+            const auto& sprite_b = sprites[b];
+            if(sprite_a.size.y != sprite_b.size.y) {
+                return sprite_a.size.y > sprite_b.size.y;
+            }
+            if(sprite_a.size.x != sprite_b.size.x) {
+                return sprite_a.size.x > sprite_b.size.x;
+            }
+            return sprite_a.name < sprite_b.name;
+        });
+
+        std::vector<atlas_page> pages;
+        while(!remaining.empty()) {
+            size_t area = 0;
+            glm::ivec2 largest_sprite = {1, 1};
+            for(size_t index : remaining) {
+                area += static_cast<size_t>(sprites[index].size.x) * sprites[index].size.y;
+                largest_sprite.x = std::max(largest_sprite.x, sprites[index].size.x);
+                largest_sprite.y = std::max(largest_sprite.y, sprites[index].size.y);
+            }
+
+            // Start with the smallest power-of-two atlas that has enough area, and at most twice as wide as it is tall
+            glm::ivec2 size = {next_power_of_two(largest_sprite.x), next_power_of_two(largest_sprite.y)};
+            while(static_cast<size_t>(size.x) * size.y < area && (size.x < max_size || size.y < max_size)) {
+                if((size.x <= size.y && size.x < max_size) || size.y >= max_size) {
+                    size.x *= 2;
+                } else {
+                    size.y *= 2;
+                }
+            }
+            size.x = std::min(size.x, max_size);
+            size.y = std::min(size.y, max_size);
+
+            std::vector<glm::ivec2> positions;
+            std::vector<size_t> leftover;
+            pack_into(remaining, sprites, size, positions, leftover);
+
+            // Area alone doesn't account for the holes the packer leaves, so grow until everything fits or the atlas
+            // can't get any bigger
+            while(!leftover.empty() && (size.x < max_size || size.y < max_size)) {
+                if((size.x <= size.y && size.x < max_size) || size.y >= max_size) {
+                    size.x = std::min(size.x * 2, max_size);
+                } else {
+                    size.y = std::min(size.y * 2, max_size);
+                }
+                pack_into(remaining, sprites, size, positions, leftover);
+            }
+
+            pages.push_back(make_page(remaining, positions, sprites, size, jobs));
+            remaining = leftover;
+        }
+
+        return pages;
+    }
+
+    std::vector<uint8_t> save_atlas_layout(const std::vector<atlas_page>& pages) {
+        std::vector<uint8_t> data;
+        write_value(data, static_cast<uint32_t>(pages.size()));
+        for(const auto& page : pages) {
+            write_value(data, page.size);
+            write_value(data, page.efficiency);
+            write_value(data, static_cast<uint32_t>(page.placements.size()));
+            for(const auto& placement : page.placements) {
+                write_value(data, placement.second.position);
+                write_value(data, placement.second.size);
+                write_value(data, static_cast<uint32_t>(placement.first.size()));
+                data.insert(data.end(), placement.first.begin(), placement.first.end());
+            }
+        }
+        return data;
+    }
+
+    bool load_atlas_layout(const uint8_t* data, size_t size, std::vector<atlas_page>& pages) {
+        const uint8_t* end = data + size;
+        pages.clear();
+
+        uint32_t num_pages;
+        if(!read_value(data, end, num_pages)) {
+            return false;
+        }
+        for(uint32_t page_index = 0; page_index < num_pages; page_index++) {
+            atlas_page page;
+            uint32_t num_placements;
+            if(!read_value(data, end, page.size) || !read_value(data, end, page.efficiency) || !read_value(data, end, num_placements)) {
+                return false;
+            }
+
+            for(uint32_t i = 0; i < num_placements; i++) {
+                sprite_placement placement;
+                uint32_t name_size;
+                if(!read_value(data, end, placement.position) || !read_value(data, end, placement.size) ||
+                   !read_value(data, end, name_size) || static_cast<size_t>(end - data) < name_size) {
+                    return false;
+                }
+
+                page.placements[std::string(reinterpret_cast<const char*>(data), name_size)] = placement;
+                data += name_size;
+            }
+            pages.push_back(std::move(page));
+        }
+
+        return data == end;
+    }
+}
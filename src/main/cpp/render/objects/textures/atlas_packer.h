@@ -0,0 +1,94 @@
+/*!
+ * \brief Packs individual sprites into texture atlases
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_ATLAS_PACKER_H
+#define RENDERER_ATLAS_PACKER_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../../../utils/job_system.h"
+
+namespace nova {
+    /*!
+     * \brief A single texture that should go into an atlas
+     */
+    struct atlas_sprite {
+        std::string name;
+        glm::ivec2 size;
+
+        /*!
+         * \brief The sprite's pixels, as tightly packed RGBA8
+         */
+        std::vector<uint8_t> rgba_pixels;
+    };
+
+    /*!
+     * \brief Where a sprite ended up in its atlas, in pixels
+     */
+    struct sprite_placement {
+        glm::ivec2 position;
+        glm::ivec2 size;
+    };
+
+    /*!
+     * \brief One atlas texture, filled with sprites
+     */
+    struct atlas_page {
+        glm::ivec2 size;
+        std::vector<uint8_t> rgba_pixels;
+
+        std::unordered_map<std::string, sprite_placement> placements;
+
+        /*!
+         * \brief The fraction of the atlas' pixels that are covered by sprites, from 0 to 1
+         */
+        float efficiency;
+    };
+
+    /*!
+     * \brief Packs sprites into as few atlases as possible
+     *
+     * Sprites are placed with a skyline packer: sprites are sorted from tallest to shortest, then each one goes at the
+     * lowest spot along the top edge of the sprites already placed. Minecraft's sprites are almost all square powers
+     * of two, so this leaves very few holes. Packs that are all square powers of two put every sprite on a multiple of
+     * the smallest sprite size, which keeps mipmapping from mixing sprites together, but skyline packing doesn't
+     * guarantee that once non-square sprites are mixed in
+     *
+     * Each atlas is a power of two in each dimension and starts out just big enough to hold all the remaining
+     * sprites, growing until everything fits or it reaches max_size. Sprites that still don't fit spill over into
+     * another atlas
+     *
+     * \param sprites The sprites to pack
+     * \param max_size The largest an atlas may be in either dimension, usually texture_manager::get_max_texture_size
+     * \param jobs The job system to copy the sprites into the atlases on. If it's null, everything is done on the
+     * calling thread
+     * \return The filled atlases. Sprites bigger than max_size, and sprites with the same name as an earlier sprite,
+     * are left out with an error in the log
+     */
+    std::vector<atlas_page> pack_sprites(const std::vector<atlas_sprite>& sprites, int max_size, job_system* jobs = nullptr);
+
+    /*!
+     * \brief Writes down the size of each atlas and where each sprite is in it, but not the pixels, so a layout can be
+     * cached along with the finished atlases
+     */
+    std::vector<uint8_t> save_atlas_layout(const std::vector<atlas_page>& pages);
+
+    /*!
+     * \brief Reads a layout written by #save_atlas_layout
+     *
+     * \param data The saved layout
+     * \param size How many bytes the saved layout is
+     * \param pages The atlases, with their sizes, placements and efficiencies but no pixels
+     * \return False if the data is damaged
+     */
+    bool load_atlas_layout(const uint8_t* data, size_t size, std::vector<atlas_page>& pages);
+}
+
+#endif //RENDERER_ATLAS_PACKER_H
@@ -0,0 +1,729 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "block_compression.h"
+
+namespace nova {
+    const size_t BLOCK_ROWS_PER_JOB = 4;
+
+    const int PIXELS_PER_BLOCK = 16;
+
+    /*!
+     * \brief Interpolation weights for BC7's 4-bit indices, out of 64
+     */
+    const int BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    using block_pixels = std::array<std::array<uint8_t, 4>, PIXELS_PER_BLOCK>;
+    using color = std::array<float, 4>;
+
+    size_t get_block_size(block_format format) {
+        return format == block_format::bc1 ? 8 : 16;
+    }
+
+    size_t get_compressed_size(const glm::ivec2& size, block_format format) {
+        size_t blocks_x = static_cast<size_t>((size.x + 3) / 4);
+        size_t blocks_y = static_cast<size_t>((size.y + 3) / 4);
+        return blocks_x * blocks_y * get_block_size(format);
+    }
+
+    /*!
+     * \brief Reads a 4x4 block out of an image, repeating the last row and column for blocks that hang off the edge
+     */
+    block_pixels load_block(const uint8_t* rgba, const glm::ivec2& size, int block_x, int block_y) {
+        block_pixels pixels;
+        for(int y = 0; y < 4; y++) {
+            int source_y = std::min(block_y * 4 + y, size.y - 1);
+            for(int x = 0; x < 4; x++) {
+                int source_x = std::min(block_x * 4 + x, size.x - 1);
+                const uint8_t* source = rgba + (static_cast<size_t>(source_y) * size.x + source_x) * 4;
+                std::copy(source, source + 4, pixels[y * 4 + x].begin());
+            }
+        }
+        return pixels;
+    }
+
+    float squared_distance(const color& a, const color& b, int num_channels) {
+        float total = 0;
+        for(int channel = 0; channel < num_channels; channel++) {
+            float difference = a[channel] - b[channel];
+            total += difference * difference;
+        }
+        return total;
+    }
+
+    color to_color(const std::array<uint8_t, 4>& pixel) {
+        return {float(pixel[0]), float(pixel[1]), float(pixel[2]), float(pixel[3])};
+    }
+
+    /*!
+     * \brief Finds two endpoints that the given colors lie roughly between
+     *
+     * \param points The colors to fit
+     * \param num_points How many colors there are
+     * \param num_channels How many channels of each color to look at: 3 for RGB, 4 for RGBA
+     * \param quality fast uses the bounding box of the colors, everything else uses the principal axis
+     */
+    void fit_endpoints(const color* points, int num_points, int num_channels, compression_quality quality, color& endpoint0, color& endpoint1) {
+        if(quality == compression_quality::fast) {
+            endpoint0 = points[0];
+            endpoint1 = points[0];
+            for(int i = 1; i < num_points; i++) {
+                for(int channel = 0; channel < num_channels; channel++) {
+                    endpoint0[channel] = std::min(endpoint0[channel], points[i][channel]);
+                    endpoint1[channel] = std::max(endpoint1[channel], points[i][channel]);
+                }
+            }
+
+            // Pull the endpoints in a little, since the colors at the edges of the box are usually rare
+            for(int channel = 0; channel < num_channels; channel++) {
+                float inset = (endpoint1[channel] - endpoint0[channel]) / 16.0f;
+                endpoint0[channel] += inset;
+                endpoint1[channel] -= inset;
+            }
+            return;
+        }
+
+        color mean = {0, 0, 0, 0};
+        for(int i = 0; i < num_points; i++) {
+            for(int channel = 0; channel < num_channels; channel++) {
+                mean[channel] += points[i][channel] / num_points;
+            }
+        }
+
+        float covariance[4][4] = {};
+        for(int i = 0; i < num_points; i++) {
+            for(int a = 0; a < num_channels; a++) {
+                for(int b = 0; b < num_channels; b++) {
+                    covariance[a][b] += (points[i][a] - mean[a]) * (points[i][b] - mean[b]);
+                }
+            }
+        }
+
+        // Power iteration to find the principal axis, starting from the axis with the most variance
+        color axis = {0, 0, 0, 0};
+        int widest_channel = 0;
+        for(int channel = 1; channel < num_channels; channel++) {
+            if(covariance[channel][channel] > covariance[widest_channel][widest_channel]) {
+                widest_channel = channel;
+            }
+        }
+        axis[widest_channel] = 1;
+
+        for(int iteration = 0; iteration < 8; iteration++) {
+            color next_axis = {0, 0, 0, 0};
+            for(int a = 0; a < num_channels; a++) {
+                for(int b = 0; b < num_channels; b++) {
+                    next_axis[a] += covariance[a][b] * axis[b];
+                }
+            }
+
+            float length = std::sqrt(squared_distance(next_axis, {0, 0, 0, 0}, num_channels));
+            if(length < 1e-6f) {
+                break;
+            }
+            for(int channel = 0; channel < num_channels; channel++) {
+                axis[channel] = next_axis[channel] / length;
+            }
+        }
+
+        float min_t = std::numeric_limits<float>::max();
+        float max_t = std::numeric_limits<float>::lowest();
+        for(int i = 0; i < num_points; i++) {
+            float t = 0;
+            for(int channel = 0; channel < num_channels; channel++) {
+                t += (points[i][channel] - mean[channel]) * axis[channel];
+            }
+            min_t = std::min(min_t, t);
+            max_t = std::max(max_t, t);
+        }
+
+        endpoint0 = mean;
+        endpoint1 = mean;
+        for(int channel = 0; channel < num_channels; channel++) {
+            endpoint0[channel] = mean[channel] + axis[channel] * min_t;
+            endpoint1[channel] = mean[channel] + axis[channel] * max_t;
+        }
+    }
+
+    /*!
+     * \brief Finds the endpoints that best reproduce the given colors, if each color is made from the endpoints with
+     * the given weight. A least squares fit
+     *
+     * \return False if the weights don't constrain the endpoints enough to solve for them
+     */
+    bool refine_endpoints(const color* points, const float* weights, int num_points, int num_channels, color& endpoint0, color& endpoint1) {
+        float aa = 0, ab = 0, bb = 0;
+        color ax = {0, 0, 0, 0};
+        color bx = {0, 0, 0, 0};
+        for(int i = 0; i < num_points; i++) {
+            float b = weights[i];
+            float a = 1 - b;
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+            for(int channel = 0; channel < num_channels; channel++) {
+                ax[channel] += a * points[i][channel];
+                bx[channel] += b * points[i][channel];
+            }
+        }
+
+        float determinant = aa * bb - ab * ab;
+        if(std::abs(determinant) < 1e-6f) {
+            return false;
+        }
+
+        for(int channel = 0; channel < num_channels; channel++) {
+            endpoint0[channel] = std::min(std::max((ax[channel] * bb - bx[channel] * ab) / determinant, 0.0f), 255.0f);
+            endpoint1[channel] = std::min(std::max((bx[channel] * aa - ax[channel] * ab) / determinant, 0.0f), 255.0f);
+        }
+        return true;
+    }
+
+    /*
+     * BC1
+     */
+
+    uint16_t to_rgb565(const color& c) {
+        auto r = static_cast<uint16_t>(std::lround(std::min(std::max(c[0], 0.0f), 255.0f) * 31.0f / 255.0f));
+        auto g = static_cast<uint16_t>(std::lround(std::min(std::max(c[1], 0.0f), 255.0f) * 63.0f / 255.0f));
+        auto b = static_cast<uint16_t>(std::lround(std::min(std::max(c[2], 0.0f), 255.0f) * 31.0f / 255.0f));
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    color from_rgb565(uint16_t value) {
+        int r = (value >> 11) & 31;
+        int g = (value >> 5) & 63;
+        int b = value & 31;
+        return {float((r << 3) | (r >> 2)), float((g << 2) | (g >> 4)), float((b << 3) | (b >> 2)), 255};
+    }
+
+    /*!
+     * \brief Builds the four colors that a BC1 block's indices refer to
+     *
+     * \param four_colors True for four opaque colors, false for three colors and transparent black. BC1 blocks pick
+     * the mode by the order of their endpoints, BC3 color blocks always have four colors
+     */
+    std::array<color, 4> make_bc1_palette(uint16_t color0, uint16_t color1, bool four_colors) {
+        std::array<color, 4> palette;
+        palette[0] = from_rgb565(color0);
+        palette[1] = from_rgb565(color1);
+        for(int channel = 0; channel < 3; channel++) {
+            if(four_colors) {
+                palette[2][channel] = std::floor((2 * palette[0][channel] + palette[1][channel]) / 3);
+                palette[3][channel] = std::floor((palette[0][channel] + 2 * palette[1][channel]) / 3);
+            } else {
+                palette[2][channel] = std::floor((palette[0][channel] + palette[1][channel]) / 2);
+                palette[3][channel] = 0;
+            }
+        }
+        palette[2][3] = 255;
+        palette[3][3] = four_colors ? 255 : 0;
+        return palette;
+    }
+
+    /*!
+     * \brief Picks the closest palette entry for every pixel
+     *
+     * \return The total squared error of the block
+     */
+    float choose_bc1_indices(const block_pixels& pixels, uint16_t color0, uint16_t color1, bool has_transparency, uint32_t& indices) {
+        auto palette = make_bc1_palette(color0, color1, !has_transparency);
+        int num_colors = has_transparency ? 3 : 4;
+
+        indices = 0;
+        float total_error = 0;
+        for(int i = 0; i < PIXELS_PER_BLOCK; i++) {
+            uint32_t best_index = 3;
+            if(!has_transparency || pixels[i][3] >= 128) {
+                float best_error = std::numeric_limits<float>::max();
+                color pixel = to_color(pixels[i]);
+                for(int index = 0; index < num_colors; index++) {
+                    float error = squared_distance(pixel, palette[index], 3);
+                    if(error < best_error) {
+                        best_error = error;
+                        best_index = static_cast<uint32_t>(index);
+                    }
+                }
+                total_error += best_error;
+            }
+            indices |= best_index << (i * 2);
+        }
+        return total_error;
+    }
+
+    /*!
+     * \brief Puts the endpoints in the order that selects the mode we want, swapping the indices to match
+     */
+    void order_bc1_endpoints(uint16_t& color0, uint16_t& color1, bool has_transparency) {
+        // color0 > color1 means four colors, color0 <= color1 means three colors and transparent
+        bool needs_swap = has_transparency ? color0 > color1 : color0 < color1;
+        if(needs_swap) {
+            std::swap(color0, color1);
+        }
+    }
+
+    void encode_bc1_color(const block_pixels& pixels, compression_quality quality, bool allow_transparency, uint8_t* out) {
+        color points[PIXELS_PER_BLOCK];
+        int num_points = 0;
+        bool has_transparency = false;
+        for(const auto& pixel : pixels) {
+            if(allow_transparency && pixel[3] < 128) {
+                has_transparency = true;
+            } else {
+                points[num_points++] = to_color(pixel);
+            }
+        }
+
+        uint16_t color0 = 0;
+        uint16_t color1 = 0;
+        uint32_t indices = 0xFFFFFFFF;
+
+        if(num_points > 0) {
+            color endpoint0, endpoint1;
+            fit_endpoints(points, num_points, 3, quality, endpoint0, endpoint1);
+            color0 = to_rgb565(endpoint1);
+            color1 = to_rgb565(endpoint0);
+            order_bc1_endpoints(color0, color1, has_transparency);
+            float error = choose_bc1_indices(pixels, color0, color1, has_transparency, indices);
+
+            if(quality == compression_quality::high) {
+                const float four_color_weights[4] = {0, 1, 1.0f / 3.0f, 2.0f / 3.0f};
+                const float three_color_weights[4] = {0, 1, 0.5f, 0};
+                const float* index_weights = has_transparency ? three_color_weights : four_color_weights;
+
+                for(int iteration = 0; iteration < 2; iteration++) {
+                    float weights[PIXELS_PER_BLOCK];
+                    int num_weights = 0;
+                    for(int i = 0; i < PIXELS_PER_BLOCK; i++) {
+                        if(!has_transparency || pixels[i][3] >= 128) {
+                            weights[num_weights++] = index_weights[(indices >> (i * 2)) & 3];
+                        }
+                    }
+
+                    if(!refine_endpoints(points, weights, num_points, 3, endpoint0, endpoint1)) {
+                        break;
+                    }
+
+                    uint16_t refined_color0 = to_rgb565(endpoint0);
+                    uint16_t refined_color1 = to_rgb565(endpoint1);
+                    order_bc1_endpoints(refined_color0, refined_color1, has_transparency);
+                    uint32_t refined_indices;
+                    float refined_error = choose_bc1_indices(pixels, refined_color0, refined_color1, has_transparency, refined_indices);
+                    if(refined_error >= error) {
+                        break;
+                    }
+
+                    color0 = refined_color0;
+                    color1 = refined_color1;
+                    indices = refined_indices;
+                    error = refined_error;
+                }
+            }
+        }
+
+        out[0] = static_cast<uint8_t>(color0 & 0xFF);
+        out[1] = static_cast<uint8_t>(color0 >> 8);
+        out[2] = static_cast<uint8_t>(color1 & 0xFF);
+        out[3] = static_cast<uint8_t>(color1 >> 8);
+        for(int i = 0; i < 4; i++) {
+            out[4 + i] = static_cast<uint8_t>((indices >> (i * 8)) & 0xFF);
+        }
+    }
+
+    void decode_bc1_color(const uint8_t* block, block_pixels& pixels, bool force_four_colors) {
+        auto color0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+        auto color1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+        auto palette = make_bc1_palette(color0, color1, force_four_colors || color0 > color1);
+
+        uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24);
+        for(int i = 0; i < PIXELS_PER_BLOCK; i++) {
+            const auto& entry = palette[(indices >> (i * 2)) & 3];
+            for(int channel = 0; channel < 4; channel++) {
+                pixels[i][channel] = static_cast<uint8_t>(entry[channel]);
+            }
+        }
+    }
+
+    /*
+     * BC3 alpha
+     */
+
+    /*!
+     * \brief Builds the eight alphas that a BC3 alpha block's indices refer to
+     */
+    std::array<int, 8> make_bc3_alpha_palette(int alpha0, int alpha1) {
+        std::array<int, 8> palette;
+        palette[0] = alpha0;
+        palette[1] = alpha1;
+        if(alpha0 > alpha1) {
+            for(int i = 1; i < 7; i++) {
+                palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+            }
+        } else {
+            for(int i = 1; i < 5; i++) {
+                palette[i + 1] = ((5 - i) * alpha0 + i * alpha1) / 5;
+            }
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+        return palette;
+    }
+
+    int choose_bc3_alpha_indices(const block_pixels& pixels, int alpha0, int alpha1, uint64_t& indices) {
+        auto palette = make_bc3_alpha_palette(alpha0, alpha1);
+        indices = 0;
+        int total_error = 0;
+        for(int i = 0; i < PIXELS_PER_BLOCK; i++) {
+            int best_index = 0;
+            int best_error = std::numeric_limits<int>::max();
+            for(int index = 0; index < 8; index++) {
+                int error = std::abs(palette[index] - pixels[i][3]);
+                if(error < best_error) {
+                    best_error = error;
+                    best_index = index;
+                }
+            }
+            total_error += best_error * best_error;
+            indices |= static_cast<uint64_t>(best_index) << (i * 3);
+        }
+        return total_error;
+    }
+
+    void encode_bc3_alpha(const block_pixels& pixels, compression_quality quality, uint8_t* out) {
+        int min_alpha = 255, max_alpha = 0;
+        int min_inner_alpha = 255, max_inner_alpha = 0;
+        for(const auto& pixel : pixels) {
+            min_alpha = std::min(min_alpha, int(pixel[3]));
+            max_alpha = std::max(max_alpha, int(pixel[3]));
+            if(pixel[3] != 0 && pixel[3] != 255) {
+                min_inner_alpha = std::min(min_inner_alpha, int(pixel[3]));
+                max_inner_alpha = std::max(max_inner_alpha, int(pixel[3]));
+            }
+        }
+
+        // Eight interpolated alphas between the extremes...
+        int alpha0 = max_alpha;
+        int alpha1 = min_alpha;
+        if(alpha0 == alpha1) {
+            alpha1 = std::max(alpha0 - 1, 0);
+            alpha0 = alpha1 + 1;
+        }
+        uint64_t indices;
+        int error = choose_bc3_alpha_indices(pixels, alpha0, alpha1, indices);
+
+        // ...or six between the alphas that aren't 0 or 255, with exact 0 and 255 as the other two. That's usually
+        // better for blocks on the edge of a cutout
+        if(quality != compression_quality::fast && min_inner_alpha <= max_inner_alpha) {
+            uint64_t inner_indices;
+            int inner_error = choose_bc3_alpha_indices(pixels, min_inner_alpha, max_inner_alpha, inner_indices);
+            if(inner_error < error) {
+                alpha0 = min_inner_alpha;
+                alpha1 = max_inner_alpha;
+                indices = inner_indices;
+            }
+        }
+
+        out[0] = static_cast<uint8_t>(alpha0);
+        out[1] = static_cast<uint8_t>(alpha1);
+        for(int i = 0; i < 6; i++) {
+            out[2 + i] = static_cast<uint8_t>((indices >> (i * 8)) & 0xFF);
+        }
+    }
+
+    void decode_bc3_alpha(const uint8_t* block, block_pixels& pixels) {
+        auto palette = make_bc3_alpha_palette(block[0], block[1]);
+        uint64_t indices = 0;
+        for(int i = 0; i < 6; i++) {
+            indices |= static_cast<uint64_t>(block[2 + i]) << (i * 8);
+        }
+        for(int i = 0; i < PIXELS_PER_BLOCK; i++) {
+            pixels[i][3] = static_cast<uint8_t>(palette[(indices >> (i * 3)) & 7]);
+        }
+    }
+
+    /*
+     * BC7. Only mode 6 is used: one subset, RGBA endpoints, 4-bit indices. A full encoder would search every mode and
+     * partition, which costs a lot more time for a little more quality
+     */
+
+    /*!
+     * \brief A mode 6 endpoint: seven bits per channel plus a shared low bit
+     */
+    struct bc7_endpoint {
+        std::array<int, 4> channels;
+        int p_bit;
+
+        color expand() const {
+            return {float((channels[0] << 1) | p_bit), float((channels[1] << 1) | p_bit), float((channels[2] << 1) | p_bit), float((channels[3] << 1) | p_bit)};
+        }
+    };
+
+    bc7_endpoint quantize_bc7_endpoint(const color& value, int p_bit) {
+        bc7_endpoint endpoint;
+        endpoint.p_bit = p_bit;
+        for(int channel = 0; channel < 4; channel++) {
+            endpoint.channels[channel] = std::min(std::max(static_cast<int>(std::lround((value[channel] - p_bit) / 2.0f)), 0), 127);
+        }
+        return endpoint;
+    }
+
+    /*!
+     * \brief Quantizes an endpoint with whichever p-bit gets it closest to the unquantized value
+     */
+    bc7_endpoint quantize_bc7_endpoint(const color& value) {
+        auto with_zero = quantize_bc7_endpoint(value, 0);
+        auto with_one = quantize_bc7_endpoint(value, 1);
+        return squared_distance(with_zero.expand(), value, 4) <= squared_distance(with_one.expand(), value, 4) ? with_zero : with_one;
+    }
+
+    float choose_bc7_indices(const block_pixels& pixels, const bc7_endpoint& endpoint0, const bc7_endpoint& endpoint1, std::array<int, PIXELS_PER_BLOCK>& indices) {
+        color e0 = endpoint0.expand();
+        color e1 = endpoint1.expand();
+        std::array<color, 16> palette;
+        for(int index = 0; index < 16; index++) {
+            for(int channel = 0; channel < 4; channel++) {
+                palette[index][channel] = float(((64 - BC7_WEIGHTS[index]) * int(e0[channel]) + BC7_WEIGHTS[index] * int(e1[channel]) + 32) >> 6);
+            }
+        }
+
+        float total_error = 0;
+        for(int i = 0; i < PIXELS_PER_BLOCK; i++) {
+            color pixel = to_color(pixels[i]);
+            float best_error = std::numeric_limits<float>::max();
+            for(int index = 0; index < 16; index++) {
+                float error = squared_distance(pixel, palette[index], 4);
+                if(error < best_error) {
+                    best_error = error;
+                    indices[i] = index;
+                }
+            }
+            total_error += best_error;
+        }
+        return total_error;
+    }
+
+    /*!
+     * \brief Writes bits into a block, least significant bit first
+     */
+    class bit_writer {
+    public:
+        explicit bit_writer(uint8_t* out) : out(out) {
+            std::memset(out, 0, 16);
+        }
+
+        void write(uint32_t value, int num_bits) {
+            for(int bit = 0; bit < num_bits; bit++) {
+                if((value >> bit) & 1) {
+                    out[position / 8] |= static_cast<uint8_t>(1 << (position % 8));
+                }
+                position++;
+            }
+        }
+
+    private:
+        uint8_t* out;
+        int position = 0;
+    };
+
+    class bit_reader {
+    public:
+        explicit bit_reader(const uint8_t* in) : in(in) {}
+
+        uint32_t read(int num_bits) {
+            uint32_t value = 0;
+            for(int bit = 0; bit < num_bits; bit++) {
+                value |= static_cast<uint32_t>((in[position / 8] >> (position % 8)) & 1) << bit;
+                position++;
+            }
+            return value;
+        }
+
+    private:
+        const uint8_t* in;
+        int position = 0;
+    };
+
+    void encode_bc7(const block_pixels& pixels, compression_quality quality, uint8_t* out) {
+        color points[PIXELS_PER_BLOCK];
+        for(int i = 0; i < PIXELS_PER_BLOCK; i++) {
+            points[i] = to_color(pixels[i]);
+        }
+
+        color unquantized0, unquantized1;
+        fit_endpoints(points, PIXELS_PER_BLOCK, 4, quality, unquantized0, unquantized1);
+
+        bc7_endpoint endpoint0 = quantize_bc7_endpoint(unquantized0);
+        bc7_endpoint endpoint1 = quantize_bc7_endpoint(unquantized1);
+        std::array<int, PIXELS_PER_BLOCK> indices;
+        float error = choose_bc7_indices(pixels, endpoint0, endpoint1, indices);
+
+        if(quality == compression_quality::high) {
+            for(int iteration = 0; iteration < 2; iteration++) {
+                float weights[PIXELS_PER_BLOCK];
+                for(int i = 0; i < PIXELS_PER_BLOCK; i++) {
+                    weights[i] = BC7_WEIGHTS[indices[i]] / 64.0f;
+                }
+                if(!refine_endpoints(points, weights, PIXELS_PER_BLOCK, 4, unquantized0, unquantized1)) {
+                    break;
+                }
+
+                // The p-bits interact with the indices, so try every combination
+                bool improved = false;
+                for(int p_bits = 0; p_bits < 4; p_bits++) {
+                    auto candidate0 = quantize_bc7_endpoint(unquantized0, p_bits & 1);
+                    auto candidate1 = quantize_bc7_endpoint(unquantized1, p_bits >> 1);
+                    std::array<int, PIXELS_PER_BLOCK> candidate_indices;
+                    float candidate_error = choose_bc7_indices(pixels, candidate0, candidate1, candidate_indices);
+                    if(candidate_error < error) {
+                        endpoint0 = candidate0;
+                        endpoint1 = candidate1;
+                        indices = candidate_indices;
+                        error = candidate_error;
+                        improved = true;
+                    }
+                }
+
+                if(!improved) {
+                    break;
+                }
+            }
+        }
+
+        // The first pixel's index only gets three bits, so its top bit has to be zero. Swapping the endpoints and
+        // flipping the indices makes that true
+        if(indices[0] >= 8) {
+            std::swap(endpoint0, endpoint1);
+            for(auto& index : indices) {
+                index = 15 - index;
+            }
+        }
+
+        bit_writer writer(out);
+        writer.write(1 << 6, 7);
+        for(int channel = 0; channel < 4; channel++) {
+            writer.write(static_cast<uint32_t>(endpoint0.channels[channel]), 7);
+            writer.write(static_cast<uint32_t>(endpoint1.channels[channel]), 7);
+        }
+        writer.write(static_cast<uint32_t>(endpoint0.p_bit), 1);
+        writer.write(static_cast<uint32_t>(endpoint1.p_bit), 1);
+        writer.write(static_cast<uint32_t>(indices[0]), 3);
+        for(int i = 1; i < PIXELS_PER_BLOCK; i++) {
+            writer.write(static_cast<uint32_t>(indices[i]), 4);
+        }
+    }
+
+    void decode_bc7(const uint8_t* block, block_pixels& pixels) {
+        bit_reader reader(block);
+        if(reader.read(7) != (1 << 6)) {
+            // Not mode 6, which is the only mode we write. Decode to transparent black, which is what GPUs do for
+            // invalid blocks
+            for(auto& pixel : pixels) {
+                pixel = {0, 0, 0, 0};
+            }
+            return;
+        }
+
+        bc7_endpoint endpoint0, endpoint1;
+        for(int channel = 0; channel < 4; channel++) {
+            endpoint0.channels[channel] = static_cast<int>(reader.read(7));
+            endpoint1.channels[channel] = static_cast<int>(reader.read(7));
+        }
+        endpoint0.p_bit = static_cast<int>(reader.read(1));
+        endpoint1.p_bit = static_cast<int>(reader.read(1));
+
+        color e0 = endpoint0.expand();
+        color e1 = endpoint1.expand();
+        for(int i = 0; i < PIXELS_PER_BLOCK; i++) {
+            auto index = static_cast<int>(reader.read(i == 0 ? 3 : 4));
+            for(int channel = 0; channel < 4; channel++) {
+                pixels[i][channel] = static_cast<uint8_t>(((64 - BC7_WEIGHTS[index]) * int(e0[channel]) + BC7_WEIGHTS[index] * int(e1[channel]) + 32) >> 6);
+            }
+        }
+    }
+
+    void encode_block(const block_pixels& pixels, block_format format, compression_quality quality, uint8_t* out) {
+        switch(format) {
+            case block_format::bc1:
+                encode_bc1_color(pixels, quality, true, out);
+                break;
+            case block_format::bc3:
+                encode_bc3_alpha(pixels, quality, out);
+                encode_bc1_color(pixels, quality, false, out + 8);
+                break;
+            case block_format::bc7:
+                encode_bc7(pixels, quality, out);
+                break;
+        }
+    }
+
+    compressed_image compress_image(const uint8_t* rgba, const glm::ivec2& size, block_format format, compression_quality quality, job_system* jobs) {
+        compressed_image image;
+        image.size = size;
+        image.format = format;
+        image.blocks.resize(get_compressed_size(size, format));
+
+        int blocks_x = (size.x + 3) / 4;
+        int blocks_y = (size.y + 3) / 4;
+        size_t block_size = get_block_size(format);
+
+        auto compress_rows = [&](size_t first_row, size_t last_row) {
+            for(int block_y = static_cast<int>(first_row); block_y < static_cast<int>(last_row); block_y++) {
+                for(int block_x = 0; block_x < blocks_x; block_x++) {
+                    auto pixels = load_block(rgba, size, block_x, block_y);
+                    uint8_t* out = &image.blocks[(static_cast<size_t>(block_y) * blocks_x + block_x) * block_size];
+                    encode_block(pixels, format, quality, out);
+                }
+            }
+        };
+
+        if(jobs) {
+            jobs->parallel_for(static_cast<size_t>(blocks_y), BLOCK_ROWS_PER_JOB, compress_rows);
+        } else {
+            compress_rows(0, static_cast<size_t>(blocks_y));
+        }
+
+        return image;
+    }
+
+    std::vector<uint8_t> decompress_image(const compressed_image& image) {
+        std::vector<uint8_t> rgba(static_cast<size_t>(image.size.x) * image.size.y * 4);
+        int blocks_x = (image.size.x + 3) / 4;
+        int blocks_y = (image.size.y + 3) / 4;
+        size_t block_size = get_block_size(image.format);
+
+        for(int block_y = 0; block_y < blocks_y; block_y++) {
+            for(int block_x = 0; block_x < blocks_x; block_x++) {
+                const uint8_t* block = &image.blocks[(static_cast<size_t>(block_y) * blocks_x + block_x) * block_size];
+                block_pixels pixels;
+                switch(image.format) {
+                    case block_format::bc1:
+                        decode_bc1_color(block, pixels, false);
+                        break;
+                    case block_format::bc3:
+                        decode_bc1_color(block + 8, pixels, true);
+                        decode_bc3_alpha(block, pixels);
+                        break;
+                    case block_format::bc7:
+                        decode_bc7(block, pixels);
+                        break;
+                }
+
+                for(int y = 0; y < 4 && block_y * 4 + y < image.size.y; y++) {
+                    for(int x = 0; x < 4 && block_x * 4 + x < image.size.x; x++) {
+                        size_t dest = (static_cast<size_t>(block_y * 4 + y) * image.size.x + block_x * 4 + x) * 4;
+                        std::copy(pixels[y * 4 + x].begin(), pixels[y * 4 + x].end(), rgba.begin() + dest);
+                    }
+                }
+            }
+        }
+
+        return rgba;
+    }
+}
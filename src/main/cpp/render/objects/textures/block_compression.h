@@ -0,0 +1,93 @@
+/*!
+ * \brief Encodes textures into GPU block-compressed formats
+ *
+ * Nothing in here touches OpenGL, so textures can be compressed without a window - by tests, or by tools that build
+ * texture caches ahead of time
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_BLOCK_COMPRESSION_H
+#define RENDERER_BLOCK_COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../../../utils/job_system.h"
+#include "../../../utils/smart_enum.h"
+
+namespace nova {
+    /*!
+     * \brief The block-compressed formats Nova can encode. Every format stores 4x4 pixel blocks
+     *
+     * - bc1: 8 bytes per block. Two RGB565 endpoints and 2-bit indices. Pixels with an alpha below 128 become fully
+     *   transparent and every other pixel becomes fully opaque, which suits cutout textures
+     * - bc3: 16 bytes per block. BC1 color plus a separately interpolated 8-bit alpha channel
+     * - bc7: 16 bytes per block. RGBA endpoints with seven bits per channel plus a shared bit, and 4-bit indices.
+     *   Much better color than BC1 or BC3, at the same size as BC3
+     */
+    SMART_ENUM(block_format, \
+        bc1, \
+        bc3, \
+        bc7);
+
+    /*!
+     * \brief How much time the encoder spends looking for good endpoints
+     *
+     * - fast: Endpoints come from the bounding box of the block's colors
+     * - normal: Endpoints come from the principal axis of the block's colors
+     * - high: Like normal, then the endpoints are refined with a least squares fit
+     */
+    SMART_ENUM(compression_quality, \
+        fast, \
+        normal, \
+        high);
+
+    /*!
+     * \brief A block-compressed image
+     */
+    struct compressed_image {
+        glm::ivec2 size;
+        block_format format;
+
+        /*!
+         * \brief The blocks, left to right then top to bottom
+         */
+        std::vector<uint8_t> blocks;
+    };
+
+    /*!
+     * \brief Returns the number of bytes each 4x4 block takes up in the given format
+     */
+    size_t get_block_size(block_format format);
+
+    /*!
+     * \brief Returns the number of bytes an image of the given size takes up in the given format
+     *
+     * Images that aren't a multiple of four pixels in a dimension are padded out to the next full block
+     */
+    size_t get_compressed_size(const glm::ivec2& size, block_format format);
+
+    /*!
+     * \brief Compresses an RGBA8 image
+     *
+     * \param rgba The pixels to compress, tightly packed
+     * \param size The size of the image. Doesn't need to be a multiple of four; the edge blocks are padded by
+     * repeating the last row and column
+     * \param format The format to compress to
+     * \param quality How hard to try to find good endpoints
+     * \param jobs The job system to compress on. If it's null, everything is done on the calling thread
+     */
+    compressed_image compress_image(const uint8_t* rgba, const glm::ivec2& size, block_format format, compression_quality quality, job_system* jobs = nullptr);
+
+    /*!
+     * \brief Decodes a compressed image back into RGBA8 pixels. Mostly useful to measure how much quality the
+     * compression lost
+     */
+    std::vector<uint8_t> decompress_image(const compressed_image& image);
+}
+
+#endif //RENDERER_BLOCK_COMPRESSION_H
@@ -0,0 +1,474 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <easylogging++.h>
+#include "mipmap_builder.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define NOVA_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace nova {
+    const size_t ROWS_PER_MIPMAP_JOB = 16;
+    const size_t TILES_PER_COVERAGE_JOB = 64;
+
+    const int KAISER_TAPS = 8;
+    const float KAISER_ALPHA = 4.0f;
+    const float KAISER_WIDTH = 2.0f;
+
+    const int LINEAR_TO_SRGB_TABLE_SIZE = 4096;
+
+    /*!
+     * \brief A mip level in the middle of being built: linear, premultiplied RGBA floats
+     */
+    struct float_image {
+        glm::ivec2 size;
+        glm::ivec2 tile_size;
+        std::vector<float> texels;
+
+        float* pixel(int x, int y) {
+            return &texels[(static_cast<size_t>(y) * size.x + x) * 4];
+        }
+
+        const float* pixel(int x, int y) const {
+            return &texels[(static_cast<size_t>(y) * size.x + x) * 4];
+        }
+    };
+
+    /*!
+     * \brief Runs func over [0, count) in batches, on the job system if there is one
+     */
+    void for_each_batch(job_system* jobs, size_t count, size_t batch_size, const std::function<void(size_t, size_t)>& func) {
+        if(jobs) {
+            jobs->parallel_for(count, batch_size, func);
+        } else {
+            func(0, count);
+        }
+    }
+
+    bool is_power_of_two(int value) {
+        return value > 0 && (value & (value - 1)) == 0;
+    }
+
+    /*!
+     * \brief Works out the tile size to build the mip chain with, falling back to treating the whole image as one
+     * tile if the requested tile size doesn't fit the image
+     */
+    glm::ivec2 get_effective_tile_size(const glm::ivec2& size, const mipmap_options& options) {
+        const auto& tile = options.tile_size;
+        if(tile.x == 0 && tile.y == 0) {
+            return size;
+        }
+
+        if(!is_power_of_two(tile.x) || !is_power_of_two(tile.y) || size.x % tile.x != 0 || size.y % tile.y != 0) {
+            LOG(WARNING) << "Tile size " << tile.x << "x" << tile.y << " doesn't evenly divide the " << size.x << "x"
+                         << size.y << " image, so the whole image will be mipmapped as one tile";
+            return size;
+        }
+
+        return tile;
+    }
+
+    size_t count_mip_levels(const glm::ivec2& size, const mipmap_options& options) {
+        glm::ivec2 tile_size = get_effective_tile_size(size, options);
+
+        // Tiles stop at one pixel. A single tile covering the whole image keeps going until the whole image is one
+        // pixel, the same as OpenGL's mip chain
+        int largest_dimension = tile_size == size ? std::max(size.x, size.y) : std::min(tile_size.x, tile_size.y);
+        size_t num_levels = 1;
+        while(largest_dimension > 1) {
+            largest_dimension /= 2;
+            num_levels++;
+        }
+
+        if(options.max_levels > 0) {
+            num_levels = std::min(num_levels, options.max_levels);
+        }
+
+        return num_levels;
+    }
+
+    float srgb_to_linear(float value) {
+        return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float linear_to_srgb(float value) {
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+
+    const std::array<float, 256>& get_srgb_to_linear_table() {
+        static const std::array<float, 256> table = []() {
+            std::array<float, 256> values;
+            for(int i = 0; i < 256; i++) {
+                values[i] = srgb_to_linear(i / 255.0f);
+            }
+            return values;
+        }();
+        return table;
+    }
+
+    const std::array<uint8_t, LINEAR_TO_SRGB_TABLE_SIZE>& get_linear_to_srgb_table() {
+        static const std::array<uint8_t, LINEAR_TO_SRGB_TABLE_SIZE> table = []() {
+            std::array<uint8_t, LINEAR_TO_SRGB_TABLE_SIZE> values;
+            for(int i = 0; i < LINEAR_TO_SRGB_TABLE_SIZE; i++) {
+                float srgb = linear_to_srgb(i / float(LINEAR_TO_SRGB_TABLE_SIZE - 1));
+                values[i] = static_cast<uint8_t>(std::lround(srgb * 255.0f));
+            }
+            return values;
+        }();
+        return table;
+    }
+
+    /*!
+     * \brief The zeroth order modified Bessel function of the first kind, which the Kaiser window is built from
+     */
+    float bessel_i0(float x) {
+        float sum = 1;
+        float term = 1;
+        for(int k = 1; k < 16; k++) {
+            float half_x_over_k = x / (2.0f * k);
+            term *= half_x_over_k * half_x_over_k;
+            sum += term;
+        }
+        return sum;
+    }
+
+    /*!
+     * \brief The weights of the eight source pixels that make up each destination pixel, when shrinking by half
+     */
+    const std::array<float, KAISER_TAPS>& get_kaiser_weights() {
+        static const std::array<float, KAISER_TAPS> weights = []() {
+            const float pi = 3.14159265358979f;
+            std::array<float, KAISER_TAPS> values;
+            float total = 0;
+            for(int tap = 0; tap < KAISER_TAPS; tap++) {
+                // Distance from the center of the destination pixel to the center of the source pixel, in
+                // destination pixels
+                float x = (tap - (KAISER_TAPS - 1) / 2.0f) / 2.0f;
+                float sinc = std::sin(pi * x) / (pi * x);
+                float window_x = x / KAISER_WIDTH;
+                float window = bessel_i0(KAISER_ALPHA * std::sqrt(1.0f - window_x * window_x)) / bessel_i0(KAISER_ALPHA);
+                values[tap] = sinc * window;
+                total += values[tap];
+            }
+
+            for(auto& value : values) {
+                value /= total;
+            }
+            return values;
+        }();
+        return weights;
+    }
+
+    /*!
+     * \brief Moves a coordinate back inside the tile that starts at tile_start, so filtering never reads from a
+     * neighbouring tile
+     */
+    inline int clamp_to_tile(int coord, int tile_start, int tile_length) {
+        return tile_start + std::min(std::max(coord - tile_start, 0), tile_length - 1);
+    }
+
+    /*!
+     * \brief Writes the weighted sum of some RGBA pixels
+     */
+    inline void weighted_sum(float* out, const float* const* samples, const float* weights, int count) {
+#ifdef NOVA_USE_SSE
+        __m128 sum = _mm_setzero_ps();
+        for(int i = 0; i < count; i++) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(samples[i]), _mm_set1_ps(weights[i])));
+        }
+        _mm_storeu_ps(out, sum);
+#else
+        float sum[4] = {0, 0, 0, 0};
+        for(int i = 0; i < count; i++) {
+            for(int channel = 0; channel < 4; channel++) {
+                sum[channel] += samples[i][channel] * weights[i];
+            }
+        }
+        std::copy(sum, sum + 4, out);
+#endif
+    }
+
+    glm::ivec2 get_next_level_size(const glm::ivec2& size) {
+        return {std::max(size.x / 2, 1), std::max(size.y / 2, 1)};
+    }
+
+    float_image to_float_image(const uint8_t* rgba, const glm::ivec2& size, const glm::ivec2& tile_size, bool gamma_correct, job_system* jobs) {
+        float_image image;
+        image.size = size;
+        image.tile_size = tile_size;
+        image.texels.resize(static_cast<size_t>(size.x) * size.y * 4);
+
+        const auto& srgb_table = get_srgb_to_linear_table();
+        for_each_batch(jobs, static_cast<size_t>(size.y), ROWS_PER_MIPMAP_JOB, [&](size_t first_row, size_t last_row) {
+            for(size_t y = first_row; y < last_row; y++) {
+                for(int x = 0; x < size.x; x++) {
+                    const uint8_t* source = rgba + (y * size.x + x) * 4;
+                    float* dest = image.pixel(x, static_cast<int>(y));
+                    float alpha = source[3] / 255.0f;
+                    for(int channel = 0; channel < 3; channel++) {
+                        float color = gamma_correct ? srgb_table[source[channel]] : source[channel] / 255.0f;
+                        dest[channel] = color * alpha;
+                    }
+                    dest[3] = alpha;
+                }
+            }
+        });
+
+        return image;
+    }
+
+    float_image downsample_box(const float_image& source, job_system* jobs) {
+        float_image dest;
+        dest.size = get_next_level_size(source.size);
+        dest.tile_size = get_next_level_size(source.tile_size);
+        dest.texels.resize(static_cast<size_t>(dest.size.x) * dest.size.y * 4);
+
+        const float weights[4] = {0.25f, 0.25f, 0.25f, 0.25f};
+        for_each_batch(jobs, static_cast<size_t>(dest.size.y), ROWS_PER_MIPMAP_JOB, [&](size_t first_row, size_t last_row) {
+            for(int y = static_cast<int>(first_row); y < static_cast<int>(last_row); y++) {
+                int tile_start_y = (2 * y / source.tile_size.y) * source.tile_size.y;
+                int y0 = clamp_to_tile(2 * y, tile_start_y, source.tile_size.y);
+                int y1 = clamp_to_tile(2 * y + 1, tile_start_y, source.tile_size.y);
+
+                for(int x = 0; x < dest.size.x; x++) {
+                    int tile_start_x = (2 * x / source.tile_size.x) * source.tile_size.x;
+                    int x0 = clamp_to_tile(2 * x, tile_start_x, source.tile_size.x);
+                    int x1 = clamp_to_tile(2 * x + 1, tile_start_x, source.tile_size.x);
+
+                    const float* samples[4] = {source.pixel(x0, y0), source.pixel(x1, y0), source.pixel(x0, y1), source.pixel(x1, y1)};
+                    weighted_sum(dest.pixel(x, y), samples, weights, 4);
+                }
+            }
+        });
+
+        return dest;
+    }
+
+    float_image downsample_kaiser(const float_image& source, job_system* jobs) {
+        const auto& weights = get_kaiser_weights();
+        const int first_tap_offset = -(KAISER_TAPS / 2 - 1);
+
+        glm::ivec2 dest_size = get_next_level_size(source.size);
+
+        // The filter is separable, so shrink horizontally first then vertically
+        float_image horizontal;
+        horizontal.size = {dest_size.x, source.size.y};
+        horizontal.tile_size = source.tile_size;
+        horizontal.texels.resize(static_cast<size_t>(horizontal.size.x) * horizontal.size.y * 4);
+
+        for_each_batch(jobs, static_cast<size_t>(horizontal.size.y), ROWS_PER_MIPMAP_JOB, [&](size_t first_row, size_t last_row) {
+            const float* samples[KAISER_TAPS];
+            for(int y = static_cast<int>(first_row); y < static_cast<int>(last_row); y++) {
+                for(int x = 0; x < horizontal.size.x; x++) {
+                    int tile_start = (2 * x / source.tile_size.x) * source.tile_size.x;
+                    for(int tap = 0; tap < KAISER_TAPS; tap++) {
+                        int source_x = clamp_to_tile(2 * x + first_tap_offset + tap, tile_start, source.tile_size.x);
+                        samples[tap] = source.pixel(source_x, y);
+                    }
+                    weighted_sum(horizontal.pixel(x, y), samples, weights.data(), KAISER_TAPS);
+                }
+            }
+        });
+
+        float_image dest;
+        dest.size = dest_size;
+        dest.tile_size = get_next_level_size(source.tile_size);
+        dest.texels.resize(static_cast<size_t>(dest.size.x) * dest.size.y * 4);
+
+        for_each_batch(jobs, static_cast<size_t>(dest.size.y), ROWS_PER_MIPMAP_JOB, [&](size_t first_row, size_t last_row) {
+            const float* samples[KAISER_TAPS];
+            for(int y = static_cast<int>(first_row); y < static_cast<int>(last_row); y++) {
+                int tile_start = (2 * y / source.tile_size.y) * source.tile_size.y;
+                int source_rows[KAISER_TAPS];
+                for(int tap = 0; tap < KAISER_TAPS; tap++) {
+                    source_rows[tap] = clamp_to_tile(2 * y + first_tap_offset + tap, tile_start, source.tile_size.y);
+                }
+
+                for(int x = 0; x < dest.size.x; x++) {
+                    for(int tap = 0; tap < KAISER_TAPS; tap++) {
+                        samples[tap] = horizontal.pixel(x, source_rows[tap]);
+                    }
+                    float* out = dest.pixel(x, y);
+                    weighted_sum(out, samples, weights.data(), KAISER_TAPS);
+
+                    // The negative lobes can ring past the valid range, and color can't be more than alpha once it's
+                    // premultiplied
+                    out[3] = std::min(std::max(out[3], 0.0f), 1.0f);
+                    for(int channel = 0; channel < 3; channel++) {
+                        out[channel] = std::min(std::max(out[channel], 0.0f), out[3]);
+                    }
+                }
+            }
+        });
+
+        return dest;
+    }
+
+    /*!
+     * \brief What the alpha test does to each tile of the base level
+     */
+    struct tile_coverage {
+        /*!
+         * \brief True if every pixel in the tile is fully opaque or fully transparent, and at least one is fully
+         * transparent
+         */
+        bool is_cutout;
+
+        /*!
+         * \brief The fraction of pixels in the tile that pass the alpha test
+         */
+        float coverage;
+    };
+
+    std::vector<tile_coverage> compute_base_coverage(const uint8_t* rgba, const glm::ivec2& size, const glm::ivec2& tile_size, float alpha_cutoff, job_system* jobs) {
+        glm::ivec2 num_tiles = size / tile_size;
+        std::vector<tile_coverage> coverages(static_cast<size_t>(num_tiles.x) * num_tiles.y);
+        int cutoff = static_cast<int>(std::ceil(alpha_cutoff * 255.0f));
+
+        for_each_batch(jobs, coverages.size(), TILES_PER_COVERAGE_JOB, [&](size_t first_tile, size_t last_tile) {
+            for(size_t tile = first_tile; tile < last_tile; tile++) {
+                int tile_x = static_cast<int>(tile % num_tiles.x) * tile_size.x;
+                int tile_y = static_cast<int>(tile / num_tiles.x) * tile_size.y;
+
+                bool only_binary_alpha = true;
+                bool has_transparency = false;
+                size_t num_passing = 0;
+                for(int y = tile_y; y < tile_y + tile_size.y; y++) {
+                    for(int x = tile_x; x < tile_x + tile_size.x; x++) {
+                        uint8_t alpha = rgba[(static_cast<size_t>(y) * size.x + x) * 4 + 3];
+                        only_binary_alpha = only_binary_alpha && (alpha == 0 || alpha == 255);
+                        has_transparency = has_transparency || alpha == 0;
+                        num_passing += alpha >= cutoff ? 1 : 0;
+                    }
+                }
+
+                coverages[tile].is_cutout = only_binary_alpha && has_transparency;
+                coverages[tile].coverage = num_passing / float(tile_size.x * tile_size.y);
+            }
+        });
+
+        return coverages;
+    }
+
+    /*!
+     * \brief Finds, for each cutout tile, how much to scale the alpha of this mip level by so that as much of the
+     * tile passes the alpha test as in the base level
+     */
+    std::vector<float> compute_alpha_scales(const float_image& image, const std::vector<tile_coverage>& base_coverage, float alpha_cutoff, job_system* jobs) {
+        glm::ivec2 num_tiles = image.size / image.tile_size;
+        std::vector<float> scales(base_coverage.size(), 1.0f);
+
+        for_each_batch(jobs, scales.size(), TILES_PER_COVERAGE_JOB, [&](size_t first_tile, size_t last_tile) {
+            std::vector<float> alphas;
+            for(size_t tile = first_tile; tile < last_tile; tile++) {
+                if(!base_coverage[tile].is_cutout) {
+                    continue;
+                }
+
+                int tile_x = static_cast<int>(tile % num_tiles.x) * image.tile_size.x;
+                int tile_y = static_cast<int>(tile / num_tiles.x) * image.tile_size.y;
+
+                alphas.clear();
+                for(int y = tile_y; y < tile_y + image.tile_size.y; y++) {
+                    for(int x = tile_x; x < tile_x + image.tile_size.x; x++) {
+                        alphas.push_back(image.pixel(x, y)[3]);
+                    }
+                }
+
+                // For the right number of pixels to pass, the alpha of the Nth most opaque pixel has to end up
+                // exactly at the cutoff
+                auto num_passing = static_cast<size_t>(std::lround(base_coverage[tile].coverage * alphas.size()));
+                if(num_passing == 0) {
+                    continue;
+                }
+
+                auto nth = alphas.begin() + (num_passing - 1);
+                std::nth_element(alphas.begin(), nth, alphas.end(), std::greater<float>());
+                if(*nth > 0) {
+                    scales[tile] = alpha_cutoff / *nth;
+                }
+            }
+        });
+
+        return scales;
+    }
+
+    mip_level to_mip_level(const float_image& image, const std::vector<float>& alpha_scales, bool gamma_correct, job_system* jobs) {
+        mip_level level;
+        level.size = image.size;
+        level.pixels.resize(static_cast<size_t>(image.size.x) * image.size.y * 4);
+
+        int num_tiles_x = image.size.x / image.tile_size.x;
+        const auto& srgb_table = get_linear_to_srgb_table();
+
+        for_each_batch(jobs, static_cast<size_t>(image.size.y), ROWS_PER_MIPMAP_JOB, [&](size_t first_row, size_t last_row) {
+            for(int y = static_cast<int>(first_row); y < static_cast<int>(last_row); y++) {
+                for(int x = 0; x < image.size.x; x++) {
+                    const float* source = image.pixel(x, y);
+                    uint8_t* dest = &level.pixels[(static_cast<size_t>(y) * image.size.x + x) * 4];
+
+                    float alpha = source[3];
+                    for(int channel = 0; channel < 3; channel++) {
+                        float color = alpha > 0 ? std::min(source[channel] / alpha, 1.0f) : 0.0f;
+                        if(gamma_correct) {
+                            dest[channel] = srgb_table[static_cast<size_t>(color * (LINEAR_TO_SRGB_TABLE_SIZE - 1) + 0.5f)];
+                        } else {
+                            dest[channel] = static_cast<uint8_t>(color * 255.0f + 0.5f);
+                        }
+                    }
+
+                    if(!alpha_scales.empty()) {
+                        size_t tile = static_cast<size_t>(y / image.tile_size.y) * num_tiles_x + x / image.tile_size.x;
+                        alpha = std::min(alpha * alpha_scales[tile], 1.0f);
+                    }
+                    dest[3] = static_cast<uint8_t>(alpha * 255.0f + 0.5f);
+                }
+            }
+        });
+
+        return level;
+    }
+
+    std::vector<mip_level> build_mipmaps(const uint8_t* rgba, const glm::ivec2& size, const mipmap_options& options, job_system* jobs) {
+        std::vector<mip_level> levels;
+        size_t num_levels = count_mip_levels(size, options);
+        if(num_levels <= 1) {
+            return levels;
+        }
+
+        glm::ivec2 tile_size = get_effective_tile_size(size, options);
+
+        std::vector<tile_coverage> base_coverage;
+        if(options.preserve_alpha_coverage) {
+            base_coverage = compute_base_coverage(rgba, size, tile_size, options.alpha_cutoff, jobs);
+        }
+
+        float_image current_level = to_float_image(rgba, size, tile_size, options.gamma_correct, jobs);
+        levels.reserve(num_levels - 1);
+
+        for(size_t level = 1; level < num_levels; level++) {
+            if(options.filter == mipmap_filter::kaiser) {
+                current_level = downsample_kaiser(current_level, jobs);
+            } else {
+                current_level = downsample_box(current_level, jobs);
+            }
+
+            std::vector<float> alpha_scales;
+            if(options.preserve_alpha_coverage) {
+                alpha_scales = compute_alpha_scales(current_level, base_coverage, options.alpha_cutoff, jobs);
+            }
+
+            levels.push_back(to_mip_level(current_level, alpha_scales, options.gamma_correct, jobs));
+        }
+
+        return levels;
+    }
+}
@@ -0,0 +1,102 @@
+/*!
+ * \brief Builds mipmap chains for texture atlases on the CPU
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_MIPMAP_BUILDER_H
+#define RENDERER_MIPMAP_BUILDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../../../utils/job_system.h"
+
+namespace nova {
+    /*!
+     * \brief The filter used to shrink each mip level into the next one
+     */
+    enum class mipmap_filter {
+        /*!
+         * \brief Averages each 2x2 block of pixels. Fast, but a little blurry
+         */
+        box,
+
+        /*!
+         * \brief An eight tap Kaiser-windowed sinc. Keeps more detail than the box filter, at about four times the
+         * cost
+         */
+        kaiser,
+    };
+
+    struct mipmap_options {
+        mipmap_filter filter = mipmap_filter::kaiser;
+
+        /*!
+         * \brief If true the color channels are treated as sRGB and filtered in linear space, so mip levels don't
+         * get darker than the base texture
+         */
+        bool gamma_correct = true;
+
+        /*!
+         * \brief If true, the alpha of cutout tiles - tiles where every pixel is either fully opaque or fully
+         * transparent, like leaves and grass - is scaled in each mip level so that the same fraction of the tile
+         * passes the alpha test as in the base level. Without this, cutout textures fade away in the distance
+         */
+        bool preserve_alpha_coverage = true;
+
+        /*!
+         * \brief The alpha value, from 0 to 1, that the shaders test against for cutout textures
+         */
+        float alpha_cutoff = 0.5f;
+
+        /*!
+         * \brief The size of each tile in the atlas, in pixels
+         *
+         * Filtering never reads across the edge of a tile, so tiles don't bleed into each other. Must be a power of
+         * two in each dimension and evenly divide the image, otherwise the whole image is treated as one tile. The
+         * mip chain stops when the tiles are one pixel big. Leave it at (0, 0) for a texture that isn't an atlas
+         */
+        glm::ivec2 tile_size = {0, 0};
+
+        /*!
+         * \brief The maximum number of mip levels, including the base level. 0 means no limit
+         */
+        size_t max_levels = 0;
+    };
+
+    /*!
+     * \brief One level of a mip chain, as RGBA8 pixels
+     */
+    struct mip_level {
+        glm::ivec2 size;
+        std::vector<uint8_t> pixels;
+    };
+
+    /*!
+     * \brief Works out how many mip levels, including the base level, an image gets with the given options
+     *
+     * \param size The size of the base level
+     * \param options The options the mip chain will be built with
+     */
+    size_t count_mip_levels(const glm::ivec2& size, const mipmap_options& options);
+
+    /*!
+     * \brief Builds every mip level below the base level of an RGBA8 image
+     *
+     * Each level is filtered from the one above it, keeping full float precision the whole way down. Colors are
+     * filtered premultiplied by alpha, so fully transparent pixels don't bleed their (usually black) color into
+     * their neighbours
+     *
+     * \param rgba The base level, as tightly packed RGBA8 pixels
+     * \param size The size of the base level
+     * \param options How to build the mip chain
+     * \param jobs The job system to do the filtering on. If it's null, everything is done on the calling thread
+     * \return The mip levels, starting with the level half the size of the base level
+     */
+    std::vector<mip_level> build_mipmaps(const uint8_t* rgba, const glm::ivec2& size, const mipmap_options& options, job_system* jobs = nullptr);
+}
+
+#endif //RENDERER_MIPMAP_BUILDER_H
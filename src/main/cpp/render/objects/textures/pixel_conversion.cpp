@@ -0,0 +1,47 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include "pixel_conversion.h"
+
+#if defined(__SSSE3__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#define NOVA_USE_SSSE3
+#include <tmmintrin.h>
+#endif
+
+namespace nova {
+    /*!
+     * \brief How many pixels each job converts. Big enough that a job takes a lot longer than submitting it
+     */
+    const size_t PIXELS_PER_CONVERSION_JOB = 64 * 1024;
+
+    void expand_rgb_to_rgba(const uint8_t* rgb, uint8_t* rgba, size_t num_pixels) {
+        size_t pixel = 0;
+
+#ifdef NOVA_USE_SSSE3
+        // Each iteration reads 16 bytes but only uses the first 12 (four pixels), so stop while there are still at
+        // least 16 bytes left to read
+        const __m128i spread_pixels = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+        for(; pixel + 6 <= num_pixels; pixel += 4) {
+            __m128i source = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + pixel * 3));
+            __m128i expanded = _mm_or_si128(_mm_shuffle_epi8(source, spread_pixels), alpha);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + pixel * 4), expanded);
+        }
+#endif
+
+        for(; pixel < num_pixels; pixel++) {
+            rgba[pixel * 4 + 0] = rgb[pixel * 3 + 0];
+            rgba[pixel * 4 + 1] = rgb[pixel * 3 + 1];
+            rgba[pixel * 4 + 2] = rgb[pixel * 3 + 2];
+            rgba[pixel * 4 + 3] = 255;
+        }
+    }
+
+    void expand_rgb_to_rgba(job_system& jobs, const uint8_t* rgb, uint8_t* rgba, size_t num_pixels) {
+        jobs.parallel_for(num_pixels, PIXELS_PER_CONVERSION_JOB, [=](size_t begin, size_t end) {
+            expand_rgb_to_rgba(rgb + begin * 3, rgba + begin * 4, end - begin);
+        });
+    }
+}
@@ -0,0 +1,41 @@
+/*!
+ * \brief Functions to convert pixel data into a format that OpenGL can take directly
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_PIXEL_CONVERSION_H
+#define RENDERER_PIXEL_CONVERSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include "../../../utils/job_system.h"
+
+namespace nova {
+    /*!
+     * \brief Expands tightly packed RGB pixels into RGBA pixels with an alpha of 255
+     *
+     * Uploading three-component textures is slow on most drivers, and rows that aren't a multiple of four bytes long
+     * trip up GL_UNPACK_ALIGNMENT, so RGB textures are expanded before they're uploaded. Uses SSSE3 when the compiler
+     * targets it, and a scalar loop otherwise
+     *
+     * \param rgb The RGB pixels, three bytes each
+     * \param rgba Where to write the RGBA pixels, four bytes each. Must not overlap rgb
+     * \param num_pixels The number of pixels to convert
+     */
+    void expand_rgb_to_rgba(const uint8_t* rgb, uint8_t* rgba, size_t num_pixels);
+
+    /*!
+     * \brief Expands tightly packed RGB pixels into RGBA pixels with an alpha of 255, splitting the work across the
+     * job system
+     *
+     * \param jobs The job system to do the conversion on
+     * \param rgb The RGB pixels, three bytes each
+     * \param rgba Where to write the RGBA pixels, four bytes each. Must not overlap rgb
+     * \param num_pixels The number of pixels to convert
+     */
+    void expand_rgb_to_rgba(job_system& jobs, const uint8_t* rgb, uint8_t* rgba, size_t num_pixels);
+}
+
+#endif //RENDERER_PIXEL_CONVERSION_H
@@ -3,25 +3,66 @@
 //
 
 #include "texture2D.h"
+#include <algorithm>
 #include <stdexcept>
 #include <easylogging++.h>
 #include "../../../utils/utils.h"
 
 namespace nova {
-    texture2D::texture2D() : size(0) {
-        glGenTextures(1, &gl_name);
+    texture2D::texture2D() : size(0), format(0) {
+        glCreateTextures(GL_TEXTURE_2D, 1, &gl_name);
     }
 
-    void texture2D::set_data(void* pixel_data, glm::ivec2 &dimensions, GLenum format, GLenum type, GLenum internal_format) {
-        GLint previous_texture;
-        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous_texture);
-        glBindTexture(GL_TEXTURE_2D, gl_name);
-        glTexImage2D(GL_TEXTURE_2D, 0, internal_format, dimensions.x, dimensions.y, 0, format, type, pixel_data);
+    void texture2D::set_data(const void* pixel_data, const glm::ivec2 &dimensions, GLenum format, GLenum type, GLenum internal_format) {
+        set_mipmapped_data({pixel_data}, dimensions, format, type, internal_format);
+    }
+
+    void texture2D::set_mipmapped_data(const std::vector<const void*> &level_data, const glm::ivec2 &dimensions, GLenum format, GLenum type, GLenum internal_format) {
+        auto levels = (GLsizei) level_data.size();
+        if(!has_storage || dimensions.x != size.x || dimensions.y != size.y || (GLint) internal_format != this->format || levels != num_levels) {
+            allocate_storage(dimensions, internal_format, levels);
+        }
+
+        // Textures with one or two components can have rows that aren't a multiple of four bytes
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for(GLsizei level = 0; level < levels; level++) {
+            GLsizei width = std::max(dimensions.x >> level, 1);
+            GLsizei height = std::max(dimensions.y >> level, 1);
+            glTextureSubImage2D(gl_name, level, 0, 0, width, height, format, type, level_data[level]);
+        }
+    }
+
+    void texture2D::set_compressed_data(const std::vector<const void*> &level_data, const std::vector<GLsizei> &level_sizes, const glm::ivec2 &dimensions, GLenum internal_format) {
+        auto levels = (GLsizei) level_data.size();
+        if(!has_storage || dimensions.x != size.x || dimensions.y != size.y || (GLint) internal_format != this->format || levels != num_levels) {
+            allocate_storage(dimensions, internal_format, levels);
+        }
+
+        for(GLsizei level = 0; level < levels; level++) {
+            GLsizei width = std::max(dimensions.x >> level, 1);
+            GLsizei height = std::max(dimensions.y >> level, 1);
+            glCompressedTextureSubImage2D(gl_name, level, 0, 0, width, height, internal_format, level_sizes[level], level_data[level]);
+        }
+    }
+
+    void texture2D::allocate_storage(const glm::ivec2 &dimensions, GLenum internal_format, GLsizei levels) {
+        if(has_storage) {
+            // Immutable storage can't be resized, so the only option is a brand new texture
+            glDeleteTextures(1, &gl_name);
+            glCreateTextures(GL_TEXTURE_2D, 1, &gl_name);
+        }
+
+        glTextureStorage2D(gl_name, levels, internal_format, dimensions.x, dimensions.y);
+
+        // Blend between mip levels, but keep the pixels within a level sharp
+        glTextureParameteri(gl_name, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_NEAREST_MIPMAP_LINEAR : GL_NEAREST);
+        glTextureParameteri(gl_name, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTextureParameteri(gl_name, GL_TEXTURE_MAX_LEVEL, levels - 1);
 
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        
-        glBindTexture(GL_TEXTURE_2D, (GLuint) previous_texture);
+        size = dimensions;
+        format = internal_format;
+        num_levels = levels;
+        has_storage = true;
     }
 
     void texture2D::bind(unsigned int binding) {
@@ -73,11 +73,40 @@ namespace nova {
          * It's worth noting that this function doesn't do any validation on its data. You specified a LDR texture format
          * but you gave me HDR data? Sure hope the GPU can deal with that
          *
-         * \param pixel_data The raw pixel_data
+         * The texture uses immutable storage. Setting data with the same size and internal format as last time just
+         * overwrites the pixels, which is cheap. Changing the size or internal format means a new GL texture has to be
+         * created, so get_gl_name will return something different afterwards
+         *
+         * \param pixel_data The raw pixel_data. Rows are tightly packed, with no padding at the end of each row
          * \param dimensions An array of the dimensions in this texture. For a texture2D that array MUST have two elements
          * \param format The format of the texture data
+         * \param type The type of each component of the texture data
+         * \param internal_format The sized format to store the texture in, like GL_RGBA8 or GL_SRGB8_ALPHA8
          */
-        void set_data(void* pixel_data, glm::ivec2 &dimensions, GLenum format, GLenum type = GL_FLOAT, GLenum internal_format = GL_RGBA);
+        void set_data(const void* pixel_data, const glm::ivec2 &dimensions, GLenum format, GLenum type = GL_UNSIGNED_BYTE, GLenum internal_format = GL_RGBA8);
+
+        /*!
+         * \brief Sets this texture's data along with all its mip levels, and turns on mipmapped filtering
+         *
+         * \param level_data The pixels of each mip level, starting with the base level. Level N must be
+         * max(1, dimensions >> N) pixels big
+         * \param dimensions The size of the base level
+         * \param format The format of the texture data
+         * \param type The type of each component of the texture data
+         * \param internal_format The sized format to store the texture in
+         */
+        void set_mipmapped_data(const std::vector<const void*> &level_data, const glm::ivec2 &dimensions, GLenum format, GLenum type = GL_UNSIGNED_BYTE, GLenum internal_format = GL_RGBA8);
+
+        /*!
+         * \brief Sets this texture's data to already block-compressed data, along with all its mip levels
+         *
+         * \param level_data The compressed blocks of each mip level, starting with the base level. Level N must be
+         * max(1, dimensions >> N) pixels big
+         * \param level_sizes The size of each mip level's data, in bytes
+         * \param dimensions The size of the base level, in pixels
+         * \param internal_format The compressed format of the data, like GL_COMPRESSED_RGBA_BPTC_UNORM
+         */
+        void set_compressed_data(const std::vector<const void*> &level_data, const std::vector<GLsizei> &level_sizes, const glm::ivec2 &dimensions, GLenum internal_format);
 
         void set_filtering_parameters(texture_filtering_params &params);
 
@@ -116,6 +145,13 @@ namespace nova {
         GLuint gl_name;
         GLint current_location = -1;
         std::string name;
+        bool has_storage = false;
+        GLsizei num_levels = 0;
+
+        /*!
+         * \brief Allocates immutable storage for this texture, replacing the GL texture if it already has storage
+         */
+        void allocate_storage(const glm::ivec2 &dimensions, GLenum internal_format, GLsizei levels);
     };
 }
 
@@ -0,0 +1,162 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <easylogging++.h>
+#include "texture_cache.h"
+#include "../../../utils/utils.h"
+
+namespace nova {
+    /*!
+     * \brief Bump this whenever the file layout or the way textures are processed changes, so old files get ignored
+     */
+    const uint32_t CACHE_FILE_VERSION = 1;
+
+    const char CACHE_FILE_MAGIC[4] = {'N', 'V', 'T', 'X'};
+
+    /*!
+     * \brief Level data starts on a multiple of this many bytes
+     */
+    const uint64_t LEVEL_ALIGNMENT = 16;
+
+    struct cache_file_header {
+        char magic[4];
+        uint32_t version;
+        uint64_t key;
+        uint32_t format;
+        uint32_t num_levels;
+    };
+
+    struct cache_level_header {
+        uint64_t offset;
+        uint64_t size;
+        int32_t width;
+        int32_t height;
+    };
+
+    texture_cache::texture_cache(const std::string& directory) : directory(directory) {
+        make_directories(directory);
+    }
+
+    std::unique_ptr<texture_cache::entry> texture_cache::load(uint64_t key) {
+        std::unique_ptr<entry> cached;
+        try {
+            cached = std::make_unique<entry>(mapped_file(get_path(key)));
+        } catch(resource_not_found& e) {
+            num_misses++;
+            return nullptr;
+        }
+
+        const uint8_t* data = cached->file.get_data();
+        size_t size = cached->file.get_size();
+
+        cache_file_header header;
+        if(size < sizeof(header)) {
+            LOG(WARNING) << "Cached texture " << get_path(key) << " is too small to be a cached texture, ignoring it";
+            num_misses++;
+            return nullptr;
+        }
+        std::memcpy(&header, data, sizeof(header));
+
+        bool is_valid = std::memcmp(header.magic, CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC)) == 0 &&
+                        header.version == CACHE_FILE_VERSION && header.key == key &&
+                        sizeof(header) + header.num_levels * sizeof(cache_level_header) <= size;
+        if(!is_valid) {
+            LOG(WARNING) << "Cached texture " << get_path(key) << " is from a different version of Nova or is damaged, ignoring it";
+            num_misses++;
+            return nullptr;
+        }
+
+        cached->format = header.format;
+        for(uint32_t i = 0; i < header.num_levels; i++) {
+            cache_level_header level_header;
+            std::memcpy(&level_header, data + sizeof(header) + i * sizeof(cache_level_header), sizeof(level_header));
+            if(level_header.offset > size || level_header.size > size - level_header.offset) {
+                LOG(WARNING) << "Cached texture " << get_path(key) << " is truncated, ignoring it";
+                num_misses++;
+                return nullptr;
+            }
+
+            cached->levels.push_back({{level_header.width, level_header.height}, data + level_header.offset, static_cast<size_t>(level_header.size)});
+        }
+
+        num_hits++;
+        return cached;
+    }
+
+    bool texture_cache::store(uint64_t key, uint32_t format, const std::vector<level>& levels) {
+        std::string path = get_path(key);
+        std::string temp_path = path + ".tmp";
+
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            if(!file.is_open()) {
+                LOG(WARNING) << "Could not open " << temp_path << " to cache a texture";
+                return false;
+            }
+
+            cache_file_header header = {};
+            std::memcpy(header.magic, CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC));
+            header.version = CACHE_FILE_VERSION;
+            header.key = key;
+            header.format = format;
+            header.num_levels = static_cast<uint32_t>(levels.size());
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            uint64_t offset = sizeof(header) + levels.size() * sizeof(cache_level_header);
+            std::vector<uint64_t> offsets;
+            for(const auto& level : levels) {
+                offset = (offset + LEVEL_ALIGNMENT - 1) / LEVEL_ALIGNMENT * LEVEL_ALIGNMENT;
+                offsets.push_back(offset);
+
+                cache_level_header level_header = {offset, level.data_size, level.size.x, level.size.y};
+                file.write(reinterpret_cast<const char*>(&level_header), sizeof(level_header));
+                offset += level.data_size;
+            }
+
+            const char padding[LEVEL_ALIGNMENT] = {};
+            for(size_t i = 0; i < levels.size(); i++) {
+                auto position = static_cast<uint64_t>(file.tellp());
+                file.write(padding, static_cast<std::streamsize>(offsets[i] - position));
+                file.write(reinterpret_cast<const char*>(levels[i].data), static_cast<std::streamsize>(levels[i].data_size));
+            }
+
+            if(!file.good()) {
+                LOG(WARNING) << "Could not write a cached texture to " << temp_path;
+                file.close();
+                std::remove(temp_path.c_str());
+                return false;
+            }
+        }
+
+        // rename won't replace an existing file everywhere, so get rid of any old version first
+        std::remove(path.c_str());
+        if(std::rename(temp_path.c_str(), path.c_str()) != 0) {
+            LOG(WARNING) << "Could not move cached texture " << temp_path << " to " << path;
+            std::remove(temp_path.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    size_t texture_cache::get_num_hits() const {
+        return num_hits;
+    }
+
+    size_t texture_cache::get_num_misses() const {
+        return num_misses;
+    }
+
+    std::string texture_cache::get_path(uint64_t key) const {
+        std::stringstream path;
+        path << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".nvtex";
+        return path.str();
+    }
+}
@@ -0,0 +1,97 @@
+/*!
+ * \brief A disk cache of textures that have already been processed and are ready to upload
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_TEXTURE_CACHE_H
+#define RENDERER_TEXTURE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../../../utils/mapped_file.h"
+
+namespace nova {
+    /*!
+     * \brief Stores the GPU-ready data of processed textures - every mip level, compressed or not - so that loading
+     * the same texture with the same options again doesn't need any processing
+     *
+     * Each texture is one file in the cache directory, named after its key. Cached textures are memory mapped when
+     * they're loaded, so their data goes from the page cache to the GPU without being copied
+     *
+     * Keys are a hash of everything that goes into processing a texture: its pixels and the options it was processed
+     * with. Use nova::hash_bytes and nova::hash_value to build them
+     */
+    class texture_cache {
+    public:
+        /*!
+         * \brief One mip level of a cached texture
+         */
+        struct level {
+            glm::ivec2 size;
+            const uint8_t* data;
+            size_t data_size;
+        };
+
+        /*!
+         * \brief A texture loaded from the cache. The level data points into the mapped file, so it's only valid for
+         * as long as the entry is around
+         */
+        struct entry {
+            explicit entry(mapped_file&& file) : file(std::move(file)) {}
+
+            mapped_file file;
+
+            /*!
+             * \brief The format the texture was stored with. The cache doesn't care what it means, but it's usually the
+             * texture's OpenGL internal format
+             */
+            uint32_t format;
+
+            std::vector<level> levels;
+        };
+
+        /*!
+         * \param directory The directory to keep the cached textures in. It's created if it doesn't exist
+         */
+        explicit texture_cache(const std::string& directory);
+
+        /*!
+         * \brief Loads the texture with the given key
+         *
+         * \return The texture, or nullptr if it's not in the cache or its file is damaged
+         */
+        std::unique_ptr<entry> load(uint64_t key);
+
+        /*!
+         * \brief Saves a texture in the cache
+         *
+         * The texture is written to a temporary file that's renamed when it's done, so a crash halfway through doesn't
+         * leave a broken file behind
+         *
+         * \param key The key to save the texture with
+         * \param format The texture's format
+         * \param levels The texture's mip levels, starting with the base level
+         * \return True if the texture was saved
+         */
+        bool store(uint64_t key, uint32_t format, const std::vector<level>& levels);
+
+        size_t get_num_hits() const;
+
+        size_t get_num_misses() const;
+
+    private:
+        std::string directory;
+        size_t num_hits = 0;
+        size_t num_misses = 0;
+
+        std::string get_path(uint64_t key) const;
+    };
+}
+
+#endif //RENDERER_TEXTURE_CACHE_H
@@ -4,11 +4,67 @@
  */
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <easylogging++.h>
 #include "texture_manager.h"
+#include "pixel_conversion.h"
+#include "../../nova_renderer.h"
+#include "../../../utils/utils.h"
 
 namespace nova {
-    texture_manager::texture_manager() {
+    const std::string TEXTURE_CACHE_DIRECTORY = "cache/textures";
+
+    /*!
+     * \brief Everything a finished texture's mip levels point into, kept alive until they've been uploaded
+     */
+    struct finished_texture {
+        std::vector<uint8_t> base_level;
+        std::vector<mip_level> mip_levels;
+        std::vector<compressed_image> compressed_levels;
+    };
+
+    /*!
+     * \brief Converts RGB or RGBA pixels to RGBA
+     */
+    std::vector<uint8_t> to_rgba(std::vector<uint8_t>&& pixels, int num_components, job_system& jobs) {
+        if(num_components == 4) {
+            return std::move(pixels);
+        }
+
+        auto num_pixels = pixels.size() / 3;
+        std::vector<uint8_t> rgba_pixels(num_pixels * 4);
+        expand_rgb_to_rgba(jobs, pixels.data(), rgba_pixels.data(), num_pixels);
+        return rgba_pixels;
+    }
+
+    std::string get_page_name(const std::string& atlas_name, size_t page_index) {
+        return page_index == 0 ? atlas_name : atlas_name + "_" + std::to_string(page_index);
+    }
+
+    glm::ivec2 get_smallest_sprite_size(const atlas_page& page) {
+        glm::ivec2 smallest_sprite_size = {0, 0};
+        for(const auto& placement : page.placements) {
+            const auto& sprite_size = placement.second.size;
+            smallest_sprite_size.x = smallest_sprite_size.x == 0 ? sprite_size.x : std::min(smallest_sprite_size.x, sprite_size.x);
+            smallest_sprite_size.y = smallest_sprite_size.y == 0 ? sprite_size.y : std::min(smallest_sprite_size.y, sprite_size.y);
+        }
+        return smallest_sprite_size;
+    }
+
+    GLenum to_gl_format(block_format format) {
+        switch(format) {
+            case block_format::bc1:
+                return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+            case block_format::bc3:
+                return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            case block_format::bc7:
+            default:
+                return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        }
+    }
+
+    texture_manager::texture_manager() : cache(TEXTURE_CACHE_DIRECTORY) {
         LOG(INFO) << "Creating the Texture Manager";
         reset();
         LOG(INFO) << "Texture manager created";
@@ -21,12 +77,13 @@ namespace nova {
     }
 
     void texture_manager::reset() {
-        if(!atlases.empty()) {
+        if(atlases.empty()) {
             // Nothing to deallocate, let's just return
             return;
         }
         // Gather all the textures into a list so we only need one call to delete them
-        std::vector<GLuint> texture_ids(atlases.size());
+        std::vector<GLuint> texture_ids;
+        texture_ids.reserve(atlases.size());
         for(auto tex : atlases) {
             texture_ids.push_back(tex.second.get_gl_name());
         }
@@ -35,6 +92,10 @@ namespace nova {
 
         atlases.clear();
         locations.clear();
+        staged_textures.clear();
+        unpacked_sprites.clear();
+        last_added_texture.clear();
+        uploads.clear();
 
         atlases["lightmap"] = texture2D{};
     }
@@ -44,44 +105,47 @@ namespace nova {
         texture.set_data(data, size, format, type, internal_format);
     }
 
-    void texture_manager::add_texture(mc_atlas_texture &new_texture) {
+    texture_upload_handle texture_manager::add_texture(mc_atlas_texture &new_texture) {
         LOG(INFO) << "Adding texture " << new_texture.name << " (" << new_texture.width << "x" << new_texture.height << ")";
         std::string texture_name = new_texture.name;
-        texture2D texture;
+        auto& texture = atlases[texture_name];
         texture.set_name(texture_name);
-
-        std::vector<float> pixel_data(
-                (size_t) (new_texture.width * new_texture.height * new_texture.num_components));
-        for(int i = 0; i < new_texture.width * new_texture.height * new_texture.num_components; i++) {
-            pixel_data[i] = float(new_texture.texture_data[i]) / 255.0f;
-        }
+        last_added_texture = texture_name;
 
         auto dimensions = glm::ivec2{new_texture.width, new_texture.height};
+        auto num_pixels = static_cast<size_t>(new_texture.width * new_texture.height);
+        bool should_mipmap = texture_name == BLOCK_COLOR_ATLAS_NAME;
 
-        GLenum format = GL_RGB;
+        // The bytes go to the GPU as they are whenever OpenGL can take them that way
+        const uint8_t* data = new_texture.texture_data;
         switch(new_texture.num_components) {
             case 1:
-                format = GL_RED;
-                break;
+                return uploads.enqueue(texture, std::vector<uint8_t>(data, data + num_pixels), dimensions, GL_RED, GL_UNSIGNED_BYTE, GL_R8);
             case 2:
-                format = GL_RG;
-                break;
+                return uploads.enqueue(texture, std::vector<uint8_t>(data, data + num_pixels * 2), dimensions, GL_RG, GL_UNSIGNED_BYTE, GL_RG8);
             case 3:
-                format = GL_RGB;
-                break;
             case 4:
-                format = GL_RGBA;
                 break;
             default:
                 LOG(ERROR) << "Unsupported number of components. You have " << new_texture.num_components
                            << " components "
                            << ", but I need a number in [1,4]";
+                return nullptr;
         }
 
-        texture.set_data(pixel_data.data(), dimensions, format);
+        std::vector<uint8_t> pixels(data, data + num_pixels * new_texture.num_components);
+        if(should_mipmap) {
+            // The mip chain is built once we know where the sprites are. The texture is hashed now so that
+            // finalize_textures can look for it in the cache before converting anything
+            uint64_t input_hash = hash_bytes(pixels.data(), pixels.size());
+            input_hash = hash_value(dimensions, input_hash);
+            input_hash = hash_value(new_texture.num_components, input_hash);
+            staged_textures[texture_name] = {dimensions, new_texture.num_components, std::move(pixels), {0, 0}, input_hash};
+            return nullptr;
+        }
 
-        atlases[texture_name] = texture;
-        LOG(DEBUG) << "Texture atlas " << texture_name << " is OpenGL texture " << texture.get_gl_name();
+        auto rgba_pixels = to_rgba(std::move(pixels), new_texture.num_components, nova_renderer::instance->get_job_system());
+        return uploads.enqueue(texture, std::move(rgba_pixels), dimensions, GL_RGBA, GL_UNSIGNED_BYTE, GL_RGBA8);
     }
 
     void texture_manager::add_texture_location(mc_texture_atlas_location &location) {
@@ -91,8 +155,247 @@ namespace nova {
         };
 
         locations[location.name] = tex_loc;
+
+        auto staged_texture_itr = staged_textures.find(last_added_texture);
+        if(staged_texture_itr != staged_textures.end()) {
+            auto& staged = staged_texture_itr->second;
+            glm::ivec2 sprite_size = {
+                    static_cast<int>(std::lround((location.max_u - location.min_u) * staged.size.x)),
+                    static_cast<int>(std::lround((location.max_v - location.min_v) * staged.size.y))
+            };
+            auto& smallest = staged.smallest_sprite_size;
+            if(sprite_size.x > 0 && sprite_size.y > 0) {
+                smallest.x = smallest.x == 0 ? sprite_size.x : std::min(smallest.x, sprite_size.x);
+                smallest.y = smallest.y == 0 ? sprite_size.y : std::min(smallest.y, sprite_size.y);
+            }
+
+            // Added rather than chained, so the order the locations arrive in doesn't change the hash
+            uint64_t location_hash = hash_bytes(location.name, std::strlen(location.name));
+            location_hash = hash_value(tex_loc, location_hash);
+            staged.input_hash += location_hash;
+        }
+    }
+
+    void texture_manager::add_sprite(const std::string &atlas_name, mc_atlas_texture &sprite) {
+        if(sprite.num_components != 3 && sprite.num_components != 4) {
+            LOG(ERROR) << "Sprite " << sprite.name << " has " << sprite.num_components << " components, but atlases need 3 or 4";
+            return;
+        }
+
+        auto data_size = static_cast<size_t>(sprite.width * sprite.height * sprite.num_components);
+        unpacked_sprite new_sprite = {sprite.name, {sprite.width, sprite.height}, sprite.num_components,
+                                      std::vector<uint8_t>(sprite.texture_data, sprite.texture_data + data_size)};
+
+        // Each sprite is hashed as it arrives, so finalize_textures can look for the finished atlas in the cache
+        // before packing anything. Sprite hashes are added rather than chained, since the order that sprites arrive
+        // in doesn't change the atlas
+        uint64_t sprite_hash = hash_bytes(new_sprite.name.data(), new_sprite.name.size());
+        sprite_hash = hash_value(new_sprite.size, sprite_hash);
+        sprite_hash = hash_value(new_sprite.num_components, sprite_hash);
+        sprite_hash = hash_bytes(new_sprite.pixels.data(), new_sprite.pixels.size(), sprite_hash);
+
+        auto& atlas = unpacked_sprites[atlas_name];
+        atlas.input_hash += sprite_hash;
+        atlas.sprites.push_back(std::move(new_sprite));
+    }
+
+    uint64_t texture_manager::get_layout_key(const unpacked_atlas& atlas) {
+        // The packer splits sprites into atlases based on the biggest atlas the GPU can have
+        uint64_t key = hash_value(atlas.input_hash);
+        return hash_value(get_max_texture_size(), key);
     }
 
+    void texture_manager::add_locations(const atlas_page& page) {
+        glm::vec2 atlas_size = glm::vec2(page.size);
+        for(const auto& placement : page.placements) {
+            glm::vec2 min = glm::vec2(placement.second.position) / atlas_size;
+            glm::vec2 max = glm::vec2(placement.second.position + placement.second.size) / atlas_size;
+            locations[placement.first] = {min, max};
+        }
+    }
+
+    bool texture_manager::load_cached_atlas(const std::string &atlas_name, const unpacked_atlas &atlas) {
+        uint64_t layout_key = get_layout_key(atlas);
+        auto cached_layout = cache.load(layout_key);
+        if(!cached_layout) {
+            return false;
+        }
+
+        std::vector<atlas_page> pages;
+        if(cached_layout->levels.size() != 1 ||
+           !load_atlas_layout(cached_layout->levels[0].data, cached_layout->levels[0].data_size, pages)) {
+            LOG(WARNING) << "The cached layout of " << atlas_name << " is damaged, packing it again";
+            return false;
+        }
+
+        // Only use the cache if every page is there, so a partly cached atlas doesn't end up with missing pages
+        std::vector<std::unique_ptr<texture_cache::entry>> cached_pages;
+        for(size_t page_index = 0; page_index < pages.size(); page_index++) {
+            auto options = get_atlas_mipmap_options(get_smallest_sprite_size(pages[page_index]));
+            auto cached_page = cache.load(make_cache_key(hash_value(page_index, layout_key), options));
+            if(!cached_page) {
+                return false;
+            }
+            cached_pages.push_back(std::move(cached_page));
+        }
+
+        for(size_t page_index = 0; page_index < pages.size(); page_index++) {
+            auto page_name = get_page_name(atlas_name, page_index);
+            LOG(INFO) << "Loaded " << pages[page_index].placements.size() << " sprites in atlas " << page_name << " from the texture cache";
+            add_locations(pages[page_index]);
+
+            auto& texture = atlases[page_name];
+            texture.set_name(page_name);
+            upload_cached_texture(texture, std::move(cached_pages[page_index]));
+        }
+
+        return true;
+    }
+
+    void texture_manager::pack_atlas(const std::string &atlas_name, unpacked_atlas &atlas) {
+        auto& jobs = nova_renderer::instance->get_job_system();
+
+        std::vector<atlas_sprite> sprites;
+        sprites.reserve(atlas.sprites.size());
+        for(auto& sprite : atlas.sprites) {
+            sprites.push_back({sprite.name, sprite.size, to_rgba(std::move(sprite.pixels), sprite.num_components, jobs)});
+        }
+
+        auto pages = pack_sprites(sprites, get_max_texture_size(), &jobs);
+        bool is_mipmapped = atlas_name == BLOCK_COLOR_ATLAS_NAME;
+        uint64_t layout_key = get_layout_key(atlas);
+        if(is_mipmapped) {
+            auto layout = save_atlas_layout(pages);
+            cache.store(layout_key, 0, {{{0, 0}, layout.data(), layout.size()}});
+        }
+
+        for(size_t page_index = 0; page_index < pages.size(); page_index++) {
+            auto& page = pages[page_index];
+            auto page_name = get_page_name(atlas_name, page_index);
+            LOG(INFO) << "Packed " << page.placements.size() << " sprites into " << page.size.x << "x" << page.size.y
+                      << " atlas " << page_name << ", using " << page.efficiency * 100 << "% of its area";
+            add_locations(page);
+
+            atlases[page_name].set_name(page_name);
+            if(is_mipmapped) {
+                uint64_t page_hash = hash_value(page_index, layout_key);
+                staged_textures[page_name] = {page.size, 4, std::move(page.rgba_pixels), get_smallest_sprite_size(page), page_hash};
+            } else {
+                uploads.enqueue(atlases[page_name], std::move(page.rgba_pixels), page.size, GL_RGBA, GL_UNSIGNED_BYTE, GL_RGBA8);
+            }
+        }
+    }
+
+    mipmap_options texture_manager::get_atlas_mipmap_options(const glm::ivec2 &smallest_sprite_size) const {
+        mipmap_options options = atlas_mipmap_options;
+        options.tile_size = smallest_sprite_size;
+
+        if(atlas_compression_format && options.tile_size.x > 0 && options.tile_size.y > 0) {
+            // Once a sprite is smaller than a 4x4 block, every block mixes several sprites' colors together, so
+            // stop the mip chain before that happens
+            size_t max_levels = 1;
+            for(int tile_size = std::min(options.tile_size.x, options.tile_size.y); tile_size > 4; tile_size /= 2) {
+                max_levels++;
+            }
+            options.max_levels = options.max_levels == 0 ? max_levels : std::min(options.max_levels, max_levels);
+        }
+
+        return options;
+    }
+
+    void texture_manager::finalize_textures() {
+        for(auto& entry : unpacked_sprites) {
+            // Only the mipmapped atlas is worth caching. The others are ready as soon as they're packed
+            if(entry.first == BLOCK_COLOR_ATLAS_NAME && load_cached_atlas(entry.first, entry.second)) {
+                continue;
+            }
+            pack_atlas(entry.first, entry.second);
+        }
+        unpacked_sprites.clear();
+
+        auto& jobs = nova_renderer::instance->get_job_system();
+
+        for(auto& entry : staged_textures) {
+            const auto& name = entry.first;
+            auto& staged = entry.second;
+            auto& texture = atlases[name];
+
+            auto options = get_atlas_mipmap_options(staged.smallest_sprite_size);
+            uint64_t cache_key = make_cache_key(staged.input_hash, options);
+            auto cached = cache.load(cache_key);
+            if(cached) {
+                LOG(INFO) << "Loaded " << name << " from the texture cache";
+                upload_cached_texture(texture, std::move(cached));
+                continue;
+            }
+
+            auto finished = std::make_shared<finished_texture>();
+            finished->base_level = to_rgba(std::move(staged.pixels), staged.num_components, jobs);
+
+            LOG(INFO) << "Building mipmaps for " << name << " with " << options.tile_size.x << "x" << options.tile_size.y << " tiles";
+            finished->mip_levels = build_mipmaps(finished->base_level.data(), staged.size, options, &jobs);
+
+            GLenum format = GL_RGBA8;
+            std::vector<texture_cache::level> levels = {{staged.size, finished->base_level.data(), finished->base_level.size()}};
+            for(const auto& level : finished->mip_levels) {
+                levels.push_back({level.size, level.pixels.data(), level.pixels.size()});
+            }
+
+            if(atlas_compression_format) {
+                auto compressed_format = *atlas_compression_format;
+                LOG(INFO) << "Compressing " << name << " to " << compressed_format.to_string() << " at " << atlas_compression_quality.to_string() << " quality";
+
+                for(const auto& level : levels) {
+                    finished->compressed_levels.push_back(compress_image(level.data, level.size, compressed_format, atlas_compression_quality, &jobs));
+                }
+
+                format = to_gl_format(compressed_format);
+                levels.clear();
+                for(const auto& level : finished->compressed_levels) {
+                    levels.push_back({level.size, level.blocks.data(), level.blocks.size()});
+                }
+            }
+
+            cache.store(cache_key, format, levels);
+            uploads.enqueue_levels(texture, levels, finished, format);
+            LOG(DEBUG) << "Texture atlas " << name << " is OpenGL texture " << texture.get_gl_name() << " with " << levels.size() << " mip levels";
+        }
+
+        LOG(INFO) << "Texture cache: " << cache.get_num_hits() << " hits, " << cache.get_num_misses() << " misses so far";
+        staged_textures.clear();
+    }
+
+    uint64_t texture_manager::make_cache_key(uint64_t input_hash, const mipmap_options& options) const {
+        uint64_t key = hash_value(input_hash);
+
+        key = hash_value(static_cast<int32_t>(options.filter), key);
+        key = hash_value(options.gamma_correct, key);
+        key = hash_value(options.preserve_alpha_coverage, key);
+        key = hash_value(options.alpha_cutoff, key);
+        key = hash_value(options.tile_size.x, key);
+        key = hash_value(options.tile_size.y, key);
+        key = hash_value(static_cast<uint64_t>(options.max_levels), key);
+
+        int32_t compression_format = atlas_compression_format ? (*atlas_compression_format).get_value() : -1;
+        key = hash_value(compression_format, key);
+        key = hash_value(atlas_compression_quality.get_value(), key);
+        return key;
+    }
+
+    void texture_manager::upload_cached_texture(texture2D &texture, std::unique_ptr<texture_cache::entry> cached) {
+        // The levels point into the cache file's mapping, which stays around until the upload has copied them
+        std::shared_ptr<texture_cache::entry> owner = std::move(cached);
+        uploads.enqueue_levels(texture, owner->levels, owner, owner->format);
+    }
+
+    void texture_manager::process_uploads() {
+        uploads.process();
+    }
+
+    void texture_manager::set_texture_compression(std::experimental::optional<block_format> format, compression_quality quality) {
+        atlas_compression_format = format;
+        atlas_compression_quality = quality;
+    }
 
     const texture_manager::texture_location texture_manager::get_texture_location(const std::string &texture_name) {
         // If we haven't explicitly added a texture location for this texture, let's just assume that the texture isn't
@@ -10,11 +10,22 @@
 #include <unordered_map>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <optional.hpp>
 #include "../../../mc_interface/mc_objects.h"
 #include "texture2D.h"
+#include "mipmap_builder.h"
+#include "block_compression.h"
+#include "atlas_packer.h"
+#include "texture_cache.h"
+#include "texture_upload_queue.h"
 #include "../../../utils/smart_enum.h"
 
 namespace nova {
+    /*!
+     * \brief The name of the atlas that holds the block textures
+     */
+    const std::string BLOCK_COLOR_ATLAS_NAME = "block_color";
+
     /*!
      * \brief Holds all the textures that the Nova Renderer can deal with
      *
@@ -78,33 +89,77 @@ namespace nova {
         /*!
          * \brief Updates the texture with the given name with the given data
          *
-         * This method is essentially a wrapper around glTexImage2D so the docs for that will give you a lot of good info
+         * This method is essentially a wrapper around glTextureSubImage2D so the docs for that will give you a lot of good
+         * info. If the size or internal format is different from last time, the texture's storage is reallocated
          *
          * \param texture_name The name of the texture to update
          * \param data The data to set as the texture
          * \param size The size of the new texture data
          * \param format The format of the texture data
-         * \param internal_format The internal format of the texture data
+         * \param type The type of each component of the texture data
+         * \param internal_format The sized internal format of the texture, like GL_RGBA8 or GL_SRGB8_ALPHA8
          */
-        void update_texture(std::string texture_name, void* data, glm::ivec2 &size, GLenum format, GLenum type = GL_FLOAT, GLenum internal_format = GL_RGBA);
+        void update_texture(std::string texture_name, void* data, glm::ivec2 &size, GLenum format, GLenum type = GL_UNSIGNED_BYTE, GLenum internal_format = GL_RGBA8);
 
         /*!
          * \brief Adds a texture to this resource manager
          *
-         * The texture is not put into an atlas immediately. Rather, it is held in a staging area until #finalize_textures
-         * is called. Then it's put into an atlas
+         * Most textures are queued up to be streamed to the GPU over the next few frames by #process_uploads.
+         * Textures that get mipmapped (the block atlas) are held in a staging area until #finalize_textures is called,
+         * since the mip chain depends on where the atlas' sprites are
          *
-         * \param new_texture The new texture
+         * \param new_texture The new texture. Its data is copied, so it doesn't have to stay around
+         * \return A handle that says when the texture has been uploaded, or nullptr if the texture was staged or
+         * couldn't be added
          */
-        void add_texture(mc_atlas_texture &new_texture);
+        texture_upload_handle add_texture(mc_atlas_texture &new_texture);
 
         /*!
          * \brief Adds the given texture location to the list of texture locations
          *
+         * Locations are expected to arrive right after the atlas they're in, so each location is assumed to belong to
+         * the most recently added texture
+         *
          * \param location The location to add
          */
         void add_texture_location(mc_texture_atlas_location &location);
 
+        /*!
+         * \brief Adds a single texture that Nova should pack into an atlas itself
+         *
+         * The sprite is held onto until #finalize_textures, which packs all the sprites for each atlas and works out
+         * their texture locations. If the sprites don't all fit into one atlas of #get_max_texture_size, the extra
+         * atlases are named atlas_name_1, atlas_name_2, and so on
+         *
+         * \param atlas_name The name of the atlas that the sprite goes in
+         * \param sprite The sprite. Its name is used as the name of its texture location
+         */
+        void add_sprite(const std::string &atlas_name, mc_atlas_texture &sprite);
+
+        /*!
+         * \brief Packs the sprites added with #add_sprite into atlases, then builds the mip chains of all the staged
+         * textures and uploads them
+         *
+         * Call this once all the textures and texture locations for a resource pack have been added
+         */
+        void finalize_textures();
+
+        /*!
+         * \brief Sets how the staged textures are compressed by #finalize_textures
+         *
+         * Compression cuts the VRAM an atlas uses by four to eight times, and makes sampling it cheaper. Only affects
+         * textures that are finalized after this is called
+         *
+         * \param format The format to compress to, or an empty optional to upload the textures uncompressed
+         * \param quality How hard the compressor tries to find good endpoints
+         */
+        void set_texture_compression(std::experimental::optional<block_format> format, compression_quality quality);
+
+        /*!
+         * \brief Streams some of the queued texture data to the GPU. Call this once a frame
+         */
+        void process_uploads();
+
         /*!
          * \brief Retrieves the texture location for a texture with a specific name
          *
@@ -141,6 +196,115 @@ namespace nova {
         std::unordered_map<std::string, texture_location> locations;
 
         int max_texture_size = -1;
+
+        /*!
+         * \brief A texture that's waiting for #finalize_textures before it's uploaded
+         */
+        struct staged_texture {
+            glm::ivec2 size;
+
+            /*!
+             * \brief 3 or 4. The pixels aren't converted to RGBA until they're needed, which they aren't if the
+             * finished texture is in the cache
+             */
+            int num_components;
+            std::vector<uint8_t> pixels;
+
+            /*!
+             * \brief The size, in pixels, of the smallest sprite in this texture. Mip levels are built one tile of this
+             * size at a time, so sprites don't bleed into each other. (0, 0) if no sprites have been added
+             */
+            glm::ivec2 smallest_sprite_size;
+
+            /*!
+             * \brief A hash of the texture and its locations, built up as they arrive
+             */
+            uint64_t input_hash;
+        };
+
+        std::unordered_map<std::string, staged_texture> staged_textures;
+
+        /*!
+         * \brief A sprite from #add_sprite, as it came from Minecraft
+         */
+        struct unpacked_sprite {
+            std::string name;
+            glm::ivec2 size;
+            int num_components;
+            std::vector<uint8_t> pixels;
+        };
+
+        /*!
+         * \brief All the sprites for one atlas, and a hash of all of them that doesn't depend on their order
+         */
+        struct unpacked_atlas {
+            std::vector<unpacked_sprite> sprites;
+            uint64_t input_hash = 0;
+        };
+
+        /*!
+         * \brief The sprites waiting to be packed, keyed by the name of the atlas they go in
+         */
+        std::unordered_map<std::string, unpacked_atlas> unpacked_sprites;
+
+        /*!
+         * \brief The cache key of an atlas' layout. The key of each of its pages is made from this and the page's
+         * index
+         */
+        uint64_t get_layout_key(const unpacked_atlas& atlas);
+
+        /*!
+         * \brief Loads an atlas' layout and all of its finished pages from the cache, without converting or packing any
+         * of its sprites
+         *
+         * \return True if the layout and every page were in the cache and have been queued for upload
+         */
+        bool load_cached_atlas(const std::string& atlas_name, const unpacked_atlas& atlas);
+
+        /*!
+         * \brief Packs an atlas' sprites and adds their texture locations
+         *
+         * The block atlas is staged to be mipmapped, and its layout is cached. Other atlases are queued for upload
+         */
+        void pack_atlas(const std::string& atlas_name, unpacked_atlas& atlas);
+
+        /*!
+         * \brief Adds the texture location of every sprite in an atlas
+         */
+        void add_locations(const atlas_page& page);
+
+        /*!
+         * \brief The options that a mipmapped atlas is processed with, given the size of its smallest sprite
+         */
+        mipmap_options get_atlas_mipmap_options(const glm::ivec2& smallest_sprite_size) const;
+
+        /*!
+         * \brief Finalized textures, so that a resource pack that hasn't changed doesn't have to be mipmapped and
+         * compressed again
+         */
+        texture_cache cache;
+
+        texture_upload_queue uploads;
+
+        /*!
+         * \brief Combines the hash of a texture's inputs with everything else that affects how it's processed
+         */
+        uint64_t make_cache_key(uint64_t input_hash, const mipmap_options& options) const;
+
+        /*!
+         * \brief Queues a texture from the cache for upload, keeping its file mapped until the upload starts
+         */
+        void upload_cached_texture(texture2D &texture, std::unique_ptr<texture_cache::entry> cached);
+
+        /*!
+         * \brief The name of the texture that was most recently added, which new texture locations belong to
+         */
+        std::string last_added_texture;
+
+        mipmap_options atlas_mipmap_options;
+
+        std::experimental::optional<block_format> atlas_compression_format;
+        compression_quality atlas_compression_quality = compression_quality::normal;
     };
 }
 
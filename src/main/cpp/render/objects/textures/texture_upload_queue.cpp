@@ -0,0 +1,209 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <cstring>
+#include <easylogging++.h>
+#include "texture_upload_queue.h"
+
+namespace nova {
+    /*!
+     * \brief Uploads start on a multiple of this many bytes in the staging buffer
+     */
+    const size_t STAGING_ALIGNMENT = 16;
+
+    bool texture_upload::is_resident() const {
+        return resident.load(std::memory_order_acquire);
+    }
+
+    texture_upload_queue::texture_upload_queue(size_t staging_size, size_t max_bytes_per_frame) :
+            staging_size(staging_size), max_bytes_per_frame(max_bytes_per_frame) {}
+
+    texture_upload_queue::~texture_upload_queue() {
+        for(auto& batch : batches_in_flight) {
+            glDeleteSync(batch.fence);
+        }
+
+        if(staging_buffer != 0) {
+            glUnmapNamedBuffer(staging_buffer);
+            glDeleteBuffers(1, &staging_buffer);
+        }
+    }
+
+    texture_upload_handle texture_upload_queue::enqueue(texture2D& texture, std::vector<uint8_t>&& pixels, const glm::ivec2& size,
+                                                        GLenum format, GLenum type, GLenum internal_format) {
+        auto owned_pixels = std::make_shared<std::vector<uint8_t>>(std::move(pixels));
+        std::vector<texture_cache::level> levels = {{size, owned_pixels->data(), owned_pixels->size()}};
+
+        auto handle = std::make_shared<texture_upload>();
+        pending_uploads.push_back({&texture, std::move(levels), std::move(owned_pixels), format, type, internal_format, false, handle});
+        return handle;
+    }
+
+    texture_upload_handle texture_upload_queue::enqueue_levels(texture2D& texture, std::vector<texture_cache::level> levels,
+                                                               std::shared_ptr<const void> owner, GLenum internal_format) {
+        bool is_compressed = internal_format != GL_RGBA8;
+        auto handle = std::make_shared<texture_upload>();
+        pending_uploads.push_back({&texture, std::move(levels), std::move(owner), GL_RGBA, GL_UNSIGNED_BYTE, internal_format, is_compressed, handle});
+        return handle;
+    }
+
+    void texture_upload_queue::process() {
+        if(staging_buffer == 0) {
+            create_staging_buffer();
+        }
+
+        retire_finished_batches();
+
+        if(pending_uploads.empty()) {
+            return;
+        }
+
+        upload_batch batch = {nullptr, 0, 0, {}};
+        size_t bytes_this_frame = 0;
+        size_t bytes_in_use_before = staging_bytes_in_use;
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging_buffer);
+        while(!pending_uploads.empty()) {
+            auto& upload = pending_uploads.front();
+            size_t num_bytes = 0;
+            for(const auto& level : upload.levels) {
+                num_bytes += level.data_size;
+            }
+
+            std::vector<const void*> level_data;
+            if(num_bytes > staging_size) {
+                // Too big to ever fit in the staging buffer, so it has to go the slow way
+                LOG(DEBUG) << "Texture " << upload.texture->get_name() << " is bigger than the staging buffer, uploading it directly";
+                for(const auto& level : upload.levels) {
+                    level_data.push_back(level.data);
+                }
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                set_texture_data(upload, level_data);
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging_buffer);
+
+                upload.handle->resident.store(true, std::memory_order_release);
+                pending_uploads.pop_front();
+                continue;
+            }
+
+            if(bytes_this_frame > 0 && bytes_this_frame + num_bytes > max_bytes_per_frame) {
+                break;
+            }
+
+            size_t offset;
+            if(!allocate_staging(num_bytes, offset)) {
+                break;
+            }
+
+            // The levels go one after another. Compressed levels are whole blocks and uncompressed ones are unpacked
+            // with an alignment of one, so they don't need any padding between them
+            for(const auto& level : upload.levels) {
+                std::memcpy(staging_memory + offset, level.data, level.data_size);
+
+                // With a pixel unpack buffer bound, the data pointer is an offset into that buffer
+                level_data.push_back(reinterpret_cast<const void*>(offset));
+                offset += level.data_size;
+            }
+            set_texture_data(upload, level_data);
+
+            batch.handles.push_back(upload.handle);
+            bytes_this_frame += num_bytes;
+            pending_uploads.pop_front();
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        if(!batch.handles.empty()) {
+            batch.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            batch.staging_end = staging_head;
+            batch.num_bytes = staging_bytes_in_use - bytes_in_use_before;
+            batches_in_flight.push_back(std::move(batch));
+        }
+    }
+
+    void texture_upload_queue::set_texture_data(const pending_upload& upload, const std::vector<const void*>& level_data) {
+        const auto& size = upload.levels[0].size;
+        if(upload.is_compressed) {
+            std::vector<GLsizei> level_sizes;
+            for(const auto& level : upload.levels) {
+                level_sizes.push_back(static_cast<GLsizei>(level.data_size));
+            }
+            upload.texture->set_compressed_data(level_data, level_sizes, size, upload.internal_format);
+
+        } else {
+            upload.texture->set_mipmapped_data(level_data, size, upload.format, upload.type, upload.internal_format);
+        }
+    }
+
+    void texture_upload_queue::clear() {
+        pending_uploads.clear();
+    }
+
+    size_t texture_upload_queue::get_num_pending() const {
+        return pending_uploads.size();
+    }
+
+    void texture_upload_queue::create_staging_buffer() {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glCreateBuffers(1, &staging_buffer);
+        glNamedBufferStorage(staging_buffer, static_cast<GLsizeiptr>(staging_size), nullptr, flags);
+        staging_memory = static_cast<uint8_t*>(glMapNamedBufferRange(staging_buffer, 0, static_cast<GLsizeiptr>(staging_size), flags));
+
+        LOG(INFO) << "Created a " << staging_size / (1024 * 1024) << "MB texture staging buffer";
+    }
+
+    void texture_upload_queue::retire_finished_batches() {
+        while(!batches_in_flight.empty()) {
+            auto& batch = batches_in_flight.front();
+            GLenum status = glClientWaitSync(batch.fence, 0, 0);
+            if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+                // Batches finish in order, so nothing after this one is done either
+                break;
+            }
+
+            glDeleteSync(batch.fence);
+            for(auto& handle : batch.handles) {
+                handle->resident.store(true, std::memory_order_release);
+            }
+
+            staging_tail = batch.staging_end;
+            staging_bytes_in_use -= batch.num_bytes;
+            batches_in_flight.pop_front();
+        }
+
+        if(staging_bytes_in_use == 0) {
+            staging_head = 0;
+            staging_tail = 0;
+        }
+    }
+
+    bool texture_upload_queue::allocate_staging(size_t num_bytes, size_t& offset) {
+        size_t aligned_head = (staging_head + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+
+        // If the data in use wraps around the end of the buffer, the only free space is between the head and the tail
+        bool in_use_wraps = staging_bytes_in_use > 0 && staging_head <= staging_tail;
+        if(in_use_wraps) {
+            if(aligned_head + num_bytes > staging_tail) {
+                return false;
+            }
+            offset = aligned_head;
+
+        } else if(aligned_head + num_bytes <= staging_size) {
+            offset = aligned_head;
+
+        } else if(num_bytes <= staging_tail) {
+            // Skip the space at the end of the buffer and start again from the beginning
+            offset = 0;
+            staging_bytes_in_use += staging_size - staging_head;
+            staging_head = 0;
+
+        } else {
+            return false;
+        }
+
+        staging_bytes_in_use += offset + num_bytes - staging_head;
+        staging_head = offset + num_bytes;
+        return true;
+    }
+}
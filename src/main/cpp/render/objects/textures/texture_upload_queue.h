@@ -0,0 +1,179 @@
+/*!
+ * \brief Streams texture data to the GPU in the background
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_TEXTURE_UPLOAD_QUEUE_H
+#define RENDERER_TEXTURE_UPLOAD_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "texture2D.h"
+#include "texture_cache.h"
+
+namespace nova {
+    /*!
+     * \brief Tracks a single texture upload
+     */
+    class texture_upload {
+    public:
+        /*!
+         * \brief Returns true once the GPU has finished copying the texture's data
+         *
+         * Until then the texture may have no storage at all, and samples as black
+         */
+        bool is_resident() const;
+
+    private:
+        friend class texture_upload_queue;
+
+        std::atomic<bool> resident{false};
+    };
+
+    using texture_upload_handle = std::shared_ptr<texture_upload>;
+
+    /*!
+     * \brief Uploads texture data through a persistently mapped pixel buffer, so the CPU never waits on the GPU to
+     * copy pixels
+     *
+     * Each frame, #process copies as many pending uploads as fit into the staging buffer and tells OpenGL to copy
+     * them into their textures from there. A fence after each frame's copies says when that part of the staging
+     * buffer can be reused. The staging buffer is a fixed size, so uploads never use more than that much GPU-visible
+     * memory; uploads that don't fit wait for a later frame.
+     *
+     * Everything here has to be called on the thread with the OpenGL context
+     */
+    class texture_upload_queue {
+    public:
+        /*!
+         * \param staging_size The size of the staging buffer, in bytes
+         * \param max_bytes_per_frame The most data to start uploading in one frame, so a big resource pack doesn't
+         * cause one really long frame
+         */
+        explicit texture_upload_queue(size_t staging_size = 32 * 1024 * 1024, size_t max_bytes_per_frame = 8 * 1024 * 1024);
+
+        ~texture_upload_queue();
+
+        /*!
+         * \brief Queues up new data for a texture
+         *
+         * The texture's storage is (re)allocated when the upload is issued, like with texture2D#set_data. The texture
+         * has to stay around until the upload is resident or #clear is called
+         *
+         * \param texture The texture to upload to
+         * \param pixels The pixel data. Rows are tightly packed, with no padding at the end of each row
+         * \param size The size of the texture
+         * \param format The format of the pixel data
+         * \param type The type of each component of the pixel data
+         * \param internal_format The sized format to store the texture in
+         * \return A handle that says when the texture is ready
+         */
+        texture_upload_handle enqueue(texture2D& texture, std::vector<uint8_t>&& pixels, const glm::ivec2& size,
+                                      GLenum format, GLenum type = GL_UNSIGNED_BYTE, GLenum internal_format = GL_RGBA8);
+
+        /*!
+         * \brief Queues up a whole mip chain for a texture, compressed or not
+         *
+         * \param texture The texture to upload to
+         * \param levels The mip levels, starting with the base level
+         * \param owner Whatever owns the levels' data. It's kept around until the data has been copied to the
+         * staging buffer, so the data can come straight from something like a memory mapped cache file
+         * \param internal_format GL_RGBA8 for uncompressed RGBA data, or one of the compressed formats
+         * \return A handle that says when the texture is ready
+         */
+        texture_upload_handle enqueue_levels(texture2D& texture, std::vector<texture_cache::level> levels,
+                                             std::shared_ptr<const void> owner, GLenum internal_format);
+
+        /*!
+         * \brief Finds uploads that the GPU has finished, and starts as many pending uploads as there's room for
+         *
+         * Call this once a frame
+         */
+        void process();
+
+        /*!
+         * \brief Drops every upload that hasn't been started yet. Uploads that have already started still finish
+         */
+        void clear();
+
+        /*!
+         * \brief Returns the number of uploads that haven't been started yet
+         */
+        size_t get_num_pending() const;
+
+    private:
+        struct pending_upload {
+            texture2D* texture;
+            std::vector<texture_cache::level> levels;
+            std::shared_ptr<const void> owner;
+            GLenum format;
+            GLenum type;
+            GLenum internal_format;
+            bool is_compressed;
+            texture_upload_handle handle;
+        };
+
+        /*!
+         * \brief All the uploads started in one call to #process, and the fence that says when they're done
+         */
+        struct upload_batch {
+            GLsync fence;
+            size_t staging_end;
+            size_t num_bytes;
+            std::vector<texture_upload_handle> handles;
+        };
+
+        size_t staging_size;
+        size_t max_bytes_per_frame;
+
+        GLuint staging_buffer = 0;
+        uint8_t* staging_memory = nullptr;
+
+        /*!
+         * \brief Where the next upload goes in the staging buffer
+         */
+        size_t staging_head = 0;
+
+        /*!
+         * \brief The start of the oldest data the GPU might still be reading
+         */
+        size_t staging_tail = 0;
+        size_t staging_bytes_in_use = 0;
+
+        std::deque<pending_upload> pending_uploads;
+        std::deque<upload_batch> batches_in_flight;
+
+        void create_staging_buffer();
+
+        /*!
+         * \brief Marks batches whose fences have been signalled as resident, and frees their part of the staging
+         * buffer
+         */
+        void retire_finished_batches();
+
+        /*!
+         * \brief Finds room in the staging buffer
+         *
+         * \param num_bytes How much room to find
+         * \param offset Where the room starts
+         * \return True if there's room, false if the staging buffer is too full
+         */
+        bool allocate_staging(size_t num_bytes, size_t& offset);
+
+        /*!
+         * \brief Gives an upload's data to its texture
+         *
+         * \param level_data Where each level's data is. With a pixel unpack buffer bound these are offsets into it
+         */
+        void set_texture_data(const pending_upload& upload, const std::vector<const void*>& level_data);
+    };
+}
+
+#endif //RENDERER_TEXTURE_UPLOAD_QUEUE_H
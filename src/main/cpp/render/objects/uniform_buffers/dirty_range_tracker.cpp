@@ -0,0 +1,77 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "dirty_range_tracker.h"
+#include "../../frame_sync.h"
+
+namespace nova {
+    static_assert(MAX_FRAMES_IN_FLIGHT <= 8, "Each chunk has one byte of dirty bits, so there can only be 8 frame slots");
+
+    /*!
+     * \brief Every slot's bit set
+     */
+    const uint8_t ALL_SLOTS = static_cast<uint8_t>((1u << MAX_FRAMES_IN_FLIGHT) - 1);
+
+    dirty_range_tracker::dirty_range_tracker(size_t size, size_t chunk_size) :
+            size(size), chunk_size(chunk_size), stale_slots((size + chunk_size - 1) / chunk_size, ALL_SLOTS) {}
+
+    void dirty_range_tracker::mark_dirty(size_t offset, size_t num_bytes) {
+        if(num_bytes == 0 || offset >= size) {
+            return;
+        }
+
+        size_t first_chunk = offset / chunk_size;
+        size_t last_chunk = (std::min(offset + num_bytes, size) - 1) / chunk_size;
+        for(size_t chunk = first_chunk; chunk <= last_chunk; chunk++) {
+            stale_slots[chunk] = ALL_SLOTS;
+        }
+    }
+
+    void dirty_range_tracker::mark_changes(const uint8_t* old_data, const uint8_t* new_data) {
+        for(size_t chunk = 0; chunk < stale_slots.size(); chunk++) {
+            size_t offset = chunk * chunk_size;
+            if(std::memcmp(old_data + offset, new_data + offset, std::min(chunk_size, size - offset)) != 0) {
+                stale_slots[chunk] = ALL_SLOTS;
+            }
+        }
+    }
+
+    void dirty_range_tracker::mark_all_dirty() {
+        std::fill(stale_slots.begin(), stale_slots.end(), ALL_SLOTS);
+    }
+
+    size_t dirty_range_tracker::flush(size_t frame_slot, const std::function<void(size_t, size_t)>& write) {
+        auto slot_bit = static_cast<uint8_t>(1u << (frame_slot % MAX_FRAMES_IN_FLIGHT));
+        size_t num_bytes_written = 0;
+
+        size_t chunk = 0;
+        while(chunk < stale_slots.size()) {
+            if((stale_slots[chunk] & slot_bit) == 0) {
+                chunk++;
+                continue;
+            }
+
+            size_t first_chunk = chunk;
+            while(chunk < stale_slots.size() && (stale_slots[chunk] & slot_bit) != 0) {
+                stale_slots[chunk] &= ~slot_bit;
+                chunk++;
+            }
+
+            size_t offset = first_chunk * chunk_size;
+            size_t num_bytes = std::min(chunk * chunk_size, size) - offset;
+            write(offset, num_bytes);
+            num_bytes_written += num_bytes;
+        }
+
+        return num_bytes_written;
+    }
+
+    bool dirty_range_tracker::is_dirty(size_t frame_slot) const {
+        auto slot_bit = static_cast<uint8_t>(1u << (frame_slot % MAX_FRAMES_IN_FLIGHT));
+        return std::any_of(stale_slots.begin(), stale_slots.end(), [&](uint8_t stale) { return (stale & slot_bit) != 0; });
+    }
+}
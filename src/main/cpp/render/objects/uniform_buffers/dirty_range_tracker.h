@@ -0,0 +1,79 @@
+/*!
+ * \brief Keeps track of which parts of a uniform buffer each frame slot's copy is missing
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_DIRTY_RANGE_TRACKER_H
+#define RENDERER_DIRTY_RANGE_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace nova {
+    /*!
+     * \brief Tracks which parts of some data are out of date in each frame slot's copy of it
+     *
+     * The data is split into chunks. Each chunk has a bit for each frame slot, set when that slot's copy of the chunk
+     * is out of date. Changing part of the data sets the bits for every slot, and writing a slot's copy clears that
+     * slot's bits, so a change gets written once into each slot as the slots come around, and data that doesn't
+     * change is never written again
+     */
+    class dirty_range_tracker {
+    public:
+        /*!
+         * \param size The size of the data, in bytes
+         * \param chunk_size How many bytes each dirty bit covers. 16 lines up with the std140 rules, where nothing
+         * bigger than a vec4 sits between two 16-byte boundaries
+         */
+        explicit dirty_range_tracker(size_t size, size_t chunk_size = 16);
+
+        /*!
+         * \brief Marks part of the data as out of date in every slot
+         */
+        void mark_dirty(size_t offset, size_t num_bytes);
+
+        /*!
+         * \brief Marks every chunk where old_data and new_data are different as out of date in every slot
+         *
+         * \param old_data The data as it was. Must be as big as the tracked data
+         * \param new_data The data as it is now. Must be as big as the tracked data
+         */
+        void mark_changes(const uint8_t* old_data, const uint8_t* new_data);
+
+        /*!
+         * \brief Marks all the data as out of date in every slot
+         */
+        void mark_all_dirty();
+
+        /*!
+         * \brief Hands every out of date range of the given slot to the writer, then marks them as up to date
+         *
+         * Chunks that are next to each other are merged into one range
+         *
+         * \param frame_slot The slot to write
+         * \param write Called with the offset and size of each range to write
+         * \return How many bytes were written
+         */
+        size_t flush(size_t frame_slot, const std::function<void(size_t, size_t)>& write);
+
+        /*!
+         * \brief True if the given slot's copy of the data is out of date anywhere
+         */
+        bool is_dirty(size_t frame_slot) const;
+
+    private:
+        size_t size;
+        size_t chunk_size;
+
+        /*!
+         * \brief For each chunk, a bit for each slot that has an out of date copy of it
+         */
+        std::vector<uint8_t> stale_slots;
+    };
+}
+
+#endif //RENDERER_DIRTY_RANGE_TRACKER_H
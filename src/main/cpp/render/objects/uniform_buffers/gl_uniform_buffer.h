@@ -6,59 +6,108 @@
 #ifndef RENDERER_GL_UNIFORM_BUFFER_H
 #define RENDERER_GL_UNIFORM_BUFFER_H
 
+#include <cstring>
+#include <stdexcept>
 #include <string>
 #include <glad/glad.h>
+#include <easylogging++.h>
 #include "../shaders/gl_shader_program.h"
-#include <GLFW/glfw3.h>
+#include "../gl_ring_buffer.h"
+#include "dirty_range_tracker.h"
 
 namespace nova {
     /*!
      * \brief A nice interface for uniform buffer objects
+     *
+     * The buffer keeps a copy of the data in every slice of a gl_ring_buffer, at the same place in each slice. Each
+     * frame, #upload writes only the parts of the current slice's copy that have changed since that slice was last
+     * written, then binds the copy with glBindBufferRange. The GPU might still be reading the other slices, but
+     * frame_sync makes sure it's done with the current one, so nothing ever waits
      */
     template <typename T>
     class gl_uniform_buffer {
     public:
-        gl_uniform_buffer(std::string name) : name(name) {
-            glCreateBuffers(1, &gl_name);
+        /*!
+         * \param name The name of the uniform block in the shaders
+         * \param binding The binding point to bind the data to
+         * \param ring Where to put the data. Has to have room for a T in each slice
+         */
+        gl_uniform_buffer(std::string name, GLuint binding, gl_ring_buffer& ring) :
+                name(name), binding(binding), ring(&ring), dirty_ranges(sizeof(T)) {
             LOG(TRACE) << "creating ubo " << name << " with size: " << sizeof(T);
-            glNamedBufferStorage(gl_name, sizeof(T), nullptr, GL_DYNAMIC_STORAGE_BIT);
-        }
-
-        gl_uniform_buffer(gl_uniform_buffer &&old) noexcept {
-            gl_name = old.gl_name;
-            name = old.name;
-
-            old.gl_name = 0;
-            old.name = "";
+            if(!ring.reserve(sizeof(T), slice_offset)) {
+                throw std::runtime_error("No room for UBO " + name + " in the uniform ring buffer");
+            }
         }
 
         void link_to_shader(const gl_shader_program &shader) {
             auto ubo_index = glGetUniformBlockIndex(shader.gl_name, name.c_str());
-            glBindBuffer(GL_UNIFORM_BUFFER, gl_name);
-            glBindBufferBase(GL_UNIFORM_BUFFER, ubo_index, gl_name);
+            if(ubo_index != GL_INVALID_INDEX) {
+                glUniformBlockBinding(shader.gl_name, ubo_index, binding);
+            }
+        }
+
+        /*!
+         * \brief Changes one of the fields. Nothing is uploaded if the field already has that value
+         *
+         * \param field The field to change, like &per_frame_uniforms::viewWidth
+         * \param value The field's new value
+         */
+        template <typename Field>
+        void set(Field T::*field, const Field& value) {
+            auto& current_value = data.*field;
+            if(std::memcmp(&current_value, &value, sizeof(Field)) == 0) {
+                return;
+            }
+
+            current_value = value;
+            auto offset = reinterpret_cast<const uint8_t*>(&current_value) - reinterpret_cast<const uint8_t*>(&data);
+            dirty_ranges.mark_dirty(static_cast<size_t>(offset), sizeof(Field));
         }
 
-        void send_data(T &data) {
-            LOG(TRACE) << "sending date with size: " << sizeof(T) << " to ubo " << name;
-            glNamedBufferSubData(gl_name, 0, sizeof(T), &data);
+        /*!
+         * \brief Replaces all the data. Only the parts that are different get uploaded
+         */
+        void send_data(const T &new_data) {
+            dirty_ranges.mark_changes(reinterpret_cast<const uint8_t*>(&data), reinterpret_cast<const uint8_t*>(&new_data));
+            data = new_data;
         }
 
-        void bind() {
-            glBindBuffer(GL_UNIFORM_BUFFER, gl_name);
+        const T& get_data() const {
+            return data;
         }
 
         /*!
-         * \brief Deallocates this uniform buffer
+         * \brief Brings the current frame's copy up to date and binds it. Call this once a frame, after the ring's
+         * begin_frame
+         *
+         * \return How many bytes were written
          */
-        ~gl_uniform_buffer() {
-            if(glfwGetCurrentContext() != NULL) {
-                glDeleteBuffers(1, &gl_name);
-            }
+        size_t upload() {
+            auto copy_offset = ring->get_reserved_offset(slice_offset);
+            auto* copy = ring->get_memory(copy_offset);
+            const auto* source = reinterpret_cast<const uint8_t*>(&data);
+            size_t num_bytes_written = dirty_ranges.flush(ring->get_frame_slot(), [&](size_t offset, size_t num_bytes) {
+                std::memcpy(copy + offset, source + offset, num_bytes);
+            });
+
+            glBindBufferRange(GL_UNIFORM_BUFFER, binding, ring->get_gl_name(), static_cast<GLintptr>(copy_offset), sizeof(T));
+            return num_bytes_written;
         }
 
     private:
-        GLuint gl_name;
         std::string name;
+        GLuint binding;
+        gl_ring_buffer* ring;
+
+        /*!
+         * \brief Where the copies of the data are, from the start of each slice
+         */
+        size_t slice_offset = 0;
+
+        T data = {};
+
+        dirty_range_tracker dirty_ranges;
     };
 }
 
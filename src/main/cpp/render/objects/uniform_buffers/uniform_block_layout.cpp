@@ -0,0 +1,29 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <sstream>
+#include "uniform_block_layout.h"
+
+namespace nova {
+    std::string make_glsl_block(const char* block_name, block_layout layout, const std::vector<uniform_field_info>& fields) {
+        std::stringstream glsl;
+        // std430 is only allowed for shader storage blocks
+        if(layout == block_layout::std140) {
+            glsl << "layout(std140) uniform " << block_name << " {\n";
+        } else {
+            glsl << "layout(std430) buffer " << block_name << " {\n";
+        }
+        for(const auto& field : fields) {
+            glsl << "    " << field.glsl_type << " " << field.name;
+            if(field.array_size > 0) {
+                glsl << "[" << field.array_size << "]";
+            }
+            glsl << ";\n";
+        }
+        glsl << "};\n";
+
+        return glsl.str();
+    }
+}
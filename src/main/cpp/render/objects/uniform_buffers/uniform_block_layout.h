@@ -0,0 +1,239 @@
+/*!
+ * \brief Lays out uniform blocks by the GLSL std140 and std430 rules at compile time, and writes the matching GLSL
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_UNIFORM_BLOCK_LAYOUT_H
+#define RENDERER_UNIFORM_BLOCK_LAYOUT_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+namespace nova {
+    /*!
+     * \brief The GLSL memory layouts that a block can use
+     *
+     * They only differ for arrays: std140 rounds the stride of every array up to 16 bytes, and std430 doesn't
+     */
+    enum class block_layout {
+        std140,
+        std430,
+    };
+
+    constexpr size_t round_up_to(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    /*!
+     * \brief What a C++ type is called in GLSL, and how it's aligned there. Types without a specialization can't be
+     * used in a uniform block
+     */
+    template<typename T>
+    struct glsl_type;
+
+#define NOVA_GLSL_TYPE(cpp_type, glsl_name, base_alignment)                     \
+    template<>                                                                  \
+    struct glsl_type<cpp_type> {                                                \
+        static constexpr const char* name() { return glsl_name; }              \
+        static constexpr size_t alignment = base_alignment;                     \
+        static constexpr size_t array_size = 0;                                 \
+        using element_type = cpp_type;                                          \
+    };
+
+    NOVA_GLSL_TYPE(GLfloat,         "float",    4)
+    NOVA_GLSL_TYPE(GLint,           "int",      4)
+    NOVA_GLSL_TYPE(GLuint,          "uint",     4)
+    NOVA_GLSL_TYPE(glm::vec2,       "vec2",     8)
+    NOVA_GLSL_TYPE(glm::vec3,       "vec3",     16)
+    NOVA_GLSL_TYPE(glm::vec4,       "vec4",     16)
+    NOVA_GLSL_TYPE(glm::ivec2,      "ivec2",    8)
+    NOVA_GLSL_TYPE(glm::ivec3,      "ivec3",    16)
+    NOVA_GLSL_TYPE(glm::ivec4,      "ivec4",    16)
+    NOVA_GLSL_TYPE(glm::mat4,       "mat4",     16)
+
+#undef NOVA_GLSL_TYPE
+
+    template<typename T, size_t N>
+    struct glsl_type<T[N]> {
+        static constexpr const char* name() { return glsl_type<T>::name(); }
+        static constexpr size_t alignment = glsl_type<T>::alignment;
+        static constexpr size_t array_size = N;
+        using element_type = T;
+    };
+
+    /*!
+     * \brief Lets array fields be declared like other fields, as `uniform_member<GLfloat[4]> weights;`
+     */
+    template<typename T>
+    using uniform_member = T;
+
+    /*!
+     * \brief Where a type goes in a block with the given layout
+     */
+    template<typename T, block_layout Layout>
+    struct uniform_layout {
+        using element_type = typename glsl_type<T>::element_type;
+
+        static constexpr bool is_array = glsl_type<T>::array_size > 0;
+
+        /*!
+         * \brief The base alignment. std140 rounds arrays up to a vec4
+         */
+        static constexpr size_t alignment = is_array && Layout == block_layout::std140 ?
+                                            round_up_to(glsl_type<T>::alignment, 16) : glsl_type<T>::alignment;
+
+        /*!
+         * \brief How far apart the elements of an array are. For anything that's not an array, its size
+         */
+        static constexpr size_t stride = is_array ? round_up_to(sizeof(element_type), alignment) : sizeof(T);
+
+        static constexpr size_t size = is_array ? stride * glsl_type<T>::array_size : sizeof(T);
+    };
+
+    template<typename T, block_layout Layout>
+    constexpr bool uniform_layout<T, Layout>::is_array;
+
+    template<typename T, block_layout Layout>
+    constexpr size_t uniform_layout<T, Layout>::alignment;
+
+    template<typename T, block_layout Layout>
+    constexpr size_t uniform_layout<T, Layout>::stride;
+
+    template<typename T, block_layout Layout>
+    constexpr size_t uniform_layout<T, Layout>::size;
+
+    /*!
+     * \brief One field of a uniform block, as GLSL sees it
+     */
+    struct uniform_field_info {
+        const char* glsl_type;
+        const char* name;
+        size_t array_size;
+        size_t alignment;
+        size_t size;
+    };
+
+    template<typename T, block_layout Layout>
+    constexpr uniform_field_info make_uniform_field_info(const char* name) {
+        return {glsl_type<T>::name(), name, glsl_type<T>::array_size, uniform_layout<T, Layout>::alignment, uniform_layout<T, Layout>::size};
+    }
+
+    constexpr bool names_equal(const char* a, const char* b) {
+        while(*a != '\0' && *a == *b) {
+            a++;
+            b++;
+        }
+        return *a == *b;
+    }
+
+    /*!
+     * \brief Where the GLSL layout rules put the field with the given name, or the size of the whole block if there's
+     * no field with that name
+     *
+     * Each field starts at the end of the last one, rounded up to the field's base alignment
+     */
+    template<typename Block>
+    constexpr size_t glsl_offset_of(const char* name) {
+        size_t offset = 0;
+        for(size_t i = 0; i < Block::num_fields; i++) {
+            auto field = Block::field_info(i);
+            offset = round_up_to(offset, field.alignment);
+            if(names_equal(field.name, name)) {
+                return offset;
+            }
+            offset += field.size;
+        }
+        return offset;
+    }
+
+    /*!
+     * \brief Writes the GLSL declaration of a uniform block. std430 blocks are written as shader storage blocks, since
+     * uniform blocks can't use std430
+     */
+    std::string make_glsl_block(const char* block_name, block_layout layout, const std::vector<uniform_field_info>& fields);
+
+    /*!
+     * \brief Writes the GLSL declaration of a block made with NOVA_UNIFORM_BLOCK
+     */
+    template<typename Block>
+    std::string make_glsl_block() {
+        std::vector<uniform_field_info> fields;
+        for(size_t i = 0; i < Block::num_fields; i++) {
+            fields.push_back(Block::field_info(i));
+        }
+        return make_glsl_block(Block::block_name(), Block::layout, fields);
+    }
+}
+
+/*
+ * A uniform block is declared from a list of fields, like this:
+ *
+ *     #define NOVA_MY_UNIFORMS(field, renamed_field) \
+ *         field(glm::mat4, modelView)                 \
+ *         field(glm::vec4[4], lightColors)             \
+ *         renamed_field(GLfloat, nearPlane, "near")
+ *
+ *     NOVA_UNIFORM_BLOCK(my_uniforms, block_layout::std140, NOVA_MY_UNIFORMS)
+ *
+ * That makes a struct called my_uniforms, with each field aligned so that the struct has exactly the layout the GLSL
+ * block has. Nothing needs to be padded by hand. renamed_field is for fields that can't have the same name in C++ as
+ * they have in GLSL. make_glsl_block<my_uniforms>() writes the matching GLSL block.
+ *
+ * The compiler's offset of every field is checked against the GLSL rules with a static_assert. Arrays whose GLSL
+ * stride doesn't match their C++ stride, like a float array in std140, don't compile
+ */
+
+#define NOVA_DECLARE_UNIFORM_FIELD(type, name)                                  \
+    alignas(nova::uniform_layout<type, layout>::alignment) nova::uniform_member<type> name;
+
+#define NOVA_DECLARE_RENAMED_UNIFORM_FIELD(type, name, glsl_name)               \
+    NOVA_DECLARE_UNIFORM_FIELD(type, name)
+
+#define NOVA_UNIFORM_FIELD_INFO(type, name)                                     \
+    nova::make_uniform_field_info<type, layout>(#name),
+
+#define NOVA_RENAMED_UNIFORM_FIELD_INFO(type, name, glsl_name)                  \
+    nova::make_uniform_field_info<type, layout>(glsl_name),
+
+#define NOVA_COUNT_UNIFORM_FIELD(type, name) + 1
+
+#define NOVA_COUNT_RENAMED_UNIFORM_FIELD(type, name, glsl_name) + 1
+
+#define NOVA_CHECK_UNIFORM_FIELD(type, name)                                    \
+    NOVA_CHECK_RENAMED_UNIFORM_FIELD(type, name, #name)
+
+#define NOVA_CHECK_RENAMED_UNIFORM_FIELD(type, name, glsl_name)                 \
+    static_assert(nova::uniform_layout<type, block::layout>::size == sizeof(type),                                   \
+                  #name " has a different stride in C++ than in GLSL");                                               \
+    static_assert(offsetof(block, name) == nova::glsl_offset_of<block>(glsl_name),                                   \
+                  #name " isn't where the GLSL layout rules put it");
+
+#define NOVA_UNIFORM_BLOCK(block_name_, layout_, FIELDS)                        \
+    struct block_name_ {                                                        \
+        static constexpr nova::block_layout layout = layout_;                   \
+        static constexpr size_t num_fields = 0 FIELDS(NOVA_COUNT_UNIFORM_FIELD, NOVA_COUNT_RENAMED_UNIFORM_FIELD); \
+                                                                                \
+        static constexpr const char* block_name() { return #block_name_; }      \
+                                                                                \
+        static constexpr nova::uniform_field_info field_info(size_t index) {    \
+            constexpr nova::uniform_field_info fields[] = {                     \
+                FIELDS(NOVA_UNIFORM_FIELD_INFO, NOVA_RENAMED_UNIFORM_FIELD_INFO) \
+            };                                                                  \
+            return fields[index];                                               \
+        }                                                                       \
+                                                                                \
+        FIELDS(NOVA_DECLARE_UNIFORM_FIELD, NOVA_DECLARE_RENAMED_UNIFORM_FIELD)  \
+    };                                                                          \
+                                                                                \
+    namespace block_name_##_layout_checks {                                     \
+        using block = block_name_;                                              \
+        FIELDS(NOVA_CHECK_UNIFORM_FIELD, NOVA_CHECK_RENAMED_UNIFORM_FIELD)      \
+    }
+
+#endif //RENDERER_UNIFORM_BLOCK_LAYOUT_H
@@ -16,72 +16,84 @@
 #include <glm/glm.hpp>
 
 #include <ostream>
+#include <string>
+#include <optional.hpp>
 
 #include <easylogging++.h>
+#include "uniform_block_layout.h"
 
 namespace nova {
+    /*!
+     * \brief All the uniform variables that are shared by all shader executions, in the order they're in in the
+     * per_frame_uniforms block
+     *
+     * Each vec3 is followed by a float, so the float fills the four bytes that std140 leaves at the end of the vec3.
+     * Shaders can get this block with `#include "/nova/per_frame_uniforms.glsl"`
+     */
+#define NOVA_PER_FRAME_UNIFORMS(field, renamed_field) \
+        field(glm::mat4, gbufferModelView) \
+        field(glm::mat4, gbufferModelViewInverse) \
+        field(glm::mat4, gbufferPreviousModelView) \
+        field(glm::mat4, gbufferProjection) \
+        field(glm::mat4, gbufferProjectionInverse) \
+        field(glm::mat4, gbufferPreviousProjection) \
+        field(glm::mat4, shadowProjection) \
+        field(glm::mat4, shadowProjectionInverse) \
+        field(glm::mat4, shadowModelView) \
+        field(glm::mat4, shadowModelViewInverse) \
+        field(glm::vec4, entityColor) \
+        field(glm::vec3, fogColor) \
+        field(GLfloat, frameTimeCounter) \
+        field(glm::vec3, skyColor) \
+        field(GLfloat, sunAngle) \
+        field(glm::vec3, sunPosition) \
+        field(GLfloat, shadowAngle) \
+        field(glm::vec3, moonPosition) \
+        field(GLfloat, rainStrength) \
+        field(glm::vec3, shadowLightPosition) \
+        field(GLfloat, aspectRatio) \
+        field(glm::vec3, upPosition) \
+        field(GLfloat, viewWidth) \
+        field(glm::vec3, cameraPosition) \
+        field(GLfloat, viewHeight) \
+        field(glm::vec3, previousCameraPosition) \
+        /* near and far in the shaders. Re-named because GCC was yelling about "This line does not declare anything" */ \
+        renamed_field(GLfloat, nearPlane, "near") \
+        field(glm::ivec2, eyeBrightness) \
+        field(glm::ivec2, eyeBrightnessSmooth) \
+        field(glm::ivec2, terrainTextureSize) \
+        field(glm::ivec2, atlasSize) \
+        field(GLint, heldItemId) \
+        field(GLint, heldBlockLightValue) \
+        field(GLint, heldItemId2) \
+        field(GLint, heldBlockLightValue2) \
+        field(GLint, fogMode) \
+        field(GLint, worldTime) \
+        field(GLint, moonPhase) \
+        field(GLint, terrainIconSize) \
+        field(GLint, isEyeInWater) \
+        field(GLint, hideGUI) \
+        field(GLint, entityId) \
+        field(GLint, blockEntityId) \
+        renamed_field(GLfloat, farPlane, "far") \
+        field(GLfloat, wetness) \
+        field(GLfloat, eyeAltitude) \
+        field(GLfloat, centerDepthSmooth)
+
     /*!
      * \brief Holds all the uniform variables that are shared by all shader executions
      *
      * The data in the structure should only be uploaded once per frame
      */
-    struct per_frame_uniforms {
-        glm::mat4 gbufferModelView;
-        glm::mat4 gbufferModelViewInverse;
-        glm::mat4 gbufferPreviousModelView;
-        glm::mat4 gbufferProjection;
-        glm::mat4 gbufferProjectionInverse;
-        glm::mat4 gbufferPreviousProjection;
-        glm::mat4 shadowProjection;
-        glm::mat4 shadowProjectionInverse;
-        glm::mat4 shadowModelView;
-        glm::mat4 shadowModelViewInverse;
-        glm::vec4 entityColor;
-        glm::vec3 fogColor;
-        float padding1; // needed to fit the GLSL std140 alignment rules. A future version will pack the data here more efficiently
-        glm::vec3 skyColor;
-        float padding2;
-        glm::vec3 sunPosition;
-        float padding3;
-        glm::vec3 moonPosition;
-        float padding4;
-        glm::vec3 shadowLightPosition;
-        float padding5;
-        glm::vec3 upPosition;
-        float padding6;
-        glm::vec3 cameraPosition;
-        float padding7;
-        glm::vec3 previousCameraPosition;
-        float padding8;
-        glm::ivec2 eyeBrightness;
-        glm::ivec2 eyeBrightnessSmooth;
-        glm::ivec2 terrainTextureSize;
-        glm::ivec2 atlasSize;
-        GLint heldItemId;
-        GLint heldBlockLightValue;
-        GLint heldItemId2;
-        GLint heldBlockLightValue2;
-        GLint fogMode;
-        GLint worldTime;
-        GLint moonPhase;
-        GLint terrainIconSize;
-        GLint isEyeInWater;
-        GLint hideGUI;
-        GLint entityId;
-        GLint blockEntityId;
-        GLfloat frameTimeCounter;
-        GLfloat sunAngle;
-        GLfloat shadowAngle;
-        GLfloat rainStrength;
-        GLfloat aspectRatio;
-        GLfloat viewWidth;
-        GLfloat viewHeight;
-        GLfloat nearPlane;  // near in the shaders. Re-named because GCC was yelling about "This line does not declare anything", like it's some great authority on declaring things
-        GLfloat farPlane;   // far in the shaders
-        GLfloat wetness;
-        GLfloat eyeAltitude;
-        GLfloat centerDepthSmooth;
-    };
+    NOVA_UNIFORM_BLOCK(per_frame_uniforms, block_layout::std140, NOVA_PER_FRAME_UNIFORMS)
+
+    /*!
+     * \brief The GLSL for the blocks above, for the virtual include files under /nova/
+     *
+     * \param include_name The name of the include file, like "/nova/per_frame_uniforms.glsl"
+     * \return The GLSL, or an empty optional if there's no block with that name
+     */
+    std::experimental::optional<std::string> get_uniform_block_include(const std::string& include_name);
 
     /*!
      * \brief Holds all the uniform variables that are specific to shadow passes
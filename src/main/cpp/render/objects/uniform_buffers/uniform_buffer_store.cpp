@@ -6,25 +6,53 @@
 #include <fstream>
 #include <easylogging++.h>
 #include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
 #include "../../nova_renderer.h"
 #include "uniform_buffer_store.h"
+#include "../../../utils/stats.h"
 
 namespace nova {
-    uniform_buffer_store::uniform_buffer_store() : per_frame_uniforms_buffer("per_frame_uniforms") {
+    /*!
+     * \brief How many bytes of uniforms each frame can have. Way more than the per-frame uniforms need, so there's
+     * room for more buffers
+     */
+    const size_t UNIFORM_RING_SLICE_SIZE = 64 * 1024;
+
+    /*!
+     * \brief Where the per-frame uniforms are bound. Matches uboBindPoints in the config file
+     */
+    const GLuint PER_FRAME_UNIFORMS_BINDING = 0;
+
+    static std::unique_ptr<gl_ring_buffer> make_uniform_ring() {
+        GLint alignment = 256;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        return std::make_unique<gl_ring_buffer>(UNIFORM_RING_SLICE_SIZE, static_cast<size_t>(alignment));
+    }
+
+    uniform_buffer_store::uniform_buffer_store() :
+            uniform_ring(make_uniform_ring()),
+            per_frame_uniforms_buffer("per_frame_uniforms", PER_FRAME_UNIFORMS_BINDING, *uniform_ring) {
+        // Only the settings that go into the per frame uniforms, so that other settings changing doesn't re-upload them
+        view_subscription = nova_renderer::get_render_settings().subscribe(
+                {setting::view_width, setting::view_height}, [&]() {
+                    LOG(DEBUG) << "UBO store received updated view settings";
+                    per_frame_uniforms_dirty = true;
+                });
+
 		LOG(INFO) << "Initialized uniform buffer store";
     }
 
-    void uniform_buffer_store::update() {
-        update_per_frame_uniforms(nova_renderer::get_render_settings().get_options());
+    uniform_buffer_store::~uniform_buffer_store() {
+        nova_renderer::get_render_settings().unsubscribe(view_subscription);
     }
 
-    void uniform_buffer_store::on_config_change(nlohmann::json &new_config) {
-        LOG(DEBUG) << "UBO store received updated config";
+    void uniform_buffer_store::begin_frame(size_t frame_slot) {
+        uniform_ring->begin_frame(frame_slot);
+    }
 
-        // We'll probably also want to update the per frame uniforms so that we have the correct aspect ratio and
-        // whatnot
-        update_per_frame_uniforms(new_config);
+    void uniform_buffer_store::update(const settings_snapshot& frame_settings) {
+        if(per_frame_uniforms_dirty.exchange(false)) {
+            update_per_frame_uniforms(frame_settings);
+        }
     }
 
     void uniform_buffer_store::on_config_loaded(nlohmann::json &config) {}
@@ -33,29 +61,22 @@ namespace nova {
         per_frame_uniforms_buffer.link_to_shader(shader);
     }
 
-    void uniform_buffer_store::update_per_frame_uniforms(nlohmann::json &config) {
-		float view_width = config["viewWidth"];
-		float view_height = config["viewHeight"];
-        float scalefactor = config["scalefactor"];
-        // The GUI matrix is super simple, just a viewport transformation
-        glm::mat4 gui_model_view(1.0f);
-        gui_model_view = glm::translate(gui_model_view, glm::vec3(-1.0f, 1.0f, 0.0f));
-        gui_model_view = glm::scale(gui_model_view, glm::vec3(scalefactor, scalefactor, 1.0f));
-        gui_model_view = glm::scale(gui_model_view, glm::vec3(1.0 / view_width, 1.0 / view_height, 1.0));
-        gui_model_view = glm::scale(gui_model_view, glm::vec3(1.0f, -1.0f, 1.0f));
-
-        per_frame_uniform_variables.gbufferModelView = glm::mat4(1);
-        per_frame_uniform_variables.gbufferProjection = glm::mat4(1);
-        per_frame_uniform_variables.aspectRatio = view_width / view_height;
-        per_frame_uniform_variables.viewHeight = view_height;
-        per_frame_uniform_variables.viewWidth = view_width;
-        per_frame_uniform_variables.frameTimeCounter = 0;
-        per_frame_uniform_variables.hideGUI = 0;
-
-        per_frame_uniforms_buffer.send_data(per_frame_uniform_variables);
+    void uniform_buffer_store::update_per_frame_uniforms(const settings_snapshot& frame_settings) {
+        auto view_width = static_cast<float>(frame_settings.view_width);
+        auto view_height = static_cast<float>(frame_settings.view_height);
+
+        per_frame_uniforms_buffer.set(&per_frame_uniforms::aspectRatio, view_width / view_height);
+        per_frame_uniforms_buffer.set(&per_frame_uniforms::viewHeight, view_height);
+        per_frame_uniforms_buffer.set(&per_frame_uniforms::viewWidth, view_width);
+
         LOG(DEBUG) << "Updated Per-Frame UBO";
     }
 
+    void uniform_buffer_store::upload() {
+        auto num_bytes = per_frame_uniforms_buffer.upload();
+        stats::set("ubo_bytes_per_frame", num_bytes);
+    }
+
     gl_uniform_buffer<per_frame_uniforms>& uniform_buffer_store::get_per_frame_uniforms() {
         return per_frame_uniforms_buffer;
     }
@@ -6,6 +6,8 @@
 #ifndef RENDERER_UBO_MANAGER_H
 #define RENDERER_UBO_MANAGER_H
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <json.hpp>
@@ -19,9 +21,10 @@ namespace nova {
     /*!
      * \brief Holds all the uniform buffers that Nova needs to use
      *
-     * The Uniform Buffer Store is kinda nice because it registers itself as a configuration change listener,
-     * meaning that it will receive updates whenever a new configuration is available. These updates are (currently)
-     * uploaded by the "update" stage of the renderer
+     * The Uniform Buffer Store is kinda nice because it subscribes to the settings that go into its buffers, meaning
+     * that it will receive updates whenever one of them changes. Those updates, and anything the renderer changes,
+     * are uploaded once a frame by #upload, into that frame's slice of a ring buffer. Only the parts that changed get
+     * written
      *
      * Ideally, all transfers of data from the CPU to GPU will happen in a separate thread, and the render thread
      * will do nothing except dispatch rendering commands
@@ -33,25 +36,55 @@ namespace nova {
          */
         uniform_buffer_store();
 
+        ~uniform_buffer_store();
+
         void register_all_buffers_with_shader(const gl_shader_program &shader) noexcept;
 
-        void update();
+        /*!
+         * \brief Starts writing uniforms into the given frame slot's part of the ring buffer
+         *
+         * \param frame_slot The slot from frame_sync#begin_frame
+         */
+        void begin_frame(size_t frame_slot);
+
+        /*!
+         * \brief Updates the per-frame uniforms if any of the settings that go into them have changed. Only call this
+         * from the render thread
+         *
+         * \param frame_settings The settings for the frame that's about to be rendered
+         */
+        void update(const settings_snapshot& frame_settings);
+
+        /*!
+         * \brief Sends whatever changed in this frame's uniforms to the GPU. Call this once a frame, after everything's
+         * been updated. The number of bytes written goes into the "ubo_bytes_per_frame" stat
+         */
+        void upload();
 
         /*
          * Inherited from iconfig_listener
          */
-        virtual void on_config_change(nlohmann::json &new_config);
-
         virtual void on_config_loaded(nlohmann::json &config);
 
+        /*!
+         * \brief The per-frame uniforms. Anything set on them is sent by the next #upload
+         */
         gl_uniform_buffer<per_frame_uniforms>& get_per_frame_uniforms();
 
     private:
-        per_frame_uniforms per_frame_uniform_variables;
+        std::unique_ptr<gl_ring_buffer> uniform_ring;
 
         gl_uniform_buffer<per_frame_uniforms> per_frame_uniforms_buffer;
 
-        void update_per_frame_uniforms(nlohmann::json &config);
+        settings::subscription_id view_subscription;
+
+        /*!
+         * \brief Set by the settings subscription, which can run on any thread, and cleared by #update on the render
+         * thread
+         */
+        std::atomic<bool> per_frame_uniforms_dirty{true};
+
+        void update_per_frame_uniforms(const settings_snapshot& frame_settings);
     };
 }
 
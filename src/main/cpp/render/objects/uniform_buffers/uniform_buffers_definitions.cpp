@@ -17,4 +17,12 @@ namespace nova {
 
 		return out;
     }
+
+    std::experimental::optional<std::string> get_uniform_block_include(const std::string& include_name) {
+        if(include_name == "/nova/per_frame_uniforms.glsl") {
+            return make_glsl_block<per_frame_uniforms>();
+        }
+
+        return {};
+    }
 }
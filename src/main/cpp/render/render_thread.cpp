@@ -0,0 +1,153 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <easylogging++.h>
+#include "render_thread.h"
+
+namespace nova {
+    render_thread::~render_thread() {
+        if(running) {
+            stop();
+        }
+    }
+
+    void render_thread::start(task on_start, task on_stop) {
+        std::lock_guard<std::mutex> lock(work_lock);
+        stopping = false;
+        running = true;
+        thread = std::thread([this, on_start, on_stop]() {
+            // Set here rather than after the thread is made, so on_start already counts as the render thread
+            render_thread_id = std::this_thread::get_id();
+            on_start();
+            run();
+            on_stop();
+        });
+    }
+
+    void render_thread::stop() {
+        {
+            std::unique_lock<std::mutex> lock(work_lock);
+            hand_over(lock, []() {});
+            stopping = true;
+        }
+        work_available.notify_one();
+        thread.join();
+
+        std::lock_guard<std::mutex> lock(work_lock);
+        running = false;
+        render_thread_id = std::thread::id();
+    }
+
+    bool render_thread::is_running() const {
+        return running;
+    }
+
+    bool render_thread::is_render_thread() const {
+        return std::this_thread::get_id() == render_thread_id;
+    }
+
+    void render_thread::run_before_next_frame(task work) {
+        std::unique_lock<std::mutex> lock(work_lock);
+        if(!running || is_render_thread()) {
+            lock.unlock();
+            work();
+            return;
+        }
+
+        next_frame_work.push_back(std::move(work));
+    }
+
+    void render_thread::run_and_wait(task work) {
+        std::unique_lock<std::mutex> lock(work_lock);
+        if(!running || is_render_thread()) {
+            lock.unlock();
+            work();
+            return;
+        }
+
+        bool done = false;
+        std::exception_ptr error;
+        hand_over(lock, [&]() {
+            try {
+                work();
+
+            } catch(...) {
+                error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> done_lock(work_lock);
+            done = true;
+        });
+        work_available.notify_one();
+
+        work_finished.wait(lock, [&]() { return done; });
+        lock.unlock();
+
+        if(error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    void render_thread::publish_frame(task frame) {
+        std::unique_lock<std::mutex> lock(work_lock);
+        if(!running) {
+            lock.unlock();
+            for(auto& work : next_frame_work) {
+                work();
+            }
+            next_frame_work.clear();
+            frame();
+            return;
+        }
+
+        hand_over(lock, std::move(frame));
+        lock.unlock();
+        work_available.notify_one();
+    }
+
+    void render_thread::wait_until_idle() {
+        std::unique_lock<std::mutex> lock(work_lock);
+        work_finished.wait(lock, [&]() { return !busy; });
+    }
+
+    void render_thread::hand_over(std::unique_lock<std::mutex>& lock, task work) {
+        work_finished.wait(lock, [&]() { return !busy; });
+
+        ready_work = std::move(next_frame_work);
+        next_frame_work.clear();
+        ready_work.push_back(std::move(work));
+        busy = true;
+    }
+
+    void render_thread::run() {
+        std::unique_lock<std::mutex> lock(work_lock);
+        while(true) {
+            work_available.wait(lock, [&]() { return busy || stopping; });
+            if(!busy) {
+                break;
+            }
+
+            auto work = std::move(ready_work);
+            ready_work.clear();
+            lock.unlock();
+
+            for(auto& item : work) {
+                try {
+                    item();
+
+                } catch(std::exception& e) {
+                    LOG(ERROR) << "Render thread task failed: " << e.what();
+
+                } catch(...) {
+                    LOG(ERROR) << "Render thread task failed with something that isn't a std::exception";
+                }
+            }
+
+            lock.lock();
+            busy = false;
+            work_finished.notify_all();
+        }
+    }
+}
@@ -0,0 +1,130 @@
+/*!
+ * \brief The thread that owns the OpenGL context and renders the frames the game thread hands it
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_RENDER_THREAD_H
+#define RENDERER_RENDER_THREAD_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nova {
+    /*!
+     * \brief Renders frames on its own thread while the game thread simulates the next tick
+     *
+     * Anything that touches OpenGL has to happen on this thread. The game thread queues that work with
+     * #run_before_next_frame. The work piles up until the game thread publishes a frame, then the whole pile and the
+     * frame are handed over together. Work queued after that waits for the frame after, so a frame only ever sees
+     * the calls that were made before it was published.
+     *
+     * Only one frame is in flight at a time: publishing a frame waits for the last one to finish. That wait is the
+     * frame fence, and it's the only time the game thread waits for rendering. Things that need an answer from the
+     * render thread, like how many shaders are loaded, use #run_and_wait, which waits for the frame in flight too.
+     *
+     * Before the thread is started, and on the render thread itself, everything just runs right away
+     */
+    class render_thread {
+    public:
+        using task = std::function<void()>;
+
+        render_thread() = default;
+
+        render_thread(const render_thread& other) = delete;
+        render_thread& operator=(const render_thread& other) = delete;
+
+        /*!
+         * \brief Stops the thread if it's still running
+         */
+        ~render_thread();
+
+        /*!
+         * \brief Starts the thread
+         *
+         * \param on_start Runs on the new thread before anything else. This is where to make the OpenGL context current
+         * \param on_stop Runs on the thread right before it exits. This is where to let go of the OpenGL context
+         */
+        void start(task on_start, task on_stop);
+
+        /*!
+         * \brief Finishes the frame in flight and anything that's been queued, then stops the thread
+         */
+        void stop();
+
+        bool is_running() const;
+
+        bool is_render_thread() const;
+
+        /*!
+         * \brief Runs the task on the render thread right before the next frame that's published. Can be called from any
+         * thread
+         */
+        void run_before_next_frame(task work);
+
+        /*!
+         * \brief Runs the task on the render thread as soon as it's not rendering, and waits for it to finish.
+         * Everything queued with #run_before_next_frame runs first, so this sees the result of every call made before
+         * it
+         *
+         * If the task throws, the exception is rethrown here
+         */
+        void run_and_wait(task work);
+
+        /*!
+         * \brief Waits for the frame in flight, then hands the render thread the next frame along with everything
+         * that's been queued for it
+         */
+        void publish_frame(task frame);
+
+        /*!
+         * \brief Waits until the render thread isn't doing anything
+         */
+        void wait_until_idle();
+
+    private:
+        std::thread thread;
+
+        /*!
+         * \brief Read from any thread without the lock, by #is_render_thread and #is_running
+         */
+        std::atomic<std::thread::id> render_thread_id{std::thread::id()};
+        std::atomic<bool> running{false};
+
+        std::mutex work_lock;
+        std::condition_variable work_available;
+        std::condition_variable work_finished;
+
+        /*!
+         * \brief Work that's waiting for the next frame to be published
+         */
+        std::vector<task> next_frame_work;
+
+        /*!
+         * \brief Work that the render thread should do right now. Only ever filled when the render thread is idle
+         */
+        std::vector<task> ready_work;
+
+        /*!
+         * \brief True from when work is handed to the render thread until it's all done
+         */
+        bool busy = false;
+
+        bool stopping = false;
+
+        void run();
+
+        /*!
+         * \brief Waits until the render thread is idle, then hands it everything queued for the next frame plus the
+         * given task. The lock must be held
+         */
+        void hand_over(std::unique_lock<std::mutex>& lock, task work);
+    };
+}
+
+#endif //RENDERER_RENDER_THREAD_H
@@ -0,0 +1,79 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <cmath>
+#include <easylogging++.h>
+#include "visibility_cache.h"
+#include "../utils/profiler.h"
+
+namespace nova {
+    /*!
+     * \brief Computes the smallest difference between two angles, in degrees
+     */
+    float angle_difference(float angle1, float angle2) {
+        float difference = std::fmod(std::abs(angle1 - angle2), 360.0f);
+        return std::min(difference, 360.0f - difference);
+    }
+
+    visibility_cache::visibility_cache(float position_threshold, float rotation_threshold) :
+            position_threshold(position_threshold), rotation_threshold(rotation_threshold) {}
+
+    void visibility_cache::update(const camera& player_camera) {
+        if(has_culling_camera && !camera_moved_too_far(player_camera)) {
+            return;
+        }
+
+        profiler::start("refresh_culling_camera");
+        culling_camera = player_camera;
+        culling_camera.recalculate_frustum(position_threshold, rotation_threshold);
+        has_culling_camera = true;
+
+        visibility_by_shader.clear();
+        profiler::end("refresh_culling_camera");
+    }
+
+    const std::vector<size_t>& visibility_cache::get_visible_objects(const std::string& shader_name, std::vector<render_object>& objects, uint64_t geometry_version) {
+        auto& cached = visibility_by_shader[shader_name];
+        if(cached.is_valid && cached.geometry_version == geometry_version) {
+            return cached.visible_objects;
+        }
+
+        profiler::start("frustum_cull");
+        cached.is_valid = true;
+        cached.geometry_version = geometry_version;
+        cached.visible_objects.clear();
+        for(size_t i = 0; i < objects.size(); i++) {
+            auto& obj = objects[i];
+            if(culling_camera.has_sphere_in_frustum(obj.bounding_sphere) && culling_camera.has_object_in_frustum(obj.bounding_box)) {
+                cached.visible_objects.push_back(i);
+            }
+        }
+        profiler::end("frustum_cull");
+
+        LOG(TRACE) << "Shader " << shader_name << " has " << cached.visible_objects.size() << " of " << objects.size() << " objects in the guard band frustum";
+
+        return cached.visible_objects;
+    }
+
+    void visibility_cache::invalidate() {
+        has_culling_camera = false;
+        visibility_by_shader.clear();
+    }
+
+    bool visibility_cache::camera_moved_too_far(const camera& player_camera) const {
+        if(player_camera.fov != culling_camera.fov || player_camera.aspect_ratio != culling_camera.aspect_ratio ||
+           player_camera.near_plane != culling_camera.near_plane || player_camera.far_plane != culling_camera.far_plane) {
+            return true;
+        }
+
+        if(glm::distance(player_camera.position, culling_camera.position) > position_threshold) {
+            return true;
+        }
+
+        float yaw_change = angle_difference(player_camera.rotation.x, culling_camera.rotation.x);
+        float pitch_change = std::abs(player_camera.rotation.y - culling_camera.rotation.y);
+        return yaw_change + pitch_change > rotation_threshold;
+    }
+}
@@ -0,0 +1,88 @@
+/*!
+ * \brief Caches the results of frustum culling between frames
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_VISIBILITY_CACHE_H
+#define RENDERER_VISIBILITY_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <glm/glm.hpp>
+#include "objects/camera.h"
+#include "objects/render_object.h"
+
+namespace nova {
+    /*!
+     * \brief Remembers which render_objects passed the frustum test so that culling only has to run again when the
+     * camera has moved or turned far enough, or when the geometry for a shader has changed
+     *
+     * The cached results are computed against a "guard band" frustum: the camera's frustum widened by the same
+     * thresholds that trigger a refresh. Anything that could come into view before the camera crosses a threshold is
+     * already in the cached list, so a player who stands still (or just wiggles the mouse a bit) costs nothing to cull
+     */
+    class visibility_cache {
+    public:
+        /*!
+         * \param position_threshold How many blocks the camera can move before the cache is refreshed
+         * \param rotation_threshold How many degrees the camera can turn (yaw and pitch combined) before the cache is
+         * refreshed
+         */
+        explicit visibility_cache(float position_threshold = 2.0f, float rotation_threshold = 10.0f);
+
+        /*!
+         * \brief Compares the camera to the camera the cached results were computed with, throwing away all cached
+         * results if it has moved or turned too much
+         *
+         * Call this once per frame, before asking for any visible objects
+         *
+         * \param player_camera The camera to render from
+         */
+        void update(const camera& player_camera);
+
+        /*!
+         * \brief Retrieves the indices of the objects that might be visible
+         *
+         * If the cached list for this shader was built from an older version of the shader's geometry, it's rebuilt
+         *
+         * \param shader_name The name of the shader that renders the objects
+         * \param objects The objects that the shader renders
+         * \param geometry_version The version of the shader's geometry, as reported by the mesh_store
+         * \return The indices in objects of all the objects which passed the frustum test
+         */
+        const std::vector<size_t>& get_visible_objects(const std::string& shader_name, std::vector<render_object>& objects, uint64_t geometry_version);
+
+        /*!
+         * \brief Throws away every cached result
+         */
+        void invalidate();
+
+    private:
+        struct cached_visibility {
+            bool is_valid = false;
+            uint64_t geometry_version = 0;
+            std::vector<size_t> visible_objects;
+        };
+
+        float position_threshold;
+        float rotation_threshold;
+
+        bool has_culling_camera = false;
+
+        /*!
+         * \brief A copy of the player camera from when the cache was last refreshed, with its frustum widened by the
+         * thresholds
+         */
+        camera culling_camera;
+
+        std::unordered_map<std::string, cached_visibility> visibility_by_shader;
+
+        bool camera_moved_too_far(const camera& player_camera) const;
+    };
+}
+
+#endif //RENDERER_VISIBILITY_CACHE_H
@@ -32,10 +32,10 @@ namespace nova {
 
     int glfw_gl_window::init() {
 
-		nlohmann::json &config = nova_renderer::get_render_settings().get_options();
+		const auto& config = nova_renderer::get_render_settings();
 
-		float view_width = config["settings"]["viewWidth"];
-		float view_height = config["settings"]["viewHeight"];
+		auto view_width = config.get<setting::view_width>();
+		auto view_height = config.get<setting::view_height>();
 
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
@@ -129,29 +129,40 @@ namespace nova {
     }
 
     void glfw_gl_window::end_frame() {
-        // We're in thread 29
+        // Runs on the render thread
         glfwSwapBuffers(window);
+    }
+
+    void glfw_gl_window::poll_events() {
+        // GLFW only lets the thread that made the window poll it, so this runs on the game thread
         glfwPollEvents();
 
         glm::ivec2 new_window_size;
         glfwGetFramebufferSize(window, &new_window_size.x, &new_window_size.y);
-		
+
         if(new_window_size != window_dimensions) {
             set_framebuffer_size(new_window_size);
         }
     }
 
+    void glfw_gl_window::make_context_current() {
+        glfwMakeContextCurrent(window);
+    }
+
+    void glfw_gl_window::release_context() {
+        glfwMakeContextCurrent(nullptr);
+    }
+
     void glfw_gl_window::set_framebuffer_size(glm::ivec2 new_framebuffer_size) {
-        nlohmann::json &settings = nova_renderer::instance->get_render_settings().get_options();
-        settings["settings"]["viewWidth"] = new_framebuffer_size.x;
-        settings["settings"]["viewHeight"] = new_framebuffer_size.y;
+        // The render thread sets the viewport from the settings at the start of each frame
         window_dimensions = new_framebuffer_size;
-        glViewport(0, 0, window_dimensions.x, window_dimensions.y);
-        nova_renderer::instance->get_render_settings().update_config_changed();
-    }
 
-    void glfw_gl_window::on_config_change(nlohmann::json &new_config) {
-        LOG(INFO) << "gl_glfw_window received the updated config";
+        // One transaction so the width and height show up together
+        auto& settings = nova_renderer::get_render_settings();
+        settings.begin_transaction();
+        settings.set<setting::view_width>(new_framebuffer_size.x);
+        settings.set<setting::view_height>(new_framebuffer_size.y);
+        settings.commit_transaction();
     }
 
     void glfw_gl_window::on_config_loaded(nlohmann::json &config) {
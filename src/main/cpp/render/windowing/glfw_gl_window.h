@@ -55,14 +55,28 @@ namespace nova {
 
         bool is_active();
 
+        /*!
+         * \brief Handles any window events that have happened, including passing input to the input handler. Only call
+         * this from the thread that created the window
+         */
+        void poll_events();
+
+        /*!
+         * \brief Makes the window's OpenGL context current on the calling thread
+         */
+        void make_context_current();
+
+        /*!
+         * \brief Makes the calling thread let go of the window's OpenGL context, so another thread can take it
+         */
+        void release_context();
+
         void set_mouse_grabbed(bool grabbed);
 
         /**
          * iconfig_change_listener methods
          */
 
-        void on_config_change(nlohmann::json &new_config);
-
         void on_config_loaded(nlohmann::json &config);
 
         static void setActive(bool active);
@@ -0,0 +1,81 @@
+/*!
+ * \brief Tests for sorting chunk geometry into face direction buckets
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../geometry_cache/face_buckets.h"
+
+namespace nova {
+    namespace test {
+        uint8_t bit_for(face_direction direction) {
+            return static_cast<uint8_t>(1 << static_cast<uint8_t>(direction));
+        }
+
+        TEST(face_buckets, quads_are_grouped_by_direction) {
+            // Two quads: the first one on the top of a block (+Y), the second on the side of a block (-X)
+            std::vector<float> vertices = {
+                    0, 1, 0,
+                    0, 1, 1,
+                    1, 1, 1,
+                    1, 1, 0,
+
+                    0, 0, 0,
+                    0, 0, 1,
+                    0, 1, 1,
+                    0, 1, 0,
+            };
+            std::vector<int> indices = {
+                    0, 1, 2, 0, 2, 3,
+                    4, 5, 6, 4, 6, 7,
+            };
+
+            auto ranges = sort_indices_into_face_buckets(vertices.data(), 3, indices);
+
+            auto& neg_x = ranges[static_cast<size_t>(face_direction::negative_x)];
+            auto& pos_y = ranges[static_cast<size_t>(face_direction::positive_y)];
+            EXPECT_EQ(neg_x.num_indices, 6);
+            EXPECT_EQ(pos_y.num_indices, 6);
+            EXPECT_EQ(ranges[static_cast<size_t>(face_direction::other)].num_indices, 0);
+
+            // -X comes before +Y in the index buffer
+            EXPECT_EQ(neg_x.first_index, 0);
+            EXPECT_EQ(pos_y.first_index, 6);
+            EXPECT_EQ(indices[0], 4);
+            EXPECT_EQ(indices[6], 0);
+        }
+
+        TEST(face_buckets, leftover_indices_go_in_other) {
+            std::vector<float> vertices = {
+                    0, 0, 0,
+                    1, 0, 0,
+                    0, 1, 0,
+            };
+            std::vector<int> indices = {0, 1, 2};
+
+            auto ranges = sort_indices_into_face_buckets(vertices.data(), 3, indices);
+
+            EXPECT_EQ(ranges[static_cast<size_t>(face_direction::other)].num_indices, 3);
+        }
+
+        TEST(face_buckets, faces_pointing_away_are_skipped) {
+            aabb bounds = {};
+            bounds.center = {8, 8, 8};
+            bounds.extents = {8, 8, 8};
+
+            // Above the chunk, and off to its +X side but inside its Z range
+            auto visible = get_potentially_visible_faces(bounds, {20, 30, 8});
+
+            EXPECT_TRUE(visible & bit_for(face_direction::positive_x));
+            EXPECT_FALSE(visible & bit_for(face_direction::negative_x));
+            EXPECT_TRUE(visible & bit_for(face_direction::positive_y));
+            EXPECT_FALSE(visible & bit_for(face_direction::negative_y));
+            EXPECT_TRUE(visible & bit_for(face_direction::positive_z));
+            EXPECT_TRUE(visible & bit_for(face_direction::negative_z));
+            EXPECT_TRUE(visible & bit_for(face_direction::other));
+        }
+    }
+}
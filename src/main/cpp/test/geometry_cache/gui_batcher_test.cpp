@@ -0,0 +1,61 @@
+/*!
+ * \brief Tests turning GUI geometry from Minecraft into batched draws
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../geometry_cache/gui_batcher.h"
+
+namespace nova {
+    namespace test {
+        TEST(gui_batcher, normalizes_texture_names) {
+            EXPECT_EQ(normalize_gui_texture_name("textures/gui/widgets.png"), "minecraft:gui/widgets");
+            EXPECT_EQ(normalize_gui_texture_name("gui/widgets"), "minecraft:gui/widgets");
+
+            // Only a prefix or suffix gets removed
+            EXPECT_EQ(normalize_gui_texture_name("font/textures/ascii.png.png"), "minecraft:font/textures/ascii.png");
+            EXPECT_EQ(normalize_gui_texture_name(".png"), "minecraft:");
+        }
+
+        TEST(gui_batcher, merges_draws_with_the_same_atlas) {
+            std::vector<gui_draw> draws;
+            append_gui_draw(draws, "gui", 0, 6);
+            append_gui_draw(draws, "gui", 6, 12);
+            append_gui_draw(draws, "font", 18, 6);
+            append_gui_draw(draws, "gui", 24, 6);
+
+            ASSERT_EQ(draws.size(), 3);
+            EXPECT_EQ(draws[0].atlas_name, "gui");
+            EXPECT_EQ(draws[0].first_index, 0u);
+            EXPECT_EQ(draws[0].num_indices, 18u);
+            EXPECT_EQ(draws[1].atlas_name, "font");
+            EXPECT_EQ(draws[2].first_index, 24u);
+        }
+
+        TEST(gui_batcher, remaps_uvs_and_indices) {
+            std::vector<float> vertices = {
+                    1, 2, 3, 0.0f, 0.0f, 1, 1, 1, 1,
+                    4, 5, 6, 1.0f, 0.5f, 0.5f, 0.5f, 0.5f, 1
+            };
+            std::vector<int> indices = {0, 1, 1};
+            mc_gui_geometry command = {"textures/gui/widgets.png", 3, 18, indices.data(), vertices.data(), "gui"};
+            texture_manager::texture_location location = {{0.5f, 0.25f}, {0.75f, 0.5f}};
+
+            std::vector<float> written_vertices(vertices.size());
+            write_gui_vertices(command, location, written_vertices.data());
+            EXPECT_FLOAT_EQ(written_vertices[0], 1);
+            EXPECT_FLOAT_EQ(written_vertices[3], 0.5f);
+            EXPECT_FLOAT_EQ(written_vertices[4], 0.25f);
+            EXPECT_FLOAT_EQ(written_vertices[12], 0.75f);
+            EXPECT_FLOAT_EQ(written_vertices[13], 0.375f);
+            EXPECT_FLOAT_EQ(written_vertices[14], 0.5f);
+
+            std::vector<uint32_t> written_indices(indices.size());
+            write_gui_indices(command, 10, written_indices.data());
+            EXPECT_EQ(written_indices, std::vector<uint32_t>({10, 11, 11}));
+        }
+    }
+}
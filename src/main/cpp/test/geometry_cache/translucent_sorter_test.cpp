@@ -0,0 +1,73 @@
+/*!
+ * \brief Tests for sorting translucent geometry back-to-front
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../geometry_cache/translucent_sorter.h"
+
+namespace nova {
+    namespace test {
+        /*!
+         * \brief Three unit quads facing +Y, at x = 0, 2 and 4
+         */
+        std::shared_ptr<translucent_geometry> make_row_of_quads(const glm::vec3& position) {
+            std::vector<float> vertices;
+            std::vector<int> indices;
+            for(int quad = 0; quad < 3; quad++) {
+                float x = quad * 2.0f;
+                std::vector<float> quad_vertices = {
+                        x, 0, 0,
+                        x, 0, 1,
+                        x + 1, 0, 1,
+                        x + 1, 0, 0,
+                };
+                vertices.insert(vertices.end(), quad_vertices.begin(), quad_vertices.end());
+
+                int first = quad * 4;
+                std::vector<int> quad_indices = {first, first + 1, first + 2, first, first + 2, first + 3};
+                indices.insert(indices.end(), quad_indices.begin(), quad_indices.end());
+            }
+
+            return make_translucent_geometry(vertices.data(), 3, indices, position);
+        }
+
+        TEST(translucent_sorter, quad_centers) {
+            auto geometry = make_row_of_quads({0, 0, 0});
+
+            ASSERT_EQ(geometry->quad_centers.size(), 3);
+            EXPECT_FLOAT_EQ(geometry->quad_centers[1].x, 2.5f);
+            EXPECT_FLOAT_EQ(geometry->quad_centers[1].z, 0.5f);
+        }
+
+        TEST(translucent_sorter, farthest_quad_comes_first) {
+            auto geometry = make_row_of_quads({0, 0, 0});
+
+            // Off the +X end of the row, so the quad at x = 0 is the farthest away
+            sort_translucent_geometry(*geometry, {10, 1, 0});
+
+            ASSERT_EQ(geometry->sorted_indices.size(), 18);
+            EXPECT_EQ(geometry->sorted_indices[0], 0);
+            EXPECT_EQ(geometry->sorted_indices[6], 4);
+            EXPECT_EQ(geometry->sorted_indices[12], 8);
+
+            // Off the -X end, so the order flips
+            sort_translucent_geometry(*geometry, {-10, 1, 0});
+
+            EXPECT_EQ(geometry->sorted_indices[0], 8);
+            EXPECT_EQ(geometry->sorted_indices[12], 0);
+        }
+
+        TEST(translucent_sorter, camera_is_relative_to_mesh_position) {
+            // The mesh is moved far down +X, so a camera at the origin is off its -X end
+            auto geometry = make_row_of_quads({100, 0, 0});
+
+            sort_translucent_geometry(*geometry, {0, 1, 0});
+
+            EXPECT_EQ(geometry->sorted_indices[0], 8);
+        }
+    }
+}
@@ -0,0 +1,117 @@
+/*!
+ * \brief Tests for getting input events out of the input handler
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+#include "../../input/InputHandler.h"
+
+namespace nova {
+    namespace test {
+        TEST(input_handler, drains_every_kind_of_event_in_order) {
+            input_handler inputs;
+            inputs.queue_mouse_position_event({10, 20, 1});
+            inputs.queue_key_char_event({'a', 1});
+            inputs.queue_mouse_button_event({0, 1, 0, 1});
+            inputs.queue_mouse_position_event({11, 21, 1});
+            inputs.queue_mouse_scroll_event({0.0, 1.0, 1});
+
+            input_event events[8];
+            ASSERT_EQ(inputs.drain_events(events, 8, false), 5);
+            EXPECT_EQ(events[0].type, INPUT_EVENT_MOUSE_POSITION);
+            EXPECT_EQ(events[0].xpos, 10);
+            EXPECT_EQ(events[1].type, INPUT_EVENT_KEY_CHAR);
+            EXPECT_EQ(events[1].unicode_char, 'a');
+            EXPECT_EQ(events[2].type, INPUT_EVENT_MOUSE_BUTTON);
+            EXPECT_EQ(events[3].type, INPUT_EVENT_MOUSE_POSITION);
+            EXPECT_EQ(events[4].type, INPUT_EVENT_MOUSE_SCROLL);
+            EXPECT_DOUBLE_EQ(events[4].yoffset, 1.0);
+
+            for(int i = 1; i < 5; i++) {
+                EXPECT_GE(events[i].timestamp, events[i - 1].timestamp);
+            }
+
+            EXPECT_EQ(inputs.drain_events(events, 8, false), 0);
+        }
+
+        TEST(input_handler, coalesces_mouse_moves_next_to_each_other) {
+            input_handler inputs;
+            inputs.queue_mouse_position_event({1, 1, 1});
+            inputs.queue_mouse_position_event({2, 2, 1});
+            inputs.queue_mouse_button_event({0, 1, 0, 1});
+            inputs.queue_mouse_position_event({3, 3, 1});
+            inputs.queue_mouse_position_event({4, 4, 1});
+            inputs.queue_mouse_position_event({5, 5, 1});
+
+            // Coalescing into the last event still works when the buffer is full
+            input_event events[3];
+            ASSERT_EQ(inputs.drain_events(events, 3, true), 3);
+            EXPECT_EQ(events[0].xpos, 2);
+            EXPECT_EQ(events[1].type, INPUT_EVENT_MOUSE_BUTTON);
+            EXPECT_EQ(events[2].xpos, 5);
+        }
+
+        TEST(input_handler, coalesced_moves_are_as_old_as_the_first_move) {
+            input_handler inputs;
+            inputs.queue_mouse_position_event({1, 1, 1});
+            auto between_moves = get_input_timestamp();
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            inputs.queue_mouse_position_event({2, 2, 1});
+
+            input_event events[1];
+            ASSERT_EQ(inputs.drain_events(events, 1, true), 1);
+            EXPECT_EQ(events[0].xpos, 2);
+            EXPECT_LE(events[0].timestamp, between_moves);
+        }
+
+        TEST(input_handler, leaves_events_that_dont_fit) {
+            input_handler inputs;
+            inputs.queue_key_char_event({'a', 1});
+            inputs.queue_key_char_event({'b', 1});
+
+            input_event events[1];
+            ASSERT_EQ(inputs.drain_events(events, 1, true), 1);
+            EXPECT_EQ(events[0].unicode_char, 'a');
+
+            auto next_char = inputs.dequeue_key_char_event();
+            EXPECT_EQ(next_char.filled, 1);
+            EXPECT_EQ(next_char.unicode_char, 'b');
+            EXPECT_EQ(inputs.dequeue_key_char_event().filled, 0);
+        }
+
+        TEST(input_handler, hands_events_between_threads) {
+            input_handler inputs;
+            const int num_events = 100000;
+
+            std::thread producer([&]() {
+                int i = 0;
+                while(i < num_events) {
+                    // If the ring was full, try the same event again
+                    auto num_dropped = inputs.get_num_dropped_events();
+                    inputs.queue_mouse_position_event({i, 0, 1});
+                    if(inputs.get_num_dropped_events() == num_dropped) {
+                        i++;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+
+            int next_x = 0;
+            input_event events[64];
+            while(next_x < num_events) {
+                auto num_drained = inputs.drain_events(events, 64, false);
+                for(size_t i = 0; i < num_drained; i++) {
+                    ASSERT_EQ(events[i].xpos, next_x);
+                    next_x++;
+                }
+            }
+
+            producer.join();
+        }
+    }
+}
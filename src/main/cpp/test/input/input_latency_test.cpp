@@ -0,0 +1,96 @@
+/*!
+ * \brief Tests for measuring input latency
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <gtest/gtest.h>
+#include "../../input/input_latency.h"
+#include "../../utils/stats.h"
+
+namespace nova {
+    namespace test {
+        const uint64_t MILLISECOND = 1000000;
+
+        TEST(input_latency_tracker, ties_events_to_the_next_present) {
+            input_latency_tracker tracker;
+
+            // Nothing consumed, so nothing to measure
+            tracker.on_frame_presented(tracker.on_frame_published(), 5 * MILLISECOND);
+            EXPECT_EQ(tracker.get_summary().num_samples, 0);
+
+            tracker.on_event_consumed(10 * MILLISECOND);
+            tracker.on_event_consumed(14 * MILLISECOND);
+            tracker.on_frame_presented(tracker.on_frame_published(), 20 * MILLISECOND);
+
+            auto summary = tracker.get_summary();
+            EXPECT_EQ(summary.num_samples, 2);
+            EXPECT_DOUBLE_EQ(summary.mean_ms, 8.0);
+            EXPECT_DOUBLE_EQ(summary.max_ms, 10.0);
+            EXPECT_DOUBLE_EQ(stats::get("input_latency_max_ms"), 10.0);
+
+            // Events only count towards the frame they were consumed for
+            tracker.on_frame_presented(tracker.on_frame_published(), 40 * MILLISECOND);
+            EXPECT_EQ(tracker.get_summary().num_samples, 2);
+        }
+
+        TEST(input_latency_tracker, summarizes_the_most_recent_samples) {
+            input_latency_tracker tracker(100);
+
+            for(uint64_t frame = 0; frame < 200; frame++) {
+                uint64_t present_time = frame * 16 * MILLISECOND;
+                tracker.on_event_consumed(present_time - (frame % 100 + 1) * MILLISECOND);
+                tracker.on_frame_presented(tracker.on_frame_published(), present_time);
+            }
+
+            auto summary = tracker.get_summary();
+            EXPECT_EQ(summary.num_samples, 100);
+            EXPECT_NEAR(summary.p50_ms, 50.0, 1.0);
+            EXPECT_NEAR(summary.p95_ms, 95.0, 1.0);
+            EXPECT_NEAR(summary.p99_ms, 99.0, 1.0);
+            EXPECT_DOUBLE_EQ(summary.max_ms, 100.0);
+            EXPECT_DOUBLE_EQ(stats::get("input_latency_samples"), 200.0);
+        }
+
+        TEST(input_latency_tracker, publishes_percentiles_at_most_once_a_second) {
+            input_latency_tracker tracker;
+
+            tracker.on_event_consumed(0);
+            tracker.on_frame_presented(tracker.on_frame_published(), 10 * MILLISECOND);
+            EXPECT_DOUBLE_EQ(stats::get("input_latency_max_ms"), 10.0);
+
+            // The summary is always up to date, but the stats wait
+            tracker.on_event_consumed(10 * MILLISECOND);
+            tracker.on_frame_presented(tracker.on_frame_published(), 110 * MILLISECOND);
+            EXPECT_DOUBLE_EQ(tracker.get_summary().max_ms, 100.0);
+            EXPECT_DOUBLE_EQ(stats::get("input_latency_max_ms"), 10.0);
+
+            tracker.on_event_consumed(1000 * MILLISECOND);
+            tracker.on_frame_presented(tracker.on_frame_published(), 1010 * MILLISECOND);
+            EXPECT_DOUBLE_EQ(stats::get("input_latency_max_ms"), 100.0);
+        }
+
+        TEST(input_latency_tracker, waits_for_the_frame_an_event_was_consumed_for) {
+            input_latency_tracker tracker;
+
+            tracker.on_event_consumed(0);
+            auto first_frame = tracker.on_frame_published();
+
+            // The game thread takes input for the next frame while the render thread is still presenting the first
+            tracker.on_event_consumed(12 * MILLISECOND);
+            tracker.on_frame_presented(first_frame, 16 * MILLISECOND);
+
+            auto summary = tracker.get_summary();
+            EXPECT_EQ(summary.num_samples, 1);
+            EXPECT_DOUBLE_EQ(summary.max_ms, 16.0);
+
+            auto second_frame = tracker.on_frame_published();
+            tracker.on_frame_presented(second_frame, 32 * MILLISECOND);
+
+            summary = tracker.get_summary();
+            EXPECT_EQ(summary.num_samples, 2);
+            EXPECT_DOUBLE_EQ(summary.max_ms, 20.0);
+        }
+    }
+}
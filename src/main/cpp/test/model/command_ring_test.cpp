@@ -0,0 +1,165 @@
+/*!
+ * \brief Tests for writing commands into the command ring and reading them back out
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <thread>
+#include <gtest/gtest.h>
+#include "../../data_loading/command_ring.h"
+
+namespace nova {
+    namespace test {
+        TEST(command_ring, header_describes_the_ring) {
+            command_ring ring(1000);
+            auto* header = reinterpret_cast<command_ring_header*>(ring.get_memory());
+
+            EXPECT_EQ(header->magic, COMMAND_RING_MAGIC);
+            EXPECT_EQ(header->version, COMMAND_RING_VERSION);
+            EXPECT_EQ(header->capacity, 1024u);
+            EXPECT_EQ(header->data_offset, sizeof(command_ring_header));
+            EXPECT_EQ(ring.get_memory_size(), sizeof(command_ring_header) + 1024);
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(header) % 64, 0u);
+        }
+
+        TEST(command_ring, reads_back_what_was_written) {
+            command_ring ring(1024);
+
+            int indices[] = {0, 1, 2};
+            float vertices[] = {1.0f, 2.0f, 3.0f, 4.0f};
+            command_builder gui;
+            gui.add<int32_t>(3).add<int32_t>(4).add_string("minecraft:gui/widgets").add_string("gui").add_array(indices, 3).add_array(vertices, 4);
+            ASSERT_TRUE(ring.write(command_type::add_gui_geometry, gui.get_data()));
+
+            command_builder camera;
+            camera.add(1.5).add(2.5).add(3.5).add(90.0f).add(-45.0f);
+            ASSERT_TRUE(ring.write(command_type::set_camera, camera.get_data()));
+
+            std::vector<command_type> types;
+            auto num_commands = ring.consume([&](command_type type, command_reader& reader) {
+                types.push_back(type);
+                if(type == command_type::add_gui_geometry) {
+                    auto num_indices = reader.read<int32_t>();
+                    auto num_vertices = reader.read<int32_t>();
+                    EXPECT_STREQ(reader.read_string(), "minecraft:gui/widgets");
+                    EXPECT_STREQ(reader.read_string(), "gui");
+                    auto* read_indices = reader.read_array<int32_t>(num_indices);
+                    EXPECT_EQ(read_indices[2], 2);
+                    auto* read_vertices = reader.read_array<float>(num_vertices);
+                    EXPECT_FLOAT_EQ(read_vertices[3], 4.0f);
+
+                } else {
+                    EXPECT_DOUBLE_EQ(reader.read<double>(), 1.5);
+                    EXPECT_DOUBLE_EQ(reader.read<double>(), 2.5);
+                    EXPECT_DOUBLE_EQ(reader.read<double>(), 3.5);
+                    EXPECT_FLOAT_EQ(reader.read<float>(), 90.0f);
+                    EXPECT_FLOAT_EQ(reader.read<float>(), -45.0f);
+                }
+            });
+
+            EXPECT_EQ(num_commands, 2u);
+            ASSERT_EQ(types.size(), 2u);
+            EXPECT_EQ(types[0], command_type::add_gui_geometry);
+            EXPECT_EQ(types[1], command_type::set_camera);
+
+            EXPECT_EQ(ring.consume([](command_type, command_reader&) { FAIL(); }), 0u);
+        }
+
+        TEST(command_ring, stops_at_the_given_offset) {
+            command_ring ring(1024);
+
+            ASSERT_TRUE(ring.write(command_type::clear_gui, {}));
+            auto frame_end = ring.get_write_offset();
+            ASSERT_TRUE(ring.write(command_type::clear_gui, {}));
+
+            auto count_commands = [](command_type, command_reader&) {};
+            EXPECT_EQ(ring.consume(count_commands, frame_end), 1u);
+            EXPECT_EQ(ring.consume(count_commands, frame_end), 0u);
+            EXPECT_EQ(ring.consume(count_commands), 1u);
+
+            // An offset from before everything was consumed doesn't do anything
+            EXPECT_EQ(ring.consume(count_commands, frame_end), 0u);
+        }
+
+        TEST(command_ring, skips_commands_that_read_too_far) {
+            command_ring ring(1024);
+
+            command_builder short_setting;
+            short_setting.add(1.0f);
+            ASSERT_TRUE(ring.write(command_type::set_float_setting, short_setting.get_data()));
+            ASSERT_TRUE(ring.write(command_type::clear_gui, {}));
+
+            std::vector<command_type> handled;
+            auto num_commands = ring.consume([&](command_type type, command_reader& reader) {
+                if(type == command_type::set_float_setting) {
+                    reader.read<float>();
+                    reader.read_string();
+                }
+                handled.push_back(type);
+            });
+
+            EXPECT_EQ(num_commands, 1u);
+            ASSERT_EQ(handled.size(), 1u);
+            EXPECT_EQ(handled[0], command_type::clear_gui);
+        }
+
+        TEST(command_ring, refuses_commands_that_dont_fit_and_wraps_around) {
+            command_ring ring(64);
+            std::vector<uint8_t> payload(16, 0xAB);
+
+            // 24 bytes each, so the third one doesn't fit
+            ASSERT_TRUE(ring.write(command_type::clear_gui, payload));
+            ASSERT_TRUE(ring.write(command_type::clear_gui, payload));
+            EXPECT_FALSE(ring.write(command_type::clear_gui, payload));
+            EXPECT_EQ(ring.consume([](command_type, command_reader&) {}), 2u);
+
+            // Now there's only 16 bytes before the end of the ring, so this one gets padded to the start
+            ASSERT_TRUE(ring.write(command_type::clear_gui, payload));
+            auto num_commands = ring.consume([](command_type type, command_reader& reader) {
+                EXPECT_EQ(type, command_type::clear_gui);
+                EXPECT_EQ(reader.read<uint8_t>(), 0xAB);
+            });
+            EXPECT_EQ(num_commands, 1u);
+        }
+
+        TEST(command_ring, throws_away_a_corrupt_ring) {
+            command_ring ring(1024);
+            ASSERT_TRUE(ring.write(command_type::clear_gui, {}));
+
+            auto* header = reinterpret_cast<command_ring_header*>(ring.get_memory());
+            auto* first_command = reinterpret_cast<command_header*>(ring.get_memory() + header->data_offset);
+            first_command->size = 12;
+
+            EXPECT_EQ(ring.consume([](command_type, command_reader&) { FAIL(); }), 0u);
+            EXPECT_EQ(header->read_offset.load(), header->write_offset.load());
+        }
+
+        TEST(command_ring, hands_commands_between_threads) {
+            command_ring ring(4096);
+            const int num_commands = 100000;
+
+            std::thread writer([&]() {
+                for(int i = 0; i < num_commands; i++) {
+                    command_builder setting;
+                    setting.add(static_cast<float>(i)).add_string("someSetting");
+                    while(!ring.write(command_type::set_float_setting, setting.get_data())) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+
+            int next_value = 0;
+            while(next_value < num_commands) {
+                ring.consume([&](command_type type, command_reader& reader) {
+                    EXPECT_EQ(type, command_type::set_float_setting);
+                    EXPECT_FLOAT_EQ(reader.read<float>(), static_cast<float>(next_value));
+                    EXPECT_STREQ(reader.read_string(), "someSetting");
+                    next_value++;
+                });
+            }
+
+            writer.join();
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/*!
+ * \brief Tests for keeping a shader's source in one string with a map of where its lines came from
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <gtest/gtest.h>
+#include "../../../data_loading/loaders/shader_source_structs.h"
+
+namespace nova {
+    namespace test {
+        TEST(shader_source, keeps_lines_in_one_string) {
+            shader_source source;
+            auto file_id = source.add_file("shaderpacks/default/shaders/gui.frag");
+            source.add_line(file_id, 1, "#version 450");
+            source.add_line(file_id, 2, "");
+            source.add_line(file_id, 3, "void main() {}");
+
+            EXPECT_EQ(source.get_text(), "#version 450\n\nvoid main() {}\n");
+            ASSERT_EQ(source.size(), 3);
+
+            EXPECT_EQ(source.get_line(1), "");
+            EXPECT_EQ(source.get_line(2), "void main() {}");
+
+            auto line = source[2];
+            EXPECT_EQ(line.line_num, 3);
+            EXPECT_EQ(line.shader_name, "shaderpacks/default/shaders/gui.frag");
+            EXPECT_EQ(line.line, "void main() {}");
+        }
+
+        TEST(shader_source, only_keeps_each_file_name_once) {
+            shader_source source;
+            auto first_id = source.add_file("a.glsl");
+            auto second_id = source.add_file("b.glsl");
+
+            EXPECT_NE(first_id, second_id);
+            EXPECT_EQ(source.add_file("a.glsl"), first_id);
+            EXPECT_EQ(source.get_file_name(second_id), "b.glsl");
+        }
+
+        TEST(shader_source, appends_lines_from_other_shaders) {
+            shader_source library;
+            auto library_id = library.add_file("lib.glsl");
+            library.add_line(library_id, 1, "float a;");
+            library.add_line(library_id, 2, "float b;");
+            library.add_line(library_id, 3, "float c;");
+
+            shader_source shader;
+            auto shader_id = shader.add_file("shader.frag");
+            shader.add_line(shader_id, 1, "#version 450");
+            shader.append(library, 1, 3);
+            shader.add_line(shader_id, 3, "void main() {}");
+
+            EXPECT_EQ(shader.get_text(), "#version 450\nfloat b;\nfloat c;\nvoid main() {}\n");
+            ASSERT_EQ(shader.size(), 4);
+
+            for(size_t i = 1; i < 3; i++) {
+                auto line = shader[i];
+                EXPECT_EQ(line.shader_name, "lib.glsl");
+                EXPECT_EQ(line.line_num, static_cast<int>(i + 1));
+                EXPECT_EQ(line.line, library.get_line(i));
+            }
+            EXPECT_EQ(shader[3].shader_name, "shader.frag");
+            EXPECT_EQ(shader.get_location(3).offset, shader.get_text().find("void main"));
+
+            // Appending nothing changes nothing
+            shader.append(library, 2, 2);
+            EXPECT_EQ(shader.size(), 4);
+        }
+    }
+}
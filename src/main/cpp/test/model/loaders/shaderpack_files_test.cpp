@@ -0,0 +1,224 @@
+/*!
+ * \brief Tests for reading a shaderpack's files, and a benchmark against reading them one at a time
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <gtest/gtest.h>
+#include "../../../data_loading/loaders/shaderpack_files.h"
+#include "../../../data_loading/loaders/shader_loading.h"
+#include "../../../utils/job_system.h"
+#include "../../../utils/utils.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#define rmdir _rmdir
+#else
+#include <unistd.h>
+#endif
+
+namespace nova {
+    namespace test {
+        /*!
+         * \brief Writes a shaderpack's files to disk, and deletes them again when it goes away
+         */
+        class test_shaderpack {
+        public:
+            explicit test_shaderpack(const std::string& name) : shaders_directory("shaderpacks/" + name + "/shaders") {}
+
+            ~test_shaderpack() {
+                for(const auto& path : list_files(shaders_directory)) {
+                    std::remove(path.c_str());
+                }
+                for(auto itr = directories.rbegin(); itr != directories.rend(); ++itr) {
+                    rmdir(itr->c_str());
+                }
+                rmdir(shaders_directory.c_str());
+                rmdir(shaders_directory.substr(0, shaders_directory.find_last_of('/')).c_str());
+            }
+
+            void add_file(const std::string& name, const std::string& contents) {
+                auto path = shaders_directory + "/" + name;
+                auto directory = path.substr(0, path.find_last_of('/'));
+                make_directories(directory);
+                directories.push_back(directory);
+
+                std::ofstream file(path, std::ios::binary | std::ios::trunc);
+                file << contents;
+            }
+
+            const std::string shaders_directory;
+
+        private:
+            std::vector<std::string> directories;
+        };
+
+        TEST(shaderpack_files, finds_shaders_without_reading_them) {
+            test_shaderpack pack("nova_test_find");
+            pack.add_file("gbuffers_terrain.vert", "#version 450\n");
+            pack.add_file("gbuffers_terrain.frag", "#version 450\n");
+
+            shaderpack_files files(pack.shaders_directory);
+            auto shader_path = pack.shaders_directory + "/gbuffers_terrain";
+
+            EXPECT_EQ(*files.find_shader(shader_path, {".vsh", ".vert"}), shader_path + ".vert");
+            EXPECT_EQ(*files.find_shader(shader_path, {".fsh", ".frag"}), shader_path + ".frag");
+            EXPECT_FALSE(files.find_shader(shader_path, {".gsh"}));
+
+            EXPECT_EQ(files.get_num_files(), 2);
+            EXPECT_EQ(files.get_num_files_read(), 0);
+        }
+
+        TEST(shaderpack_files, puts_includes_in_and_reads_each_file_once) {
+            test_shaderpack pack("nova_test_includes");
+            pack.add_file("lib/common.glsl", "float common_value;\n#include \"constants.glsl\"\n");
+            pack.add_file("lib/constants.glsl", "const float PI = 3.14159;\n");
+            pack.add_file("a.frag", "#version 450\n#include \"/lib/common.glsl\"\nvoid main() {}\n");
+            pack.add_file("b.frag", "#version 450\n#include \"lib/../lib/./common.glsl\"\nvoid main() {}");
+
+            shaderpack_files files(pack.shaders_directory);
+            auto a = files.load_shader(pack.shaders_directory + "/a.frag");
+            auto b = files.load_shader(pack.shaders_directory + "/b.frag");
+
+            ASSERT_EQ(a.size(), 4);
+            EXPECT_EQ(a[0].line, "#version 450");
+            EXPECT_EQ(a[1].line, "float common_value;");
+            EXPECT_EQ(a[1].shader_name, pack.shaders_directory + "/lib/common.glsl");
+            EXPECT_EQ(a[2].line, "const float PI = 3.14159;");
+            EXPECT_EQ(a[2].line_num, 1);
+            EXPECT_EQ(a[3].line, "void main() {}");
+            EXPECT_EQ(a[3].line_num, 3);
+
+            // b.frag doesn't end with a newline, but its last line is still there
+            EXPECT_EQ(b[3].line, "void main() {}");
+
+            // The same included lines, even though b.frag spells the path differently
+            ASSERT_EQ(b.size(), a.size());
+            for(size_t i = 1; i < 3; i++) {
+                EXPECT_EQ(b[i].line, a[i].line);
+                EXPECT_EQ(b[i].shader_name, a[i].shader_name);
+            }
+
+            EXPECT_EQ(files.get_num_files_read(), 4);
+        }
+
+        TEST(shaderpack_files, leaves_windows_line_endings_out) {
+            test_shaderpack pack("nova_test_crlf");
+            pack.add_file("lib.glsl", "float value;\r\n");
+            pack.add_file("crlf.frag", "#version 450\r\n#include \"lib.glsl\"\r\nvoid main() {}\r\n");
+
+            shaderpack_files files(pack.shaders_directory);
+            auto shader = files.load_shader(pack.shaders_directory + "/crlf.frag");
+
+            ASSERT_EQ(shader.size(), 3);
+            EXPECT_EQ(shader[0].line, "#version 450");
+            EXPECT_EQ(shader[1].line, "float value;");
+            EXPECT_EQ(shader[2].line, "void main() {}");
+        }
+
+        TEST(shaderpack_files, catches_files_that_include_themselves) {
+            test_shaderpack pack("nova_test_loop");
+            pack.add_file("a.glsl", "#include \"b.glsl\"\n");
+            pack.add_file("b.glsl", "#include \"a.glsl\"\n");
+            pack.add_file("loop.frag", "#version 450\n#include \"a.glsl\"\n");
+
+            shaderpack_files files(pack.shaders_directory);
+            EXPECT_THROW(files.load_shader(pack.shaders_directory + "/loop.frag"), std::runtime_error);
+        }
+
+        TEST(shaderpack_files, missing_includes_are_errors) {
+            test_shaderpack pack("nova_test_missing");
+            pack.add_file("missing.frag", "#version 450\n#include \"not_here.glsl\"\n");
+
+            shaderpack_files files(pack.shaders_directory);
+            EXPECT_THROW(files.load_shader(pack.shaders_directory + "/missing.frag"), std::runtime_error);
+            EXPECT_THROW(files.load_shader(pack.shaders_directory + "/not_a_shader.frag"), resource_not_found);
+        }
+
+        TEST(shaderpack_files, normalizes_paths) {
+            EXPECT_EQ(normalize_path("shaderpacks/pack/shaders/lib/../common.glsl"), "shaderpacks/pack/shaders/common.glsl");
+            EXPECT_EQ(normalize_path("shaderpacks//pack/./shaders/"), "shaderpacks/pack/shaders");
+            EXPECT_EQ(normalize_path("../outside.glsl"), "../outside.glsl");
+            EXPECT_EQ(normalize_path("/absolute/path"), "/absolute/path");
+        }
+
+        /*!
+         * \brief Writes a pack shaped like the big packs people actually use: a lot of programs that all include the
+         * same few dozen library files, which include each other
+         */
+        void write_large_pack(test_shaderpack& pack, size_t num_programs, size_t num_library_files, size_t lines_per_file) {
+            for(size_t library_file = 0; library_file < num_library_files; library_file++) {
+                std::string contents;
+                if(library_file > 0) {
+                    contents += "#include \"lib" + std::to_string(library_file - 1) + ".glsl\"\n";
+                }
+                for(size_t line = 0; line < lines_per_file; line++) {
+                    contents += "float lib" + std::to_string(library_file) + "_function" + std::to_string(line) + "(vec3 position) { return dot(position, vec3(0.299, 0.587, 0.114)); }\n";
+                }
+                pack.add_file("lib/lib" + std::to_string(library_file) + ".glsl", contents);
+            }
+
+            std::string program_contents = "#version 450\n";
+            for(size_t library_file = 3; library_file < num_library_files; library_file += 4) {
+                program_contents += "#include \"lib/lib" + std::to_string(library_file) + ".glsl\"\n";
+            }
+            for(size_t line = 0; line < lines_per_file; line++) {
+                program_contents += "    color.rgb += vec3(0.01) * float(" + std::to_string(line) + ");\n";
+            }
+
+            for(size_t program = 0; program < num_programs; program++) {
+                pack.add_file("program" + std::to_string(program) + ".vert", program_contents);
+                pack.add_file("program" + std::to_string(program) + ".frag", program_contents);
+            }
+        }
+
+        TEST(shaderpack_files, benchmark_large_pack) {
+            const size_t num_programs = 100;
+            test_shaderpack pack("nova_benchmark_pack");
+            write_large_pack(pack, num_programs, 24, 100);
+
+            // The old way: every stage on its own, probing each extension and reading every include again
+            auto sequential_start = std::chrono::high_resolution_clock::now();
+            size_t sequential_lines = 0;
+            for(size_t program = 0; program < num_programs; program++) {
+                auto shader_path = pack.shaders_directory + "/program" + std::to_string(program);
+                sequential_lines += load_shader_file(shader_path, {".vsh", ".vert", ".vert.spv"}).size();
+                sequential_lines += load_shader_file(shader_path, {".fsh", ".frag", ".frag.spv"}).size();
+            }
+            auto sequential_end = std::chrono::high_resolution_clock::now();
+
+            // The new way: list the pack once, read each file once, and load the stages in parallel
+            job_system jobs;
+            auto parallel_start = std::chrono::high_resolution_clock::now();
+            shaderpack_files files(pack.shaders_directory);
+            std::vector<size_t> stage_lines(num_programs * 2);
+            jobs.parallel_for(stage_lines.size(), 1, [&](size_t first_stage, size_t last_stage) {
+                for(size_t stage = first_stage; stage < last_stage; stage++) {
+                    auto shader_path = pack.shaders_directory + "/program" + std::to_string(stage / 2);
+                    auto stage_path = stage % 2 == 0 ? files.find_shader(shader_path, {".vsh", ".vert", ".vert.spv"})
+                                                     : files.find_shader(shader_path, {".fsh", ".frag", ".frag.spv"});
+                    stage_lines[stage] = files.load_shader(*stage_path).size();
+                }
+            });
+            auto parallel_end = std::chrono::high_resolution_clock::now();
+
+            size_t parallel_lines = 0;
+            for(auto lines : stage_lines) {
+                parallel_lines += lines;
+            }
+            EXPECT_EQ(parallel_lines, sequential_lines);
+            EXPECT_EQ(files.get_num_files_read(), files.get_num_files());
+
+            auto sequential_ms = std::chrono::duration<double, std::milli>(sequential_end - sequential_start).count();
+            auto parallel_ms = std::chrono::duration<double, std::milli>(parallel_end - parallel_start).count();
+            std::cout << "Loaded " << num_programs * 2 << " stages (" << parallel_lines << " lines) in " << sequential_ms
+                      << "ms one at a time, " << parallel_ms << "ms with " << jobs.get_num_threads()
+                      << " worker threads and each file read once" << std::endl;
+        }
+    }
+}
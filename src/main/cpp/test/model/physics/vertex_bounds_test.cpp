@@ -0,0 +1,61 @@
+/*!
+ * \brief Tests the functions that compute bounding volumes from vertex data
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../../data_loading/physics/vertex_bounds.h"
+
+namespace nova {
+    namespace test {
+        TEST(vertex_bounds, no_vertices_gives_empty_bounds) {
+            auto bounds = nova::compute_vertex_bounds(nullptr, 0, 7);
+
+            EXPECT_EQ(bounds.bounding_box.extents.x, 0);
+            EXPECT_EQ(bounds.bounding_box.extents.y, 0);
+            EXPECT_EQ(bounds.bounding_box.extents.z, 0);
+            EXPECT_EQ(bounds.bounding_sphere.radius, 0);
+        }
+
+        TEST(vertex_bounds, interleaved_vertices) {
+            // Three floats of position followed by four floats of other data, which should be ignored even if it's
+            // bigger than all the positions
+            std::vector<float> vertices = {
+                    1, 2, 3,    100, 100, 100, 100,
+                    5, 2, 1,    -100, -100, -100, -100,
+                    3, 6, 3,    100, 100, 100, 100,
+            };
+
+            auto bounds = nova::compute_vertex_bounds(vertices.data(), 3, 7);
+
+            EXPECT_FLOAT_EQ(bounds.bounding_box.center.x, 3);
+            EXPECT_FLOAT_EQ(bounds.bounding_box.center.y, 4);
+            EXPECT_FLOAT_EQ(bounds.bounding_box.center.z, 2);
+
+            EXPECT_FLOAT_EQ(bounds.bounding_box.extents.x, 2);
+            EXPECT_FLOAT_EQ(bounds.bounding_box.extents.y, 2);
+            EXPECT_FLOAT_EQ(bounds.bounding_box.extents.z, 1);
+
+            // (1, 2, 3) and (5, 2, 1) are the farthest from the center, at sqrt(4 + 4 + 1)
+            EXPECT_FLOAT_EQ(bounds.bounding_sphere.radius, 3);
+        }
+
+        TEST(vertex_bounds, tightly_packed_positions) {
+            // The last vertex ends at the very end of the buffer, so nothing past it may be read
+            std::vector<float> vertices = {
+                    0, 0, 0,
+                    16, 1, 16,
+            };
+
+            auto bounds = nova::compute_vertex_bounds(vertices.data(), 2, 3);
+
+            EXPECT_FLOAT_EQ(bounds.bounding_box.center.y, 0.5f);
+            EXPECT_FLOAT_EQ(bounds.bounding_box.extents.x, 8);
+            EXPECT_FLOAT_EQ(bounds.bounding_box.extents.y, 0.5f);
+            EXPECT_FLOAT_EQ(bounds.bounding_box.extents.z, 8);
+        }
+    }
+}
@@ -0,0 +1,120 @@
+/*!
+ * \brief Tests for the typed settings and their subscriptions
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <thread>
+#include <gtest/gtest.h>
+#include "../../data_loading/settings.h"
+
+namespace nova {
+    namespace test {
+        TEST(settings, starts_with_defaults_when_there_is_no_config_file) {
+            settings config("this_config_does_not_exist.json");
+
+            EXPECT_EQ(config.get<setting::view_width>(), 854);
+            EXPECT_EQ(config.get<setting::loaded_shaderpack>(), "default");
+            EXPECT_FLOAT_EQ(config.get<setting::scalefactor>(), 4.0f);
+        }
+
+        TEST(settings, only_tells_subscribers_about_real_changes) {
+            settings config("this_config_does_not_exist.json");
+
+            int num_width_changes = 0;
+            int last_width = 0;
+            config.subscribe<setting::view_width>([&](const int& width) {
+                num_width_changes++;
+                last_width = width;
+            });
+
+            int num_shaderpack_changes = 0;
+            config.subscribe({setting::loaded_shaderpack}, [&]() { num_shaderpack_changes++; });
+
+            config.set<setting::view_width>(1920);
+            config.set<setting::view_width>(1920);
+            EXPECT_EQ(num_width_changes, 1);
+            EXPECT_EQ(last_width, 1920);
+            EXPECT_EQ(num_shaderpack_changes, 0);
+
+            // By name, the way Minecraft sets them
+            config.set("viewWidth", 1280.0f);
+            EXPECT_EQ(num_width_changes, 2);
+            EXPECT_EQ(config.get<setting::view_width>(), 1280);
+            EXPECT_EQ(config.get_options()["settings"]["viewWidth"], 1280);
+        }
+
+        TEST(settings, transactions_notify_once) {
+            settings config("this_config_does_not_exist.json");
+
+            int num_notifications = 0;
+            auto id = config.subscribe({setting::view_width, setting::view_height}, [&]() { num_notifications++; });
+
+            config.begin_transaction();
+            config.set<setting::view_width>(100);
+            config.set<setting::view_height>(200);
+            config.begin_transaction();
+            config.set<setting::view_height>(300);
+            config.commit_transaction();
+            EXPECT_EQ(num_notifications, 0);
+            config.commit_transaction();
+            EXPECT_EQ(num_notifications, 1);
+
+            config.unsubscribe(id);
+            config.set<setting::view_width>(400);
+            EXPECT_EQ(num_notifications, 1);
+        }
+
+        TEST(settings, keeps_unknown_and_invalid_settings_out_of_the_typed_settings) {
+            settings config("this_config_does_not_exist.json");
+
+            config.set("someShaderpackOption", 3.5f);
+            EXPECT_EQ(config.get_options()["settings"]["someShaderpackOption"], 3.5f);
+
+            config.set("viewWidth", "very wide");
+            EXPECT_EQ(config.get<setting::view_width>(), 854);
+        }
+    
+        TEST(settings, snapshot_only_shows_committed_transactions) {
+            settings config("this_config_does_not_exist.json");
+            EXPECT_EQ(config.get_snapshot().view_width, 854);
+
+            config.begin_transaction();
+            config.set<setting::view_width>(1920);
+            EXPECT_EQ(config.get_snapshot().view_width, 854);
+            config.set<setting::view_height>(1080);
+            config.commit_transaction();
+
+            const auto& snapshot = config.get_snapshot();
+            EXPECT_EQ(snapshot.view_width, 1920);
+            EXPECT_EQ(snapshot.view_height, 1080);
+        }
+
+        TEST(settings, snapshot_is_never_torn) {
+            settings config("this_config_does_not_exist.json");
+
+            std::thread writer([&]() {
+                for(int i = 1; i <= 20000; i++) {
+                    config.begin_transaction();
+                    config.set<setting::view_width>(i);
+                    config.set<setting::view_height>(i * 2);
+                    config.commit_transaction();
+                }
+            });
+
+            int last_width = 0;
+            while(last_width < 20000) {
+                const auto& snapshot = config.get_snapshot();
+                if(snapshot.view_width == 854) {
+                    continue;
+                }
+                ASSERT_EQ(snapshot.view_height, snapshot.view_width * 2);
+                ASSERT_GE(snapshot.view_width, last_width);
+                last_width = snapshot.view_width;
+            }
+
+            writer.join();
+        }
+    }
+}
@@ -0,0 +1,107 @@
+/*!
+ * \brief Tests for the camera's frustum, and the guard band frustum that's widened for the visibility cache
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include "../../../render/objects/camera.h"
+
+namespace nova {
+    namespace test {
+        /*!
+         * \brief Half of the horizontal field of view of a camera, in radians
+         */
+        float get_half_fov_x(const camera& cam) {
+            return std::atan(std::tan(glm::radians(cam.fov) / 2.0f) * cam.aspect_ratio);
+        }
+
+        /*!
+         * \brief Makes a tiny sphere that's some distance outside the side plane of a frustum with the given
+         * horizontal half-angle
+         *
+         * \param half_angle The angle between the side plane and the view direction, in radians
+         * \param distance_along_plane How far away from the camera the point on the plane is
+         * \param distance_outside How far outside the plane the sphere is. Negative values are inside the plane
+         */
+        sphere make_sphere_outside_side_plane(float half_angle, float distance_along_plane, float distance_outside) {
+            glm::vec3 on_plane = glm::vec3(std::sin(half_angle), 0, std::cos(half_angle)) * distance_along_plane;
+            glm::vec3 outwards = glm::vec3(std::cos(half_angle), 0, -std::sin(half_angle));
+            return {on_plane + outwards * distance_outside, 0.01f};
+        }
+
+        TEST(camera, sees_what_is_in_front_of_it) {
+            camera cam;
+            cam.recalculate_frustum();
+
+            EXPECT_TRUE(cam.has_sphere_in_frustum({{0, 0, 20}, 0.5f}));
+            EXPECT_FALSE(cam.has_sphere_in_frustum({{0, 0, -20}, 0.5f}));
+        }
+
+        TEST(camera, guard_band_includes_what_the_camera_can_turn_towards) {
+            camera cam;
+            auto half_fov_x = get_half_fov_x(cam);
+
+            // Five degrees past the edge of the screen
+            auto beside_screen = make_sphere_outside_side_plane(half_fov_x + glm::radians(5.0f), 20, 0);
+
+            cam.recalculate_frustum();
+            EXPECT_FALSE(cam.has_sphere_in_frustum(beside_screen));
+
+            cam.recalculate_frustum(2, 10);
+            EXPECT_TRUE(cam.has_sphere_in_frustum(beside_screen));
+        }
+
+        TEST(camera, guard_band_pushes_planes_out_by_the_position_margin) {
+            camera cam;
+            cam.recalculate_frustum(2, 10);
+            auto guard_band_half_angle = get_half_fov_x(cam) + glm::radians(10.0f);
+
+            EXPECT_TRUE(cam.has_sphere_in_frustum(make_sphere_outside_side_plane(guard_band_half_angle, 30, 1.5f)));
+            EXPECT_FALSE(cam.has_sphere_in_frustum(make_sphere_outside_side_plane(guard_band_half_angle, 30, 2.5f)));
+        }
+
+        TEST(camera, guard_band_includes_the_far_corners_the_camera_can_turn_towards) {
+            camera cam;
+            auto half_fov_x = get_half_fov_x(cam);
+
+            // The far right corner of the screen after turning right by the angle margin, which is further away than
+            // the far plane was before turning
+            auto turn = glm::radians(10.0f);
+            glm::vec3 turned_forward = {std::sin(turn), 0, std::cos(turn)};
+            glm::vec3 turned_right = {std::cos(turn), 0, -std::sin(turn)};
+            auto far_corner = (turned_forward + turned_right * std::tan(half_fov_x)) * (cam.far_plane - 1);
+
+            cam.recalculate_frustum();
+            EXPECT_FALSE(cam.has_sphere_in_frustum({far_corner, 0.01f}));
+
+            cam.recalculate_frustum(2, 10);
+            EXPECT_TRUE(cam.has_sphere_in_frustum({far_corner, 0.01f}));
+        }
+
+        TEST(camera, guard_band_includes_what_is_right_in_front_of_the_camera) {
+            camera cam;
+            cam.near_plane = 1;
+            cam.recalculate_frustum(2, 10);
+
+            EXPECT_TRUE(cam.has_sphere_in_frustum({{0, 0, 0.5f}, 0.01f}));
+            EXPECT_FALSE(cam.has_sphere_in_frustum({{0, 0, -2.5f}, 0.01f}));
+        }
+
+        TEST(camera, guard_band_boxes_just_outside_are_culled) {
+            camera cam;
+            cam.recalculate_frustum(2, 10);
+            auto guard_band_half_angle = get_half_fov_x(cam) + glm::radians(10.0f);
+
+            // A block whose nearest corner is just outside the guard band
+            auto center = make_sphere_outside_side_plane(guard_band_half_angle, 30, 2.5f + std::sqrt(2.0f) * 0.5f).center;
+            aabb box = {center, {0.5f, 0.5f, 0.5f}};
+            EXPECT_FALSE(cam.has_object_in_frustum(box));
+
+            box.center = make_sphere_outside_side_plane(guard_band_half_angle, 30, 1.5f + std::sqrt(2.0f) * 0.5f).center;
+            EXPECT_TRUE(cam.has_object_in_frustum(box));
+        }
+    }
+}
@@ -0,0 +1,76 @@
+/*!
+ * \brief Tests for handing out space in each frame's slice of a ring buffer
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <gtest/gtest.h>
+#include "../../../render/objects/gl_ring_buffer.h"
+
+namespace nova {
+    namespace test {
+        TEST(frame_slice_allocator, allocations_are_aligned) {
+            frame_slice_allocator allocator(1024, 256);
+            allocator.begin_frame(0);
+
+            size_t first = 1, second = 1;
+            ASSERT_TRUE(allocator.allocate(100, first));
+            ASSERT_TRUE(allocator.allocate(300, second));
+
+            EXPECT_EQ(first, 0u);
+            EXPECT_EQ(second, 256u);
+            EXPECT_EQ(allocator.get_num_bytes_used(), 768u);
+        }
+
+        TEST(frame_slice_allocator, each_slot_gets_its_own_slice) {
+            frame_slice_allocator allocator(1000, 256);
+            EXPECT_EQ(allocator.get_slice_size(), 1024u);
+
+            for(size_t slot = 0; slot < MAX_FRAMES_IN_FLIGHT; slot++) {
+                allocator.begin_frame(slot);
+                size_t offset = 0;
+                ASSERT_TRUE(allocator.allocate(16, offset));
+                EXPECT_EQ(offset, slot * 1024u);
+            }
+        }
+
+        TEST(frame_slice_allocator, fails_when_the_slice_is_full) {
+            frame_slice_allocator allocator(512, 256);
+            allocator.begin_frame(1);
+
+            size_t offset = 0;
+            EXPECT_FALSE(allocator.allocate(513, offset));
+            ASSERT_TRUE(allocator.allocate(300, offset));
+            EXPECT_FALSE(allocator.allocate(1, offset));
+
+            // Starting the slot again frees everything in it
+            allocator.begin_frame(1);
+            ASSERT_TRUE(allocator.allocate(512, offset));
+            EXPECT_EQ(offset, 512u);
+        }
+
+        TEST(frame_slice_allocator, reserved_room_is_in_every_slice) {
+            frame_slice_allocator allocator(1024, 256);
+
+            size_t first_block = 1, second_block = 1;
+            ASSERT_TRUE(allocator.reserve(100, first_block));
+            ASSERT_TRUE(allocator.reserve(300, second_block));
+            EXPECT_EQ(first_block, 0u);
+            EXPECT_EQ(second_block, 256u);
+
+            for(size_t slot = 0; slot < MAX_FRAMES_IN_FLIGHT; slot++) {
+                allocator.begin_frame(slot);
+                EXPECT_EQ(allocator.get_slice_start(), slot * 1024u);
+
+                size_t offset = 0;
+                ASSERT_TRUE(allocator.allocate(16, offset));
+                EXPECT_EQ(offset, slot * 1024u + 768u);
+            }
+
+            // Too late to reserve anything once this frame has allocated something
+            size_t late_block = 0;
+            EXPECT_FALSE(allocator.reserve(16, late_block));
+        }
+    }
+}
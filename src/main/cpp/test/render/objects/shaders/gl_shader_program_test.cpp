@@ -28,6 +28,31 @@ namespace nova {
             nova::nova_renderer::deinit();
         }
 
+        TEST(gl_shader_program, compilation_error_finds_original_lines) {
+            nova::shader_source source;
+            auto shader_file = source.add_file("shaderpacks/default/shaders/gbuffers_basic.frag");
+            auto include_file = source.add_file("shaderpacks/default/shaders/lib/lighting.glsl");
+            source.add_line(shader_file, 1, "#version 450");
+            source.add_line(include_file, 1, "float brightness;");
+            source.add_line(include_file, 2, "vec3 light = undefined_variable;");
+            source.add_line(shader_file, 3, "void main() {}");
+
+            // Each driver writes its errors a bit differently
+            for(const std::string error_log : {"0(3) : error C1008: undefined variable \"undefined_variable\"\n",
+                                               "0:3(14): error: `undefined_variable' undeclared\n",
+                                               "ERROR: 0:3: 'undefined_variable' : undeclared identifier\n"}) {
+                nova::compilation_error error(error_log, source);
+                std::string message = error.what();
+
+                EXPECT_EQ(message.find(error_log), 0);
+                EXPECT_NE(message.find("\nshaderpacks/default/shaders/lib/lighting.glsl(2): "), std::string::npos) << message;
+                EXPECT_NE(message.find("\n    vec3 light = undefined_variable;"), std::string::npos) << message;
+            }
+
+            nova::compilation_error no_line_error("error: too many uniforms\n", source);
+            EXPECT_EQ(std::string(no_line_error.what()), "error: too many uniforms\n");
+        }
+
         nlohmann::json get_gui_def_json() {
             return {
                     {"name",     "gui"},
@@ -37,11 +62,11 @@ namespace nova {
         };
 
         void add_shader_source_to_definition(nova::shader_definition &def) {
-            auto version_line = nova::shader_line{0, "gbuffers_basic.vert", "#version 450"};
-            auto lines = std::vector<nova::shader_line>{version_line};
+            nova::shader_source source;
+            source.add_line(source.add_file("gbuffers_basic.vert"), 0, "#version 450");
 
-            def.vertex_source = lines;
-            def.fragment_source = lines;
+            def.vertex_source = source;
+            def.fragment_source = source;
         }
     }
 }
@@ -0,0 +1,110 @@
+/*!
+ * \brief Tests saving linked programs to disk and loading them back
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../../../render/objects/shaders/program_binary_cache.h"
+#include "../../../../utils/stats.h"
+
+namespace nova {
+    namespace test {
+        const std::string PROGRAM_CACHE_DIRECTORY = "test_cache/programs";
+
+        std::vector<uint8_t> make_binary(size_t size, uint8_t seed) {
+            std::vector<uint8_t> binary(size);
+            for(size_t i = 0; i < size; i++) {
+                binary[i] = static_cast<uint8_t>(seed + i * 13);
+            }
+            return binary;
+        }
+
+        std::string get_program_path(uint64_t key) {
+            std::stringstream path;
+            path << PROGRAM_CACHE_DIRECTORY << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".nvprog";
+            return path.str();
+        }
+
+        TEST(program_binary_cache, keys_depend_on_sources_and_driver) {
+            auto key = program_binary_cache::make_key({"vertex\n", "fragment\n"}, "Vendor\nRenderer\n4.5\n");
+
+            EXPECT_EQ(program_binary_cache::make_key({"vertex\n", "fragment\n"}, "Vendor\nRenderer\n4.5\n"), key);
+            EXPECT_NE(program_binary_cache::make_key({"vertex\n", "fragment2\n"}, "Vendor\nRenderer\n4.5\n"), key);
+            EXPECT_NE(program_binary_cache::make_key({"vertex\n", "fragment\n"}, "Vendor\nRenderer\n4.6\n"), key);
+
+            // Where one stage ends and the next starts matters too
+            EXPECT_NE(program_binary_cache::make_key({"vertex\nfragment\n", ""}, "Vendor\nRenderer\n4.5\n"), key);
+        }
+
+        TEST(program_binary_cache, round_trips_a_binary) {
+            program_binary_cache cache(PROGRAM_CACHE_DIRECTORY);
+            auto binary = make_binary(4000, 1);
+            uint64_t key = program_binary_cache::make_key({"round trip"}, "driver");
+
+            ASSERT_TRUE(cache.store(key, 0x8741, binary.data(), binary.size(), 120.0));
+
+            auto loaded = cache.load(key);
+            ASSERT_NE(loaded, nullptr);
+            EXPECT_EQ(loaded->format, 0x8741);
+            EXPECT_DOUBLE_EQ(loaded->compile_ms, 120.0);
+            ASSERT_EQ(loaded->binary_size, binary.size());
+            EXPECT_EQ(std::vector<uint8_t>(loaded->binary, loaded->binary + loaded->binary_size), binary);
+
+            cache.add_time_saved(100.0);
+            EXPECT_EQ(cache.get_num_hits(), 1);
+            EXPECT_DOUBLE_EQ(cache.get_ms_saved(), 100.0);
+            EXPECT_DOUBLE_EQ(stats::get("program_cache_hit_rate"), 1.0);
+            EXPECT_DOUBLE_EQ(stats::get("program_cache_ms_saved"), 100.0);
+
+            std::remove(get_program_path(key).c_str());
+        }
+
+        TEST(program_binary_cache, rejected_binaries_count_as_misses_and_are_deleted) {
+            program_binary_cache cache(PROGRAM_CACHE_DIRECTORY);
+            auto binary = make_binary(256, 2);
+            uint64_t key = program_binary_cache::make_key({"rejected"}, "driver");
+            ASSERT_TRUE(cache.store(key, 1, binary.data(), binary.size(), 10.0));
+
+            ASSERT_NE(cache.load(key), nullptr);
+            cache.reject(key);
+
+            EXPECT_EQ(cache.get_num_hits(), 0);
+            EXPECT_EQ(cache.get_num_misses(), 1);
+            EXPECT_DOUBLE_EQ(stats::get("program_cache_hit_rate"), 0.0);
+
+            EXPECT_EQ(cache.load(key), nullptr);
+            EXPECT_EQ(cache.get_num_misses(), 2);
+        }
+
+        TEST(program_binary_cache, ignores_damaged_files) {
+            program_binary_cache cache(PROGRAM_CACHE_DIRECTORY);
+            auto binary = make_binary(1024, 3);
+            uint64_t key = program_binary_cache::make_key({"damaged"}, "driver");
+            ASSERT_TRUE(cache.store(key, 1, binary.data(), binary.size(), 10.0));
+
+            // Flip a byte in the middle of the binary
+            auto path = get_program_path(key);
+            std::vector<char> contents;
+            {
+                std::ifstream file(path, std::ios::binary);
+                contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            }
+            contents[contents.size() - 512] ^= 0xFF;
+            {
+                std::ofstream file(path, std::ios::binary | std::ios::trunc);
+                file.write(contents.data(), contents.size());
+            }
+
+            EXPECT_EQ(cache.load(key), nullptr);
+            EXPECT_EQ(cache.get_num_misses(), 1);
+            std::remove(path.c_str());
+        }
+    }
+}
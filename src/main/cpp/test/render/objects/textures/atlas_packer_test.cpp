@@ -0,0 +1,214 @@
+/*!
+ * \brief Tests packing sprites into atlases
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../../../render/objects/textures/atlas_packer.h"
+
+namespace nova {
+    namespace test {
+        /*!
+         * \brief Makes a sprite where every pixel holds the sprite's ID, so it's easy to tell where pixels came from
+         */
+        atlas_sprite make_sprite(uint32_t id, const glm::ivec2& size) {
+            atlas_sprite sprite;
+            sprite.name = "sprite_" + std::to_string(id);
+            sprite.size = size;
+            for(int i = 0; i < size.x * size.y; i++) {
+                sprite.rgba_pixels.insert(sprite.rgba_pixels.end(), {
+                        static_cast<uint8_t>(id & 0xFF),
+                        static_cast<uint8_t>((id >> 8) & 0xFF),
+                        static_cast<uint8_t>(i & 0xFF),
+                        255
+                });
+            }
+            return sprite;
+        }
+
+        /*!
+         * \brief Something like a big resource pack: mostly 16x16 blocks, some higher resolution textures, and some
+         * tall animation strips
+         */
+        std::vector<atlas_sprite> make_resource_pack(size_t num_sprites) {
+            std::vector<atlas_sprite> sprites;
+            for(uint32_t i = 0; i < num_sprites; i++) {
+                glm::ivec2 size = {16, 16};
+                if(i % 60 == 0) {
+                    size = {16, 256};
+                } else if(i % 20 == 0) {
+                    size = {64, 64};
+                } else if(i % 5 == 0) {
+                    size = {32, 32};
+                }
+                sprites.push_back(make_sprite(i, size));
+            }
+            return sprites;
+        }
+
+        /*!
+         * \brief Checks that no two sprites overlap, every sprite is inside its atlas, and every sprite's pixels made
+         * it into the atlas
+         */
+        void check_pages(const std::vector<atlas_page>& pages, const std::vector<atlas_sprite>& sprites) {
+            size_t num_placed = 0;
+            for(const auto& page : pages) {
+                std::vector<bool> covered(static_cast<size_t>(page.size.x) * page.size.y, false);
+                for(const auto& sprite : sprites) {
+                    auto placement_itr = page.placements.find(sprite.name);
+                    if(placement_itr == page.placements.end()) {
+                        continue;
+                    }
+                    num_placed++;
+
+                    const auto& placement = placement_itr->second;
+                    ASSERT_EQ(placement.size, sprite.size);
+                    ASSERT_GE(placement.position.x, 0);
+                    ASSERT_GE(placement.position.y, 0);
+                    ASSERT_LE(placement.position.x + placement.size.x, page.size.x);
+                    ASSERT_LE(placement.position.y + placement.size.y, page.size.y);
+
+                    for(int y = 0; y < sprite.size.y; y++) {
+                        for(int x = 0; x < sprite.size.x; x++) {
+                            size_t atlas_pixel = static_cast<size_t>(placement.position.y + y) * page.size.x + placement.position.x + x;
+                            ASSERT_FALSE(covered[atlas_pixel]) << sprite.name << " overlaps another sprite";
+                            covered[atlas_pixel] = true;
+
+                            size_t sprite_pixel = static_cast<size_t>(y) * sprite.size.x + x;
+                            ASSERT_EQ(page.rgba_pixels[atlas_pixel * 4 + 0], sprite.rgba_pixels[sprite_pixel * 4 + 0]);
+                            ASSERT_EQ(page.rgba_pixels[atlas_pixel * 4 + 1], sprite.rgba_pixels[sprite_pixel * 4 + 1]);
+                            ASSERT_EQ(page.rgba_pixels[atlas_pixel * 4 + 2], sprite.rgba_pixels[sprite_pixel * 4 + 2]);
+                        }
+                    }
+                }
+            }
+            EXPECT_EQ(num_placed, sprites.size());
+        }
+
+        TEST(atlas_packer, packs_everything_into_one_atlas) {
+            auto sprites = make_resource_pack(200);
+            auto pages = pack_sprites(sprites, 4096);
+
+            ASSERT_EQ(pages.size(), 1);
+            check_pages(pages, sprites);
+
+            // Atlases are powers of two
+            EXPECT_EQ(pages[0].size.x & (pages[0].size.x - 1), 0);
+            EXPECT_EQ(pages[0].size.y & (pages[0].size.y - 1), 0);
+        }
+
+        TEST(atlas_packer, same_size_sprites_fill_the_atlas) {
+            std::vector<atlas_sprite> sprites;
+            for(uint32_t i = 0; i < 64; i++) {
+                sprites.push_back(make_sprite(i, {16, 16}));
+            }
+
+            auto pages = pack_sprites(sprites, 4096);
+            ASSERT_EQ(pages.size(), 1);
+            EXPECT_EQ(pages[0].size, glm::ivec2(128, 128));
+            EXPECT_FLOAT_EQ(pages[0].efficiency, 1.0f);
+        }
+
+        TEST(atlas_packer, sprites_stay_on_the_smallest_sprite_grid) {
+            auto sprites = make_resource_pack(500);
+            auto pages = pack_sprites(sprites, 4096);
+
+            for(const auto& page : pages) {
+                for(const auto& entry : page.placements) {
+                    EXPECT_EQ(entry.second.position.x % 16, 0);
+                    EXPECT_EQ(entry.second.position.y % 16, 0);
+                }
+            }
+        }
+
+        TEST(atlas_packer, overflows_into_more_atlases) {
+            std::vector<atlas_sprite> sprites;
+            for(uint32_t i = 0; i < 40; i++) {
+                sprites.push_back(make_sprite(i, {16, 16}));
+            }
+
+            // Each 64x64 atlas only holds 16 sprites
+            auto pages = pack_sprites(sprites, 64);
+            ASSERT_EQ(pages.size(), 3);
+            check_pages(pages, sprites);
+        }
+
+        TEST(atlas_packer, skips_sprites_that_are_too_big) {
+            std::vector<atlas_sprite> sprites = {make_sprite(0, {16, 16}), make_sprite(1, {128, 16})};
+            auto pages = pack_sprites(sprites, 64);
+
+            ASSERT_EQ(pages.size(), 1);
+            EXPECT_EQ(pages[0].placements.size(), 1);
+            EXPECT_NE(pages[0].placements.find("sprite_0"), pages[0].placements.end());
+        }
+
+        TEST(atlas_packer, keeps_the_first_sprite_with_each_name) {
+            auto first = make_sprite(0, {16, 16});
+            auto duplicate = make_sprite(1, {32, 32});
+            duplicate.name = first.name;
+
+            auto pages = pack_sprites({first, duplicate}, 64);
+            ASSERT_EQ(pages.size(), 1);
+            ASSERT_EQ(pages[0].placements.size(), 1);
+            EXPECT_EQ(pages[0].placements.at(first.name).size, glm::ivec2(16, 16));
+        }
+
+        TEST(atlas_packer, saved_layouts_load_the_same) {
+            auto sprites = make_resource_pack(200);
+            auto pages = pack_sprites(sprites, 256);
+            ASSERT_GT(pages.size(), 1);
+
+            auto saved = save_atlas_layout(pages);
+            std::vector<atlas_page> loaded;
+            ASSERT_TRUE(load_atlas_layout(saved.data(), saved.size(), loaded));
+            ASSERT_EQ(loaded.size(), pages.size());
+            for(size_t i = 0; i < pages.size(); i++) {
+                EXPECT_EQ(loaded[i].size, pages[i].size);
+                EXPECT_FLOAT_EQ(loaded[i].efficiency, pages[i].efficiency);
+                ASSERT_EQ(loaded[i].placements.size(), pages[i].placements.size());
+                for(const auto& placement : pages[i].placements) {
+                    const auto& loaded_placement = loaded[i].placements.at(placement.first);
+                    EXPECT_EQ(loaded_placement.position, placement.second.position);
+                    EXPECT_EQ(loaded_placement.size, placement.second.size);
+                }
+            }
+
+            // A truncated layout isn't mistaken for a smaller one
+            EXPECT_FALSE(load_atlas_layout(saved.data(), saved.size() - 1, loaded));
+        }
+
+        TEST(atlas_packer, job_system_gives_the_same_result) {
+            auto sprites = make_resource_pack(300);
+            job_system jobs(3);
+
+            auto single_threaded = pack_sprites(sprites, 4096);
+            auto multi_threaded = pack_sprites(sprites, 4096, &jobs);
+            ASSERT_EQ(single_threaded.size(), multi_threaded.size());
+            for(size_t i = 0; i < single_threaded.size(); i++) {
+                EXPECT_EQ(single_threaded[i].rgba_pixels, multi_threaded[i].rgba_pixels);
+            }
+        }
+
+        TEST(atlas_packer, benchmark_3000_sprites) {
+            auto sprites = make_resource_pack(3000);
+            job_system jobs;
+
+            auto start_time = std::chrono::high_resolution_clock::now();
+            auto pages = pack_sprites(sprites, 4096, &jobs);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+            ASSERT_EQ(pages.size(), 1);
+            std::cout << "Packed " << sprites.size() << " sprites into a " << pages[0].size.x << "x" << pages[0].size.y
+                      << " atlas in " << duration.count() << "us, " << pages[0].efficiency * 100 << "% of the atlas is used" << std::endl;
+
+            EXPECT_GT(pages[0].efficiency, 0.5f);
+            check_pages(pages, sprites);
+        }
+    }
+}
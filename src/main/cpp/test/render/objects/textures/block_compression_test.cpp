@@ -0,0 +1,160 @@
+/*!
+ * \brief Tests encoding images into block-compressed formats
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../../../render/objects/textures/block_compression.h"
+
+namespace nova {
+    namespace test {
+        std::vector<uint8_t> make_gradient_image(const glm::ivec2& size) {
+            std::vector<uint8_t> pixels;
+            for(int y = 0; y < size.y; y++) {
+                for(int x = 0; x < size.x; x++) {
+                    pixels.push_back(static_cast<uint8_t>(x * 255 / (size.x - 1)));
+                    pixels.push_back(static_cast<uint8_t>(y * 255 / (size.y - 1)));
+                    pixels.push_back(static_cast<uint8_t>(128 + (x - y) * 2));
+                    pixels.push_back(255);
+                }
+            }
+            return pixels;
+        }
+
+        /*!
+         * \brief The root mean square difference between two images, over every channel
+         */
+        double rms_error(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+            double total = 0;
+            for(size_t i = 0; i < a.size(); i++) {
+                double difference = double(a[i]) - double(b[i]);
+                total += difference * difference;
+            }
+            return std::sqrt(total / a.size());
+        }
+
+        TEST(block_compression, compressed_sizes) {
+            EXPECT_EQ(get_compressed_size({16, 16}, block_format::bc1), 16 * 8);
+            EXPECT_EQ(get_compressed_size({16, 16}, block_format::bc3), 16 * 16);
+            EXPECT_EQ(get_compressed_size({16, 16}, block_format::bc7), 16 * 16);
+
+            // Partial blocks round up
+            EXPECT_EQ(get_compressed_size({5, 1}, block_format::bc1), 2 * 8);
+        }
+
+        TEST(block_compression, solid_color_round_trips) {
+            glm::ivec2 size = {8, 8};
+            std::vector<uint8_t> pixels;
+            for(int i = 0; i < size.x * size.y; i++) {
+                pixels.insert(pixels.end(), {200, 100, 50, 255});
+            }
+
+            for(auto format : block_format::all_values()) {
+                for(auto quality : compression_quality::all_values()) {
+                    auto compressed = compress_image(pixels.data(), size, format, quality);
+                    auto decompressed = decompress_image(compressed);
+                    ASSERT_EQ(decompressed.size(), pixels.size());
+
+                    // RGB565 can't store most colors exactly, but it gets within a few steps
+                    for(size_t i = 0; i < pixels.size(); i++) {
+                        EXPECT_NEAR(decompressed[i], pixels[i], 4) << "format " << block_format::to_string(format) << " quality " << compression_quality::to_string(quality);
+                    }
+                }
+            }
+        }
+
+        TEST(block_compression, gradients_stay_close) {
+            glm::ivec2 size = {32, 32};
+            auto pixels = make_gradient_image(size);
+
+            for(auto format : block_format::all_values()) {
+                for(auto quality : compression_quality::all_values()) {
+                    auto decompressed = decompress_image(compress_image(pixels.data(), size, format, quality));
+                    EXPECT_LT(rms_error(pixels, decompressed), 6.0) << "format " << block_format::to_string(format) << " quality " << compression_quality::to_string(quality);
+                }
+            }
+        }
+
+        TEST(block_compression, higher_quality_is_not_worse) {
+            glm::ivec2 size = {32, 32};
+            auto pixels = make_gradient_image(size);
+
+            for(auto format : block_format::all_values()) {
+                auto fast = decompress_image(compress_image(pixels.data(), size, format, compression_quality::fast));
+                auto high = decompress_image(compress_image(pixels.data(), size, format, compression_quality::high));
+                EXPECT_LE(rms_error(pixels, high), rms_error(pixels, fast)) << "format " << block_format::to_string(format);
+            }
+        }
+
+        TEST(block_compression, bc7_beats_bc1) {
+            glm::ivec2 size = {32, 32};
+            auto pixels = make_gradient_image(size);
+
+            auto bc1 = decompress_image(compress_image(pixels.data(), size, block_format::bc1, compression_quality::normal));
+            auto bc7 = decompress_image(compress_image(pixels.data(), size, block_format::bc7, compression_quality::normal));
+            EXPECT_LT(rms_error(pixels, bc7), rms_error(pixels, bc1));
+        }
+
+        TEST(block_compression, bc1_keeps_cutouts) {
+            // A checkerboard of opaque green and fully transparent pixels, like a leaves texture
+            glm::ivec2 size = {4, 4};
+            std::vector<uint8_t> pixels;
+            for(int y = 0; y < size.y; y++) {
+                for(int x = 0; x < size.x; x++) {
+                    uint8_t alpha = (x + y) % 2 == 0 ? uint8_t(255) : uint8_t(0);
+                    pixels.insert(pixels.end(), {40, 160, 40, alpha});
+                }
+            }
+
+            auto decompressed = decompress_image(compress_image(pixels.data(), size, block_format::bc1, compression_quality::normal));
+            for(size_t i = 0; i < pixels.size(); i += 4) {
+                EXPECT_EQ(decompressed[i + 3], pixels[i + 3]);
+                if(pixels[i + 3] == 255) {
+                    EXPECT_NEAR(decompressed[i + 1], pixels[i + 1], 4);
+                }
+            }
+        }
+
+        TEST(block_compression, bc3_keeps_smooth_alpha) {
+            glm::ivec2 size = {4, 4};
+            std::vector<uint8_t> pixels;
+            for(int i = 0; i < 16; i++) {
+                pixels.insert(pixels.end(), {255, 255, 255, static_cast<uint8_t>(i * 17)});
+            }
+
+            // Eight alphas spread over the whole range are 36 apart, so nothing should be more than half that off
+            auto decompressed = decompress_image(compress_image(pixels.data(), size, block_format::bc3, compression_quality::normal));
+            for(size_t i = 3; i < pixels.size(); i += 4) {
+                EXPECT_NEAR(decompressed[i], pixels[i], 18);
+            }
+        }
+
+        TEST(block_compression, odd_sizes_are_padded) {
+            glm::ivec2 size = {34, 33};
+            auto pixels = make_gradient_image(size);
+
+            auto compressed = compress_image(pixels.data(), size, block_format::bc7, compression_quality::normal);
+            EXPECT_EQ(compressed.blocks.size(), 9 * 9 * 16);
+
+            auto decompressed = decompress_image(compressed);
+            ASSERT_EQ(decompressed.size(), pixels.size());
+            EXPECT_LT(rms_error(pixels, decompressed), 6.0);
+        }
+
+        TEST(block_compression, job_system_gives_the_same_result) {
+            glm::ivec2 size = {64, 64};
+            auto pixels = make_gradient_image(size);
+            job_system jobs(3);
+
+            for(auto format : block_format::all_values()) {
+                auto single_threaded = compress_image(pixels.data(), size, format, compression_quality::high);
+                auto multi_threaded = compress_image(pixels.data(), size, format, compression_quality::high, &jobs);
+                EXPECT_EQ(single_threaded.blocks, multi_threaded.blocks);
+            }
+        }
+    }
+}
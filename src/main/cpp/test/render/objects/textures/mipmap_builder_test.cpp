@@ -0,0 +1,188 @@
+/*!
+ * \brief Tests building mip chains from image data
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../../../render/objects/textures/mipmap_builder.h"
+
+namespace nova {
+    namespace test {
+        std::vector<uint8_t> make_solid_image(const glm::ivec2& size, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+            std::vector<uint8_t> pixels;
+            for(int i = 0; i < size.x * size.y; i++) {
+                pixels.insert(pixels.end(), {r, g, b, a});
+            }
+            return pixels;
+        }
+
+        const uint8_t* get_pixel(const mip_level& level, int x, int y) {
+            return &level.pixels[(y * level.size.x + x) * 4];
+        }
+
+        TEST(mipmap_builder, level_count) {
+            mipmap_options options;
+            EXPECT_EQ(count_mip_levels({256, 64}, options), 9);
+            EXPECT_EQ(count_mip_levels({1, 1}, options), 1);
+
+            options.tile_size = {16, 16};
+            EXPECT_EQ(count_mip_levels({256, 64}, options), 5);
+
+            options.max_levels = 3;
+            EXPECT_EQ(count_mip_levels({256, 64}, options), 3);
+        }
+
+        TEST(mipmap_builder, level_sizes) {
+            mipmap_options options;
+            auto image = make_solid_image({8, 2}, 10, 20, 30, 255);
+
+            auto levels = build_mipmaps(image.data(), {8, 2}, options);
+
+            ASSERT_EQ(levels.size(), 3);
+            EXPECT_EQ(levels[0].size.x, 4);
+            EXPECT_EQ(levels[0].size.y, 1);
+            EXPECT_EQ(levels[2].size.x, 1);
+            EXPECT_EQ(levels[2].size.y, 1);
+        }
+
+        TEST(mipmap_builder, solid_color_stays_the_same) {
+            for(auto filter : {mipmap_filter::box, mipmap_filter::kaiser}) {
+                mipmap_options options;
+                options.filter = filter;
+                auto image = make_solid_image({16, 16}, 200, 100, 50, 255);
+
+                auto levels = build_mipmaps(image.data(), {16, 16}, options);
+
+                for(const auto& level : levels) {
+                    const uint8_t* pixel = get_pixel(level, 0, 0);
+                    EXPECT_EQ(pixel[0], 200);
+                    EXPECT_EQ(pixel[1], 100);
+                    EXPECT_EQ(pixel[2], 50);
+                    EXPECT_EQ(pixel[3], 255);
+                }
+            }
+        }
+
+        TEST(mipmap_builder, averages_in_linear_space) {
+            // A checkerboard of black and white should average to middle grey in linear space, which is 188 in sRGB
+            // rather than the 128 that you get from averaging the bytes
+            std::vector<uint8_t> image = {
+                    0, 0, 0, 255,         255, 255, 255, 255,
+                    255, 255, 255, 255,   0, 0, 0, 255,
+            };
+            mipmap_options options;
+            options.filter = mipmap_filter::box;
+
+            auto levels = build_mipmaps(image.data(), {2, 2}, options);
+            EXPECT_NEAR(get_pixel(levels[0], 0, 0)[0], 188, 1);
+
+            options.gamma_correct = false;
+            levels = build_mipmaps(image.data(), {2, 2}, options);
+            EXPECT_NEAR(get_pixel(levels[0], 0, 0)[0], 128, 1);
+        }
+
+        TEST(mipmap_builder, tiles_dont_bleed) {
+            // Two 4x4 tiles side by side, one red and one blue
+            glm::ivec2 size = {8, 4};
+            std::vector<uint8_t> image;
+            for(int y = 0; y < size.y; y++) {
+                for(int x = 0; x < size.x; x++) {
+                    if(x < 4) {
+                        image.insert(image.end(), {255, 0, 0, 255});
+                    } else {
+                        image.insert(image.end(), {0, 0, 255, 255});
+                    }
+                }
+            }
+
+            mipmap_options options;
+            options.tile_size = {4, 4};
+
+            auto levels = build_mipmaps(image.data(), size, options, nullptr);
+
+            ASSERT_EQ(levels.size(), 2);
+            for(const auto& level : levels) {
+                const uint8_t* left = get_pixel(level, level.size.x / 2 - 1, 0);
+                const uint8_t* right = get_pixel(level, level.size.x / 2, 0);
+                EXPECT_EQ(left[0], 255);
+                EXPECT_EQ(left[2], 0);
+                EXPECT_EQ(right[0], 0);
+                EXPECT_EQ(right[2], 255);
+            }
+        }
+
+        TEST(mipmap_builder, transparent_pixels_dont_darken_color) {
+            // Half the pixels are transparent black. Their color shouldn't leak into the opaque white
+            std::vector<uint8_t> image = {
+                    255, 255, 255, 255,   0, 0, 0, 0,
+                    0, 0, 0, 0,           255, 255, 255, 255,
+            };
+            mipmap_options options;
+            options.filter = mipmap_filter::box;
+            options.preserve_alpha_coverage = false;
+
+            auto levels = build_mipmaps(image.data(), {2, 2}, options);
+
+            EXPECT_EQ(get_pixel(levels[0], 0, 0)[0], 255);
+            EXPECT_NEAR(get_pixel(levels[0], 0, 0)[3], 128, 1);
+        }
+
+        TEST(mipmap_builder, alpha_coverage_is_preserved) {
+            // A 16x16 cutout tile where a quarter of the pixels are opaque, in a sparse pattern that averages out to
+            // an alpha well below the cutoff
+            glm::ivec2 size = {16, 16};
+            std::vector<uint8_t> image;
+            for(int y = 0; y < size.y; y++) {
+                for(int x = 0; x < size.x; x++) {
+                    uint8_t alpha = (x % 2 == 0 && y % 2 == 0) ? 255 : 0;
+                    image.insert(image.end(), {0, 255, 0, alpha});
+                }
+            }
+
+            for(bool preserve_coverage : {false, true}) {
+                mipmap_options options;
+                options.filter = mipmap_filter::box;
+                options.preserve_alpha_coverage = preserve_coverage;
+                options.max_levels = 3;
+
+                auto levels = build_mipmaps(image.data(), size, options);
+
+                const auto& level = levels[1];
+                size_t num_passing = 0;
+                for(int i = 0; i < level.size.x * level.size.y; i++) {
+                    num_passing += level.pixels[i * 4 + 3] >= 128 ? 1 : 0;
+                }
+                float coverage = num_passing / float(level.size.x * level.size.y);
+
+                if(preserve_coverage) {
+                    EXPECT_GE(coverage, 0.25f);
+                } else {
+                    EXPECT_EQ(coverage, 0.0f);
+                }
+            }
+        }
+
+        TEST(mipmap_builder, same_result_on_job_system) {
+            glm::ivec2 size = {64, 64};
+            std::vector<uint8_t> image;
+            for(int i = 0; i < size.x * size.y * 4; i++) {
+                image.push_back(static_cast<uint8_t>(i * 31));
+            }
+
+            mipmap_options options;
+            options.tile_size = {16, 16};
+            job_system jobs(3);
+
+            auto single_threaded = build_mipmaps(image.data(), size, options);
+            auto multi_threaded = build_mipmaps(image.data(), size, options, &jobs);
+
+            ASSERT_EQ(single_threaded.size(), multi_threaded.size());
+            for(size_t i = 0; i < single_threaded.size(); i++) {
+                EXPECT_EQ(single_threaded[i].pixels, multi_threaded[i].pixels);
+            }
+        }
+    }
+}
@@ -0,0 +1,63 @@
+/*!
+ * \brief Tests the functions that convert pixels before they're uploaded
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../../../render/objects/textures/pixel_conversion.h"
+
+namespace nova {
+    namespace test {
+        std::vector<uint8_t> make_rgb_pixels(size_t num_pixels) {
+            std::vector<uint8_t> rgb(num_pixels * 3);
+            for(size_t i = 0; i < rgb.size(); i++) {
+                rgb[i] = static_cast<uint8_t>(i * 7);
+            }
+            return rgb;
+        }
+
+        void expect_expanded(const std::vector<uint8_t>& rgb, const std::vector<uint8_t>& rgba) {
+            for(size_t pixel = 0; pixel < rgb.size() / 3; pixel++) {
+                EXPECT_EQ(rgba[pixel * 4 + 0], rgb[pixel * 3 + 0]) << "pixel " << pixel;
+                EXPECT_EQ(rgba[pixel * 4 + 1], rgb[pixel * 3 + 1]) << "pixel " << pixel;
+                EXPECT_EQ(rgba[pixel * 4 + 2], rgb[pixel * 3 + 2]) << "pixel " << pixel;
+                EXPECT_EQ(rgba[pixel * 4 + 3], 255) << "pixel " << pixel;
+            }
+        }
+
+        TEST(pixel_conversion, rgb_to_rgba_odd_pixel_count) {
+            // Not a multiple of four, so both the vectorized loop and the scalar tail get used
+            auto rgb = make_rgb_pixels(37);
+            std::vector<uint8_t> rgba(37 * 4);
+
+            expand_rgb_to_rgba(rgb.data(), rgba.data(), 37);
+
+            expect_expanded(rgb, rgba);
+        }
+
+        TEST(pixel_conversion, rgb_to_rgba_doesnt_write_past_end) {
+            auto rgb = make_rgb_pixels(5);
+            std::vector<uint8_t> rgba(5 * 4 + 4, 42);
+
+            expand_rgb_to_rgba(rgb.data(), rgba.data(), 5);
+
+            for(size_t i = 5 * 4; i < rgba.size(); i++) {
+                EXPECT_EQ(rgba[i], 42);
+            }
+        }
+
+        TEST(pixel_conversion, rgb_to_rgba_on_job_system) {
+            job_system jobs(3);
+            size_t num_pixels = 300 * 1000;
+            auto rgb = make_rgb_pixels(num_pixels);
+            std::vector<uint8_t> rgba(num_pixels * 4);
+
+            expand_rgb_to_rgba(jobs, rgb.data(), rgba.data(), num_pixels);
+
+            expect_expanded(rgb, rgba);
+        }
+    }
+}
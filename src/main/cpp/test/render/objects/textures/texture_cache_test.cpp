@@ -0,0 +1,101 @@
+/*!
+ * \brief Tests saving processed textures to disk and loading them back
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../../../render/objects/textures/texture_cache.h"
+#include "../../../../utils/utils.h"
+
+namespace nova {
+    namespace test {
+        const std::string CACHE_DIRECTORY = "test_cache/textures";
+
+        std::vector<uint8_t> make_level_data(size_t size, uint8_t seed) {
+            std::vector<uint8_t> data(size);
+            for(size_t i = 0; i < size; i++) {
+                data[i] = static_cast<uint8_t>(seed + i * 7);
+            }
+            return data;
+        }
+
+        TEST(texture_cache, hash_depends_on_every_byte) {
+            auto data = make_level_data(64, 0);
+            auto original_hash = hash_bytes(data.data(), data.size());
+
+            data[40]++;
+            EXPECT_NE(hash_bytes(data.data(), data.size()), original_hash);
+
+            // Hashes can be chained
+            auto chained = hash_value(uint32_t(4), original_hash);
+            EXPECT_NE(chained, original_hash);
+            EXPECT_EQ(chained, hash_value(uint32_t(4), original_hash));
+        }
+
+        TEST(texture_cache, round_trips_every_level) {
+            texture_cache cache(CACHE_DIRECTORY);
+            auto base = make_level_data(16 * 16 * 4, 1);
+            auto level_1 = make_level_data(8 * 8 * 4, 2);
+            auto level_2 = make_level_data(3, 3);
+
+            uint64_t key = hash_bytes(base.data(), base.size());
+            ASSERT_TRUE(cache.store(key, 0x8058, {
+                    {{16, 16}, base.data(), base.size()},
+                    {{8, 8}, level_1.data(), level_1.size()},
+                    {{4, 4}, level_2.data(), level_2.size()}
+            }));
+
+            auto loaded = cache.load(key);
+            ASSERT_NE(loaded, nullptr);
+            EXPECT_EQ(loaded->format, 0x8058);
+            ASSERT_EQ(loaded->levels.size(), 3);
+            EXPECT_EQ(loaded->levels[1].size, glm::ivec2(8, 8));
+
+            std::vector<std::vector<uint8_t>*> expected = {&base, &level_1, &level_2};
+            for(size_t i = 0; i < loaded->levels.size(); i++) {
+                const auto& level = loaded->levels[i];
+                ASSERT_EQ(level.data_size, expected[i]->size());
+                EXPECT_EQ(std::vector<uint8_t>(level.data, level.data + level.data_size), *expected[i]);
+                EXPECT_EQ(reinterpret_cast<uintptr_t>(level.data) % 16, 0u);
+            }
+
+            EXPECT_EQ(cache.get_num_hits(), 1);
+        }
+
+        TEST(texture_cache, misses_unknown_keys) {
+            texture_cache cache(CACHE_DIRECTORY);
+            EXPECT_EQ(cache.load(0x1234), nullptr);
+            EXPECT_EQ(cache.get_num_misses(), 1);
+        }
+
+        TEST(texture_cache, ignores_damaged_files) {
+            texture_cache cache(CACHE_DIRECTORY);
+            auto base = make_level_data(1024, 4);
+            uint64_t key = hash_bytes(base.data(), base.size());
+            ASSERT_TRUE(cache.store(key, 0, {{{16, 16}, base.data(), base.size()}}));
+
+            // Chop the file off halfway through its pixels
+            std::stringstream path;
+            path << CACHE_DIRECTORY << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".nvtex";
+            std::vector<char> contents;
+            {
+                std::ifstream file(path.str(), std::ios::binary);
+                contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            }
+            {
+                std::ofstream file(path.str(), std::ios::binary | std::ios::trunc);
+                file.write(contents.data(), contents.size() / 2);
+            }
+
+            EXPECT_EQ(cache.load(key), nullptr);
+            std::remove(path.str().c_str());
+        }
+    }
+}
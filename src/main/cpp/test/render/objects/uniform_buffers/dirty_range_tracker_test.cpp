@@ -0,0 +1,71 @@
+/*!
+ * \brief Tests for tracking which parts of a uniform buffer each frame slot needs to write
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../../../render/objects/uniform_buffers/dirty_range_tracker.h"
+#include "../../../../render/frame_sync.h"
+
+namespace nova {
+    namespace test {
+        using range = std::pair<size_t, size_t>;
+
+        static std::vector<range> flush_ranges(dirty_range_tracker& tracker, size_t frame_slot) {
+            std::vector<range> ranges;
+            tracker.flush(frame_slot, [&](size_t offset, size_t num_bytes) { ranges.emplace_back(offset, num_bytes); });
+            return ranges;
+        }
+
+        TEST(dirty_range_tracker, everything_starts_out_dirty_in_every_slot) {
+            dirty_range_tracker tracker(100);
+
+            for(size_t slot = 0; slot < MAX_FRAMES_IN_FLIGHT; slot++) {
+                EXPECT_EQ(flush_ranges(tracker, slot), std::vector<range>({{0, 100}}));
+                EXPECT_FALSE(tracker.is_dirty(slot));
+            }
+        }
+
+        TEST(dirty_range_tracker, a_change_is_written_once_into_each_slot) {
+            dirty_range_tracker tracker(256);
+            for(size_t slot = 0; slot < MAX_FRAMES_IN_FLIGHT; slot++) {
+                flush_ranges(tracker, slot);
+            }
+
+            tracker.mark_dirty(70, 4);
+            EXPECT_EQ(flush_ranges(tracker, 0), std::vector<range>({{64, 16}}));
+            EXPECT_TRUE(flush_ranges(tracker, 0).empty());
+
+            EXPECT_TRUE(tracker.is_dirty(1));
+            EXPECT_EQ(flush_ranges(tracker, 1), std::vector<range>({{64, 16}}));
+        }
+
+        TEST(dirty_range_tracker, chunks_next_to_each_other_are_merged) {
+            dirty_range_tracker tracker(256);
+            flush_ranges(tracker, 0);
+
+            tracker.mark_dirty(0, 64);
+            tracker.mark_dirty(64, 16);
+            tracker.mark_dirty(200, 56);
+
+            EXPECT_EQ(flush_ranges(tracker, 0), std::vector<range>({{0, 80}, {192, 64}}));
+        }
+
+        TEST(dirty_range_tracker, only_changed_chunks_are_marked) {
+            std::vector<uint8_t> old_data(64, 0);
+            std::vector<uint8_t> new_data = old_data;
+            new_data[20] = 1;
+            new_data[63] = 1;
+
+            dirty_range_tracker tracker(64);
+            flush_ranges(tracker, 2);
+            tracker.mark_changes(old_data.data(), new_data.data());
+
+            EXPECT_EQ(flush_ranges(tracker, 2), std::vector<range>({{16, 16}, {48, 16}}));
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/*!
+ * \brief Tests for laying out uniform blocks and writing their GLSL
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <fstream>
+#include <sstream>
+#include <gtest/gtest.h>
+#include "../../../../render/objects/uniform_buffers/uniform_buffer_definitions.h"
+
+namespace nova {
+    namespace test {
+#define NOVA_TEST_STD430_BLOCK(field, renamed_field) \
+        field(GLfloat[4], weights) \
+        field(glm::vec3, position) \
+        field(glm::vec2[2], uv)
+
+        NOVA_UNIFORM_BLOCK(test_std430_block, block_layout::std430, NOVA_TEST_STD430_BLOCK)
+
+#define NOVA_TEST_STD140_BLOCK(field, renamed_field) \
+        field(glm::vec4[2], colors) \
+        field(GLint, count) \
+        renamed_field(glm::ivec3, position, "blockPosition")
+
+        NOVA_UNIFORM_BLOCK(test_std140_block, block_layout::std140, NOVA_TEST_STD140_BLOCK)
+
+        TEST(uniform_block_layout, std140_rounds_array_alignment_up_to_a_vec4) {
+            EXPECT_EQ((uniform_layout<GLfloat[4], block_layout::std140>::alignment), 16);
+            EXPECT_EQ((uniform_layout<GLfloat[4], block_layout::std140>::size), 64);
+            EXPECT_EQ((uniform_layout<GLfloat[4], block_layout::std430>::alignment), 4);
+            EXPECT_EQ((uniform_layout<GLfloat[4], block_layout::std430>::size), 16);
+            EXPECT_EQ((uniform_layout<glm::vec3, block_layout::std140>::alignment), 16);
+            EXPECT_EQ((uniform_layout<glm::vec3, block_layout::std140>::size), 12);
+        }
+
+        TEST(uniform_block_layout, fields_go_where_glsl_puts_them) {
+            EXPECT_EQ(offsetof(test_std430_block, position), 16);
+            EXPECT_EQ(offsetof(test_std430_block, uv), 32);
+            EXPECT_EQ(glsl_offset_of<test_std430_block>("position"), 16);
+
+            EXPECT_EQ(offsetof(test_std140_block, count), 32);
+            EXPECT_EQ(offsetof(test_std140_block, position), 48);
+            EXPECT_EQ(glsl_offset_of<test_std140_block>("blockPosition"), 48);
+        }
+
+        TEST(uniform_block_layout, per_frame_uniforms_floats_fill_in_after_vec3s) {
+            EXPECT_EQ(offsetof(per_frame_uniforms, entityColor), 640);
+            EXPECT_EQ(offsetof(per_frame_uniforms, fogColor), 656);
+            EXPECT_EQ(offsetof(per_frame_uniforms, frameTimeCounter), 668);
+            EXPECT_EQ(offsetof(per_frame_uniforms, nearPlane), 780);
+            EXPECT_EQ(offsetof(per_frame_uniforms, eyeBrightness), 784);
+            EXPECT_EQ(offsetof(per_frame_uniforms, centerDepthSmooth), 876);
+            EXPECT_EQ(sizeof(per_frame_uniforms), 880);
+        }
+
+        TEST(uniform_block_layout, writes_the_glsl_block) {
+            EXPECT_EQ(make_glsl_block<test_std140_block>(),
+                      "layout(std140) uniform test_std140_block {\n"
+                      "    vec4 colors[2];\n"
+                      "    int count;\n"
+                      "    ivec3 blockPosition;\n"
+                      "};\n");
+
+            EXPECT_EQ(make_glsl_block<test_std430_block>(),
+                      "layout(std430) buffer test_std430_block {\n"
+                      "    float weights[4];\n"
+                      "    vec3 position;\n"
+                      "    vec2 uv[2];\n"
+                      "};\n");
+        }
+
+        TEST(uniform_block_layout, default_shaderpack_matches_per_frame_uniforms) {
+            std::ifstream shader_file("shaderpacks/default/shaders/gui.frag");
+            ASSERT_TRUE(shader_file.is_open());
+
+            std::stringstream block;
+            std::string line;
+            bool in_block = false;
+            while(std::getline(shader_file, line)) {
+                if(line.find("uniform per_frame_uniforms") != std::string::npos) {
+                    in_block = true;
+                }
+                if(in_block) {
+                    block << line << "\n";
+                }
+                if(in_block && line == "};") {
+                    break;
+                }
+            }
+
+            EXPECT_EQ(block.str(), make_glsl_block<per_frame_uniforms>());
+        }
+
+        TEST(uniform_block_layout, nova_include_files_are_generated) {
+            EXPECT_EQ(*get_uniform_block_include("/nova/per_frame_uniforms.glsl"), make_glsl_block<per_frame_uniforms>());
+            EXPECT_FALSE(get_uniform_block_include("/nova/not_a_block.glsl"));
+        }
+    }
+}
@@ -0,0 +1,155 @@
+/*!
+ * \brief Tests for handing work and frames to the render thread
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include "../../render/render_thread.h"
+
+namespace nova {
+    namespace test {
+        TEST(render_thread, runs_everything_right_away_before_it_starts) {
+            render_thread renderer;
+            std::vector<int> order;
+
+            renderer.run_before_next_frame([&]() { order.push_back(1); });
+            renderer.run_and_wait([&]() { order.push_back(2); });
+            renderer.publish_frame([&]() { order.push_back(3); });
+
+            EXPECT_EQ(order, std::vector<int>({1, 2, 3}));
+        }
+
+        TEST(render_thread, runs_on_its_own_thread) {
+            render_thread renderer;
+            std::thread::id started_on;
+            std::thread::id stopped_on;
+            renderer.start([&]() { started_on = std::this_thread::get_id(); }, [&]() { stopped_on = std::this_thread::get_id(); });
+            EXPECT_FALSE(renderer.is_render_thread());
+
+            std::thread::id ran_on;
+            bool was_render_thread = false;
+            renderer.run_and_wait([&]() {
+                ran_on = std::this_thread::get_id();
+                was_render_thread = renderer.is_render_thread();
+            });
+            renderer.stop();
+
+            EXPECT_NE(ran_on, std::this_thread::get_id());
+            EXPECT_EQ(ran_on, started_on);
+            EXPECT_EQ(ran_on, stopped_on);
+            EXPECT_TRUE(was_render_thread);
+        }
+
+        TEST(render_thread, queued_work_waits_for_the_next_frame) {
+            render_thread renderer;
+            renderer.start([]() {}, []() {});
+            std::vector<int> order;
+
+            renderer.run_before_next_frame([&]() { order.push_back(1); });
+            renderer.wait_until_idle();
+            EXPECT_TRUE(order.empty());
+
+            renderer.publish_frame([&]() { order.push_back(2); });
+            renderer.wait_until_idle();
+            EXPECT_EQ(order, std::vector<int>({1, 2}));
+
+            renderer.stop();
+        }
+
+        TEST(render_thread, work_queued_during_a_frame_waits_for_the_frame_after) {
+            render_thread renderer;
+            renderer.start([]() {}, []() {});
+            std::atomic<int> num_runs{0};
+
+            std::promise<void> finish_frame;
+            auto frame_finished = finish_frame.get_future().share();
+            renderer.publish_frame([=]() { frame_finished.wait(); });
+            renderer.run_before_next_frame([&]() { num_runs++; });
+            finish_frame.set_value();
+
+            renderer.wait_until_idle();
+            EXPECT_EQ(num_runs, 0);
+
+            renderer.publish_frame([]() {});
+            renderer.wait_until_idle();
+            EXPECT_EQ(num_runs, 1);
+
+            renderer.stop();
+        }
+
+        TEST(render_thread, only_one_frame_is_in_flight) {
+            render_thread renderer;
+            renderer.start([]() {}, []() {});
+
+            std::promise<void> finish_frame;
+            auto frame_finished = finish_frame.get_future().share();
+            renderer.publish_frame([=]() { frame_finished.wait(); });
+
+            std::atomic<bool> published_second_frame{false};
+            std::thread game_thread([&]() {
+                renderer.publish_frame([]() {});
+                published_second_frame = true;
+            });
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            EXPECT_FALSE(published_second_frame);
+
+            finish_frame.set_value();
+            game_thread.join();
+            EXPECT_TRUE(published_second_frame);
+
+            renderer.stop();
+        }
+
+        TEST(render_thread, run_and_wait_sees_earlier_calls_and_rethrows) {
+            render_thread renderer;
+            renderer.start([]() {}, []() {});
+            std::vector<int> order;
+
+            renderer.run_before_next_frame([&]() { order.push_back(1); });
+            renderer.run_and_wait([&]() { order.push_back(2); });
+            EXPECT_EQ(order, std::vector<int>({1, 2}));
+
+            EXPECT_THROW(renderer.run_and_wait([]() { throw std::runtime_error("no shaderpack"); }), std::runtime_error);
+
+            // The thread keeps going after a task throws
+            renderer.run_and_wait([&]() { order.push_back(3); });
+            EXPECT_EQ(order.size(), 3u);
+
+            renderer.stop();
+        }
+
+        TEST(render_thread, keeps_going_after_a_frame_throws_anything) {
+            render_thread renderer;
+            bool started_on_render_thread = false;
+            renderer.start([&]() { started_on_render_thread = renderer.is_render_thread(); }, []() {});
+
+            renderer.publish_frame([]() { throw 42; });
+
+            bool ran = false;
+            renderer.run_and_wait([&]() { ran = true; });
+            renderer.stop();
+
+            EXPECT_TRUE(started_on_render_thread);
+            EXPECT_TRUE(ran);
+        }
+
+        TEST(render_thread, stopping_finishes_queued_work) {
+            render_thread renderer;
+            renderer.start([]() {}, []() {});
+            bool ran = false;
+
+            renderer.run_before_next_frame([&]() { ran = true; });
+            renderer.stop();
+
+            EXPECT_TRUE(ran);
+            EXPECT_FALSE(renderer.is_running());
+        }
+    }
+}
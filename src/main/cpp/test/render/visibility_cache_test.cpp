@@ -0,0 +1,128 @@
+/*!
+ * \brief Tests for keeping frustum culling results until the camera moves or turns too far
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include "../../render/visibility_cache.h"
+
+namespace nova {
+    namespace test {
+        void set_bounds(render_object& obj, const glm::vec3& center, float radius) {
+            obj.bounding_sphere = {center, radius};
+            obj.bounding_box = {center, {radius, radius, radius}};
+        }
+
+        /*!
+         * \brief A single object, right in front of a camera at the origin
+         */
+        std::vector<render_object> make_objects() {
+            std::vector<render_object> objects(1);
+            set_bounds(objects[0], {0, 0, 20}, 0.5f);
+            return objects;
+        }
+
+        /*!
+         * \brief Moves the object behind the camera, so if it's still visible then the cached results were used
+         */
+        void move_behind_camera(std::vector<render_object>& objects) {
+            set_bounds(objects[0], {0, 0, -50}, 0.5f);
+        }
+
+        TEST(visibility_cache, reculls_when_the_camera_moves_past_the_threshold) {
+            visibility_cache cache(2, 10);
+            camera cam;
+            auto objects = make_objects();
+
+            cache.update(cam);
+            EXPECT_EQ(cache.get_visible_objects("gbuffers_terrain", objects, 1), std::vector<size_t>{0});
+            move_behind_camera(objects);
+
+            cam.position = {1.5f, 0, 0};
+            cache.update(cam);
+            EXPECT_EQ(cache.get_visible_objects("gbuffers_terrain", objects, 1), std::vector<size_t>{0});
+
+            // Still measured from where the results were computed, not from the last update
+            cam.position = {2.5f, 0, 0};
+            cache.update(cam);
+            EXPECT_TRUE(cache.get_visible_objects("gbuffers_terrain", objects, 1).empty());
+        }
+
+        TEST(visibility_cache, reculls_when_the_camera_turns_past_the_threshold) {
+            visibility_cache cache(2, 10);
+            camera cam;
+            auto objects = make_objects();
+
+            cache.update(cam);
+            cache.get_visible_objects("gbuffers_terrain", objects, 1);
+            move_behind_camera(objects);
+
+            // Turning across 0 degrees is a small turn, not an almost full circle
+            cam.rotation = {-6, 0};
+            cache.update(cam);
+            EXPECT_EQ(cache.get_visible_objects("gbuffers_terrain", objects, 1), std::vector<size_t>{0});
+
+            cam.rotation = {354, 0};
+            cache.update(cam);
+            EXPECT_EQ(cache.get_visible_objects("gbuffers_terrain", objects, 1), std::vector<size_t>{0});
+
+            // Yaw and pitch add up
+            cam.rotation = {354, 5};
+            cache.update(cam);
+            EXPECT_TRUE(cache.get_visible_objects("gbuffers_terrain", objects, 1).empty());
+        }
+
+        TEST(visibility_cache, reculls_when_the_projection_changes) {
+            visibility_cache cache(2, 10);
+            camera cam;
+            auto objects = make_objects();
+
+            cache.update(cam);
+            cache.get_visible_objects("gbuffers_terrain", objects, 1);
+            move_behind_camera(objects);
+
+            cam.fov = 90;
+            cache.update(cam);
+            EXPECT_TRUE(cache.get_visible_objects("gbuffers_terrain", objects, 1).empty());
+        }
+
+        TEST(visibility_cache, reculls_each_shader_when_its_geometry_changes) {
+            visibility_cache cache(2, 10);
+            camera cam;
+            auto objects = make_objects();
+
+            cache.update(cam);
+            cache.get_visible_objects("gbuffers_terrain", objects, 1);
+            cache.get_visible_objects("gbuffers_water", objects, 1);
+            move_behind_camera(objects);
+
+            EXPECT_TRUE(cache.get_visible_objects("gbuffers_terrain", objects, 2).empty());
+            EXPECT_EQ(cache.get_visible_objects("gbuffers_water", objects, 1), std::vector<size_t>{0});
+
+            cache.invalidate();
+            cache.update(cam);
+            EXPECT_TRUE(cache.get_visible_objects("gbuffers_water", objects, 1).empty());
+        }
+
+        TEST(visibility_cache, keeps_objects_inside_the_guard_band) {
+            visibility_cache cache(2, 10);
+            camera cam;
+
+            // Put objects at 30 blocks along the side plane of the guard band frustum, some distance outside it
+            auto half_angle = std::atan(std::tan(glm::radians(cam.fov) / 2.0f) * cam.aspect_ratio) + glm::radians(10.0f);
+            glm::vec3 on_plane = glm::vec3(std::sin(half_angle), 0, std::cos(half_angle)) * 30.0f;
+            glm::vec3 outwards = glm::vec3(std::cos(half_angle), 0, -std::sin(half_angle));
+
+            std::vector<render_object> objects(3);
+            set_bounds(objects[0], on_plane - outwards * 1.0f, 0.01f);
+            set_bounds(objects[1], on_plane + outwards * 1.5f, 0.01f);
+            set_bounds(objects[2], on_plane + outwards * 2.5f, 0.01f);
+
+            cache.update(cam);
+            EXPECT_EQ(cache.get_visible_objects("gbuffers_terrain", objects, 1), std::vector<size_t>({0, 1}));
+        }
+    }
+}
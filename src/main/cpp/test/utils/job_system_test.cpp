@@ -0,0 +1,68 @@
+/*!
+ * \brief Tests for running jobs and parallel loops on the worker threads
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../utils/job_system.h"
+
+namespace nova {
+    namespace test {
+        TEST(job_system, parallel_for_processes_every_item_once) {
+            job_system jobs(3);
+            std::vector<std::atomic<int>> times_processed(1000);
+            for(auto& times : times_processed) {
+                times.store(0);
+            }
+
+            jobs.parallel_for(times_processed.size(), 7, [&](size_t begin, size_t end) {
+                for(size_t i = begin; i < end; i++) {
+                    times_processed[i]++;
+                }
+            });
+
+            for(const auto& times : times_processed) {
+                EXPECT_EQ(times.load(), 1);
+            }
+        }
+
+        TEST(job_system, parallel_for_rethrows_on_the_calling_thread) {
+            job_system jobs(3);
+
+            // Every batch throws, so the workers throw too, not only this thread
+            for(int i = 0; i < 20; i++) {
+                EXPECT_THROW(jobs.parallel_for(64, 1, [](size_t, size_t) { throw std::runtime_error("batch failed"); }),
+                             std::runtime_error);
+            }
+
+            // Only one batch in the middle throws
+            EXPECT_THROW(jobs.parallel_for(64, 1, [&](size_t begin, size_t) {
+                if(begin == 10) {
+                    throw std::runtime_error("batch failed");
+                }
+            }), std::runtime_error);
+
+            // The workers are still fine afterwards
+            std::atomic<size_t> num_items{0};
+            jobs.parallel_for(64, 4, [&](size_t begin, size_t end) { num_items += end - begin; });
+            EXPECT_EQ(num_items.load(), 64u);
+        }
+
+        TEST(job_system, parallel_for_works_inside_a_job) {
+            job_system jobs(2);
+
+            auto result = jobs.submit([&]() {
+                std::atomic<size_t> num_items{0};
+                jobs.parallel_for(100, 3, [&](size_t begin, size_t end) { num_items += end - begin; });
+                return num_items.load();
+            });
+
+            EXPECT_EQ(result.get(), 100u);
+        }
+    }
+}
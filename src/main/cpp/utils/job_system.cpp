@@ -0,0 +1,143 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <easylogging++.h>
+#include "job_system.h"
+
+namespace nova {
+    job_system::job_system(size_t num_threads) {
+        if(num_threads == 0) {
+            auto hardware_threads = static_cast<size_t>(std::thread::hardware_concurrency());
+            num_threads = hardware_threads > 1 ? hardware_threads - 1 : 1;
+        }
+
+        LOG(INFO) << "Starting " << num_threads << " worker threads";
+
+        workers.reserve(num_threads);
+        for(size_t i = 0; i < num_threads; i++) {
+            workers.emplace_back(&job_system::worker_main, this);
+        }
+    }
+
+    job_system::~job_system() {
+        {
+            std::lock_guard<std::mutex> lock(jobs_lock);
+            should_stop = true;
+        }
+        jobs_available.notify_all();
+
+        for(auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    void job_system::parallel_for(size_t count, size_t batch_size, const std::function<void(size_t, size_t)>& func) {
+        if(count == 0) {
+            return;
+        }
+
+        batch_size = std::max<size_t>(batch_size, 1);
+        size_t num_batches = (count + batch_size - 1) / batch_size;
+        if(num_batches == 1) {
+            func(0, count);
+            return;
+        }
+
+        // Batches are claimed from a shared counter, by the workers and by this thread. This thread never waits for
+        // a helper job to start - only for batches that are already being processed to finish - so calling this from
+        // a worker can't deadlock even when every other worker is busy.
+        //
+        // Helpers that start after every batch has been claimed can run after this function has returned, so
+        // everything they touch lives in the shared state, func included
+        struct batch_state {
+            explicit batch_state(const std::function<void(size_t, size_t)>& func) : func(func) {}
+
+            std::function<void(size_t, size_t)> func;
+            std::atomic<size_t> next_batch{0};
+            std::atomic<bool> has_failed{false};
+
+            std::mutex lock;
+            std::condition_variable all_finished;
+            size_t finished_batches = 0;
+            std::exception_ptr first_error;
+        };
+        auto state = std::make_shared<batch_state>(func);
+
+        auto process_batches = [state, num_batches, batch_size, count]() {
+            size_t num_finished = 0;
+            std::exception_ptr error;
+
+            size_t batch;
+            while((batch = state->next_batch.fetch_add(1)) < num_batches) {
+                // Once a batch has thrown the rest are only counted, not run
+                if(!state->has_failed.load()) {
+                    size_t begin = batch * batch_size;
+                    size_t end = std::min(begin + batch_size, count);
+                    try {
+                        state->func(begin, end);
+                    } catch(...) {
+                        state->has_failed.store(true);
+                        if(!error) {
+                            error = std::current_exception();
+                        }
+                    }
+                }
+                num_finished++;
+            }
+
+            if(num_finished == 0) {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(state->lock);
+            if(error && !state->first_error) {
+                state->first_error = error;
+            }
+            state->finished_batches += num_finished;
+            if(state->finished_batches == num_batches) {
+                state->all_finished.notify_all();
+            }
+        };
+
+        size_t num_helpers = std::min(workers.size(), num_batches - 1);
+        for(size_t i = 0; i < num_helpers; i++) {
+            submit(process_batches);
+        }
+
+        process_batches();
+
+        std::unique_lock<std::mutex> lock(state->lock);
+        state->all_finished.wait(lock, [&]() { return state->finished_batches == num_batches; });
+        if(state->first_error) {
+            std::rethrow_exception(state->first_error);
+        }
+    }
+
+    size_t job_system::get_num_threads() const {
+        return workers.size();
+    }
+
+    void job_system::worker_main() {
+        while(true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(jobs_lock);
+                jobs_available.wait(lock, [this]() { return should_stop || !jobs.empty(); });
+                if(jobs.empty()) {
+                    // should_stop is set and there's nothing left to do
+                    return;
+                }
+
+                job = std::move(jobs.front());
+                jobs.pop();
+            }
+
+            job();
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/*!
+ * \brief A small pool of worker threads for CPU work that shouldn't hold up a frame
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_JOB_SYSTEM_H
+#define RENDERER_JOB_SYSTEM_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace nova {
+    /*!
+     * \brief Runs jobs on a fixed set of worker threads
+     *
+     * Jobs are run in the order they're submitted. Jobs must not touch OpenGL - there's no context on the worker
+     * threads - so the usual pattern is to do the CPU work in a job, then pick up the result on the render thread and
+     * upload it there
+     */
+    class job_system {
+    public:
+        /*!
+         * \param num_threads How many worker threads to start. 0 means one fewer than the number of hardware
+         * threads, leaving one for the render thread, with a minimum of one
+         */
+        explicit job_system(size_t num_threads = 0);
+
+        /*!
+         * \brief Waits for all the jobs that have already been submitted, then stops the worker threads
+         */
+        ~job_system();
+
+        job_system(const job_system&) = delete;
+        job_system& operator=(const job_system&) = delete;
+
+        /*!
+         * \brief Queues up a job to run on a worker thread
+         *
+         * \param job The job to run
+         * \return A future which holds the job's return value (or exception) once the job has finished
+         */
+        template <typename Job>
+        auto submit(Job&& job) -> std::future<decltype(job())> {
+            using result_type = decltype(job());
+            auto task = std::make_shared<std::packaged_task<result_type()>>(std::forward<Job>(job));
+            auto result = task->get_future();
+
+            {
+                std::lock_guard<std::mutex> lock(jobs_lock);
+                jobs.emplace([task]() { (*task)(); });
+            }
+            jobs_available.notify_one();
+
+            return result;
+        }
+
+        /*!
+         * \brief Splits the range [0, count) into batches and processes them on the worker threads, blocking until
+         * every batch is done
+         *
+         * The calling thread processes batches too, so this is safe to call from inside a job
+         *
+         * If func throws, the batches that haven't started yet are skipped, and the first exception is rethrown on
+         * the calling thread once every batch that did start has finished
+         *
+         * \param count The number of items to process
+         * \param batch_size The number of items in each batch
+         * \param func The function to process a batch with. Receives the first item in the batch and one past the
+         * last item in the batch
+         */
+        void parallel_for(size_t count, size_t batch_size, const std::function<void(size_t, size_t)>& func);
+
+        /*!
+         * \brief Returns the number of worker threads
+         */
+        size_t get_num_threads() const;
+
+    private:
+        std::vector<std::thread> workers;
+
+        std::mutex jobs_lock;
+        std::condition_variable jobs_available;
+        std::queue<std::function<void()>> jobs;
+        bool should_stop = false;
+
+        void worker_main();
+    };
+}
+
+#endif //RENDERER_JOB_SYSTEM_H
@@ -0,0 +1,137 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifdef _WIN32
+// utils.h brings in easylogging, which includes windows.h, so its min and max macros have to be turned off up here
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#endif
+
+#include <utility>
+#include "mapped_file.h"
+#include "utils.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nova {
+    mapped_file::mapped_file(const std::string& path) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(file == INVALID_HANDLE_VALUE) {
+            throw resource_not_found(path);
+        }
+        file_handle = file;
+
+        LARGE_INTEGER file_size;
+        if(!GetFileSizeEx(file, &file_size)) {
+            close();
+            throw resource_not_found(path);
+        }
+        size = static_cast<size_t>(file_size.QuadPart);
+
+        if(size > 0) {
+            // Empty files can't be mapped, but they don't need to be
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if(mapping == nullptr) {
+                close();
+                throw resource_not_found(path);
+            }
+            mapping_handle = mapping;
+
+            data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if(data == nullptr) {
+                close();
+                throw resource_not_found(path);
+            }
+        }
+#else
+        int file = open(path.c_str(), O_RDONLY);
+        if(file < 0) {
+            throw resource_not_found(path);
+        }
+
+        struct stat file_info;
+        if(fstat(file, &file_info) != 0) {
+            ::close(file);
+            throw resource_not_found(path);
+        }
+        size = static_cast<size_t>(file_info.st_size);
+
+        if(size > 0) {
+            void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+            if(mapping == MAP_FAILED) {
+                ::close(file);
+                throw resource_not_found(path);
+            }
+            data = static_cast<const uint8_t*>(mapping);
+        }
+
+        // The mapping keeps the file alive on its own
+        ::close(file);
+#endif
+    }
+
+    mapped_file::mapped_file(mapped_file&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    mapped_file& mapped_file::operator=(mapped_file&& other) noexcept {
+        if(this != &other) {
+            close();
+            std::swap(data, other.data);
+            std::swap(size, other.size);
+#ifdef _WIN32
+            std::swap(file_handle, other.file_handle);
+            std::swap(mapping_handle, other.mapping_handle);
+#endif
+        }
+        return *this;
+    }
+
+    mapped_file::~mapped_file() {
+        close();
+    }
+
+    const uint8_t* mapped_file::get_data() const {
+        return data;
+    }
+
+    size_t mapped_file::get_size() const {
+        return size;
+    }
+
+    void mapped_file::close() {
+#ifdef _WIN32
+        if(data) {
+            UnmapViewOfFile(data);
+        }
+        if(mapping_handle) {
+            CloseHandle(mapping_handle);
+        }
+        if(file_handle) {
+            CloseHandle(file_handle);
+        }
+        file_handle = nullptr;
+        mapping_handle = nullptr;
+#else
+        if(data) {
+            munmap(const_cast<uint8_t*>(data), size);
+        }
+#endif
+        data = nullptr;
+        size = 0;
+    }
+}
@@ -0,0 +1,56 @@
+/*!
+ * \brief A read-only view of a file, mapped into memory
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_MAPPED_FILE_H
+#define RENDERER_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace nova {
+    /*!
+     * \brief Maps a whole file into memory, read-only
+     *
+     * The OS pages the file in as it's read, so nothing is copied until it's needed, and files that were read recently
+     * come straight out of the page cache
+     */
+    class mapped_file {
+    public:
+        /*!
+         * \brief Maps the file at the given path
+         *
+         * \throws resource_not_found if the file doesn't exist or can't be mapped
+         */
+        explicit mapped_file(const std::string& path);
+
+        mapped_file(const mapped_file& other) = delete;
+        mapped_file& operator=(const mapped_file& other) = delete;
+
+        mapped_file(mapped_file&& other) noexcept;
+        mapped_file& operator=(mapped_file&& other) noexcept;
+
+        ~mapped_file();
+
+        const uint8_t* get_data() const;
+
+        size_t get_size() const;
+
+    private:
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+
+#ifdef _WIN32
+        void* file_handle = nullptr;
+        void* mapping_handle = nullptr;
+#endif
+
+        void close();
+    };
+}
+
+#endif //RENDERER_MAPPED_FILE_H
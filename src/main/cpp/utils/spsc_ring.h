@@ -0,0 +1,92 @@
+/*!
+ * \brief A fixed-size queue for handing data from one thread to another without locks
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_SPSC_RING_H
+#define RENDERER_SPSC_RING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace nova {
+    /*!
+     * \brief A ring buffer with exactly one thread pushing and exactly one thread popping
+     *
+     * The pushing thread only writes the head and the popping thread only writes the tail, so each side needs nothing
+     * more than an atomic load of the other side's index. The head and tail are on separate cache lines so the two
+     * threads don't fight over them
+     *
+     * \tparam T The type of thing in the ring. Should be cheap to copy
+     * \tparam Capacity The most things the ring can hold. Must be a power of two
+     */
+    template<typename T, size_t Capacity>
+    class spsc_ring {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "The capacity of a spsc_ring must be a power of two");
+
+    public:
+        /*!
+         * \brief Adds something to the ring. Only call this from the pushing thread
+         *
+         * \return False if the ring is full, in which case the value isn't added
+         */
+        bool push(const T& value) {
+            size_t head = head_index.load(std::memory_order_relaxed);
+            if(head - tail_index.load(std::memory_order_acquire) == Capacity) {
+                return false;
+            }
+
+            items[head & (Capacity - 1)] = value;
+            head_index.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /*!
+         * \brief Returns the oldest thing in the ring without removing it, or nullptr if the ring is empty. Only call
+         * this from the popping thread
+         */
+        const T* peek() const {
+            size_t tail = tail_index.load(std::memory_order_relaxed);
+            if(tail == head_index.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+
+            return &items[tail & (Capacity - 1)];
+        }
+
+        /*!
+         * \brief Removes the oldest thing in the ring. Only call this from the popping thread, and only after #peek
+         * returned something
+         */
+        void pop() {
+            tail_index.store(tail_index.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /*!
+         * \brief Removes the oldest thing in the ring and copies it into value. Only call this from the popping thread
+         *
+         * \return False if the ring was empty
+         */
+        bool pop(T& value) {
+            const T* oldest = peek();
+            if(oldest == nullptr) {
+                return false;
+            }
+
+            value = *oldest;
+            pop();
+            return true;
+        }
+
+    private:
+        std::array<T, Capacity> items;
+
+        alignas(64) std::atomic<size_t> head_index{0};
+        alignas(64) std::atomic<size_t> tail_index{0};
+    };
+}
+
+#endif //RENDERER_SPSC_RING_H
@@ -0,0 +1,25 @@
+/*!
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#include "stats.h"
+
+namespace nova {
+    std::mutex stats::stats_mutex;
+    std::unordered_map<std::string, double> stats::values;
+
+    void stats::set(const std::string& name, double value) {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        values[name] = value;
+    }
+
+    double stats::get(const std::string& name) {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        auto itr = values.find(name);
+        if(itr == values.end()) {
+            return 0;
+        }
+        return itr->second;
+    }
+}
@@ -0,0 +1,35 @@
+/*!
+ * \brief A place for the different parts of Nova to publish numbers about how they're doing
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_STATS_H
+#define RENDERER_STATS_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace nova {
+    /*!
+     * \brief Named numbers, like how often the GUI reuses last frame's buffers or how long input takes to reach the
+     * screen
+     *
+     * Anything can set a stat from any thread, and Minecraft can read them through get_stat in the C interface. Stats
+     * that have never been set read as 0
+     */
+    class stats {
+    public:
+        static void set(const std::string& name, double value);
+
+        static double get(const std::string& name);
+
+    private:
+        static std::mutex stats_mutex;
+        static std::unordered_map<std::string, double> values;
+    };
+}
+
+#endif //RENDERER_STATS_H
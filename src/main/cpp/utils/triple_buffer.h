@@ -0,0 +1,72 @@
+/*!
+ * \brief Hands the latest version of a value from one thread to another without locks
+ *
+ * \author ddubois
+ * \date 18-Oct-26.
+ */
+
+#ifndef RENDERER_TRIPLE_BUFFER_H
+#define RENDERER_TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace nova {
+    /*!
+     * \brief Three copies of a value: one the writer fills in, one the reader reads from, and one in the middle that
+     * holds the newest finished value
+     *
+     * Publishing a value swaps the writer's copy with the middle one, and reading swaps the middle one with the
+     * reader's copy if there's something new there. Both swaps are a single atomic exchange, so neither side ever
+     * waits for the other, and neither side ever touches the copy the other side is using.
+     *
+     * There can only be one writer and one reader at a time. If there are more writers, they need to take turns
+     */
+    template<typename T>
+    class triple_buffer {
+    public:
+        explicit triple_buffer(const T& initial_value = T()) : buffers{initial_value, initial_value, initial_value} {}
+
+        triple_buffer(const triple_buffer& other) = delete;
+        triple_buffer& operator=(const triple_buffer& other) = delete;
+
+        /*!
+         * \brief Returns the copy that the writer can fill in. It holds whatever was written to it last time it was
+         * the writer's copy, so write the whole thing
+         */
+        T& get_write_buffer() {
+            return buffers[write_index];
+        }
+
+        /*!
+         * \brief Makes the write buffer the newest value that the reader can see
+         */
+        void publish() {
+            write_index = middle.exchange(static_cast<uint8_t>(write_index | HAS_NEW_VALUE), std::memory_order_acq_rel) & INDEX_MASK;
+        }
+
+        /*!
+         * \brief Returns the newest value that's been published
+         *
+         * The reference stays valid and unchanging until the next call to #read
+         */
+        const T& read() {
+            if(middle.load(std::memory_order_relaxed) & HAS_NEW_VALUE) {
+                read_index = middle.exchange(read_index, std::memory_order_acq_rel) & INDEX_MASK;
+            }
+            return buffers[read_index];
+        }
+
+    private:
+        static const uint8_t INDEX_MASK = 0x3;
+        static const uint8_t HAS_NEW_VALUE = 0x4;
+
+        T buffers[3];
+
+        uint8_t write_index = 0;
+        std::atomic<uint8_t> middle{1};
+        uint8_t read_index = 2;
+    };
+}
+
+#endif //RENDERER_TRIPLE_BUFFER_H
@@ -3,10 +3,29 @@
  * \date 18-May-16.
  */
 
+#ifdef _WIN32
+// Keep windows.h from defining min and max, which break std::min, std::max and glm. easylogging includes windows.h
+// too, so these have to come before every other include
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#endif
+
 #include <easylogging++.h>
 
 #include "utils.h"
 
+#ifdef _WIN32
+#include <direct.h>
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
 void initialize_logging() {
     // Configure the logger
     el::Configurations conf("config/logging.conf");
@@ -48,6 +67,90 @@ namespace nova {
         return elems;
     }
 
+    void make_directories(const std::string& path) {
+        for(size_t separator = path.find('/'); ; separator = path.find('/', separator + 1)) {
+            std::string directory = path.substr(0, separator);
+            if(!directory.empty()) {
+#ifdef _WIN32
+                _mkdir(directory.c_str());
+#else
+                mkdir(directory.c_str(), 0755);
+#endif
+            }
+
+            if(separator == std::string::npos) {
+                break;
+            }
+        }
+    }
+
+    uint64_t hash_bytes(const void* data, size_t size, uint64_t hash) {
+        auto bytes = static_cast<const uint8_t*>(data);
+        for(size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    std::vector<std::string> list_files(const std::string& directory) {
+        std::vector<std::string> files;
+        std::vector<std::string> directories_to_list = {directory};
+        while(!directories_to_list.empty()) {
+            std::string current_directory = directories_to_list.back();
+            directories_to_list.pop_back();
+
+#ifdef _WIN32
+            WIN32_FIND_DATAA entry;
+            HANDLE search = FindFirstFileA((current_directory + "/*").c_str(), &entry);
+            if(search == INVALID_HANDLE_VALUE) {
+                continue;
+            }
+
+            do {
+                std::string name = entry.cFileName;
+                if(name == "." || name == "..") {
+                    continue;
+                }
+
+                if(entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+                    directories_to_list.push_back(current_directory + "/" + name);
+                } else {
+                    files.push_back(current_directory + "/" + name);
+                }
+            } while(FindNextFileA(search, &entry));
+            FindClose(search);
+#else
+            DIR* listing = opendir(current_directory.c_str());
+            if(listing == nullptr) {
+                continue;
+            }
+
+            while(dirent* entry = readdir(listing)) {
+                std::string name = entry->d_name;
+                if(name == "." || name == "..") {
+                    continue;
+                }
+
+                std::string path = current_directory + "/" + name;
+                struct stat info;
+                if(stat(path.c_str(), &info) != 0) {
+                    continue;
+                }
+
+                if(S_ISDIR(info.st_mode)) {
+                    directories_to_list.push_back(path);
+                } else {
+                    files.push_back(path);
+                }
+            }
+            closedir(listing);
+#endif
+        }
+
+        return files;
+    }
+
     el::base::Writer &operator<<(el::base::Writer &out, const glm::ivec3 &vec) {
         out << "(" << vec.x << ", " << vec.y << ", " << vec.z << ")";
         return out;
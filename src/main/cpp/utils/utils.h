@@ -8,6 +8,7 @@
 #ifndef RENDERER_UTILS_H
 #define RENDERER_UTILS_H
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <algorithm>
@@ -48,6 +49,45 @@ namespace nova {
 
     std::vector<std::string> split(const std::string &s, char delim);
 
+    /*!
+     * \brief Creates the directory at the given path, and any of its parents that don't exist yet
+     *
+     * \param path The directory to create, with / between the directory names
+     */
+    void make_directories(const std::string& path);
+
+    /*!
+     * \brief Finds every file in a directory and in all the directories under it
+     *
+     * \param directory The directory to look in
+     * \return The path of each file, starting with the directory and with / between the directory names. Empty if
+     * the directory doesn't exist
+     */
+    std::vector<std::string> list_files(const std::string& directory);
+
+    /*!
+     * \brief The starting value for a hash
+     */
+    const uint64_t EMPTY_HASH = 14695981039346656037ULL;
+
+    /*!
+     * \brief Hashes some bytes with 64-bit FNV-1a. It's fast and stable between runs, so it's good for cache keys,
+     * but it's not meant to stand up to anyone trying to make collisions
+     *
+     * \param data The bytes to hash
+     * \param size How many bytes there are
+     * \param hash The hash to continue from, so that several things can be hashed together
+     */
+    uint64_t hash_bytes(const void* data, size_t size, uint64_t hash = EMPTY_HASH);
+
+    /*!
+     * \brief Hashes a single value. Only use it with types that don't have padding, or the padding gets hashed too
+     */
+    template <typename T>
+    uint64_t hash_value(const T& value, uint64_t hash = EMPTY_HASH) {
+        return hash_bytes(&value, sizeof(T), hash);
+    }
+
     /*!
      * \brief Simple exception to represent that a resouce can not be found
      */
@@ -0,0 +1,206 @@
+package com.continuum.nova;
+
+import com.sun.jna.Pointer;
+import sun.misc.Unsafe;
+
+import java.lang.reflect.Field;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
+
+/**
+ * Writes commands into native memory that Nova reads at the start of each frame, so that sending Nova lots of little
+ * things doesn't cost a JNA call each
+ * <p>
+ * The layout of the ring and of each command is described in data_loading/command_ring.h. Only one thread may write
+ * commands, and it has to be the thread that calls execute_frame
+ * <p>
+ * Nova can read the ring while Java writes to it, so the offsets are handed back and forth with the same ordering the
+ * native side uses: the write offset is stored with release semantics after the command's bytes, and the read offset
+ * is loaded with acquire semantics before the space it frees is reused. Java 8 doesn't have VarHandles, so both go
+ * through Unsafe on the ring's native address
+ *
+ * @author ddubois
+ * @since 18-Oct-26
+ */
+public class CommandRing {
+    public static final int ADD_CHUNK_GEOMETRY = 1;
+    public static final int REMOVE_CHUNK_GEOMETRY = 2;
+    public static final int ADD_GUI_GEOMETRY = 3;
+    public static final int CLEAR_GUI = 4;
+    public static final int SET_FLOAT_SETTING = 5;
+    public static final int SET_STRING_SETTING = 6;
+    public static final int SET_CAMERA = 7;
+
+    private static final int MAGIC = 0x5243564E;
+    private static final int VERSION = 1;
+
+    private static final int CAPACITY_POS = 8;
+    private static final int DATA_OFFSET_POS = 12;
+    private static final int WRITE_OFFSET_POS = 64;
+    private static final int READ_OFFSET_POS = 128;
+
+    private static final int COMMAND_HEADER_SIZE = 8;
+
+    private static final Unsafe UNSAFE = getUnsafe();
+
+    private final NovaNative nova;
+    private final long headerAddress;
+    private final ByteBuffer data;
+    private final int capacity;
+
+    private long writeOffset;
+    private long commandEnd;
+
+    public CommandRing(NovaNative nova) {
+        this.nova = nova;
+
+        Pointer memory = nova.get_command_ring();
+        headerAddress = Pointer.nativeValue(memory);
+        ByteBuffer header = memory.getByteBuffer(0, nova.get_command_ring_size()).order(ByteOrder.nativeOrder());
+        if(header.getInt(0) != MAGIC || header.getInt(4) != VERSION) {
+            throw new IllegalStateException("Nova's command ring is version " + header.getInt(4) + " but Java writes version " + VERSION);
+        }
+
+        capacity = header.getInt(CAPACITY_POS);
+        header.position(header.getInt(DATA_OFFSET_POS));
+        data = header.slice().order(ByteOrder.nativeOrder());
+        writeOffset = UNSAFE.getLongVolatile(null, headerAddress + WRITE_OFFSET_POS);
+    }
+
+    private static Unsafe getUnsafe() {
+        try {
+            Field field = Unsafe.class.getDeclaredField("theUnsafe");
+            field.setAccessible(true);
+            return (Unsafe) field.get(null);
+        } catch(NoSuchFieldException | IllegalAccessException e) {
+            throw new IllegalStateException("The command ring needs sun.misc.Unsafe to share its offsets with Nova", e);
+        }
+    }
+
+    /**
+     * Starts a new command. Write exactly payloadSize bytes of payload with the put methods, then call
+     * {@link #endCommand()}
+     * <p>
+     * If the ring is too full, Nova processes everything in it first
+     *
+     * @return False if the command is bigger than the whole ring. Send it through JNA instead
+     */
+    public boolean beginCommand(int type, int payloadSize) {
+        int size = roundUp(COMMAND_HEADER_SIZE + payloadSize, 8);
+        int spaceBeforeEnd = capacity - (int) (writeOffset & (capacity - 1));
+        int padding = size > spaceBeforeEnd ? spaceBeforeEnd : 0;
+        if(padding + size > capacity) {
+            return false;
+        }
+
+        // Acquire, so the commands Nova has finished with really are finished before they're written over
+        long readOffset = UNSAFE.getLongVolatile(null, headerAddress + READ_OFFSET_POS);
+        if(padding + size > capacity - (writeOffset - readOffset)) {
+            flush();
+        }
+
+        if(padding > 0) {
+            data.putInt((int) (writeOffset & (capacity - 1)), 0);
+            data.putInt((int) (writeOffset & (capacity - 1)) + 4, padding);
+            writeOffset += padding;
+        }
+
+        int position = (int) (writeOffset & (capacity - 1));
+        data.putInt(position, type);
+        data.putInt(position + 4, size);
+        data.position(position + COMMAND_HEADER_SIZE);
+        commandEnd = writeOffset + size;
+        return true;
+    }
+
+    /**
+     * Lets Nova see the command that was just written
+     */
+    public void endCommand() {
+        writeOffset = commandEnd;
+
+        // Release, so Nova sees all of the command's bytes once it sees the new write offset
+        UNSAFE.putOrderedLong(null, headerAddress + WRITE_OFFSET_POS, writeOffset);
+    }
+
+    /**
+     * Makes Nova do everything in the ring right now. Call this before sending Nova anything through JNA that has to
+     * happen after the commands in the ring
+     */
+    public void flush() {
+        nova.process_command_ring();
+    }
+
+    public CommandRing putInt(int value) {
+        data.putInt(value);
+        return this;
+    }
+
+    public CommandRing putFloat(float value) {
+        data.putFloat(value);
+        return this;
+    }
+
+    public CommandRing putDouble(double value) {
+        data.putDouble(value);
+        return this;
+    }
+
+    /**
+     * Writes a string from {@link #encode(String)}
+     */
+    public CommandRing putString(byte[] str) {
+        data.putInt(str.length);
+        data.put(str);
+        for(int i = str.length; i < roundUp(str.length + 1, 4); i++) {
+            data.put((byte) 0);
+        }
+        return this;
+    }
+
+    public static byte[] encode(String str) {
+        return str.getBytes(StandardCharsets.UTF_8);
+    }
+
+    /**
+     * How many bytes a string from {@link #encode(String)} takes up in a command
+     */
+    public static int stringSize(byte[] str) {
+        return 4 + roundUp(str.length + 1, 4);
+    }
+
+    public void clearGui() {
+        if(beginCommand(CLEAR_GUI, 0)) {
+            endCommand();
+        }
+    }
+
+    public void setFloatSetting(String name, float value) {
+        byte[] nameBytes = encode(name);
+        if(beginCommand(SET_FLOAT_SETTING, 4 + stringSize(nameBytes))) {
+            putFloat(value).putString(nameBytes);
+            endCommand();
+        }
+    }
+
+    public void setStringSetting(String name, String value) {
+        byte[] nameBytes = encode(name);
+        byte[] valueBytes = encode(value);
+        if(beginCommand(SET_STRING_SETTING, stringSize(nameBytes) + stringSize(valueBytes))) {
+            putString(nameBytes).putString(valueBytes);
+            endCommand();
+        }
+    }
+
+    public void setCamera(double x, double y, double z, float yaw, float pitch) {
+        if(beginCommand(SET_CAMERA, 8 * 3 + 4 * 2)) {
+            putDouble(x).putDouble(y).putDouble(z).putFloat(yaw).putFloat(pitch);
+            endCommand();
+        }
+    }
+
+    private static int roundUp(int value, int alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
@@ -0,0 +1,61 @@
+package com.continuum.nova;
+
+/**
+ * Plain JNI bindings for the native functions that get called the most
+ * <p>
+ * JNA figures out how to marshal every argument with reflection on every call, which adds up for chunk geometry and
+ * input polling. These methods are registered by JNI_OnLoad in mc_interface/nova_jni.cpp, and they go to the same
+ * native code that the matching functions in {@link NovaNative} go to. Everything that isn't called often stays in
+ * NovaNative
+ *
+ * @author ddubois
+ * @since 18-Oct-26
+ */
+public class NovaJNI {
+    static {
+        // JNA has already loaded the library, but the JVM only calls JNI_OnLoad for libraries it loads itself
+        System.loadLibrary("nova-renderer");
+    }
+
+    private NovaJNI() {}
+
+    /**
+     * Adds a chunk to Nova, or replaces the chunk with the same ID. The arrays are copied before this returns, so
+     * they can be reused straight away
+     */
+    public static native void addChunkGeometryForFilter(String filterName, int format, float x, float y, float z, int id,
+                                                        int[] vertexData, int vertexCount, int[] indices, int indexCount);
+
+    public static native void removeChunkGeometryForFilter(String filterName, float x, float y, float z, int id);
+
+    public static native void setPlayerCameraTransform(double x, double y, double z, float yaw, float pitch);
+
+    /**
+     * @param event Gets {button, action, mods}
+     * @return False if there are no more mouse button events
+     */
+    public static native boolean nextMouseButtonEvent(int[] event);
+
+    /**
+     * @param event Gets {x, y}
+     * @return False if there are no more mouse position events
+     */
+    public static native boolean nextMousePositionEvent(int[] event);
+
+    /**
+     * @param event Gets {x offset, y offset}
+     * @return False if there are no more mouse scroll events
+     */
+    public static native boolean nextMouseScrollEvent(double[] event);
+
+    /**
+     * @param event Gets {key, scancode, action, mods}
+     * @return False if there are no more key press events
+     */
+    public static native boolean nextKeyPressEvent(int[] event);
+
+    /**
+     * @return The next typed character, or -1 if there isn't one
+     */
+    public static native long nextKeyCharEvent();
+}
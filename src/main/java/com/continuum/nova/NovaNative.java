@@ -46,7 +46,7 @@ public interface NovaNative extends Library {
 
         @Override
         public List<String> getFieldOrder() {
-            return Arrays.asList("width", "height", "num_components", "texture_data");
+            return Arrays.asList("width", "height", "num_components", "texture_data", "name");
         }
 
         @Override
@@ -228,6 +228,35 @@ public interface NovaNative extends Library {
         }
     }
 
+    /**
+     * Any kind of input event. Only the fields that go with the event's type are filled in
+     */
+    class input_event extends Structure {
+        public static final int MOUSE_BUTTON = 0;
+        public static final int MOUSE_POSITION = 1;
+        public static final int MOUSE_SCROLL = 2;
+        public static final int KEY_PRESS = 3;
+        public static final int KEY_CHAR = 4;
+
+        public int type;
+        public int button_or_key;
+        public int scancode;
+        public int action;
+        public int mods;
+        public int xpos;
+        public int ypos;
+        public double xoffset;
+        public double yoffset;
+        public long unicode_char;
+        public long timestamp;
+
+        @Override
+        protected List<String> getFieldOrder() {
+            return Arrays.asList("type", "button_or_key", "scancode", "action", "mods", "xpos", "ypos", "xoffset",
+                    "yoffset", "unicode_char", "timestamp");
+        }
+    }
+
     class window_size extends Structure implements Structure.ByValue{
         public int height;
         public int width;
@@ -270,6 +299,10 @@ public interface NovaNative extends Library {
 
     void add_texture_location(mc_texture_atlas_location location);
 
+    void add_sprite(String atlas_name, mc_atlas_texture sprite);
+
+    void finalize_textures();
+
     int get_max_texture_size();
 
     void reset_texture_manager();
@@ -296,6 +329,24 @@ public interface NovaNative extends Library {
 
     key_char_event get_next_key_char_event();
 
+    /**
+     * Gets all the pending input events at once, in the order they happened
+     *
+     * @param buffer An array made with {@code new input_event().toArray(capacity)}, so the events are next to each
+     *               other in memory
+     * @param capacity The length of the buffer
+     * @param coalesce_mouse_moves Non-zero to merge mouse moves that happen right after each other
+     * @return The number of events put in the buffer
+     */
+    int drain_input_events(input_event[] buffer, int capacity, int coalesce_mouse_moves);
+
+    /**
+     * Reads one of the numbers Nova keeps about how it's doing, like "gui_reuse_rate" or "input_latency_p95_ms"
+     *
+     * @return The value of the stat, or 0 if it's never been set
+     */
+    double get_stat(String name);
+
     window_size get_window_size();
 
     void set_fullscreen(int fullscreen);
@@ -309,4 +360,16 @@ public interface NovaNative extends Library {
     void set_player_camera_transform(double x, double y, double z, float yaw, float pitch);
 
     String get_shaders_and_filters();
+
+    /**
+     * Gets the memory that {@link CommandRing} writes commands into
+     */
+    Pointer get_command_ring();
+
+    int get_command_ring_size();
+
+    /**
+     * Makes Nova do everything in the command ring right now, to make room for more commands
+     */
+    void process_command_ring();
 }
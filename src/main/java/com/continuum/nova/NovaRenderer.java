@@ -5,6 +5,7 @@ import com.continuum.nova.chunks.ChunkBuilder;
 import com.continuum.nova.chunks.ChunkUpdateListener;
 import com.continuum.nova.chunks.IGeometryFilter;
 import com.continuum.nova.gui.NovaDraw;
+import com.continuum.nova.utils.NativeCallBenchmark;
 import com.continuum.nova.utils.Profiler;
 import com.continuum.nova.utils.Utils;
 import glm.Glm;
@@ -51,16 +52,8 @@ public class NovaRenderer implements IResourceManagerReloadListener {
     private boolean firstLoad = true;
 
     private static final List<ResourceLocation> GUI_COLOR_TEXTURES_LOCATIONS = new ArrayList<>();
-    private TextureMap guiAtlas = new TextureMap("textures");
-    private Map<ResourceLocation, TextureAtlasSprite> guiSpriteLocations = new HashMap<>();
-
     private static final List<ResourceLocation> BLOCK_COLOR_TEXTURES_LOCATIONS = new ArrayList<>();
-    private TextureMap blockAtlas = new TextureMap("textures");
-    private Map<ResourceLocation, TextureAtlasSprite> blockSpriteLocations = new HashMap<>();
-
     private static final List<ResourceLocation> FONT_COLOR_TEXTURES_LOCATIONS = new ArrayList<>();
-    private TextureMap fontAtlas = new TextureMap("textures");
-    private Map<ResourceLocation, TextureAtlasSprite> fontSpriteLocations = new HashMap<>();
 
     private static final List<ResourceLocation> FREE_TEXTURES = new ArrayList<>();
 
@@ -81,6 +74,8 @@ public class NovaRenderer implements IResourceManagerReloadListener {
     final private Executor chunkUpdateThreadPool = Executors.newFixedThreadPool(10);
 
     private ChunkBuilder chunkBuilder;
+
+    private static CommandRing commandRing;
     private HashMap<String, IGeometryFilter> filterMap;
 
     public NovaRenderer() {
@@ -109,6 +104,9 @@ public class NovaRenderer implements IResourceManagerReloadListener {
         addFontAtlas(resourceManager);
         addFreeTextures(resourceManager);
         addLightmap(resourceManager);
+
+        // Nova packs the GUI and font atlases here. The block atlas is packed once Minecraft has stitched its own
+        NovaNative.INSTANCE.finalize_textures();
     }
 
     private void addLightmap(IResourceManager resourceManager) {
@@ -139,101 +137,88 @@ public class NovaRenderer implements IResourceManagerReloadListener {
     }
 
     private void addGuiAtlas(@Nonnull IResourceManager resourceManager) {
-        guiAtlas.createWhiteTexture(WHITE_TEXTURE_GUI_LOCATION);
-        addAtlas(resourceManager, guiAtlas, GUI_COLOR_TEXTURES_LOCATIONS, guiSpriteLocations, GUI_ATLAS_NAME);
-        LOG.debug("Created GUI atlas");
+        addAtlas(resourceManager, GUI_COLOR_TEXTURES_LOCATIONS, GUI_ATLAS_NAME);
+        addWhiteSprite(GUI_ATLAS_NAME, WHITE_TEXTURE_GUI_LOCATION);
+        LOG.debug("Sent GUI sprites");
     }
 
     private void addFontAtlas(@Nonnull IResourceManager resourceManager) {
-        addAtlas(resourceManager, fontAtlas, FONT_COLOR_TEXTURES_LOCATIONS, fontSpriteLocations, FONT_ATLAS_NAME);
-        LOG.debug("Created font atlas");
+        addAtlas(resourceManager, FONT_COLOR_TEXTURES_LOCATIONS, FONT_ATLAS_NAME);
+        LOG.debug("Sent font sprites");
     }
 
+    /**
+     * Sends Nova every sprite that Minecraft stitched into its block atlas, then has Nova pack them into its own atlas
+     *
+     * @param blockColorMap Minecraft's block atlas, which has already loaded all the sprites
+     */
     public void addTerrainAtlas(@Nonnull TextureMap blockColorMap) {
-        // Copy over the atlas
-        NovaNative.mc_atlas_texture blockColorTexture = getFullImage(blockColorMap.getWidth(), blockColorMap.getHeight(), blockColorMap.getMapUploadedSprites().values());
-        blockColorTexture.name = BLOCK_COLOR_ATLAS_NAME;
-        NovaNative.INSTANCE.add_texture(blockColorTexture);
-
-        // Copy over all the icon locations
-        for(String spriteName : blockColorMap.getMapUploadedSprites().keySet()) {
-            TextureAtlasSprite sprite = blockColorMap.getAtlasSprite(spriteName);
-            NovaNative.mc_texture_atlas_location location = new NovaNative.mc_texture_atlas_location(
-                    sprite.getIconName(),
-                    sprite.getMinU(),
-                    sprite.getMinV(),
-                    sprite.getMaxU(),
-                    sprite.getMaxV()
-            );
-
-            NovaNative.INSTANCE.add_texture_location(location);
+        for(TextureAtlasSprite sprite : blockColorMap.getMapUploadedSprites().values()) {
+            if(sprite.getFrameCount() > 0) {
+                addSprite(BLOCK_COLOR_ATLAS_NAME, sprite.getIconName(), sprite.getIconWidth(), sprite.getIconHeight(), getSpriteData(sprite));
+            }
         }
-    }
 
-    private void addAtlas(@Nonnull IResourceManager resourceManager, TextureMap atlas, List<ResourceLocation> resources,
-                          Map<ResourceLocation, TextureAtlasSprite> spriteLocations, String textureName) {
-        atlas.loadSprites(resourceManager, textureMapIn -> resources.forEach(location -> {
-            TextureAtlasSprite textureAtlasSprite = textureMapIn.registerSprite(location);
-            spriteLocations.put(location, textureAtlasSprite);
-        }));
-
-        Optional<TextureAtlasSprite> whiteImage = atlas.getWhiteImage();
-        whiteImage.ifPresent(image -> spriteLocations.put(image.getLocation(), image));
-
-        NovaNative.mc_atlas_texture atlasTexture = getFullImage(atlas.getWidth(), atlas.getHeight(), spriteLocations.values());
-        atlasTexture.setName(textureName);
-
-        LOG.info("Adding atlas texture {}", atlasTexture);
-        NovaNative.INSTANCE.add_texture(atlasTexture);
-
-        for (TextureAtlasSprite sprite : spriteLocations.values()) {
-            NovaNative.mc_texture_atlas_location location = new NovaNative.mc_texture_atlas_location(
-                    sprite.getIconName(),
-                    sprite.getMinU(),
-                    sprite.getMinV(),
-                    sprite.getMaxU(),
-                    sprite.getMaxV()
-            );
+        // The block atlas is mipmapped, which needs to know where all the sprites are
+        NovaNative.INSTANCE.finalize_textures();
+    }
 
-            NovaNative.INSTANCE.add_texture_location(location);
+    /**
+     * Sends each of the given textures to Nova, which packs them into the named atlas when textures are finalized
+     *
+     * @param resourceManager The IResourceManager to get the textures from
+     * @param resources The textures to put in the atlas, without the textures/ prefix or the .png extension
+     * @param atlasName The name of the atlas to put the textures in
+     */
+    private void addAtlas(@Nonnull IResourceManager resourceManager, List<ResourceLocation> resources, String atlasName) {
+        for (ResourceLocation location : resources) {
+            ResourceLocation textureLocation = new ResourceLocation(location.getResourceDomain(), "textures/" + location.getResourcePath() + ".png");
+            try {
+                IResource texture = resourceManager.getResource(textureLocation);
+                BufferedImage image = ImageIO.read(new BufferedInputStream(texture.getInputStream()));
+                if (image != null) {
+                    addSprite(atlasName, location.toString(), image.getWidth(), image.getHeight(), getImageData(image));
+                } else {
+                    LOG.error("Sprite " + location + " has no data!");
+                }
+            } catch (IOException e) {
+                LOG.error("Could not load sprite " + location + " for atlas " + atlasName, e);
+            }
         }
     }
 
-    private NovaNative.mc_atlas_texture getFullImage(int atlasWidth, int atlasHeight, Collection<TextureAtlasSprite> sprites) {
-        byte[] imageData = new byte[atlasWidth * atlasHeight * 4];
+    /**
+     * Adds a plain white sprite, which untextured GUI elements are drawn with
+     */
+    private void addWhiteSprite(String atlasName, ResourceLocation location) {
+        byte[] imageData = new byte[16 * 16 * 4];
+        Arrays.fill(imageData, (byte) 0xFF);
+        addSprite(atlasName, location.toString(), 16, 16, imageData);
+    }
 
-        for (TextureAtlasSprite sprite : sprites) {
-            int startY = sprite.getOriginY() * atlasWidth * 4;
-            int startPos = sprite.getOriginX() * 4 + startY;
+    private void addSprite(String atlasName, String spriteName, int width, int height, byte[] rgbaData) {
+        NovaNative.mc_atlas_texture sprite = new NovaNative.mc_atlas_texture(width, height, 4, rgbaData);
+        sprite.setName(spriteName);
+        NovaNative.INSTANCE.add_sprite(atlasName, sprite);
+    }
 
-            if(sprite.getFrameCount() > 0) {
-                int[] data = sprite.getFrameTextureData(0)[0];
-                for(int y = 0; y < sprite.getIconHeight(); y++) {
-                    for(int x = 0; x < sprite.getIconWidth(); x++) {
-                        // Reverse the order of the color channels
-                        int pixel = data[y * sprite.getIconWidth() + x];
-
-                        byte red = (byte) (pixel & 0xFF);
-                        byte green = (byte) ((pixel >> 8) & 0xFF);
-                        byte blue = (byte) ((pixel >> 16) & 0xFF);
-                        byte alpha = (byte) ((pixel >> 24) & 0xFF);
-
-                        int imageDataBasePos = startPos + x * 4 + y * atlasWidth * 4;
-                        imageData[imageDataBasePos] = blue;
-                        imageData[imageDataBasePos + 1] = green;
-                        imageData[imageDataBasePos + 2] = red;
-                        imageData[imageDataBasePos + 3] = alpha;
-                    }
-                }
-            }
+    /**
+     * Gets the first frame of a sprite that Minecraft loaded, as RGBA bytes
+     */
+    private byte[] getSpriteData(TextureAtlasSprite sprite) {
+        int[] data = sprite.getFrameTextureData(0)[0];
+        byte[] imageData = new byte[sprite.getIconWidth() * sprite.getIconHeight() * 4];
+
+        for(int i = 0; i < sprite.getIconWidth() * sprite.getIconHeight(); i++) {
+            // Minecraft keeps its pixels as ARGB
+            int pixel = data[i];
+            imageData[i * 4] = (byte) ((pixel >> 16) & 0xFF);
+            imageData[i * 4 + 1] = (byte) ((pixel >> 8) & 0xFF);
+            imageData[i * 4 + 2] = (byte) (pixel & 0xFF);
+            imageData[i * 4 + 3] = (byte) ((pixel >> 24) & 0xFF);
         }
 
-        return new NovaNative.mc_atlas_texture(
-                atlasWidth,
-                atlasHeight,
-                4,
-                imageData
-        );
+        return imageData;
     }
 
     public void preInit() {
@@ -243,6 +228,10 @@ public class NovaRenderer implements IResourceManagerReloadListener {
         LOG.info("PID: " + pid + " TID: " + Thread.currentThread().getId());
         NovaNative.INSTANCE.initialize();
         LOG.info("Native code initialized");
+        commandRing = new CommandRing(NovaNative.INSTANCE);
+        if(NativeCallBenchmark.isEnabled()) {
+            NativeCallBenchmark.run(commandRing);
+        }
         updateWindowSize();
 
         // Moved here so that it's initialized after the native code is loaded
@@ -333,7 +322,7 @@ public class NovaRenderer implements IResourceManagerReloadListener {
             double x = viewEntity.posX;
             double y = viewEntity.posY + viewEntity.getEyeHeight();
             double z = viewEntity.posZ;
-            NovaNative.INSTANCE.set_player_camera_transform(x, y, z, yaw, pitch);
+            commandRing.setCamera(x, y, z, yaw, pitch);
         }
         Profiler.end("update_player");
 
@@ -346,7 +335,7 @@ public class NovaRenderer implements IResourceManagerReloadListener {
         Profiler.end("update_window");
         int scalefactor = new ScaledResolution(mc).getScaleFactor() * 2;
         if (scalefactor != this.scalefactor) {
-            NovaNative.INSTANCE.set_float_setting("scalefactor", scalefactor);
+            commandRing.setFloatSetting("scalefactor", scalefactor);
             this.scalefactor = scalefactor;
         }
 
@@ -396,6 +385,14 @@ public class NovaRenderer implements IResourceManagerReloadListener {
         NovaNative.INSTANCE.add_texture_location(loc);
     }
 
+    /**
+     * The command ring that the main thread uses to send Nova things without a JNA call for each one. Don't use it
+     * from any other thread
+     */
+    public static CommandRing getCommandRing() {
+        return commandRing;
+    }
+
     public static String atlasTextureOfSprite(ResourceLocation texture) {
         ResourceLocation strippedLocation = new ResourceLocation(texture.getResourceDomain(), texture.getResourcePath().replace(".png", "").replace("textures/", ""));
 
@@ -1,5 +1,6 @@
 package com.continuum.nova.gui;
 
+import com.continuum.nova.CommandRing;
 import com.continuum.nova.NovaNative;
 import com.continuum.nova.NovaRenderer;
 import com.continuum.nova.input.Mouse;
@@ -41,7 +42,7 @@ public class NovaDraw {
 
     private static void clearBuffers() {
         buffers.clear();
-        NovaNative.INSTANCE.clear_gui_buffers();
+        NovaRenderer.getCommandRing().clearGui();
         currentZ = 0.9999f;
     }
 
@@ -194,6 +195,12 @@ public class NovaDraw {
         for (Map.Entry<ResourceLocation, Buffers> entry : buffers.entrySet()) {
             Buffers b = entry.getValue();
             ResourceLocation texture = entry.getKey();
+            if(b.writeToCommandRing(NovaRenderer.getCommandRing(), texture)) {
+                continue;
+            }
+
+            // Too big for the command ring, so send it the slow way. Anything already in the ring has to happen first
+            NovaRenderer.getCommandRing().flush();
             long timeWithAlloc = System.nanoTime();
             NovaNative.mc_gui_buffer guiGeometry = b.toNativeCommand(texture);
             long timePrev = System.nanoTime();
@@ -259,6 +266,33 @@ public class NovaDraw {
             return this;
         }
 
+        /**
+         * Writes the buffers into the command ring, which is a lot cheaper than {@link #toNativeCommand(ResourceLocation)}
+         *
+         * @param ring the command ring
+         * @param texture the texture
+         * @return false if the buffers are too big for the command ring
+         */
+        public boolean writeToCommandRing(CommandRing ring, ResourceLocation texture) {
+            byte[] textureName = CommandRing.encode(texture.getResourcePath());
+            byte[] atlasName = CommandRing.encode(NovaRenderer.atlasTextureOfSprite(texture));
+            int payloadSize = 4 + 4 + CommandRing.stringSize(textureName) + CommandRing.stringSize(atlasName) +
+                    this.indexBuffer.size() * 4 + this.vertexBuffer.size() * 4;
+            if(!ring.beginCommand(CommandRing.ADD_GUI_GEOMETRY, payloadSize)) {
+                return false;
+            }
+
+            ring.putInt(this.indexBuffer.size()).putInt(this.vertexBuffer.size()).putString(textureName).putString(atlasName);
+            for(Integer index : this.indexBuffer) {
+                ring.putInt(index != null ? index : 0);
+            }
+            for(Float vertex : this.vertexBuffer) {
+                ring.putFloat(vertex != null ? vertex : 0);
+            }
+            ring.endCommand();
+            return true;
+        }
+
         /**
          * Generate a native struct which can be sent to c++.
          * <p>
@@ -0,0 +1,136 @@
+package com.continuum.nova.input;
+
+import com.continuum.nova.NovaNative;
+import org.apache.logging.log4j.LogManager;
+import org.apache.logging.log4j.Logger;
+
+/**
+ * Gets all of the input events Nova has queued up with one native call, then hands them out to {@link Mouse} and
+ * {@link Keyboard} one at a time
+ * <p>
+ * Minecraft asks for input one event at a time, which is thousands of native calls a second while the mouse moves.
+ * Instead, the first call to {@link Mouse#next()} or {@link Keyboard#next()} in a tick drains everything into a
+ * reusable buffer, and the rest of that tick's calls read from there. Mouse moves that happen right after each other
+ * are merged, since Minecraft only cares where the mouse ended up
+ *
+ * @author ddubois
+ * @since 18-Oct-26
+ */
+final class InputEvents {
+    private static final Logger LOG = LogManager.getLogger(InputEvents.class);
+
+    private static final int CAPACITY = 256;
+
+    /**
+     * JNA needs the structures next to each other in memory, which toArray takes care of
+     */
+    private static final NovaNative.input_event[] buffer = (NovaNative.input_event[]) new NovaNative.input_event().toArray(CAPACITY);
+
+    static final EventQueue mouseEvents = new EventQueue();
+    static final EventQueue keyboardEvents = new EventQueue();
+
+    private InputEvents() {}
+
+    /**
+     * One event, copied out of the native buffer so the buffer can be drained into again straight away
+     */
+    static final class Event {
+        int type;
+        int buttonOrKey;
+        int action;
+        int mods;
+        int x;
+        int y;
+        double scroll;
+        char character;
+        long nanos;
+    }
+
+    /**
+     * The events for one device, in the order they happened. The events are allocated once and reused
+     */
+    static final class EventQueue {
+        private final Event[] events = new Event[CAPACITY * 2];
+        private int head;
+        private int size;
+        private boolean drainedThisTick;
+
+        private EventQueue() {
+            for(int i = 0; i < events.length; i++) {
+                events[i] = new Event();
+            }
+        }
+
+        /**
+         * Gets the next event, draining Nova's events if this device has run out
+         * <p>
+         * Running out ends the device's loop for this tick, so after a drain this returns null once before it drains
+         * again. That way each {@code while(next())} loop makes a single native call
+         *
+         * @return The next event, or null if there are no more this tick. The event is only valid until the next call
+         */
+        Event next() {
+            if(size == 0) {
+                if(drainedThisTick) {
+                    drainedThisTick = false;
+                    return null;
+                }
+
+                drain();
+                drainedThisTick = true;
+                if(size == 0) {
+                    drainedThisTick = false;
+                    return null;
+                }
+            }
+
+            return poll();
+        }
+
+        /**
+         * @return The next event if it's already been drained, or null
+         */
+        Event peek() {
+            return size == 0 ? null : events[head];
+        }
+
+        Event poll() {
+            Event event = events[head];
+            head = (head + 1) % events.length;
+            size--;
+            return event;
+        }
+
+        private Event add() {
+            if(size == events.length) {
+                // Minecraft isn't reading this device's events, so make room by dropping the oldest one
+                LOG.warn("Dropping an input event that was never read");
+                poll();
+            }
+
+            Event event = events[(head + size) % events.length];
+            size++;
+            return event;
+        }
+    }
+
+    private static void drain() {
+        int count = NovaNative.INSTANCE.drain_input_events(buffer, CAPACITY, 1);
+
+        for(int i = 0; i < count; i++) {
+            NovaNative.input_event nativeEvent = buffer[i];
+            boolean isKeyboard = nativeEvent.type == NovaNative.input_event.KEY_PRESS || nativeEvent.type == NovaNative.input_event.KEY_CHAR;
+            Event event = (isKeyboard ? keyboardEvents : mouseEvents).add();
+
+            event.type = nativeEvent.type;
+            event.buttonOrKey = nativeEvent.button_or_key;
+            event.action = nativeEvent.action;
+            event.mods = nativeEvent.mods;
+            event.x = nativeEvent.xpos;
+            event.y = nativeEvent.ypos;
+            event.scroll = nativeEvent.yoffset;
+            event.character = (char) nativeEvent.unicode_char;
+            event.nanos = nativeEvent.timestamp;
+        }
+    }
+}
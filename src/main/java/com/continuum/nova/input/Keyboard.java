@@ -12,8 +12,6 @@ import org.lwjgl.LWJGLException;
 import org.lwjgl.opengl.InputImplementation;
 
 import com.continuum.nova.NovaNative;
-import com.continuum.nova.NovaNative.key_press_event;
-import com.continuum.nova.NovaNative.key_char_event;
 public class Keyboard {
     public static final int EVENT_SIZE = 18;
     public static final int CHAR_NONE = 0;
@@ -162,6 +160,7 @@ public class Keyboard {
     private static boolean repeat_enabled;
     private static final HashSet<Integer> keyDownBuffer = new HashSet<>();
     private static Keyboard.KeyEvent current_event;
+
     private static boolean initialized;
 
     private Keyboard() {
@@ -210,24 +209,40 @@ public class Keyboard {
 
 
     public static boolean next() {
-        key_press_event p = NovaNative.INSTANCE.get_next_key_press_event();
-        key_char_event c = NovaNative.INSTANCE.get_next_key_char_event();
-
-        if (p.filled==0 && c.filled==0){
+        InputEvents.Event event = InputEvents.keyboardEvents.next();
+        if (event == null) {
             return false;
         }
-        if (p.filled==1 && p.key !=0 &&p.action!=2){
-            if (p.action ==1){
-                keyDownBuffer.add(p.key);
 
-            } else{
-                keyDownBuffer.remove(p.key);
+        int key = 0;
+        int action = 1;
+        char character = 0;
+        if (event.type == NovaNative.input_event.KEY_PRESS) {
+            key = event.buttonOrKey;
+            action = event.action;
+            if (key != 0 && action != 2) {
+                if (action == 1) {
+                    keyDownBuffer.add(key);
+
+                } else {
+                    keyDownBuffer.remove(key);
+                }
             }
+
+            // A key that types something is followed by its character, and Minecraft wants them as one event
+            InputEvents.Event typed = InputEvents.keyboardEvents.peek();
+            if (action != 0 && typed != null && typed.type == NovaNative.input_event.KEY_CHAR) {
+                character = InputEvents.keyboardEvents.poll().character;
+            }
+
+        } else {
+            character = event.character;
         }
-        current_event.key = p.key;
-        current_event.character = (char) c.unicode_char;
-        current_event.state = p.action!=0;
-        current_event.repeat = p.action == 2;
+
+        current_event.key = key;
+        current_event.character = character;
+        current_event.state = action != 0;
+        current_event.repeat = action == 2;
         return true;
     }
 
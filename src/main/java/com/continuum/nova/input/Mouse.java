@@ -5,8 +5,6 @@ import java.util.HashSet;
 import java.util.Map;
 
 import com.continuum.nova.NovaNative;
-import com.continuum.nova.NovaNative.mouse_button_event;
-import com.continuum.nova.NovaNative.mouse_position_event;
 import org.apache.logging.log4j.LogManager;
 import org.apache.logging.log4j.Logger;
 
@@ -33,6 +31,7 @@ public class Mouse {
     private static int eventButton;
     private static boolean eventState;
     private static int event_dwheel;
+
     private static long event_nanos;
     private static int grab_x;
     private static int grab_y;
@@ -106,39 +105,40 @@ public class Mouse {
     public static boolean next() {
         lastX = x;
         lastY = y;
-        mouse_button_event e = NovaNative.INSTANCE.get_next_mouse_button_event();
-        mouse_position_event p = NovaNative.INSTANCE.get_next_mouse_position_event();
-        NovaNative.mouse_scroll_event s = NovaNative.INSTANCE.get_next_mouse_scroll_event();
-        if (e.filled == 0 && p.filled==0 && s.filled == 0){
+        InputEvents.Event event = InputEvents.mouseEvents.next();
+        if (event == null) {
             return false;
         }
-        if (e.filled == 1){
-            if (e.action ==1){
-                buttonDownBuffer.add(e.button);
-
-            } else{
-                buttonDownBuffer.remove(e.button);
-            }
-            eventButton = e.button;
-            eventState = e.action == 1;
-            LOG.trace("button: " +e.button +";action: "+e.action+ ";mods: "+e.mods +"; filled: "+e.filled);
 
-        }else{
-            eventButton = -1;
-            eventState = false;
-        }
-        if(p.filled == 1 ){
-            dx += p.xpos - x;
-            dy += p.ypos - y;
-            x = p.xpos;
-            y = p.ypos;
-            LOG.trace("dx: {} dy: {}", dx, dy);
-        }
-        if(s.filled == 1){
-            event_dwheel = (int )s.yoffset;
-            LOG.trace("button: " +e.button +";action: "+e.action+ ";mods: "+e.mods +"; filled: "+e.filled);
-        }else{
-            event_dwheel = 0;
+        eventButton = -1;
+        eventState = false;
+        event_dwheel = 0;
+        event_nanos = event.nanos;
+        switch (event.type) {
+            case NovaNative.input_event.MOUSE_BUTTON:
+                if (event.action == 1) {
+                    buttonDownBuffer.add(event.buttonOrKey);
+
+                } else {
+                    buttonDownBuffer.remove(event.buttonOrKey);
+                }
+                eventButton = event.buttonOrKey;
+                eventState = event.action == 1;
+                LOG.trace("button: " + event.buttonOrKey + ";action: " + event.action + ";mods: " + event.mods);
+                break;
+
+            case NovaNative.input_event.MOUSE_POSITION:
+                dx += event.x - x;
+                dy += event.y - y;
+                x = event.x;
+                y = event.y;
+                LOG.trace("dx: {} dy: {}", dx, dy);
+                break;
+
+            case NovaNative.input_event.MOUSE_SCROLL:
+                event_dwheel = (int) event.scroll;
+                LOG.trace("dwheel: " + event_dwheel);
+                break;
         }
 
         return true;
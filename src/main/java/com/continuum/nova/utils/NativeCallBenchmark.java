@@ -0,0 +1,112 @@
+package com.continuum.nova.utils;
+
+import com.continuum.nova.CommandRing;
+import com.continuum.nova.NovaJNI;
+import com.continuum.nova.NovaNative;
+import org.apache.logging.log4j.LogManager;
+import org.apache.logging.log4j.Logger;
+
+import java.nio.IntBuffer;
+import java.util.ArrayList;
+import java.util.List;
+
+/**
+ * Compares how long the same native calls take through JNA, through JNI, and through the command ring
+ * <p>
+ * This works like a tiny JMH: each call is warmed up so the JIT has compiled it, then timed over a few measurement
+ * rounds, and the average time per call of the fastest round is logged. Run Minecraft with
+ * {@code -Dnova.benchmarkNativeCalls=true} to run it right after Nova starts up. It reads all the pending input events
+ * and moves the camera to the origin, so don't expect either to be right for the first frame. It also leaves about
+ * 10 MB of chunk geometry behind, under a filter that nothing draws
+ *
+ * @author ddubois
+ * @since 18-Oct-26
+ */
+public class NativeCallBenchmark {
+    private static final Logger LOG = LogManager.getLogger(NativeCallBenchmark.class);
+
+    private static final int WARMUP_CALLS = 20000;
+    private static final int MEASURED_CALLS = 100000;
+    private static final int ROUNDS = 5;
+
+    /**
+     * Filter that no shader uses, so the chunks that get added never get drawn
+     */
+    private static final String BENCHMARK_FILTER = "nova_native_call_benchmark";
+
+    /**
+     * A small chunk section's worth of quads. Every chunk that's added gets uploaded, so this can't be too big
+     */
+    private static final int NUM_QUADS = 256;
+
+    private static volatile Object blackhole;
+
+    private NativeCallBenchmark() {}
+
+    public static boolean isEnabled() {
+        return Boolean.getBoolean("nova.benchmarkNativeCalls");
+    }
+
+    public static void run(CommandRing ring) {
+        LOG.info("Benchmarking native calls, times are nanoseconds per call");
+
+        measure("camera transform, JNA", () -> NovaNative.INSTANCE.set_player_camera_transform(0, 0, 0, 0, 0));
+        measure("camera transform, JNI", () -> NovaJNI.setPlayerCameraTransform(0, 0, 0, 0, 0));
+        measure("camera transform, command ring", () -> ring.setCamera(0, 0, 0, 0, 0));
+        ring.flush();
+
+        measure("mouse poll, JNA", () -> {
+            blackhole = NovaNative.INSTANCE.get_next_mouse_button_event();
+            blackhole = NovaNative.INSTANCE.get_next_mouse_position_event();
+            blackhole = NovaNative.INSTANCE.get_next_mouse_scroll_event();
+        });
+        int[] buttonEvent = new int[3];
+        int[] positionEvent = new int[2];
+        double[] scrollEvent = new double[2];
+        measure("mouse poll, JNI", () -> {
+            NovaJNI.nextMouseButtonEvent(buttonEvent);
+            NovaJNI.nextMousePositionEvent(positionEvent);
+            NovaJNI.nextMouseScrollEvent(scrollEvent);
+        });
+
+        int[] vertexData = new int[NUM_QUADS * 4 * 7];
+        int[] indices = new int[NUM_QUADS * 6];
+        NovaNative.mc_chunk_render_object chunk = new NovaNative.mc_chunk_render_object();
+        List<Integer> indexList = new ArrayList<>(indices.length);
+        for(int i = 0; i < indices.length; i++) {
+            indexList.add(0);
+        }
+
+        // Adding geometry is a lot slower than the other calls, and every chunk added sticks around until the next
+        // frame uploads it, so do a lot fewer of them
+        measure("chunk geometry, JNA", 10, 20, () -> {
+            chunk.setVertex_data(IntBuffer.wrap(vertexData));
+            chunk.setIndices(indexList);
+            NovaNative.INSTANCE.add_chunk_geometry_for_filter(BENCHMARK_FILTER, chunk);
+        });
+        measure("chunk geometry, JNI", 10, 20, () -> NovaJNI.addChunkGeometryForFilter(BENCHMARK_FILTER, 0, 0, 0, 0, 0,
+                vertexData, vertexData.length, indices, indices.length));
+    }
+
+    private static void measure(String name, Runnable call) {
+        measure(name, WARMUP_CALLS, MEASURED_CALLS, call);
+    }
+
+    private static void measure(String name, int warmupCalls, int measuredCalls, Runnable call) {
+        for(int i = 0; i < warmupCalls; i++) {
+            call.run();
+        }
+
+        double bestNanosPerCall = Double.MAX_VALUE;
+        for(int round = 0; round < ROUNDS; round++) {
+            long start = System.nanoTime();
+            for(int i = 0; i < measuredCalls; i++) {
+                call.run();
+            }
+            long end = System.nanoTime();
+            bestNanosPerCall = Math.min(bestNanosPerCall, (end - start) / (double) measuredCalls);
+        }
+
+        LOG.info(String.format("%-32s %10.1f", name, bestNanosPerCall));
+    }
+}